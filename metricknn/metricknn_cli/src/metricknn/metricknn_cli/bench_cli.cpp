@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2014-2015, ORAND S.A. <http://www.orand.cl/>
+ * All rights reserved.
+ *
+ * This file is part of MetricKnn. http://metricknn.org/
+ * MetricKnn is made available under the terms of the BSD 2-Clause License.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "metricknn_cli.hpp"
+
+class OptionsBenchIndex {
+public:
+	std::string string_index;
+	std::vector<std::string> searches;
+};
+class OptionsBench {
+public:
+	std::string num_reference;
+	std::string num_queries;
+	std::string dimension;
+	std::string num_clusters;
+	std::string seed;
+	std::string datatype;
+	std::string knn;
+	std::string max_threads;
+	std::string ground_truth_file;
+	std::string file_output;
+	std::vector<OptionsBenchIndex> indexes;
+};
+
+static void print_bench_options(bool detailed) {
+	std::cout << "    -size [num_reference] [num_queries]" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Generates random float vectors for the reference and query datasets."
+				<< std::endl;
+		std::cout
+				<< "       Ignored when query_ and reference_ datasets are given. Default: 100000 1000\n"
+				<< std::endl;
+	}
+	std::cout << "    -dim [num_dimensions]" << std::endl;
+	if (detailed)
+		std::cout << "       Dimension of generated vectors. Default: 32\n"
+				<< std::endl;
+	std::cout << "    -clusters [num_clusters]" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Generated vectors are normally distributed around num_clusters random centers."
+				<< std::endl;
+		std::cout
+				<< "       0 means uniform vectors in [0,1). Default: 0\n"
+				<< std::endl;
+	}
+	std::cout << "    -seed [num]" << std::endl;
+	if (detailed)
+		std::cout
+				<< "       Seed for the generated vectors, the same seed produces the same datasets. Default: 1\n"
+				<< std::endl;
+	std::cout << "    -datatype [datatype]" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Converts the query and reference vectors to datatype (e.g. FLOAT16) before building the indexes."
+				<< std::endl;
+		std::cout
+				<< "       The ground truth is computed on the original vectors. Default: no conversion\n"
+				<< std::endl;
+	}
+	std::cout << "    -ground_truth_file [filename]" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Caches the exact kNN computed by LINEARSCAN. It is loaded when the file exists and"
+				<< std::endl;
+		std::cout
+				<< "       its header (filename.header) matches the datasets, distance and knn, otherwise it is computed and saved.\n"
+				<< std::endl;
+	}
+	std::cout << "    -index [index_string]" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Index to benchmark. It may be repeated to sweep different indexes and build parameters."
+				<< std::endl;
+		std::cout << "       Default: " << default_index << std::endl;
+	}
+	std::cout << "    -search [search_string]" << std::endl;
+	if (detailed)
+		std::cout
+				<< "       Search parameters for the preceding -index. It may be repeated, each one is a row in the table.\n"
+				<< std::endl;
+	std::cout << "    -knn [num]" << std::endl;
+	if (detailed)
+		std::cout << "       Number of nearest neighbors. Default: 10\n"
+				<< std::endl;
+	std::cout << "    -maxThreads [num]" << std::endl;
+	if (detailed)
+		std::cout << "       Maximum number of threads. Default: 1\n"
+				<< std::endl;
+	std::cout << "    -file_output [filename]" << std::endl;
+	if (detailed)
+		std::cout
+				<< "       Writes the table to a file instead of standard output.\n"
+				<< std::endl;
+}
+static void print_help(std::vector<std::string> &args, bool detailed) {
+	std::cout << "Usage: " << my::collection::args_getBinaryName(args) << " "
+			<< args.at(1) << " [options] ..." << std::endl << std::endl;
+	if (detailed) {
+		std::cout
+				<< "\nCompares the recall and throughput of different indexes on the same data.\n"
+				<< std::endl;
+		std::cout
+				<< "The output is a tab-separated table with one row for each -index and -search pair.\n"
+				<< std::endl;
+	}
+	std::cout << "    -help" << std::endl;
+	if (detailed)
+		std::cout << "       Shows this detailed help.\n" << std::endl;
+	std::cout << std::endl << "QUERY DATASET OPTIONS" << std::endl;
+	print_dataset_options_brief(detailed, "query_");
+	std::cout << std::endl << "REFERENCE DATASET OPTIONS" << std::endl;
+	print_dataset_options_brief(detailed, "reference_");
+	std::cout << std::endl << "DISTANCE OPTIONS" << std::endl;
+	print_distance_options(detailed);
+	if (detailed)
+		std::cout << "       Default: L2\n" << std::endl;
+	std::cout << std::endl << "BENCHMARK OPTIONS" << std::endl;
+	print_bench_options(detailed);
+	std::cout << std::endl;
+}
+static bool parse_bench_opt(OptionsBench &opt, std::vector<std::string> &args,
+		unsigned int &i) {
+	if (my::collection::is_next_arg_equal("-size", args, i)) {
+		opt.num_reference = my::collection::next_arg(args, i);
+		opt.num_queries = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-dim", args, i)) {
+		opt.dimension = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-clusters", args, i)) {
+		opt.num_clusters = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-seed", args, i)) {
+		opt.seed = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-datatype", args, i)) {
+		opt.datatype = my::collection::next_arg(args, i);
+		GET_DATATYPE(opt.datatype);
+	} else if (my::collection::is_next_arg_equal("-ground_truth_file", args,
+			i)) {
+		opt.ground_truth_file = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-index", args, i)) {
+		OptionsBenchIndex opt_index;
+		opt_index.string_index = my::collection::next_arg(args, i);
+		std::string id = opt_index.string_index.substr(0,
+				opt_index.string_index.find(','));
+		if (!mknn_predefIndex_testIndexId(id.c_str())) {
+			std::cout << "Invalid index " << id << std::endl;
+			std::cout << "Use -search -list_indexes to see valid indexes."
+					<< std::endl;
+			exit(EXIT_FAILURE);
+		}
+		opt.indexes.push_back(opt_index);
+	} else if (my::collection::is_next_arg_equal("-search", args, i)) {
+		if (opt.indexes.size() == 0)
+			throw std::runtime_error("-search must follow an -index");
+		opt.indexes.back().searches.push_back(
+				my::collection::next_arg(args, i));
+	} else if (my::collection::is_next_arg_equal("-knn", args, i)) {
+		opt.knn = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-maxThreads", args, i)) {
+		opt.max_threads = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-file_output", args, i)) {
+		opt.file_output = my::collection::next_arg(args, i);
+		VALIDATE_FILE_NOT_EXISTS(opt.file_output);
+	} else {
+		return false;
+	}
+	return true;
+}
+static long long get_int(std::string value, long long default_value) {
+	return (value == "") ? default_value : my::parse::stringToInt(value);
+}
+//resident memory in bytes, zero when it can not be measured
+static long long get_resident_memory() {
+#if IS_LINUX
+	std::ifstream statm("/proc/self/statm");
+	long long size = 0, resident = 0;
+	if (statm >> size >> resident)
+		return resident * sysconf(_SC_PAGESIZE);
+#endif
+	return 0;
+}
+static MknnDataset *new_random_vectors(MyRandom *rnd, float *centers,
+		int64_t num_centers, int64_t num_vectors, int64_t dim) {
+	float *data = MY_MALLOC_NOINIT(num_vectors * dim, float);
+	for (int64_t i = 0; i < num_vectors; ++i) {
+		float *vector = data + i * dim;
+		if (num_centers == 0) {
+			for (int64_t j = 0; j < dim; ++j)
+				vector[j] = my_random_nextDouble(rnd, 0, 1);
+			continue;
+		}
+		float *center = centers
+				+ my_random_nextInt(rnd, 0, num_centers) * dim;
+		for (int64_t j = 0; j < dim; ++j) {
+			//Box-Muller transform, sigma is small compared to [0,1)
+			double u1 = my_random_nextDouble(rnd, DBL_MIN, 1);
+			double u2 = my_random_nextDouble(rnd, 0, 1);
+			double gauss = sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+			vector[j] = center[j] + 0.05 * gauss;
+		}
+	}
+	return mknn_datasetLoader_PointerCompactVectors(data, true, num_vectors,
+			dim, MKNN_DATATYPE_FLOATING_POINT_32bits);
+}
+static void generate_datasets(OptionsBench &opt, MknnDataset **out_reference,
+		MknnDataset **out_query) {
+	int64_t num_reference = get_int(opt.num_reference, 100000);
+	int64_t num_queries = get_int(opt.num_queries, 1000);
+	int64_t dim = get_int(opt.dimension, 32);
+	int64_t num_clusters = get_int(opt.num_clusters, 0);
+	int64_t seed = get_int(opt.seed, 1);
+	if (num_reference < 1 || num_queries < 1 || dim < 1)
+		throw std::runtime_error("-size and -dim must be greater than zero");
+	std::cout << "generating " << num_reference << " reference and "
+			<< num_queries << " query vectors, dim=" << dim << " clusters="
+			<< num_clusters << " seed=" << seed << std::endl;
+	//queries and references follow the same distribution using different streams
+	MyRandom *rnd = my_random_newStream(seed, 0);
+	float *centers = MY_MALLOC_NOINIT(num_clusters * dim, float);
+	for (int64_t i = 0; i < num_clusters * dim; ++i)
+		centers[i] = my_random_nextDouble(rnd, 0, 1);
+	*out_reference = new_random_vectors(rnd, centers, num_clusters,
+			num_reference, dim);
+	my_random_release(rnd);
+	rnd = my_random_newStream(seed, 1);
+	*out_query = new_random_vectors(rnd, centers, num_clusters, num_queries,
+			dim);
+	my_random_release(rnd);
+	free(centers);
+}
+static MknnDataset *new_converted_dataset(MknnDataset *dataset,
+		MknnDatatype datatype_out) {
+	MknnDomain *domain = mknn_dataset_getDomain(dataset);
+	if (!mknn_domain_isGeneralDomainVector(domain))
+		throw std::runtime_error("-datatype is only supported for vectors");
+	MknnDatatype datatype_in = mknn_domain_vector_getDimensionDataType(domain);
+	int64_t num_vecs = mknn_dataset_getNumObjects(dataset);
+	int64_t num_dims = mknn_domain_vector_getNumDimensions(domain);
+	char *data = MY_MALLOC_NOINIT(
+			num_vecs * num_dims * mknn_datatype_sizeof(datatype_out), char);
+	MknnDataset *dataset_out = mknn_datasetLoader_PointerCompactVectors(data,
+	true, num_vecs, num_dims, datatype_out);
+	my_function_copy_vector funcCopy = my_datatype_getFunctionCopyVector(
+			mknn_datatype_convertMknn2My(datatype_in),
+			mknn_datatype_convertMknn2My(datatype_out));
+	for (int64_t i = 0; i < num_vecs; ++i)
+		funcCopy(mknn_dataset_getObject(dataset, i),
+				mknn_dataset_getObject(dataset_out, i), num_dims);
+	return dataset_out;
+}
+static double get_dataset_megabytes(MknnDataset *dataset) {
+	MknnDomain *domain = mknn_dataset_getDomain(dataset);
+	if (!mknn_domain_isGeneralDomainVector(domain))
+		return 0;
+	return mknn_dataset_getNumObjects(dataset)
+			* mknn_domain_vector_getVectorLengthInBytes(domain)
+			/ (1024.0 * 1024.0);
+}
+static MknnResult *run_search(MknnIndex *index, std::string string_search,
+		int64_t knn, int64_t max_threads, MknnDataset *query_dataset) {
+	MknnResolverParams *params_resolver = mknn_resolverParams_newEmpty();
+	mknn_resolverParams_setKnn(params_resolver, knn);
+	mknn_resolverParams_setMaxThreads(params_resolver, max_threads);
+	mknn_resolverParams_setStatistics(params_resolver, true);
+	mknn_resolverParams_parseString(params_resolver, string_search.c_str());
+	MknnResolver *resolver = mknn_index_newResolver(index, params_resolver,
+	true);
+	return mknn_resolver_search(resolver, true, query_dataset, false);
+}
+//FNV-1a of the vectors, only the number of objects for other domains
+static uint64_t compute_dataset_checksum(MknnDataset *dataset) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+	MknnDomain *domain = mknn_dataset_getDomain(dataset);
+	if (!mknn_domain_isGeneralDomainVector(domain))
+		return hash;
+	int64_t num_bytes = mknn_domain_vector_getVectorLengthInBytes(domain);
+	for (int64_t i = 0; i < mknn_dataset_getNumObjects(dataset); ++i) {
+		uint8_t *bytes = (uint8_t*) mknn_dataset_getObject(dataset, i);
+		for (int64_t j = 0; j < num_bytes; ++j) {
+			hash ^= bytes[j];
+			hash *= UINT64_C(1099511628211);
+		}
+	}
+	return hash;
+}
+//describes the input of the ground truth, it is saved next to the cached file
+static std::string new_ground_truth_header(OptionsDistance &opt_dist,
+		MknnDataset *reference_dataset, MknnDataset *query_dataset,
+		int64_t knn) {
+	std::stringstream header;
+	MknnDomain *domain = mknn_dataset_getDomain(reference_dataset);
+	header << "num_reference="
+			<< mknn_dataset_getNumObjects(reference_dataset) << std::endl;
+	header << "num_queries=" << mknn_dataset_getNumObjects(query_dataset)
+			<< std::endl;
+	header << "dim="
+			<< (mknn_domain_isGeneralDomainVector(domain) ?
+					mknn_domain_vector_getNumDimensions(domain) : 0)
+			<< std::endl;
+	header << "knn=" << knn << std::endl;
+	header << "checksum_reference="
+			<< compute_dataset_checksum(reference_dataset) << std::endl;
+	header << "checksum_query=" << compute_dataset_checksum(query_dataset)
+			<< std::endl;
+	header << "distance=" << opt_dist.string_distance << std::endl;
+	header << "distance_file=" << opt_dist.load_file << std::endl;
+	return header.str();
+}
+static bool restore_ground_truth(std::string filename, std::string header,
+		int64_t num_queries, int64_t knn, int64_t **out_positions) {
+	if (filename == "" || !my::io::existsFile(filename))
+		return false;
+	std::ifstream in_header(filename + ".header");
+	std::stringstream saved_header;
+	saved_header << in_header.rdbuf();
+	if (saved_header.str() != header) {
+		std::cout << "ground truth in " << filename
+				<< " was computed on different data, computing it again"
+				<< std::endl;
+		return false;
+	}
+	MknnDataset *gt = mknn_dataset_restore(filename.c_str());
+	MknnDomain *domain = mknn_dataset_getDomain(gt);
+	bool valid = mknn_dataset_getNumObjects(gt) == num_queries
+			&& mknn_domain_isGeneralDomainVector(domain)
+			&& mknn_domain_vector_getNumDimensions(domain) == knn
+			&& mknn_datatype_isInt64(
+					mknn_domain_vector_getDimensionDataType(domain));
+	if (valid) {
+		std::cout << "ground truth loaded from " << filename << std::endl;
+		int64_t *positions = MY_MALLOC_NOINIT(num_queries * knn, int64_t);
+		for (int64_t i = 0; i < num_queries; ++i)
+			memcpy(positions + i * knn, mknn_dataset_getObject(gt, i),
+					knn * sizeof(int64_t));
+		*out_positions = positions;
+	} else {
+		std::cout << "ground truth in " << filename
+				<< " does not match queries or knn, computing it again"
+				<< std::endl;
+	}
+	mknn_dataset_release(gt);
+	return valid;
+}
+//positions of the exact knn, missing neighbors are -1
+static int64_t *load_ground_truth(OptionsBench &opt,
+		OptionsDistance &opt_dist, MknnDataset *reference_dataset,
+		MknnDataset *query_dataset, MknnDistance *distance, int64_t knn,
+		int64_t max_threads) {
+	int64_t num_queries = mknn_dataset_getNumObjects(query_dataset);
+	int64_t *positions = NULL;
+	std::string header;
+	if (opt.ground_truth_file != "")
+		header = new_ground_truth_header(opt_dist, reference_dataset,
+				query_dataset, knn);
+	if (restore_ground_truth(opt.ground_truth_file, header, num_queries, knn,
+			&positions))
+		return positions;
+	std::cout << my::timer::currentClock()
+			<< " computing ground truth with LINEARSCAN" << std::endl;
+	MknnIndex *index = mknn_index_newPredefined(
+			mknn_indexParams_newParseString("LINEARSCAN"), true,
+			reference_dataset, false, distance, false);
+	MknnResult *result = run_search(index, "", knn, max_threads,
+			query_dataset);
+	positions = MY_MALLOC_NOINIT(num_queries * knn, int64_t);
+	for (int64_t i = 0; i < num_queries; ++i) {
+		MknnResultQuery *resq = mknn_result_getResultQuery(result, i);
+		for (int64_t j = 0; j < knn; ++j)
+			positions[i * knn + j] =
+					(j < resq->num_nns) ? resq->nn_position[j] : -1;
+	}
+	mknn_result_release(result);
+	mknn_index_release(index);
+	if (opt.ground_truth_file != "") {
+		std::cout << "saving ground truth to " << opt.ground_truth_file
+				<< std::endl;
+		int64_t *copy = MY_MALLOC_NOINIT(num_queries * knn, int64_t);
+		memcpy(copy, positions, num_queries * knn * sizeof(int64_t));
+		MknnDataset *gt = mknn_datasetLoader_PointerCompactVectors(copy, true,
+				num_queries, knn, MKNN_DATATYPE_SIGNED_INTEGER_64bits);
+		mknn_dataset_save(gt, opt.ground_truth_file.c_str());
+		mknn_dataset_release(gt);
+		std::ofstream out_header(opt.ground_truth_file + ".header");
+		out_header << header;
+	}
+	return positions;
+}
+//fraction of the exact knn that were retrieved, ties are not considered
+static double compute_recall(MknnResult *result, int64_t *gt_positions,
+		int64_t knn) {
+	int64_t num_queries = mknn_result_getNumQueries(result);
+	int64_t found = 0, expected = 0;
+	for (int64_t i = 0; i < num_queries; ++i) {
+		MknnResultQuery *resq = mknn_result_getResultQuery(result, i);
+		int64_t *gt = gt_positions + i * knn;
+		for (int64_t j = 0; j < knn && gt[j] >= 0; ++j) {
+			expected++;
+			for (int64_t k = 0; k < resq->num_nns; ++k) {
+				if (resq->nn_position[k] == gt[j]) {
+					found++;
+					break;
+				}
+			}
+		}
+	}
+	return (expected == 0) ? 1 : found / (double) expected;
+}
+static void run_bench(OptionsDataset &opt_query, OptionsDataset &opt_ref,
+		OptionsDistance &opt_dist, OptionsBench &opt) {
+	MknnDataset *query_dataset = load_dataset(opt_query);
+	MknnDataset *reference_dataset = load_dataset(opt_ref);
+	if (query_dataset == NULL && reference_dataset == NULL) {
+		generate_datasets(opt, &reference_dataset, &query_dataset);
+	} else if (query_dataset == NULL || reference_dataset == NULL) {
+		throw std::runtime_error(
+				"must enter both query and reference datasets, or none to generate them");
+	}
+	if (opt_dist.string_distance == "" && opt_dist.load_file == "")
+		opt_dist.string_distance = "L2";
+	MknnDistance *distance = load_distance(opt_dist);
+	int64_t knn = get_int(opt.knn, 10);
+	int64_t max_threads = get_int(opt.max_threads, 1);
+	int64_t num_queries = mknn_dataset_getNumObjects(query_dataset);
+	//the table reports averages per query
+	if (num_queries == 0)
+		throw std::runtime_error("the query dataset is empty");
+	int64_t *gt_positions = load_ground_truth(opt, opt_dist,
+			reference_dataset, query_dataset, distance, knn, max_threads);
+	if (opt.datatype != "") {
+		MknnDatatype datatype = GET_DATATYPE(opt.datatype);
+		std::cout << "converting vectors to " << mknn_datatype_toString(datatype)
+				<< std::endl;
+		MknnDataset *converted = new_converted_dataset(reference_dataset,
+				datatype);
+		mknn_dataset_release(reference_dataset);
+		reference_dataset = converted;
+		converted = new_converted_dataset(query_dataset, datatype);
+		mknn_dataset_release(query_dataset);
+		query_dataset = converted;
+	}
+	double dataset_mb = get_dataset_megabytes(reference_dataset);
+	if (opt.indexes.size() == 0) {
+		OptionsBenchIndex opt_index;
+		opt_index.string_index = default_index;
+		opt.indexes.push_back(opt_index);
+	}
+	std::stringstream table;
+	table << "index\tsearch\tknn\tthreads\tdataset_MB\tbuild_seconds\tmemory_MB"
+			<< "\tsearch_seconds\tqueries_per_sec\tdistances_per_query"
+			<< "\tdiscarded_per_query\tp50_ms\tp99_ms\trecall" << std::endl;
+	for (size_t i = 0; i < opt.indexes.size(); ++i) {
+		OptionsBenchIndex &opt_index = opt.indexes[i];
+		if (opt_index.searches.size() == 0)
+			opt_index.searches.push_back("");
+		std::cout << my::timer::currentClock() << " building "
+				<< opt_index.string_index << std::endl;
+		long long memory_before = get_resident_memory();
+		my::timer timer;
+		MknnIndex *index = mknn_index_newPredefined(
+				mknn_indexParams_newParseString(
+						opt_index.string_index.c_str()), true,
+				reference_dataset, false, distance, false);
+		double build_seconds = timer.getSeconds();
+		double memory_mb = (get_resident_memory() - memory_before)
+				/ (1024.0 * 1024.0);
+		for (size_t j = 0; j < opt_index.searches.size(); ++j) {
+			std::string string_search = opt_index.searches[j];
+			std::cout << my::timer::currentClock() << " searching "
+					<< opt_index.string_index << " " << string_search
+					<< std::endl;
+			MknnResult *result = run_search(index, string_search, knn,
+					max_threads, query_dataset);
+			double seconds = mknn_result_getTotalSearchTime(result);
+			double evaluations = mknn_result_getTotalDistanceEvaluations(
+					result);
+			table << opt_index.string_index << "\t" << string_search << "\t"
+					<< knn << "\t" << max_threads << "\t"
+					<< my::toString::doubleValue(dataset_mb) << "\t"
+					<< my::toString::doubleValue(build_seconds) << "\t"
+					<< my::toString::doubleValue(memory_mb) << "\t"
+					<< my::toString::doubleValue(seconds) << "\t"
+					<< my::toString::doubleValue(
+							(seconds > 0) ? num_queries / seconds : 0) << "\t"
+					<< my::toString::doubleValue(evaluations / num_queries)
+					<< "\t"
+					<< my::toString::doubleValue(
+							mknn_result_getTotalDiscardedCandidates(result)
+									/ (double) num_queries) << "\t"
+					<< my::toString::doubleValue(
+							1000
+									* mknn_result_getQuerySearchTimeQuantile(
+											result, 0.5)) << "\t"
+					<< my::toString::doubleValue(
+							1000
+									* mknn_result_getQuerySearchTimeQuantile(
+											result, 0.99)) << "\t"
+					<< my::toString::doubleValue(
+							compute_recall(result, gt_positions, knn))
+					<< std::endl;
+			mknn_result_release(result);
+		}
+		mknn_index_release(index);
+	}
+	if (opt.file_output != "") {
+		std::ofstream out(opt.file_output);
+		out << table.str();
+	} else {
+		std::cout << table.str();
+	}
+	free(gt_positions);
+	mknn_distance_release(distance);
+	mknn_dataset_release(query_dataset);
+	mknn_dataset_release(reference_dataset);
+}
+int main_bench(std::vector<std::string> &args) {
+	OptionsDataset opt_query;
+	OptionsDataset opt_ref;
+	OptionsDistance opt_dist;
+	OptionsBench opt_bench;
+	//read parameters
+	unsigned int i = 2;
+	while (i < args.size()) {
+		if (my::collection::is_next_arg_equal("-help", args, i)) {
+			print_help(args, true);
+			return EXIT_SUCCESS;
+		} else if (parse_dataset_opt(opt_query, "query_", args, i)) {
+			continue;
+		} else if (parse_dataset_opt(opt_ref, "reference_", args, i)) {
+			continue;
+		} else if (parse_distance_opt(opt_dist, args, i)) {
+			continue;
+		} else if (parse_bench_opt(opt_bench, args, i)) {
+			continue;
+		} else {
+			throw std::runtime_error(
+					"unknown parameter " + my::collection::next_arg(args, i));
+		}
+	}
+	run_bench(opt_query, opt_ref, opt_dist, opt_bench);
+	return EXIT_SUCCESS;
+}
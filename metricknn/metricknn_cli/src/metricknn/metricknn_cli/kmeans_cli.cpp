@@ -14,6 +14,7 @@ class OptionsKmeans {
 public:
 	int numCenters;
 	int max_threads;
+	std::string seed;
 	std::string paramIndex, paramResolver;
 	std::string save_state;
 	double save_state_timer;
@@ -115,6 +116,11 @@ static void print_kmeans_options(bool detailed) {
 				<< std::endl;
 		std::cout << "       Default: number of cores.\n" << std::endl;
 	}
+	std::cout << "    -seed [num]" << std::endl;
+	if (detailed)
+		std::cout
+				<< "       Seed to select the initial centroids and the incremental subsets, the same seed produces the same clustering.\n"
+				<< std::endl;
 	std::cout << "    -paramIndex [index_string]" << std::endl;
 	if (detailed) {
 		std::cout
@@ -205,6 +211,8 @@ static bool parse_kmeans_opt(OptionsKmeans &opt, std::vector<std::string> &args,
 		opt.save_assignations = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-maxThreads", args, i)) {
 		opt.max_threads = my::collection::next_arg_int(args, i);
+	} else if (my::collection::is_next_arg_equal("-seed", args, i)) {
+		opt.seed = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-paramIndex", args, i)) {
 		opt.paramIndex = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-paramResolver", args, i)) {
@@ -229,6 +237,8 @@ static void run_kmeans(OptionsDataset &opt_dataset, OptionsDistance &opt_dist,
 	MknnDistance *distance = load_distance(opt_dist);
 	MknnKmeansAlgorithm *kmeans = mknn_kmeans_new();
 	mknn_kmeans_setDataset(kmeans, dataset);
+	if (opt_kmeans.seed != "")
+		mknn_kmeans_setSeed(kmeans, my::parse::stringToInt(opt_kmeans.seed));
 	if (opt_kmeans.centersDatatype != "") {
 		MknnDatatype dt = GET_DATATYPE(opt_kmeans.centersDatatype);
 		mknn_kmeans_setDefaultCentroidsDatatype(kmeans, dt);
@@ -14,6 +14,7 @@ int main_data(std::vector<std::string> &args);
 int main_search(std::vector<std::string> &args);
 int main_kmeans(std::vector<std::string> &args);
 int main_pca(std::vector<std::string> &args);
+int main_bench(std::vector<std::string> &args);
 
 static void print_version() {
 	std::cout << "This file is part of MetricKnn. http://metricknn.org/" << std::endl;
@@ -36,6 +37,7 @@ int main(int argc, char **argv) {
 		std::cout << "    -search ...           Performs Similarity Search." << std::endl;
 		std::cout << "    -kmeans ...           Performs K-means clustering algorithm." << std::endl;
 		std::cout << "    -pca ...              Computes PCA algorithm." << std::endl;
+		std::cout << "    -bench ...            Compares recall and throughput of indexes." << std::endl;
 		std::cout << "    -version              Prints MetricKnn version number and exits." << std::endl;
 		return EXIT_FAILURE;
 	}
@@ -49,6 +51,8 @@ int main(int argc, char **argv) {
 			return main_kmeans(args);
 		} else if (my::collection::is_next_arg_equal("-pca", args, i)) {
 			return main_pca(args);
+		} else if (my::collection::is_next_arg_equal("-bench", args, i)) {
+			return main_bench(args);
 		} else if (my::collection::is_next_arg_equal("-version", args, i)) {
 			print_version();
 			return EXIT_SUCCESS;
@@ -73,6 +73,7 @@ public:
 	std::string range;
 	std::string max_threads;
 	std::string string_search;
+	std::string statistics;
 };
 class OptionsOutput {
 public:
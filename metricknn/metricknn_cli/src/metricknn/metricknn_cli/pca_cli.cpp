@@ -18,6 +18,10 @@ public:
 	std::string output_datatype;
 	std::string output_filename;
 	std::string output_txt;
+	int max_threads;
+	OptionsPca() :
+			max_threads(0) {
+	}
 };
 
 static void print_pca_options(bool detailed) {
@@ -44,6 +48,13 @@ static void print_pca_options(bool detailed) {
 		print_datatypes("         ");
 		std::cout << "" << std::endl;
 	}
+	std::cout << "    -maxThreads [num]" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Maximum number of parallel threads to compute the covariance."
+				<< std::endl;
+		std::cout << "       Default: number of cores.\n" << std::endl;
+	}
 }
 static void print_help(std::vector<std::string> &args, bool detailed) {
 	std::cout << "Usage: " << my::collection::args_getBinaryName(args) << " "
@@ -76,23 +87,48 @@ static bool parse_pca_opt(OptionsPca &opt, std::vector<std::string> &args,
 		opt.output_datatype = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-output_txt", args, i)) {
 		opt.output_txt = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-maxThreads", args, i)) {
+		opt.max_threads = my::collection::next_arg_int(args, i);
 	} else {
 		return false;
 	}
 	return true;
 }
+//concatenated inputs are loaded and added to the statistics one at a time, so
+//the whole data does not need to fit in memory
+static void add_vector_stats(MknnPcaAlgorithm *pca,
+		OptionsDataset &opt_input_dataset) {
+	if (opt_input_dataset.concatenate_input
+			&& opt_input_dataset.inputList.size() > 1
+			&& opt_input_dataset.randomSample == "") {
+		for (size_t i = 0; i < opt_input_dataset.inputList.size(); ++i) {
+			OptionsDataset opt_single;
+			opt_single.inputList.push_back(opt_input_dataset.inputList.at(i));
+			MknnDataset *dataset = load_dataset(opt_single);
+			if (dataset == NULL)
+				throw std::runtime_error("could not load dataset");
+			mknn_pca_addDatasetToVectorStats(pca, dataset);
+			mknn_dataset_release(dataset);
+		}
+		return;
+	}
+	MknnDataset *dataset = load_dataset(opt_input_dataset);
+	if (dataset == NULL)
+		throw std::runtime_error(
+				"must enter a PCA state to load or a dataset to compute PCA.");
+	mknn_pca_addDatasetToVectorStats(pca, dataset);
+	mknn_dataset_release(dataset);
+}
 static void run_pca(OptionsDataset &opt_input_dataset,
 		OptionsDataset &opt_transform_dataset, OptionsPca &opt_pca) {
 	MknnPcaAlgorithm *pca = mknn_pca_new();
+	if (opt_pca.max_threads > 0)
+		mknn_pca_setMaxThreads(pca, opt_pca.max_threads);
 	if (my::io::existsFile(opt_pca.load_state)) {
 		std::cout << "loading PCA from " << opt_pca.load_state << std::endl;
 		mknn_pca_restore(pca, opt_pca.load_state.c_str());
 	} else {
-		MknnDataset *dataset = load_dataset(opt_input_dataset);
-		if (dataset == NULL)
-			throw std::runtime_error(
-					"must enter a PCA state to load or a dataset to compute PCA.");
-		mknn_pca_addDatasetToVectorStats(pca, dataset);
+		add_vector_stats(pca, opt_input_dataset);
 		mknn_pca_computeTransformationMatrix(pca);
 		if (opt_pca.save_state != "") {
 			std::cout << "saving PCA to " << opt_pca.save_state << std::endl;
@@ -33,16 +33,18 @@ static MknnResolverParams *load_resolver_params(OptionsSearch &options) {
 	int knn = default_knn;
 	double range = default_range;
 	int max_threads = my::parallel::getNumberOfCores();
-	if (options.knn == "")
+	if (options.knn != "")
 		knn = my::parse::stringToInt(options.knn);
-	if (options.range == "")
+	if (options.range != "")
 		range = my::parse::stringToDouble(options.range);
-	if (options.max_threads == "")
+	if (options.max_threads != "")
 		max_threads = my::parse::stringToInt(options.max_threads);
 	MknnResolverParams *params_resolver = mknn_resolverParams_newEmpty();
 	mknn_resolverParams_setKnn(params_resolver, knn);
 	mknn_resolverParams_setRange(params_resolver, range);
 	mknn_resolverParams_setMaxThreads(params_resolver, max_threads);
+	if (options.statistics == "yes")
+		mknn_resolverParams_setStatistics(params_resolver, true);
 	mknn_resolverParams_parseString(params_resolver,
 			options.string_search.c_str());
 	return params_resolver;
@@ -99,6 +101,35 @@ static void print_summary_end(MknnResult *result) {
 			<< mknn_result_getTotalDistanceEvaluations(result)
 			<< " distance evaluations, " << max_threads << " threads"
 			<< std::endl;
+	if (!mknn_result_hasStatistics(result))
+		return;
+	int64_t num_queries = mknn_result_getNumQueries(result);
+	std::cout << "discarded candidates per query="
+			<< my::toString::doubleValue(
+					mknn_result_getTotalDiscardedCandidates(result)
+							/ (double) MAX(1, num_queries)) << std::endl;
+	std::cout << "query time (ms): p50="
+			<< my::toString::doubleValue(
+					1000 * mknn_result_getQuerySearchTimeQuantile(result, 0.5))
+			<< " p90="
+			<< my::toString::doubleValue(
+					1000 * mknn_result_getQuerySearchTimeQuantile(result, 0.9))
+			<< " p99="
+			<< my::toString::doubleValue(
+					1000 * mknn_result_getQuerySearchTimeQuantile(result, 0.99))
+			<< " max="
+			<< my::toString::doubleValue(
+					1000 * mknn_result_getQuerySearchTimeQuantile(result, 1))
+			<< std::endl;
+	int64_t num_bins = 0;
+	const int64_t *bins = mknn_result_getQuerySearchTimeHistogram(result,
+			&num_bins);
+	for (int64_t i = 0; i < num_bins; ++i) {
+		if (bins[i] == 0)
+			continue;
+		std::cout << "  " << ((i == 0) ? 0 : (1LL << (i - 1))) << "-"
+				<< (1LL << i) << " us\t" << bins[i] << std::endl;
+	}
 }
 static void print_query(MknnDataset *query_dataset, int64_t i,
 		MknnDataset *descriptionQ, MknnPrinter *printerQ, std::ofstream &out) {
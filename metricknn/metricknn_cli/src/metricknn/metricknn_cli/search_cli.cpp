@@ -64,6 +64,13 @@ static void print_search_options(bool detailed) {
 				<< std::endl;
 		std::cout << "       Default: number of cores.\n" << std::endl;
 	}
+	std::cout << "    -statistics" << std::endl;
+	if (detailed) {
+		std::cout
+				<< "       Measures the time of each query and prints percentiles and a histogram of search times."
+				<< std::endl;
+		std::cout << "       Default: disabled.\n" << std::endl;
+	}
 }
 static void print_output_options(bool detailed) {
 	std::cout << "    -file_output [filename]" << std::endl;
@@ -170,13 +177,15 @@ static bool parse_index_opt(OptionsIndex &opt_index,
 static bool parse_search_opt(OptionsSearch &opt_search,
 		std::vector<std::string> &args, unsigned int &i) {
 	if (my::collection::is_next_arg_equal("-knn", args, i)) {
-		opt_search.knn = my::collection::next_arg_int(args, i);
+		opt_search.knn = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-range", args, i)) {
-		opt_search.range = my::collection::next_arg_double(args, i);
+		opt_search.range = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-search", args, i)) {
 		opt_search.string_search = my::collection::next_arg(args, i);
 	} else if (my::collection::is_next_arg_equal("-maxThreads", args, i)) {
-		opt_search.max_threads = my::collection::next_arg_int(args, i);
+		opt_search.max_threads = my::collection::next_arg(args, i);
+	} else if (my::collection::is_next_arg_equal("-statistics", args, i)) {
+		opt_search.statistics = "yes";
 	} else {
 		return false;
 	}
@@ -12,7 +12,8 @@
 
 void print_datatypes(std::string pref) {
 	std::cout << pref << "Valid datatypes are:" << std::endl;
-	std::cout << pref << "  Floating point types: FLOAT, DOUBLE" << std::endl;
+	std::cout << pref << "  Floating point types: FLOAT, DOUBLE, FLOAT16, BFLOAT16"
+			<< std::endl;
 	std::cout << pref << "  Integer signed types: INT8, INT16, INT32, INT64"
 			<< std::endl;
 	std::cout << pref
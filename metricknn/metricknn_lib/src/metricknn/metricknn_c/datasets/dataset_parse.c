@@ -18,42 +18,55 @@ MknnDataset *mknn_datasetLoader_ParseVectorFile(const char *filename,
 	MyLineReader *reader = my_lreader_open(my_io_openFileRead1(filename, 1));
 	my_log_info_time("reading %s\n", filename);
 	int64_t num_vectors = 0, num_dimensions = 0, num_lines = 0;
+	int64_t buffer_vectors = 0;
 	char *data_bytes = NULL;
+	//objects of each line are allocated in the arena, which is cleared by line
+	MyArena *arena = my_arena_new(0);
 	const char *line;
 	while ((line = my_lreader_readLineOrComment(reader)) != NULL) {
 		num_lines++;
 		if (line[0] == '\0' || line[0] == '#')
 			continue;
-		MyVectorDouble *vector = my_vectorDouble_new();
-		MyTokenizer *tk = my_tokenizer_new(line, ' ');
+		my_arena_clear(arena);
+		MyTokenizer *tk = my_tokenizer_newArena(line, ' ', arena);
 		my_tokenizer_addDelimiter(tk, '\t');
 		my_tokenizer_setJoinMultipleDelimiters(tk);
-		while (my_tokenizer_hasNext(tk)) {
-			const char *token = my_tokenizer_nextToken(tk);
-			if (strlen(token) > 0) {
-				my_vectorDouble_add(vector, my_parse_double(token));
+		int64_t size = 0, buffer_size = MAX(num_dimensions, 16);
+		double *vector = MY_ARENA_MALLOC_NOINIT(arena, buffer_size, double);
+		const char *token;
+		while ((token = my_tokenizer_nextToken(tk)) != NULL) {
+			if (token[0] == '\0')
+				continue;
+			if (size == buffer_size) {
+				MY_ARENA_REALLOC(arena, vector, buffer_size, 2 * buffer_size,
+						double);
+				buffer_size *= 2;
 			}
+			vector[size++] = my_parse_double(token);
 		}
-		my_tokenizer_release(tk);
-		if (my_vectorDouble_size(vector) == 0) {
-			my_vectorDouble_release(vector);
+		if (size == 0)
 			continue;
-		}
 		if (num_dimensions == 0) {
-			num_dimensions = my_vectorDouble_size(vector);
-		} else if (num_dimensions != my_vectorDouble_size(vector)) {
+			num_dimensions = size;
+		} else if (num_dimensions != size) {
 			my_log_error(
 					"Error at line %"PRIi64": different number of columns (%"PRIi64" != %"PRIi64")\n",
-					num_lines, my_vectorDouble_size(vector), num_dimensions);
+					num_lines, size, num_dimensions);
+		}
+		if (num_vectors == buffer_vectors) {
+			buffer_vectors = MAX(2 * buffer_vectors, 1024);
+			MY_REALLOC(data_bytes, buffer_vectors * num_dimensions * numBytesByDim,
+					char);
 		}
-		MY_REALLOC(data_bytes,
-				(num_vectors + 1) * num_dimensions * numBytesByDim, char);
 		char *current = data_bytes
 				+ num_vectors * num_dimensions * numBytesByDim;
-		func_copy(my_vectorDouble_array(vector), current, num_dimensions);
-		my_vectorDouble_release(vector);
+		func_copy(vector, current, num_dimensions);
 		num_vectors++;
 	}
+	my_arena_release(arena);
+	if (num_vectors > 0 && num_vectors < buffer_vectors)
+		MY_REALLOC(data_bytes, num_vectors * num_dimensions * numBytesByDim,
+				char);
 	my_lreader_close(reader, true);
 	MknnDataset *dataset = mknn_datasetLoader_PointerCompactVectors(
 			(void*) data_bytes, true, num_vectors, num_dimensions, datatype);
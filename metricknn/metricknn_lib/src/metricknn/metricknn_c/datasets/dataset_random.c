@@ -40,6 +40,17 @@ static void* get_random_float(int64_t size, double minValueIncluded,
 	free(buffer_double);
 	return array_float;
 }
+static void* get_random_float16(int64_t size, double minValueIncluded,
+		double maxValueNotIncluded, MknnDatatype datatype) {
+	float *array_float = get_random_float(size, minValueIncluded,
+			maxValueNotIncluded);
+	uint16_t *array_16 = MY_MALLOC_NOINIT(size, uint16_t);
+	my_function_copy_vector func_copy = my_datatype_getFunctionCopyVector(
+			MY_DATATYPE_FLOAT32, mknn_datatype_convertMknn2My(datatype));
+	func_copy(array_float, array_16, size);
+	free(array_float);
+	return array_16;
+}
 static void* get_random_genericInt(int64_t size, double minValueIncluded,
 		double maxValueNotIncluded, MknnDatatype datatype) {
 	size_t bytes_dim = mknn_datatype_sizeof(datatype);
@@ -68,6 +79,10 @@ static void* get_random_numbers(int64_t size, double minValueIncluded,
 		return get_random_double(size, minValueIncluded, maxValueNotIncluded);
 	} else if (mknn_datatype_isFloat(datatype)) {
 		return get_random_float(size, minValueIncluded, maxValueNotIncluded);
+	} else if (mknn_datatype_isFloat16(datatype)
+			|| mknn_datatype_isBFloat16(datatype)) {
+		return get_random_float16(size, minValueIncluded, maxValueNotIncluded,
+				datatype);
 	} else if (mknn_datatype_isInt64(datatype)) {
 		return get_random_int64(size, minValueIncluded, maxValueNotIncluded);
 	} else {
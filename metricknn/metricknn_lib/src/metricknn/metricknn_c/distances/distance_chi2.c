@@ -71,6 +71,7 @@ static struct MknnDistanceInstance chi2_dist_new(const char *id_dist,
 		MknnDistanceParams *params_distance) {
 	struct MknnDistanceInstance df = { 0 };
 	df.func_distanceEval_new = chi2_distanceEval_new;
+	df.widen_16bits = true;
 	return df;
 }
 
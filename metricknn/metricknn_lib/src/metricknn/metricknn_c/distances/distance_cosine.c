@@ -145,6 +145,7 @@ struct MknnDistanceInstance cosine_dist_new(const char *id_dist,
 	struct MknnDistanceInstance df = { 0 };
 	df.state_distance = state_dist;
 	df.func_distanceEval_new = cosine_distanceEval_new;
+	df.widen_16bits = true;
 	return df;
 }
 static void cosine_printHelp(const char *id_dist) {
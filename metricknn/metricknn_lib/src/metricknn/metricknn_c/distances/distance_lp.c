@@ -259,6 +259,7 @@ static struct MknnDistanceInstance LP_dist_new(const char *id_dist,
 	struct MknnDistanceInstance df = { 0 };
 	df.state_distance = state_dist;
 	df.func_distanceEval_new = LP_distanceEval_new;
+	df.widen_16bits = true;
 	return df;
 }
 static void LP_printHelp(const char *id_dist) {
@@ -135,8 +135,11 @@ void mknn_dataset_setCompactVectors(MknnDataset *dataset,
 }
 
 /* ************************************** */
+//vectors are passed to the statistics in chunks of this size
+#define STATS_CHUNK_SIZE 65536
+
 void mknn_dataset_computeStatsVectors(MknnDataset *dataset,
-		struct MyDataStatsCompute *stats) {
+		struct MyDataStatsCompute *stats, int64_t max_threads) {
 	MknnDomain *domain = mknn_dataset_getDomain(dataset);
 	my_assert_isTrue("is vector", mknn_domain_isGeneralDomainVector(domain));
 	int64_t numdim = mknn_domain_vector_getNumDimensions(domain);
@@ -144,25 +147,28 @@ void mknn_dataset_computeStatsVectors(MknnDataset *dataset,
 			my_math_computeStats_getNumDimensions(stats));
 	MyDatatype mytype = mknn_datatype_convertMknn2My(
 			mknn_domain_vector_getDimensionDataType(domain));
+	int64_t num_objects = mknn_dataset_getNumObjects(dataset);
 	MyProgress *lt = NULL;
-	if (mknn_dataset_getNumObjects(dataset) > 100000)
-		lt = my_progress_new("statistics", mknn_dataset_getNumObjects(dataset),
-				1);
-	my_math_computeStats_addSample funcAddSample =
-			my_math_computeStats_getAddSampleFunction(mytype);
-	for (int64_t i = 0; i < mknn_dataset_getNumObjects(dataset); ++i) {
-		if (lt != NULL && i % 10000 == 0)
-			my_progress_setN(lt, i);
-		void *vector = mknn_dataset_getObject(dataset, i);
-		funcAddSample(stats, vector);
+	if (num_objects > 100000)
+		lt = my_progress_new("statistics", num_objects, 1);
+	int64_t chunk_size = MIN(num_objects, STATS_CHUNK_SIZE);
+	void **chunk = MY_MALLOC_NOINIT(chunk_size, void*);
+	for (int64_t start = 0; start < num_objects; start += chunk_size) {
+		int64_t num_chunk = MIN(chunk_size, num_objects - start);
+		for (int64_t i = 0; i < num_chunk; ++i)
+			chunk[i] = mknn_dataset_getObject(dataset, start + i);
+		my_math_computeStats_addSamples(stats, num_chunk, chunk, mytype,
+				max_threads);
+		my_progress_setN(lt, start + num_chunk);
 	}
-	my_progress_setN(lt, mknn_dataset_getNumObjects(dataset));
+	free(chunk);
 	my_progress_release(lt);
 }
-struct MyDataStatsCompute *mknn_dataset_computeDataStats(MknnDataset *dataset) {
+struct MyDataStatsCompute *mknn_dataset_computeDataStats(MknnDataset *dataset,
+		int64_t max_threads) {
 	MknnDomain *domain = mknn_dataset_getDomain(dataset);
 	int64_t numdim = mknn_domain_vector_getNumDimensions(domain);
 	struct MyDataStatsCompute *stats = my_math_computeStats_new(numdim);
-	mknn_dataset_computeStatsVectors(dataset, stats);
+	mknn_dataset_computeStatsVectors(dataset, stats, max_threads);
 	return stats;
 }
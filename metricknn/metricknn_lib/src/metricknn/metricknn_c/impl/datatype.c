@@ -85,8 +85,10 @@ bool mknn_generalDomain_parseString(const char *string,
 #define UN32 117
 #define UN64 118
 
+#define FL16 119
 #define FL32 120
 #define FL64 121
+#define BF16 122
 
 MknnDatatype MKNN_DATATYPE_SIGNED_INTEGER_8bits = { IN08 };
 MknnDatatype MKNN_DATATYPE_SIGNED_INTEGER_16bits = { IN16 };
@@ -100,6 +102,8 @@ MknnDatatype MKNN_DATATYPE_UNSIGNED_INTEGER_64bits = { UN64 };
 
 MknnDatatype MKNN_DATATYPE_FLOATING_POINT_32bits = { FL32 };
 MknnDatatype MKNN_DATATYPE_FLOATING_POINT_64bits = { FL64 };
+MknnDatatype MKNN_DATATYPE_FLOATING_POINT_16bits = { FL16 };
+MknnDatatype MKNN_DATATYPE_BRAIN_FLOATING_POINT_16bits = { BF16 };
 
 const char *STRING_DATATYPE_SIGNED_INTEGER_8bits = "INT8";
 const char *STRING_DATATYPE_SIGNED_INTEGER_16bits = "INT16";
@@ -113,6 +117,8 @@ const char *STRING_DATATYPE_UNSIGNED_INTEGER_64bits = "UINT64";
 
 const char *STRING_DATATYPE_FLOATING_POINT_32bits = "FLOAT";
 const char *STRING_DATATYPE_FLOATING_POINT_64bits = "DOUBLE";
+const char *STRING_DATATYPE_FLOATING_POINT_16bits = "FLOAT16";
+const char *STRING_DATATYPE_BRAIN_FLOATING_POINT_16bits = "BFLOAT16";
 
 const char *mknn_datatype_toString(const MknnDatatype datatype) {
 	switch (datatype.mknn_datatype_code) {
@@ -136,6 +142,10 @@ const char *mknn_datatype_toString(const MknnDatatype datatype) {
 		return STRING_DATATYPE_FLOATING_POINT_32bits;
 	case FL64:
 		return STRING_DATATYPE_FLOATING_POINT_64bits;
+	case FL16:
+		return STRING_DATATYPE_FLOATING_POINT_16bits;
+	case BF16:
+		return STRING_DATATYPE_BRAIN_FLOATING_POINT_16bits;
 	default:
 		return "UNKNOWN";
 	}
@@ -172,6 +182,12 @@ bool mknn_datatype_parseString(const char *string, MknnDatatype *out_datatype) {
 	ASSIGN_RETURN_IF_EQUAL_STR(string, *out_datatype,
 			STRING_DATATYPE_FLOATING_POINT_64bits,
 			MKNN_DATATYPE_FLOATING_POINT_64bits)
+	ASSIGN_RETURN_IF_EQUAL_STR(string, *out_datatype,
+			STRING_DATATYPE_FLOATING_POINT_16bits,
+			MKNN_DATATYPE_FLOATING_POINT_16bits)
+	ASSIGN_RETURN_IF_EQUAL_STR(string, *out_datatype,
+			STRING_DATATYPE_BRAIN_FLOATING_POINT_16bits,
+			MKNN_DATATYPE_BRAIN_FLOATING_POINT_16bits)
 	return false;
 }
 bool mknn_datatype_isAnySignedInteger(const MknnDatatype datatype) {
@@ -200,6 +216,8 @@ bool mknn_datatype_isAnyUnsignedInteger(const MknnDatatype datatype) {
 
 bool mknn_datatype_isAnyFloatingPoint(const MknnDatatype datatype) {
 	switch (datatype.mknn_datatype_code) {
+	case FL16:
+	case BF16:
 	case FL32:
 	case FL64:
 		return true;
@@ -237,6 +255,12 @@ bool mknn_datatype_isFloat(const MknnDatatype datatype) {
 bool mknn_datatype_isDouble(const MknnDatatype datatype) {
 	return datatype.mknn_datatype_code == FL64;
 }
+bool mknn_datatype_isFloat16(const MknnDatatype datatype) {
+	return datatype.mknn_datatype_code == FL16;
+}
+bool mknn_datatype_isBFloat16(const MknnDatatype datatype) {
+	return datatype.mknn_datatype_code == BF16;
+}
 bool mknn_datatype_areEqual(const MknnDatatype datatype1, const MknnDatatype datatype2) {
 	return datatype1.mknn_datatype_code == datatype2.mknn_datatype_code;
 }
@@ -248,6 +272,8 @@ size_t mknn_datatype_sizeof(const MknnDatatype datatype) {
 		return 1;
 	case IN16:
 	case UN16:
+	case FL16:
+	case BF16:
 		return 2;
 	case IN32:
 	case UN32:
@@ -286,6 +312,10 @@ MknnDatatype mknn_datatype_convertMy2Mknn(const MyDatatype my_datatype) {
 			MKNN_DATATYPE_FLOATING_POINT_32bits)
 	RETURN_IF_EQ_MY(my_datatype, MY_DATATYPE_FLOAT64,
 			MKNN_DATATYPE_FLOATING_POINT_64bits)
+	RETURN_IF_EQ_MY(my_datatype, MY_DATATYPE_FLOAT16,
+			MKNN_DATATYPE_FLOATING_POINT_16bits)
+	RETURN_IF_EQ_MY(my_datatype, MY_DATATYPE_BFLOAT16,
+			MKNN_DATATYPE_BRAIN_FLOATING_POINT_16bits)
 	my_log_error("unknown my_datatype %i\n",
 			(int) my_datatype.my_datatype_code);
 	MknnDatatype d = { 0 };
@@ -313,6 +343,10 @@ MyDatatype mknn_datatype_convertMknn2My(const MknnDatatype mknn_datatype) {
 		return MY_DATATYPE_FLOAT32;
 	case FL64:
 		return MY_DATATYPE_FLOAT64;
+	case FL16:
+		return MY_DATATYPE_FLOAT16;
+	case BF16:
+		return MY_DATATYPE_BFLOAT16;
 	}
 	my_log_error("unknown mknn_datatype %i\n",
 			(int) mknn_datatype.mknn_datatype_code);
@@ -232,6 +232,12 @@ const char *mknn_distance_getIdPredefinedDistance(MknnDistance *distance) {
 		return NULL;
 	return distance->predef.def->id_dist;
 }
+mknn_function_distanceEval_eval mknn_distance_getCustomFunctionEval(
+		MknnDistance *distance) {
+	if (distance == NULL || !distance->is_custom)
+		return NULL;
+	return distance->custom.func_eval;
+}
 MknnDistanceParams *mknn_distance_getParameters(MknnDistance *distance) {
 	if (distance == NULL || !distance->is_predef)
 		return NULL;
@@ -253,6 +259,94 @@ static void validate_domain(MknnDistance *distance, MknnDomain *domain) {
 		my_log_error("distance %s does not support domain %s\n",
 				distance->predef.def->id_dist, mknn_generalDomain_toString(gd));
 }
+//FLOAT16 and BFLOAT16 vectors are widened to float in batches into buffers
+//of the evaluation, then the distance computes with float vectors.
+//The last widened object is kept. A new object is written into the other
+//buffer, then it never has the address of the previous object (COSINE caches
+//the norm of the last address).
+struct Widen16_Side {
+	void (*func_widen)(const uint16_t *src, float *dst, int64_t length);
+	MknnDomain *domain_float;
+	int64_t num_dimensions;
+	float *buffers[2];
+	int64_t current;
+	void *last_object;
+};
+struct Widen16_Eval {
+	struct MknnDistEvalInstance instance;
+	struct Widen16_Side left, right;
+};
+static MknnDomain *widen16_initSide(struct Widen16_Side *side,
+		MknnDomain *domain) {
+	if (!mknn_domain_isGeneralDomainVector(domain))
+		return domain;
+	MknnDatatype datatype = mknn_domain_vector_getDimensionDataType(domain);
+	if (mknn_datatype_isFloat16(datatype))
+		side->func_widen = my_math_halfToFloatArray;
+	else if (mknn_datatype_isBFloat16(datatype))
+		side->func_widen = my_math_bfloat16ToFloatArray;
+	else
+		return domain;
+	side->num_dimensions = mknn_domain_vector_getNumDimensions(domain);
+	side->domain_float = mknn_domain_newVector(side->num_dimensions,
+			MKNN_DATATYPE_FLOATING_POINT_32bits);
+	side->buffers[0] = MY_MALLOC(side->num_dimensions, float);
+	side->buffers[1] = MY_MALLOC(side->num_dimensions, float);
+	return side->domain_float;
+}
+static void widen16_releaseSide(struct Widen16_Side *side) {
+	if (side->func_widen == NULL)
+		return;
+	mknn_domain_release(side->domain_float);
+	MY_FREE_MULTI(side->buffers[0], side->buffers[1]);
+}
+static inline void *widen16_object(struct Widen16_Side *side, void *object) {
+	if (side->func_widen == NULL)
+		return object;
+	if (object != side->last_object) {
+		side->current = 1 - side->current;
+		side->func_widen(object, side->buffers[side->current],
+				side->num_dimensions);
+		side->last_object = object;
+	}
+	return side->buffers[side->current];
+}
+static double widen16_eval(void *state_distEval, void *object_left,
+		void *object_right, double current_threshold) {
+	struct Widen16_Eval *state = state_distEval;
+	return state->instance.func_distanceEval_eval(state->instance.state_distEval,
+			widen16_object(&state->left, object_left),
+			widen16_object(&state->right, object_right),
+			current_threshold);
+}
+static void widen16_release(void *state_distEval) {
+	struct Widen16_Eval *state = state_distEval;
+	if (state->instance.func_distanceEval_release != NULL)
+		state->instance.func_distanceEval_release(
+				state->instance.state_distEval);
+	widen16_releaseSide(&state->left);
+	widen16_releaseSide(&state->right);
+	MY_FREE(state);
+}
+static struct MknnDistEvalInstance widen16_distanceEval_new(
+		struct MknnDistanceInstance *distance_instance, MknnDomain *domain_left,
+		MknnDomain *domain_right) {
+	struct Widen16_Eval *state = MY_MALLOC(1, struct Widen16_Eval);
+	MknnDomain *left = widen16_initSide(&state->left, domain_left);
+	MknnDomain *right = widen16_initSide(&state->right, domain_right);
+	state->instance = distance_instance->func_distanceEval_new(
+			distance_instance->state_distance, left, right);
+	if (state->left.func_widen == NULL && state->right.func_widen == NULL) {
+		struct MknnDistEvalInstance instance = state->instance;
+		MY_FREE(state);
+		return instance;
+	}
+	struct MknnDistEvalInstance di = { 0 };
+	di.state_distEval = state;
+	di.func_distanceEval_eval = widen16_eval;
+	di.func_distanceEval_release = widen16_release;
+	return di;
+}
 MknnDistanceEval *mknn_distance_newDistanceEval(MknnDistance *distance,
 		MknnDomain *domain_left, MknnDomain *domain_right) {
 	if (distance->is_predef) {
@@ -265,10 +359,14 @@ MknnDistanceEval *mknn_distance_newDistanceEval(MknnDistance *distance,
 	distance_eval->domain_right = domain_right;
 	if (distance->is_predef) {
 		struct MknnDistEvalInstance instance =
-				distance->predef.instance.func_distanceEval_new(
-						distance->predef.instance.state_distance,
-						distance_eval->domain_left,
-						distance_eval->domain_right);
+				distance->predef.instance.widen_16bits ?
+						widen16_distanceEval_new(&distance->predef.instance,
+								distance_eval->domain_left,
+								distance_eval->domain_right) :
+						distance->predef.instance.func_distanceEval_new(
+								distance->predef.instance.state_distance,
+								distance_eval->domain_left,
+								distance_eval->domain_right);
 		distance_eval->state_distEval = instance.state_distEval;
 		distance_eval->func_eval = instance.func_distanceEval_eval;
 		distance_eval->func_releaseState = instance.func_distanceEval_release;
@@ -48,6 +48,9 @@ struct MknnKmeansAlgorithm {
 	int64_t num_centroids;
 	struct EndParameters end;
 	int64_t max_threads;
+	//without a seed, random numbers come from the global generator
+	bool with_seed;
+	int64_t seed;
 	char *filenameAutoSaveState;
 	MknnDatatype default_centroids_datatype;
 	double secondsToPrintInfo;
@@ -513,6 +516,10 @@ static void printStartLog(MknnKmeansAlgorithm *kmeans) {
 		my_stringbuf_appendString(sbLog, " max_threads=");
 		my_stringbuf_appendInt(sbLog, kmeans->max_threads);
 	}
+	if (kmeans->with_seed) {
+		my_stringbuf_appendString(sbLog, " seed=");
+		my_stringbuf_appendInt(sbLog, kmeans->seed);
+	}
 	my_log_info_time(
 			"kmeans: computing %"PRIi64" centroids for %"PRIi64" vectors %"PRIi64"-d distance=%s%s\n",
 			kmeans->num_centroids, kmeans->num_vectors, kmeans->num_dimensions,
@@ -541,8 +548,22 @@ static void selectCentroids(MknnKmeansAlgorithm *kmeans, bool useSSS) {
 	//select
 	int64_t *sample = MY_MALLOC(kmeans->num_centroids, int64_t);
 	if (useSSS) {
+		int64_t seed =
+				kmeans->with_seed ? kmeans->seed : my_random_int(0, INT32_MAX);
 		mknn_laesa_select_pivots_sss(kmeans->dataset, kmeans->distance,
-				kmeans->num_centroids, 1, kmeans->max_threads, sample);
+				kmeans->num_centroids, 1, kmeans->max_threads, 0, seed,
+				sample);
+	} else if (kmeans->with_seed) {
+		int64_t full_size = mknn_dataset_getNumObjects(kmeans->dataset);
+		if (kmeans->num_centroids > full_size)
+			my_log_error(
+					"cannot select %"PRIi64" values between %"PRIi64" possible values\n",
+					kmeans->num_centroids, full_size);
+		MyRandom *rnd = my_random_newStream(kmeans->seed, 0);
+		int64_t *perm = my_random_nextPermutation(rnd, 0, full_size);
+		memcpy(sample, perm, kmeans->num_centroids * sizeof(int64_t));
+		MY_FREE(perm);
+		my_random_release(rnd);
 	} else {
 		int64_t full_size = mknn_dataset_getNumObjects(kmeans->dataset);
 		my_random_intList_noRepetitions(0, full_size, sample,
@@ -671,12 +692,29 @@ static void printIterationProgress(MknnKmeansAlgorithm *kmeans,
 			contMovedCenters, st2);
 	MY_FREE_MULTI(rateStr, globalIteration, st0, st1, st2);
 }
+static MknnDataset *newSubsetSample(MknnKmeansAlgorithm *kmeans_full,
+		int64_t sampleSize, int64_t num_subset) {
+	if (!kmeans_full->with_seed)
+		return mknn_datasetLoader_SubsetRandomSample(kmeans_full->dataset,
+				sampleSize, false);
+	//stream 0 selects the centroids
+	MyRandom *rnd = my_random_newStream(kmeans_full->seed, 1 + num_subset);
+	int64_t *positions = my_random_nextPermutation(rnd, 0,
+			kmeans_full->num_vectors);
+	my_random_release(rnd);
+	sampleSize = MIN(sampleSize, kmeans_full->num_vectors);
+	my_qsort_int_array(positions, sampleSize);
+	MknnDataset *subset = mknn_datasetLoader_SubsetPositions(
+			kmeans_full->dataset, positions, sampleSize, false);
+	MY_FREE(positions);
+	return subset;
+}
 static void performKmeansOnSubset(MknnKmeansAlgorithm *kmeans_full,
-		struct SubsetRun *subrun) {
+		struct SubsetRun *subrun, int64_t num_subset) {
 	int64_t sampleSize = my_math_getFractionSize(subrun->fractionSubsetSize,
 			kmeans_full->num_vectors);
-	MknnDataset *dataset_sample = mknn_datasetLoader_SubsetRandomSample(
-			kmeans_full->dataset, sampleSize, false);
+	MknnDataset *dataset_sample = newSubsetSample(kmeans_full, sampleSize,
+			num_subset);
 	MknnKmeansAlgorithm *subkmeans = mknn_kmeans_new();
 	mknn_kmeans_setDataset(subkmeans, dataset_sample);
 	mknn_kmeans_setDistance(subkmeans, kmeans_full->distance);
@@ -707,7 +745,7 @@ static void mknn_kmeans_runSubsets(MknnKmeansAlgorithm *kmeans) {
 		my_log_info_time("kmeans: SUBSET %"PRIi64"/%"PRIi64" (size=%s).\n",
 				i + 1, my_vectorObj_size(kmeans->subsetsRuns), st);
 		free(st);
-		performKmeansOnSubset(kmeans, subrun);
+		performKmeansOnSubset(kmeans, subrun, i);
 	}
 	my_log_info_time("kmeans: RUNS ON SUBSETS FINALIZED OK\n");
 }
@@ -792,6 +830,10 @@ int64_t mknn_kmeans_getNumCentroids(MknnKmeansAlgorithm *kmeans) {
 void mknn_kmeans_setMaxThreads(MknnKmeansAlgorithm *kmeans, int64_t max_threads) {
 	kmeans->max_threads = max_threads;
 }
+void mknn_kmeans_setSeed(MknnKmeansAlgorithm *kmeans, int64_t seed) {
+	kmeans->with_seed = true;
+	kmeans->seed = seed;
+}
 void mknn_kmeans_setTermitationCriteria(MknnKmeansAlgorithm *kmeans,
 		int64_t maxIteration, double maxSecondsProcess,
 		double pctOrNumberMinMovedVectors, double pctOrNumberMinMovedCentroids) {
@@ -352,3 +352,10 @@ void mknn_resolverParams_setMaxThreads(MknnResolverParams *p,
 int64_t mknn_resolverParams_getMaxThreads(MknnResolverParams *p) {
 	return mknn_resolverParams_getInt(p, "max_threads");
 }
+void mknn_resolverParams_setStatistics(MknnResolverParams *p,
+		bool statistics) {
+	mknn_resolverParams_addBool(p, "statistics", statistics);
+}
+bool mknn_resolverParams_getStatistics(MknnResolverParams *p) {
+	return mknn_resolverParams_getBool(p, "statistics");
+}
@@ -19,6 +19,7 @@ struct MknnPcaAlgorithm {
 	double *eigenvalues;
 	bool deleteStats_on_release;
 	struct MyDataStatsCompute *stats;
+	int64_t max_threads;
 };
 
 MknnPcaAlgorithm *mknn_pca_new() {
@@ -38,12 +39,16 @@ void mknn_pca_addDatasetToVectorStats(MknnPcaAlgorithm *pca, MknnDataset *datase
 	my_log_info_time("PCA: computing statistics in dataset, size %"PRIi64"\n",
 			mknn_dataset_getNumObjects(dataset));
 	if (pca->stats == NULL) {
-		pca->stats = mknn_dataset_computeDataStats(dataset);
+		pca->stats = mknn_dataset_computeDataStats(dataset, pca->max_threads);
 		pca->deleteStats_on_release = true;
 	} else {
-		mknn_dataset_computeStatsVectors(dataset, pca->stats);
+		mknn_dataset_computeStatsVectors(dataset, pca->stats,
+				pca->max_threads);
 	}
 }
+void mknn_pca_setMaxThreads(MknnPcaAlgorithm *pca, int64_t max_threads) {
+	pca->max_threads = max_threads;
+}
 void mknn_pca_setVectorStats(MknnPcaAlgorithm *pca,
 		struct MyDataStatsCompute *stats, bool deleteStats_on_release) {
 	pca->stats = stats;
@@ -60,16 +65,15 @@ void mknn_pca_computeTransformationMatrix(MknnPcaAlgorithm *pca) {
 		my_math_computeStats_getStats(pca->stats, i, &vals);
 		pca->avgs[i] = vals.average;
 	}
-	CvMat* covMat = cvCreateMat(pca->dimensions, pca->dimensions, CV_32FC1);
-	for (int64_t i = 0; i < pca->dimensions; i++) {
-		for (int64_t j = 0; j <= i; j++) {
-			double cov = my_math_computeStats_getCovariance(pca->stats, i, j);
-			cvSetReal2D(covMat, i, j, cov);
-			cvSetReal2D(covMat, j, i, cov);
-		}
-	}
-	CvMat* evects = cvCreateMat(pca->dimensions, pca->dimensions, CV_32FC1);
-	CvMat* evals = cvCreateMat(pca->dimensions, 1, CV_32FC1);
+	//the covariance is written directly into the rows of the matrix
+	CvMat* covMat = cvCreateMat(pca->dimensions, pca->dimensions, CV_64FC1);
+	double **covRows = MY_MALLOC_NOINIT(pca->dimensions, double*);
+	for (int64_t i = 0; i < pca->dimensions; i++)
+		covRows[i] = (double*) (covMat->data.ptr + i * covMat->step);
+	my_math_computeStats_fillCovarianceMatrix(pca->stats, covRows);
+	free(covRows);
+	CvMat* evects = cvCreateMat(pca->dimensions, pca->dimensions, CV_64FC1);
+	CvMat* evals = cvCreateMat(pca->dimensions, 1, CV_64FC1);
 	cvEigenVV(covMat, evects, evals, DBL_EPSILON, -1, -1);
 	struct Eigen *eigens = MY_MALLOC(pca->dimensions, struct Eigen);
 	for (int64_t i = 0; i < pca->dimensions; ++i) {
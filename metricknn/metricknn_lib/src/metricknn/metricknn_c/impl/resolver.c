@@ -46,7 +46,7 @@ bool free_query_dataset_on_release) {
 			resolver->resolverInstance.state_resolver, query_dataset);
 	mknn_result_setResolverQueryDataset(result, resolver, query_dataset,
 			free_resolver_on_release, free_query_dataset_on_release);
-	mknn_result_updateTotalDistanceEvaluations(result);
+	mknn_result_updateStatistics(result);
 	mknn_result_setTotalSearchTime(result, my_timer_getSeconds(search_timer));
 	my_timer_release(search_timer);
 	return result;
@@ -11,7 +11,7 @@
 struct MknnResult {
 	int64_t num_queries, num_nn_max;
 	double total_search_time;
-	int64_t total_distance_evaluations;
+	int64_t total_distance_evaluations, total_discarded_candidates;
 	MknnResultQuery *all_results;
 	int64_t *all_positions;
 	double *all_distances;
@@ -19,8 +19,14 @@ struct MknnResult {
 	MknnDataset *query_dataset;
 	bool free_resolver_on_release;
 	bool free_query_dataset_on_release;
+	//only when statistics are enabled
+	bool with_statistics;
+	double *sorted_search_times;
+	int64_t *histogram_search_times;
 };
 
+#define NUM_BINS_SEARCH_TIMES 32
+
 MknnResult *mknn_result_newEmpty(int64_t num_queries, int64_t num_nn_max) {
 	MknnResult *result = MY_MALLOC(1, MknnResult);
 	result->num_queries = num_queries;
@@ -65,6 +71,34 @@ MknnResultQuery *mknn_result_getResultQuery(MknnResult *result,
 		int64_t num_query) {
 	return result->all_results + num_query;
 }
+bool mknn_result_hasStatistics(MknnResult *result) {
+	if (result == NULL)
+		return false;
+	return result->with_statistics;
+}
+int64_t mknn_result_getTotalDiscardedCandidates(MknnResult *result) {
+	if (result == NULL)
+		return 0;
+	return result->total_discarded_candidates;
+}
+double mknn_result_getQuerySearchTimeQuantile(MknnResult *result,
+		double quantile) {
+	if (result == NULL || result->sorted_search_times == NULL
+			|| result->num_queries == 0)
+		return 0;
+	int64_t pos = my_math_round_int(quantile * (result->num_queries - 1));
+	pos = MAX(0, MIN(pos, result->num_queries - 1));
+	return result->sorted_search_times[pos];
+}
+const int64_t *mknn_result_getQuerySearchTimeHistogram(MknnResult *result,
+		int64_t *out_num_bins) {
+	if (result == NULL || result->histogram_search_times == NULL) {
+		*out_num_bins = 0;
+		return NULL;
+	}
+	*out_num_bins = NUM_BINS_SEARCH_TIMES;
+	return result->histogram_search_times;
+}
 #if 0
 static void mknn_result_saveOld(MknnResult *result, const char *filename_write) {
 	FILE *out = my_io_openFileWrite1(filename_write);
@@ -106,6 +140,8 @@ void mknn_result_release(MknnResult *result) {
 	free(result->all_results);
 	free(result->all_positions);
 	free(result->all_distances);
+	MY_FREE_MULTI(result->sorted_search_times,
+			result->histogram_search_times);
 	if (result->free_query_dataset_on_release)
 		mknn_dataset_release(result->query_dataset);
 	if (result->free_resolver_on_release)
@@ -113,12 +149,34 @@ void mknn_result_release(MknnResult *result) {
 	free(result);
 }
 
-void mknn_result_updateTotalDistanceEvaluations(MknnResult *result) {
+static int64_t priv_getBinSearchTime(double seconds) {
+	double micros = seconds * 1000000;
+	int64_t bin = 0;
+	while (micros >= 1 && bin < NUM_BINS_SEARCH_TIMES - 1) {
+		micros /= 2;
+		bin++;
+	}
+	return bin;
+}
+void mknn_result_updateStatistics(MknnResult *result) {
 	result->total_distance_evaluations = 0;
+	result->total_discarded_candidates = 0;
 	for (int64_t i = 0; i < result->num_queries; ++i) {
 		MknnResultQuery *res = mknn_result_getResultQuery(result, i);
 		result->total_distance_evaluations += res->num_distance_evaluations;
+		result->total_discarded_candidates += res->num_discarded_candidates;
 	}
+	if (!result->with_statistics)
+		return;
+	MY_REALLOC(result->sorted_search_times, result->num_queries, double);
+	MY_REALLOC(result->histogram_search_times, NUM_BINS_SEARCH_TIMES, int64_t);
+	MY_SETZERO(result->histogram_search_times, NUM_BINS_SEARCH_TIMES, int64_t);
+	for (int64_t i = 0; i < result->num_queries; ++i) {
+		double seconds = result->all_results[i].search_time;
+		result->sorted_search_times[i] = seconds;
+		result->histogram_search_times[priv_getBinSearchTime(seconds)]++;
+	}
+	my_qsort_double_array(result->sorted_search_times, result->num_queries);
 }
 void mknn_result_setTotalSearchTime(MknnResult *result,
 		double total_search_time) {
@@ -133,10 +191,21 @@ void mknn_result_setResolverQueryDataset(MknnResult *result,
 	result->free_resolver_on_release = free_resolver_on_release;
 	result->free_query_dataset_on_release = free_query_dataset_on_release;
 }
+void mknn_result_enableStatistics(MknnResult *result) {
+	result->with_statistics = true;
+}
+void mknn_result_startQuery(MknnResult *result, int64_t num_query) {
+	//the start time is kept in search_time until the query is stored
+	if (result->with_statistics)
+		result->all_results[num_query].search_time =
+				my_timer_getMonotonicSeconds();
+}
 void mknn_result_storeMatchesInResultQuery(MknnResult *result,
 		int64_t num_query, MknnHeap *heap, int64_t cont_evaluations) {
 	MknnResultQuery *res = mknn_result_getResultQuery(result, num_query);
 	res->num_distance_evaluations = cont_evaluations;
+	if (result->with_statistics)
+		res->search_time = my_timer_getMonotonicSeconds() - res->search_time;
 	int64_t heap_size = mknn_heap_getSize(heap);
 	res->num_nns = heap_size;
 	mknn_heap_sortElements(heap);
@@ -8,21 +8,21 @@
 
 #include "../metricknn_impl.h"
 
-static void sample_random_pairs(MknnDataset *dataset_src,
+static void sample_random_pairs(MyRandom *rnd, MknnDataset *dataset_src,
 		MknnDataset *dataset_dst, int64_t sample_size, int64_t *position_src,
 		int64_t *position_dst) {
 	int64_t size_src = mknn_dataset_getNumObjects(dataset_src);
 	int64_t size_dst = mknn_dataset_getNumObjects(dataset_dst);
-	my_random_intList(0, size_src, position_src, sample_size);
-	my_random_intList(0, size_dst, position_dst, sample_size);
+	my_random_nextIntList(rnd, 0, size_src, position_src, sample_size);
+	my_random_nextIntList(rnd, 0, size_dst, position_dst, sample_size);
 //When sampling pairs from the same dataset, a sample is
 //ignored when the objects are the same.
 //This avoids to over-sample distance "0"
 	if (dataset_src == dataset_dst) {
 		for (int64_t i = 0; i < sample_size; ++i) {
 			while (position_src[i] == position_dst[i]) {
-				position_src[i] = my_random_int(0, size_src);
-				position_dst[i] = my_random_int(0, size_dst);
+				position_src[i] = my_random_nextInt(rnd, 0, size_src);
+				position_dst[i] = my_random_nextInt(rnd, 0, size_dst);
 			}
 		}
 	}
@@ -34,6 +34,7 @@ struct P_HistParamThread {
 	MknnDataset *dataset_dst;
 	int64_t **local_buffer_positions_src, **local_buffer_positions_dst;
 	int64_t *sample_position_src, *sample_position_dst;
+	bool positions_sampled;
 	double *sample_distance;
 };
 static void priv_sampleDistances_thread(int64_t start_process,
@@ -49,8 +50,9 @@ static void priv_sampleDistances_thread(int64_t start_process,
 			(param->sample_position_dst == NULL) ?
 					param->local_buffer_positions_dst[current_thread] :
 					param->sample_position_dst + start_process;
-	sample_random_pairs(param->dataset_src, param->dataset_dst, length, pos_src,
-			pos_dst);
+	if (!param->positions_sampled)
+		sample_random_pairs(my_random_getThreadStream(), param->dataset_src,
+				param->dataset_dst, length, pos_src, pos_dst);
 	MknnDistanceEval *distance_eval = param->dist_evals[current_thread];
 	double *dist_buffer = param->sample_distance + start_process;
 	for (int64_t i = 0; i < length; ++i) {
@@ -93,6 +95,37 @@ void mknn_sample_distances_multithread(MknnDataset *dataset_src,
 		MY_FREE(param.local_buffer_positions_dst);
 }
 
+//the pairs are drawn from rnd before computing the distances, therefore the
+//sample does not depend on the number of threads.
+void mknn_sample_distances_stream(MknnDataset *dataset_src,
+		MknnDataset *dataset_dst, int64_t sample_size, MknnDistance *distance,
+		int64_t max_threads, MyRandom *rnd, double *out_distances,
+		int64_t *out_position_src, int64_t *out_position_dst) {
+	struct P_HistParamThread param = { 0 };
+	param.dataset_src = dataset_src;
+	param.dataset_dst = dataset_dst;
+	param.dist_evals = mknn_distance_createDistEvalArray(distance, max_threads,
+			mknn_dataset_getDomain(dataset_src),
+			mknn_dataset_getDomain(dataset_dst));
+	param.sample_position_src =
+			(out_position_src == NULL) ?
+					MY_MALLOC_NOINIT(sample_size, int64_t) : out_position_src;
+	param.sample_position_dst =
+			(out_position_dst == NULL) ?
+					MY_MALLOC_NOINIT(sample_size, int64_t) : out_position_dst;
+	sample_random_pairs(rnd, dataset_src, dataset_dst, sample_size,
+			param.sample_position_src, param.sample_position_dst);
+	param.positions_sampled = true;
+	param.sample_distance = out_distances;
+	my_parallel_buffered(sample_size, &param, priv_sampleDistances_thread,
+			"sample", max_threads, BUFFER_SIZE);
+	mknn_distanceEval_releaseArray(param.dist_evals, max_threads);
+	if (out_position_src == NULL)
+		MY_FREE(param.sample_position_src);
+	if (out_position_dst == NULL)
+		MY_FREE(param.sample_position_dst);
+}
+
 /*******************************/
 MknnHistogram *mknn_computeDistHistogram(MknnDataset *dataset,
 		int64_t num_samples, MknnDistance *distance, int64_t max_threads) {
@@ -338,6 +338,7 @@ static struct MknnIndexInstance flann_index_new(const char *id_index,
 /*********************************************************/
 struct Flann_Search {
 	int64_t knn;
+	bool with_statistics;
 	struct Flann_Index *state_index;
 	struct FLANNParameters params_search;
 };
@@ -351,14 +352,22 @@ static MknnResult *flann_resolver_search(void *state_resolver,
 		my_log_error(
 				"flann requires identical data types between index and query sets (%s!=%s)\n",
 				state->state_index->flanntype.type_name, qtype.type_name);
+	double start_time = my_timer_getMonotonicSeconds();
 	struct FlannNNResult fresult = libflann_find_nearest_neighbors(
 			state->state_index->fnn_index, qtype, vectors_query,
 			num_query_objects, state->knn, &state->params_search);
+	//flann resolves all the queries at once, each query gets the average time
+	double query_time = (my_timer_getMonotonicSeconds() - start_time)
+			/ MAX(1, num_query_objects);
 	MknnResult *result = mknn_result_newEmpty(num_query_objects, state->knn);
+	if (state->with_statistics)
+		mknn_result_enableStatistics(result);
 	int64_t pos = 0;
 	for (int64_t i = 0; i < num_query_objects; ++i) {
 		MknnResultQuery *res = mknn_result_getResultQuery(result, i);
 		res->num_distance_evaluations = 0;
+		if (state->with_statistics)
+			res->search_time = query_time;
 		res->num_nns = state->knn;
 		for (int64_t j = 0; j < state->knn; ++j) {
 			res->nn_distance[j] =
@@ -384,6 +393,7 @@ struct MknnResolverInstance flann_resolver_new(void *state_index,
 	state->knn = mknn_resolverParams_getKnn(params_resolver);
 	if (state->knn < 1)
 		state->knn = 1;
+	state->with_statistics = mknn_resolverParams_getStatistics(params_resolver);
 	state->state_index = state_index;
 	state->params_search = state->state_index->params_index;
 	int checks = 0;
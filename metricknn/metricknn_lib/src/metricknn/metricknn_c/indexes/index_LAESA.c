@@ -20,24 +20,46 @@ struct LAESA_Index {
 	int64_t *pivots_position;
 	void **pivots;
 	double **pivot_table;
+	//rows of pivot_table are stored contiguously
+	double *pivot_table_values;
+	//used while building the table
+	MknnDistanceEval **dist_evals;
 };
+//objects processed by a thread at a time
+#define BUFFER_TABLE_OBJECTS 1024
+//the objects of a buffer are compared against groups of pivots, so the
+//pivots of the group and the objects stay in cache
+#define BLOCK_TABLE_PIVOTS 16
+#define BLOCK_TABLE_OBJECTS 64
+
 static void laesa_index_buildPivotTable_thread(int64_t start_process,
 		int64_t end_process_notIncluded, void *state_object, MyProgress *lt,
 		int64_t current_thread) {
 	struct LAESA_Index *state = state_object;
-	MknnDistanceEval *distance_eval = mknn_distance_newDistanceEval(
-			state->distance, mknn_dataset_getDomain(state->search_dataset),
-			mknn_dataset_getDomain(state->search_dataset));
-	for (int64_t id_obj = start_process; id_obj < end_process_notIncluded;
-			++id_obj) {
-		void *obj = mknn_dataset_getObject(state->search_dataset, id_obj);
-		for (int64_t id_piv = 0; id_piv < state->num_pivots; ++id_piv) {
-			void *piv = state->pivots[id_piv];
-			double d = mknn_distanceEval_eval(distance_eval, piv, obj);
-			state->pivot_table[id_obj][id_piv] = d;
+	MknnDistanceEval *distance_eval = state->dist_evals[current_thread];
+	for (int64_t start_obj = start_process;
+			start_obj < end_process_notIncluded; start_obj +=
+			BLOCK_TABLE_OBJECTS) {
+		int64_t end_obj = MIN(start_obj + BLOCK_TABLE_OBJECTS,
+				end_process_notIncluded);
+		for (int64_t start_piv = 0; start_piv < state->num_pivots; start_piv +=
+		BLOCK_TABLE_PIVOTS) {
+			int64_t end_piv = MIN(start_piv + BLOCK_TABLE_PIVOTS,
+					state->num_pivots);
+			for (int64_t id_obj = start_obj; id_obj < end_obj; ++id_obj) {
+				void *obj = mknn_dataset_getObject(state->search_dataset,
+						id_obj);
+				double *row = state->pivot_table[id_obj];
+				for (int64_t id_piv = start_piv; id_piv < end_piv; ++id_piv) {
+					void *piv = state->pivots[id_piv];
+					row[id_piv] = mknn_distanceEval_eval(distance_eval, piv,
+							obj);
+				}
+			}
 		}
 	}
-	mknn_distanceEval_release(distance_eval);
+	if (lt != NULL)
+		my_progress_addN(lt, end_process_notIncluded - start_process);
 }
 static void laesa_index_buildPivotTable(struct LAESA_Index *state,
 		int64_t max_threads) {
@@ -50,10 +72,20 @@ static void laesa_index_buildPivotTable(struct LAESA_Index *state,
 	my_log_info(
 			"populating pivot table (%"PRIi64" objects, %"PRIi64" pivots, %"PRIi64" threads)...\n",
 			num_objects, state->num_pivots, max_threads);
-	state->pivot_table = MY_MALLOC_MATRIX(num_objects, state->num_pivots,
+	//not initialized, the pages are first written by the thread that fills them
+	state->pivot_table_values = MY_MALLOC_NOINIT(num_objects * state->num_pivots,
 			double);
+	state->pivot_table = MY_MALLOC_NOINIT(num_objects, double*);
+	for (int64_t i = 0; i < num_objects; ++i)
+		state->pivot_table[i] = state->pivot_table_values
+				+ i * state->num_pivots;
+	MknnDomain *domain = mknn_dataset_getDomain(state->search_dataset);
+	state->dist_evals = mknn_distance_createDistEvalArray(state->distance,
+			max_threads, domain, domain);
 	my_parallel_buffered(num_objects, state, laesa_index_buildPivotTable_thread,
-			"building pivot table", max_threads, 0);
+			"building pivot table", max_threads, BUFFER_TABLE_OBJECTS);
+	mknn_distanceEval_releaseArray(state->dist_evals, max_threads);
+	state->dist_evals = NULL;
 }
 static void laesa_index_save(void *state_index, const char *id_index,
 		MknnIndexParams *params_index, const char *filename_write) {
@@ -94,20 +126,27 @@ static void laesa_index_build(void *state_index, const char *id_index,
 	struct LAESA_Index *state = state_index;
 	int64_t num_sets_eval = mknn_indexParams_getInt(params_index, "sets_eval");
 	int64_t max_threads = mknn_indexParams_getInt(params_index, "max_threads");
+	int64_t num_samples = mknn_indexParams_getInt(params_index,
+			"distance_samples");
+	//without a seed, it is taken from the global random generator
+	int64_t seed =
+			(mknn_indexParams_getString(params_index, "seed") == NULL) ?
+					my_random_int(0, INT32_MAX) :
+					mknn_indexParams_getInt(params_index, "seed");
 	if (max_threads <= 0)
 		max_threads = my_parallel_getNumberOfCores();
 	if (num_sets_eval <= 0)
 		num_sets_eval = MAX(2, max_threads);
 	state->pivots_position = MY_MALLOC(state->num_pivots, int64_t);
 	mknn_laesa_select_pivots_sss(state->search_dataset, state->distance,
-			state->num_pivots, num_sets_eval, max_threads,
+			state->num_pivots, num_sets_eval, max_threads, num_samples, seed,
 			state->pivots_position);
 	laesa_index_buildPivotTable(state, max_threads);
 }
 static void laesa_index_release(void *state_index) {
 	struct LAESA_Index *state = state_index;
-	MY_FREE_MULTI(state->pivots_position, state->pivots);
-	MY_FREE_MATRIX(state->pivot_table, state->num_pivots);
+	MY_FREE_MULTI(state->pivots_position, state->pivots, state->pivot_table,
+			state->pivot_table_values);
 	MY_FREE(state);
 }
 
@@ -144,6 +183,7 @@ struct LAESA_Search {
 	int64_t knn;
 	double range;
 	int64_t max_threads;
+	bool with_statistics;
 	MknnDataset *query_dataset;
 	struct LAESA_Index *state_index;
 	struct MknnResult *result;
@@ -155,7 +195,7 @@ struct LAESA_Search {
 	double approx_pct;
 	int64_t approx_size;
 	double **dist_query_pivots;
-	int64_t *dist_evaluations;
+	int64_t *dist_evaluations, *num_discarded;
 	MknnHeap **heapsLBs;
 	//
 #ifndef NO_FLANN
@@ -252,6 +292,7 @@ static void laesa_resolveSearch_exact(void *query, struct LAESA_Search *state,
 	}
 	state->dist_evaluations[current_thread] += num_database_objects
 			- cont_discarded;
+	state->num_discarded[current_thread] = cont_discarded;
 }
 static void laesa_resolveSearch_onlyLB(void *query, struct LAESA_Search *state,
 		int64_t current_thread) {
@@ -266,6 +307,7 @@ static void laesa_resolveSearch_onlyLB(void *query, struct LAESA_Search *state,
 				state);
 		mknn_heap_storeBestDistances(maxLB, i, heapNNs, &rangeLowerBound);
 	}
+	state->num_discarded[current_thread] = num_database_objects;
 }
 static void laesa_resolveSearch_approx(void *query, struct LAESA_Search *state,
 		int64_t current_thread) {
@@ -300,6 +342,8 @@ static void laesa_resolveSearch_approx(void *query, struct LAESA_Search *state,
 		mknn_heap_storeBestDistances(dist, object_id, heapNNs, &rangeSearch);
 	}
 	state->dist_evaluations[current_thread] += length - cont_discarded_by_lb;
+	state->num_discarded[current_thread] = num_database_objects - length
+			+ cont_discarded_by_lb;
 }
 
 #ifndef NO_FLANN
@@ -328,6 +372,8 @@ static void laesa_resolveSearch_approxFlann(void *query,
 		mknn_heap_storeBestDistances(dist, j, heapNNs, &rangeSearch);
 	}
 	state->dist_evaluations[current_thread] += state->approx_size;
+	state->num_discarded[current_thread] = num_database_objects
+			- state->approx_size;
 }
 #endif
 static void laesa_computeDistQueryToPivots(void *query,
@@ -344,9 +390,11 @@ static void laesa_computeDistQueryToPivots(void *query,
 static void laesa_resolveSearch_query(int64_t current_process,
 		void *state_object, int64_t current_thread) {
 	struct LAESA_Search *state = state_object;
+	mknn_result_startQuery(state->result, current_process);
 	void *query = mknn_dataset_getObject(state->query_dataset, current_process);
 	laesa_computeDistQueryToPivots(query, state, current_thread);
 	state->dist_evaluations[current_thread] = 0;
+	state->num_discarded[current_thread] = 0;
 	if (state->method == METHOD_EXACT_SEARCH) {
 		laesa_resolveSearch_exact(query, state, current_thread);
 	} else if (state->method == METHOD_LB_ONLY) {
@@ -360,6 +408,9 @@ static void laesa_resolveSearch_query(int64_t current_process,
 	}
 #endif
 	state->dist_evaluations[current_thread] += state->state_index->num_pivots;
+	MknnResultQuery *res = mknn_result_getResultQuery(state->result,
+			current_process);
+	res->num_discarded_candidates = state->num_discarded[current_thread];
 	mknn_result_storeMatchesInResultQuery(state->result, current_process,
 			state->heapsNNs[current_thread],
 			state->dist_evaluations[current_thread]);
@@ -371,6 +422,8 @@ static MknnResult *laesa_resolver_search(void *state_resolver,
 	int64_t num_query_objects = mknn_dataset_getNumObjects(query_dataset);
 	state->query_dataset = query_dataset;
 	state->result = mknn_result_newEmpty(num_query_objects, state->knn);
+	if (state->with_statistics)
+		mknn_result_enableStatistics(state->result);
 	state->dist_evals = mknn_distance_createDistEvalArray(
 			state->state_index->distance, state->max_threads,
 			mknn_dataset_getDomain(query_dataset),
@@ -383,7 +436,7 @@ static MknnResult *laesa_resolver_search(void *state_resolver,
 
 static void laesa_resolver_release(void *state_resolver) {
 	struct LAESA_Search *state = state_resolver;
-	MY_FREE(state->dist_evaluations);
+	MY_FREE_MULTI(state->dist_evaluations, state->num_discarded);
 	MY_FREE_MATRIX(state->dist_query_pivots, state->max_threads);
 	mknn_heap_releaseMulti(state->heapsNNs, state->max_threads);
 	if (state->method == METHOD_APPROX_SEARCH) {
@@ -412,6 +465,7 @@ struct MknnResolverInstance laesa_resolver_new(void *state_index,
 	state->max_threads = mknn_resolverParams_getMaxThreads(params_resolver);
 	if (state->max_threads < 1)
 		state->max_threads = my_parallel_getNumberOfCores();
+	state->with_statistics = mknn_resolverParams_getStatistics(params_resolver);
 	state->numPivotsDiv4 = state->state_index->num_pivots / 4;
 	state->numPivotsMod4 = state->state_index->num_pivots % 4;
 	const char *name_method = mknn_resolverParams_getString(params_resolver,
@@ -438,6 +492,7 @@ struct MknnResolverInstance laesa_resolver_new(void *state_index,
 	state->approx_size = num_objects * state->approx_pct;
 	state->approx_size = MAX(state->approx_size, 1);
 	state->dist_evaluations = MY_MALLOC_NOINIT(state->max_threads, int64_t);
+	state->num_discarded = MY_MALLOC_NOINIT(state->max_threads, int64_t);
 	state->dist_query_pivots = MY_MALLOC_MATRIX(state->max_threads,
 			state->state_index->num_pivots, double);
 	state->heapsNNs = mknn_heap_newMultiMaxHeap(state->knn, state->max_threads);
@@ -478,7 +533,8 @@ struct MknnResolverInstance laesa_resolver_new(void *state_index,
 }
 
 void register_index_laesa() {
-	metricknn_register_index("LAESA", "num_pivots=[int],sets_eval=[int]",
+	metricknn_register_index("LAESA",
+			"num_pivots=[int],sets_eval=[int],max_threads=[int],distance_samples=[int],seed=[int]",
 			"method=[EXACT|APPROX|L1APPROXFLANN|LB_ONLY],approximation=[percentage]",
 			NULL, laesa_index_new, laesa_resolver_new);
 }
@@ -25,25 +25,36 @@ struct EvalSubset {
 	struct EvalPair *samples;
 };
 
+//candidates checked in parallel before scanning them in order, the batch
+//grows up to MAX_BATCH_CANDIDATES per thread
+#define MIN_BATCH_CANDIDATES 256
+#define MAX_BATCH_CANDIDATES 1024
+#define BUFFER_CANDIDATES 64
+#define BUFFER_EVAL_SAMPLES 1024
+
 struct P_EvaluarParamThread {
 	MknnDataset *dataset;
 	MknnDistanceEval **dist_evals;
 	MknnHistogram *hist_distObjs;
 	struct P_PivotSet **sets;
 	int64_t num_pivots;
-	struct P_Conjunto *conj;
-	double *evalActualDist;
+	int64_t max_threads;
 	double alpha;
 	int64_t triesCurrentAlpha;
 	struct EvalSubset *evset;
 	double ALPHA_START;
 	double ALPHA_REDUCTION_FACTOR;
 	double ALPHA_TRIES_BEFORE_REDUCTION;
-	pthread_mutex_t mutex;
+	//set being selected or evaluated
+	struct P_PivotSet *current_set;
+	int64_t *candidates;
+	bool *candidates_eligible;
+	double *eval_lbs, *eval_diffs;
+	int64_t *eval_id_piv_lb;
 };
 static bool is_eligible_pivot(void *object, MyVectorObj *pivots_obj,
-		MknnDataset *dataset, MknnDistanceEval *distance, double dist_threshold) {
-	for (int64_t i = 0; i < my_vectorObj_size(pivots_obj); ++i) {
+		int64_t first_pivot, MknnDistanceEval *distance, double dist_threshold) {
+	for (int64_t i = first_pivot; i < my_vectorObj_size(pivots_obj); ++i) {
 		void *piv = my_vectorObj_get(pivots_obj, i);
 		double d = mknn_distanceEval_eval(distance, object, piv);
 		if (d <= dist_threshold)
@@ -51,27 +62,66 @@ static bool is_eligible_pivot(void *object, MyVectorObj *pivots_obj,
 	}
 	return true;
 }
-static void selectPivotsUsingSSS(struct P_PivotSet *set, MknnDataset *dataset,
-		int64_t num_pivots, MknnDistanceEval *distance) {
-	int64_t num_objects = mknn_dataset_getNumObjects(dataset);
-	int64_t *ids = my_random_newPermutation(0, num_objects);
-	for (int64_t i = 0; i < num_objects; ++i) {
-		int64_t pos = ids[i];
-		void *object = mknn_dataset_getObject(dataset, pos);
-		if (is_eligible_pivot(object, set->pivots_obj, dataset, distance,
-				set->dist_threshold)) {
-			my_vectorObj_add(set->pivots_obj, object);
-			my_vectorInt_add(set->pivots_pos, pos);
-			if (my_vectorObj_size(set->pivots_obj) >= num_pivots)
-				break;
+static void check_candidates_thread(int64_t start_process,
+		int64_t end_process_notIncluded, void *state_object, MyProgress *lt,
+		int64_t current_thread) {
+	struct P_EvaluarParamThread *param = state_object;
+	struct P_PivotSet *set = param->current_set;
+	MknnDistanceEval *distance = param->dist_evals[current_thread];
+	for (int64_t i = start_process; i < end_process_notIncluded; ++i) {
+		void *object = mknn_dataset_getObject(param->dataset,
+				param->candidates[i]);
+		param->candidates_eligible[i] = is_eligible_pivot(object,
+				set->pivots_obj, 0, distance, set->dist_threshold);
+	}
+}
+//Candidates are checked in batches. The threads compare each candidate with
+//the pivots selected before the batch, then the batch is scanned in order
+//comparing the remaining candidates with the pivots added during the batch.
+//The result is the same as checking the candidates one by one, which is
+//what a single thread does.
+static void selectPivotsUsingSSS(struct P_EvaluarParamThread *param,
+		struct P_PivotSet *set, MyRandom *rnd) {
+	int64_t num_objects = mknn_dataset_getNumObjects(param->dataset);
+	int64_t *ids = my_random_nextPermutation(rnd, 0, num_objects);
+	MknnDistanceEval *distance = param->dist_evals[0];
+	bool parallel = (param->max_threads > 1);
+	param->current_set = set;
+	int64_t batch_size = parallel ? MIN_BATCH_CANDIDATES : num_objects;
+	int64_t max_batch_size = MAX_BATCH_CANDIDATES * param->max_threads;
+	int64_t start = 0;
+	while (start < num_objects
+			&& my_vectorObj_size(set->pivots_obj) < param->num_pivots) {
+		int64_t length = MIN(batch_size, num_objects - start);
+		int64_t num_previous = 0;
+		if (parallel) {
+			num_previous = my_vectorObj_size(set->pivots_obj);
+			param->candidates = ids + start;
+			my_parallel_buffered(length, param, check_candidates_thread, NULL,
+					param->max_threads, BUFFER_CANDIDATES);
 		}
+		for (int64_t i = 0; i < length; ++i) {
+			if (parallel && !param->candidates_eligible[i])
+				continue;
+			int64_t pos = ids[start + i];
+			void *object = mknn_dataset_getObject(param->dataset, pos);
+			if (is_eligible_pivot(object, set->pivots_obj, num_previous,
+					distance, set->dist_threshold)) {
+				my_vectorObj_add(set->pivots_obj, object);
+				my_vectorInt_add(set->pivots_pos, pos);
+				if (my_vectorObj_size(set->pivots_obj) >= param->num_pivots)
+					break;
+			}
+		}
+		start += length;
+		batch_size = MIN(2 * batch_size, max_batch_size);
 	}
+	param->candidates = NULL;
 	free(ids);
 }
 
 static double getCurrentAlpha(struct P_EvaluarParamThread *param,
 		double alphaLastTry, double *out_threshold) {
-	MY_MUTEX_LOCK(param->mutex);
 	if (param->alpha == 0)
 		param->alpha = param->ALPHA_START;
 	if (alphaLastTry == param->alpha) {
@@ -88,15 +138,13 @@ static double getCurrentAlpha(struct P_EvaluarParamThread *param,
 			MY_FREE_MULTI(st1, st2);
 		}
 	}
-	double alpha = param->alpha;
 	*out_threshold = mknn_histogram_getValueQuantile(param->hist_distObjs,
-			alpha);
-	MY_MUTEX_UNLOCK(param->mutex);
-	return alpha;
+			param->alpha);
+	return param->alpha;
 }
 
 static struct P_PivotSet *generate_new_pivotset(
-		struct P_EvaluarParamThread *param, MknnDistanceEval *distance) {
+		struct P_EvaluarParamThread *param, MyRandom *rnd) {
 	double alpha = 0;
 	for (;;) {
 		double threshold = 0;
@@ -105,7 +153,7 @@ static struct P_PivotSet *generate_new_pivotset(
 		set->pivots_pos = my_vectorInt_new();
 		set->pivots_obj = my_vectorObj_new();
 		set->dist_threshold = threshold;
-		selectPivotsUsingSSS(set, param->dataset, param->num_pivots, distance);
+		selectPivotsUsingSSS(param, set, rnd);
 		if (my_vectorObj_size(set->pivots_obj) == param->num_pivots)
 			return set;
 		my_vectorInt_release(set->pivots_pos);
@@ -132,49 +180,58 @@ static double computeMaxLB(void *obj1, void *obj2, struct P_PivotSet *set,
 	*out_id_piv_lb = id_piv_lb;
 	return max_lb;
 }
-static void evaluatePivotSet(struct P_PivotSet *set, struct EvalSubset *evset,
-		MknnDistanceEval *distance) {
-	int64_t num_pivots = my_vectorObj_size(set->pivots_obj);
-	double *lbs = MY_MALLOC(evset->num_samples_eval, double);
-	double *diffs = MY_MALLOC(evset->num_samples_eval, double);
-	set->contLBPivot = MY_MALLOC(num_pivots, int64_t);
-	int64_t i;
-	for (i = 0; i < evset->num_samples_eval; ++i) {
+static void evaluate_samples_thread(int64_t start_process,
+		int64_t end_process_notIncluded, void *state_object, MyProgress *lt,
+		int64_t current_thread) {
+	struct P_EvaluarParamThread *param = state_object;
+	struct EvalSubset *evset = param->evset;
+	MknnDistanceEval *distance = param->dist_evals[current_thread];
+	for (int64_t i = start_process; i < end_process_notIncluded; ++i) {
 		void *obj1 = evset->samples[i].object1;
 		void *obj2 = evset->samples[i].object2;
 		double actual_dist = evset->samples[i].distance;
-		int64_t id_piv_lb = -1;
-		double max_lb = computeMaxLB(obj1, obj2, set, distance, &id_piv_lb);
-		set->contLBPivot[id_piv_lb]++;
-		lbs[i] = max_lb;
-		diffs[i] = actual_dist - max_lb;
+		double max_lb = computeMaxLB(obj1, obj2, param->current_set, distance,
+				param->eval_id_piv_lb + i);
+		param->eval_lbs[i] = max_lb;
+		param->eval_diffs[i] = actual_dist - max_lb;
 	}
-	set->stats_lbs = my_math_computeStats(evset->num_samples_eval, lbs);
-	set->stats_diffs = my_math_computeStats(evset->num_samples_eval, diffs);
-	free(lbs);
-	free(diffs);
 }
-static void process_pivotsets_thread(int64_t current_process,
-		void *state_object, int64_t current_thread) {
-	struct P_EvaluarParamThread *param = state_object;
-	MknnDistanceEval *distance_eval = param->dist_evals[current_thread];
-	struct P_PivotSet *set = generate_new_pivotset(param, distance_eval);
-	if (param->evset != NULL)
-		evaluatePivotSet(set, param->evset, distance_eval);
-	param->sets[current_process] = set;
+static void evaluatePivotSet(struct P_EvaluarParamThread *param,
+		struct P_PivotSet *set) {
+	struct EvalSubset *evset = param->evset;
+	int64_t num_pivots = my_vectorObj_size(set->pivots_obj);
+	param->current_set = set;
+	my_parallel_buffered(evset->num_samples_eval, param,
+			evaluate_samples_thread, NULL, param->max_threads,
+			BUFFER_EVAL_SAMPLES);
+	set->contLBPivot = MY_MALLOC(num_pivots, int64_t);
+	for (int64_t i = 0; i < evset->num_samples_eval; ++i)
+		set->contLBPivot[param->eval_id_piv_lb[i]]++;
+	set->stats_lbs = my_math_computeStats(evset->num_samples_eval,
+			param->eval_lbs);
+	set->stats_diffs = my_math_computeStats(evset->num_samples_eval,
+			param->eval_diffs);
 }
 static MknnHistogram *getHistogram(MknnDataset *dataset, MknnDistance *distance,
-		int64_t max_threads) {
-	int64_t num_objects = mknn_dataset_getNumObjects(dataset);
-	int64_t num_samples_hist = my_math_round_int(
-			log(num_objects) * num_objects / 100.0);
-	num_samples_hist = MAX(num_samples_hist, 100);
-	MknnHistogram *hist_distObjs = mknn_computeDistHistogram(dataset,
-			num_samples_hist, distance, max_threads);
+		int64_t num_samples_hist, int64_t max_threads, MyRandom *rnd) {
+	if (num_samples_hist <= 0) {
+		int64_t num_objects = mknn_dataset_getNumObjects(dataset);
+		num_samples_hist = my_math_round_int(
+				log(num_objects) * num_objects / 100.0);
+		num_samples_hist = MAX(num_samples_hist, 100);
+	}
+	my_log_info_time("computing histogram of distances (%"PRIi64" samples)\n",
+			num_samples_hist);
+	double *samples = MY_MALLOC(num_samples_hist, double);
+	mknn_sample_distances_stream(dataset, dataset, num_samples_hist, distance,
+			max_threads, rnd, samples, NULL, NULL);
+	MknnHistogram *hist_distObjs = mknn_histogram_new(num_samples_hist,
+			samples, 1000);
+	MY_FREE(samples);
 	return hist_distObjs;
 }
 static struct EvalSubset *getEvalSubset(MknnDataset *dataset,
-		MknnDistance *distance, int64_t max_threads) {
+		MknnDistance *distance, int64_t max_threads, MyRandom *rnd) {
 	int64_t num_objects = mknn_dataset_getNumObjects(dataset);
 	int64_t num_samples_eval = my_math_round_int(log(num_objects) * 10000);
 	num_samples_eval = MAX(num_samples_eval, 100);
@@ -183,8 +240,8 @@ static struct EvalSubset *getEvalSubset(MknnDataset *dataset,
 	int64_t *pos_src = MY_MALLOC(num_samples_eval, int64_t);
 	int64_t *pos_dst = MY_MALLOC(num_samples_eval, int64_t);
 	double *distances = MY_MALLOC(num_samples_eval, double);
-	mknn_sample_distances_multithread(dataset, dataset, num_samples_eval,
-			distance, max_threads, distances, pos_src, pos_dst);
+	mknn_sample_distances_stream(dataset, dataset, num_samples_eval, distance,
+			max_threads, rnd, distances, pos_src, pos_dst);
 	struct EvalSubset *evset = MY_MALLOC(1, struct EvalSubset);
 	evset->num_samples_eval = num_samples_eval;
 	evset->samples = MY_MALLOC(num_samples_eval, struct EvalPair);
@@ -193,25 +250,36 @@ static struct EvalSubset *getEvalSubset(MknnDataset *dataset,
 		evset->samples[i].object2 = mknn_dataset_getObject(dataset, pos_dst[i]);
 		evset->samples[i].distance = distances[i];
 	}
+	MY_FREE_MULTI(pos_src, pos_dst, distances);
 	return evset;
 }
 static void releaseEvalSubset(struct EvalSubset *evset) {
 	MY_FREE(evset->samples);
 	MY_FREE(evset);
 }
+//sets are selected one after the other and the threads share the work of
+//each set, thus the alpha reductions and the pivots depend only on the seed.
 static struct P_PivotSet** compute_sets(MknnDataset *dataset,
 		MknnDistance *distance, int64_t num_pivots, int64_t num_sets_eval,
-		int64_t max_threads, MknnHistogram *hist_distObjs,
+		int64_t max_threads, int64_t seed, MknnHistogram *hist_distObjs,
 		struct EvalSubset *evset) {
 	struct P_EvaluarParamThread param = { 0 };
 	param.dataset = dataset;
 	param.dist_evals = mknn_distance_createDistEvalArray(distance, max_threads,
 			mknn_dataset_getDomain(dataset), mknn_dataset_getDomain(dataset));
 	param.num_pivots = num_pivots;
+	param.max_threads = max_threads;
 	param.sets = MY_MALLOC(num_sets_eval, struct P_PivotSet*);
 	param.hist_distObjs = hist_distObjs;
 	param.evset = evset;
-	MY_MUTEX_INIT(param.mutex);
+	param.candidates_eligible = MY_MALLOC_NOINIT(
+			MAX_BATCH_CANDIDATES * max_threads, bool);
+	if (evset != NULL) {
+		param.eval_lbs = MY_MALLOC_NOINIT(evset->num_samples_eval, double);
+		param.eval_diffs = MY_MALLOC_NOINIT(evset->num_samples_eval, double);
+		param.eval_id_piv_lb = MY_MALLOC_NOINIT(evset->num_samples_eval,
+				int64_t);
+	}
 	if (num_pivots < 10) {
 		param.ALPHA_START = 0.999;
 		param.ALPHA_REDUCTION_FACTOR = 0.99;
@@ -231,9 +299,16 @@ static struct P_PivotSet** compute_sets(MknnDataset *dataset,
 	}
 	if (num_sets_eval > 1)
 		my_log_info_time("selecting %"PRIi64" sets\n", num_sets_eval);
-	my_parallel_incremental(num_sets_eval, &param, process_pivotsets_thread,
-	NULL, max_threads);
-	MY_MUTEX_DESTROY(param.mutex);
+	for (int64_t i = 0; i < num_sets_eval; ++i) {
+		//streams 0 and 1 are used by the samples of distances
+		MyRandom *rnd = my_random_newStream(seed, 2 + i);
+		param.sets[i] = generate_new_pivotset(&param, rnd);
+		if (evset != NULL)
+			evaluatePivotSet(&param, param.sets[i]);
+		my_random_release(rnd);
+	}
+	MY_FREE_MULTI(param.candidates_eligible, param.eval_lbs, param.eval_diffs,
+			param.eval_id_piv_lb);
 	mknn_distanceEval_releaseArray(param.dist_evals, max_threads);
 	return param.sets;
 }
@@ -271,6 +346,7 @@ static void releasePivotSet(struct P_PivotSet *set) {
 }
 void mknn_laesa_select_pivots_sss(MknnDataset *dataset, MknnDistance *distance,
 		int64_t num_pivots, int64_t num_sets_eval, int64_t max_threads,
+		int64_t num_samples_distances, int64_t seed,
 		int64_t *selected_positions) {
 	if (num_pivots <= 0)
 		num_pivots = 1;
@@ -279,14 +355,20 @@ void mknn_laesa_select_pivots_sss(MknnDataset *dataset, MknnDistance *distance,
 	if (max_threads <= 0)
 		max_threads = 1;
 	my_log_info(
-			"selecting %"PRIi64" sets of %"PRIi64" pivots using %"PRIi64" threads\n",
-			num_sets_eval, num_pivots, max_threads);
-	MknnHistogram *hist_distObjs = getHistogram(dataset, distance, max_threads);
+			"selecting %"PRIi64" sets of %"PRIi64" pivots using %"PRIi64" threads (seed=%"PRIi64")\n",
+			num_sets_eval, num_pivots, max_threads, seed);
+	MyRandom *rnd = my_random_newStream(seed, 0);
+	MknnHistogram *hist_distObjs = getHistogram(dataset, distance,
+			num_samples_distances, max_threads, rnd);
+	my_random_release(rnd);
 	struct EvalSubset *evset = NULL;
-	if (num_sets_eval > 1)
-		evset = getEvalSubset(dataset, distance, max_threads);
+	if (num_sets_eval > 1) {
+		rnd = my_random_newStream(seed, 1);
+		evset = getEvalSubset(dataset, distance, max_threads, rnd);
+		my_random_release(rnd);
+	}
 	struct P_PivotSet **sets = compute_sets(dataset, distance, num_pivots,
-			num_sets_eval, max_threads, hist_distObjs, evset);
+			num_sets_eval, max_threads, seed, hist_distObjs, evset);
 	mknn_histogram_release(hist_distObjs);
 	if (evset != NULL)
 		releaseEvalSubset(evset);
@@ -40,6 +40,7 @@ struct LinearScan_Search {
 	int64_t knn;
 	double range;
 	int64_t max_threads;
+	bool with_statistics;
 	struct LinearScan_Index *state_index;
 	MknnDistanceEval **dist_evals;
 	MknnHeap **heapsNNs;
@@ -50,6 +51,7 @@ struct LinearScan_Search {
 static void linearScan_resolveOneQuery(int64_t query_id,
 		MknnDataset *query_dataset, MknnDataset *search_dataset, double range,
 		MknnDistanceEval *distance_eval, MknnHeap *heapNNs, MknnResult *result) {
+	mknn_result_startQuery(result, query_id);
 	mknn_heap_reset(heapNNs);
 	void *query = mknn_dataset_getObject(query_dataset, query_id);
 	double rangeSearch = range;
@@ -91,6 +93,8 @@ static MknnResult *linearScan_resolver_search(void *state_resolver,
 	struct LinearScan_Search *state = state_resolver;
 	state->query_dataset = query_dataset;
 	state->result = mknn_result_newEmpty(num_query_objects, state->knn);
+	if (state->with_statistics)
+		mknn_result_enableStatistics(state->result);
 	state->dist_evals = mknn_distance_createDistEvalArray(
 			state->state_index->distance, state->max_threads,
 			mknn_dataset_getDomain(query_dataset),
@@ -123,6 +127,7 @@ struct MknnResolverInstance linearScan_resolver_new(void *state_index,
 	state->max_threads = mknn_resolverParams_getMaxThreads(params_resolver);
 	if (state->max_threads < 1)
 		state->max_threads = my_parallel_getNumberOfCores();
+	state->with_statistics = mknn_resolverParams_getStatistics(params_resolver);
 	const char *name_method = mknn_resolverParams_getString(params_resolver,
 			"method");
 	if (name_method == NULL
@@ -43,7 +43,7 @@ struct SnakeTable_SearchThread {
 	MknnDistanceEval *distEval_query2query;
 	MknnDistanceEval *distEval_query2ref;
 	MknnHeap *heapNNs;
-	int64_t dist_evaluations, max_query_objects;
+	int64_t dist_evaluations, num_discarded, max_query_objects;
 	struct RecordSnakeTable **pivot_table;
 	void **dynamic_pivots;
 	void **all_pivots;
@@ -66,6 +66,7 @@ struct SnakeTable_Search {
 	struct SnakeTable_Index *index;
 	int64_t maxDynPivots, knn, num_objects, max_threads;
 	double range;
+	bool with_statistics;
 	MknnDataset *query_dataset_full;
 	MknnResult *result;
 	struct SnakeTable_SearchThread *search_threads;
@@ -138,8 +139,10 @@ static void snakeV1_resolve_search(void *query, int64_t querySID,
 	for (int64_t objSID = 0; objSID < st->state->num_objects; ++objSID) {
 		void *object = mknn_dataset_getObject(st->state->index->search_dataset,
 				objSID);
-		if (snakeV1_tryToDiscard(objSID, rangeSearch, st))
+		if (snakeV1_tryToDiscard(objSID, rangeSearch, st)) {
+			st->num_discarded++;
 			continue;
+		}
 		//not discarded
 		double distance = computeActualDistance(query, object, objSID,
 				&rangeSearch, st);
@@ -212,8 +215,10 @@ static void snakeV2_resolve_search(void *query, int64_t querySID,
 				objSID);
 		int64_t pos_new_pivot = 0;
 		if (snakeV2_tryToDiscard(query, objSID, rangeSearch, &pos_new_pivot,
-				st))
+				st)) {
+			st->num_discarded++;
 			continue;
+		}
 		//not discarded
 		double distance = computeActualDistance(query, obj, objSID,
 				&rangeSearch, st);
@@ -293,8 +298,10 @@ static void snakeV3_resolve_search(void *query, int64_t querySID,
 	for (int64_t objSID = 0; objSID < st->state->num_objects; ++objSID) {
 		void *obj = mknn_dataset_getObject(st->state->index->search_dataset,
 				objSID);
-		if (snakeV3_tryToDiscard(query, objSID, rangeSearch, st))
+		if (snakeV3_tryToDiscard(query, objSID, rangeSearch, st)) {
+			st->num_discarded++;
 			continue;
+		}
 		//not discarded
 		double distance = computeActualDistance(query, obj, objSID,
 				&rangeSearch, st);
@@ -324,11 +331,15 @@ static void snaketable_resolver_query(int64_t start_process,
 	st->max_query_objects = mknn_dataset_getNumObjects(query_dataset);
 	state->func_start_searches(st);
 	for (int64_t i = 0; i < st->max_query_objects; ++i) {
+		mknn_result_startQuery(state->result, start_process + i);
 		mknn_heap_reset(st->heapNNs);
-		st->dist_evaluations = 0;
+		st->dist_evaluations = st->num_discarded = 0;
 		void *query = mknn_dataset_getObject(query_dataset, i);
 		int64_t querySID = i;
 		state->func_resolve_search(query, querySID, st);
+		MknnResultQuery *res = mknn_result_getResultQuery(state->result,
+				start_process + i);
+		res->num_discarded_candidates = st->num_discarded;
 		mknn_result_storeMatchesInResultQuery(state->result, start_process + i,
 				st->heapNNs, st->dist_evaluations);
 		if (lt != NULL)
@@ -345,6 +356,8 @@ static MknnResult *snaketable_resolver_search(void *state_resolver,
 	int64_t num_query_objects = mknn_dataset_getNumObjects(query_dataset);
 	state->query_dataset_full = query_dataset;
 	state->result = mknn_result_newEmpty(num_query_objects, state->knn);
+	if (state->with_statistics)
+		mknn_result_enableStatistics(state->result);
 	my_parallel_buffered(num_query_objects, state, snaketable_resolver_query,
 			"snake table", state->max_threads, 0);
 	return state->result;
@@ -378,6 +391,7 @@ static struct MknnResolverInstance snaketable_resolver_new(void *state_index,
 	state->max_threads = mknn_resolverParams_getMaxThreads(params_resolver);
 	if (state->max_threads < 1)
 		state->max_threads = my_parallel_getNumberOfCores();
+	state->with_statistics = mknn_resolverParams_getStatistics(params_resolver);
 	state->maxDynPivots = mknn_resolverParams_getInt(params_resolver,
 			"num_pivots");
 	if (state->maxDynPivots < 1)
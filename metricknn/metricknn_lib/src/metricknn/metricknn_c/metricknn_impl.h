@@ -33,9 +33,10 @@ void mknn_dataset_setCompactVectors(MknnDataset *dataset,
 		void *compactVectors_pointer, bool free_compactVectors_on_release);
 
 void mknn_dataset_computeStatsVectors(MknnDataset *dataset,
-		struct MyDataStatsCompute *stats);
+		struct MyDataStatsCompute *stats, int64_t max_threads);
 
-struct MyDataStatsCompute *mknn_dataset_computeDataStats(MknnDataset *dataset);
+struct MyDataStatsCompute *mknn_dataset_computeDataStats(MknnDataset *dataset,
+		int64_t max_threads);
 
 /******************/
 void mknn_dataset_printObjectsRaw(MknnDataset *dataset, FILE *out);
@@ -88,6 +89,9 @@ struct MknnDistanceInstance {
 	mknn_function_distance_save func_distance_save;
 	mknn_function_distance_release func_distance_release;
 	mknn_function_distanceEval_new func_distanceEval_new;
+	//FLOAT16 and BFLOAT16 vectors are widened to float, then
+	//func_distanceEval_new only receives the other datatypes
+	bool widen_16bits;
 };
 
 void mknn_register_default_distances();
@@ -156,21 +160,28 @@ MknnResolver *mknn_resolver_newInternal(
 
 MknnResult *mknn_result_newEmpty(int64_t num_queries, int64_t num_nn_max);
 
-void mknn_result_updateTotalDistanceEvaluations(MknnResult *result);
 void mknn_result_setTotalSearchTime(MknnResult *result,
 		double total_search_time);
 void mknn_result_setResolverQueryDataset(MknnResult *result,
 		MknnResolver *resolver, MknnDataset *query_dataset,
 		bool free_resolver_on_release,
 		bool free_query_dataset_on_release);
+void mknn_result_enableStatistics(MknnResult *result);
+void mknn_result_startQuery(MknnResult *result, int64_t num_query);
 void mknn_result_storeMatchesInResultQuery(MknnResult *result,
 		int64_t num_query, MknnHeap *heap, int64_t cont_evaluations);
+void mknn_result_updateStatistics(MknnResult *result);
 
 void mknn_sample_distances_multithread(MknnDataset *dataset_src,
 		MknnDataset *dataset_dst, int64_t sample_size, MknnDistance *distance,
 		int64_t num_threads, double *out_distances, int64_t *out_position_src,
 		int64_t *out_position_dst);
 
+void mknn_sample_distances_stream(MknnDataset *dataset_src,
+		MknnDataset *dataset_dst, int64_t sample_size, MknnDistance *distance,
+		int64_t max_threads, MyRandom *rnd, double *out_distances,
+		int64_t *out_position_src, int64_t *out_position_dst);
+
 MknnHistogram *mknn_computeDistHistogram(MknnDataset *dataset,
 		int64_t num_samples, MknnDistance *distance, int64_t max_threads);
 
@@ -186,8 +197,16 @@ void mknn_fillDistanceMatrix(MknnDataset *dataset, MknnDistance *distance,
 
 /* **************** */
 
+/**
+ * Selects pivots with Sparse Spatial Selection. The same seed selects the same
+ * pivots for any number of threads.
+ *
+ * @param num_samples_distances number of sampled pairs to estimate the
+ * distribution of distances (0 means log(n)*n/100).
+ */
 void mknn_laesa_select_pivots_sss(MknnDataset *dataset, MknnDistance *distance,
 		int64_t num_pivots, int64_t num_sets_eval, int64_t max_threads,
+		int64_t num_samples_distances, int64_t seed,
 		int64_t *selected_positions);
 
 /* **************** */
@@ -64,6 +64,18 @@ extern MknnDatatype MKNN_DATATYPE_FLOATING_POINT_32bits;
  */
 extern MknnDatatype MKNN_DATATYPE_FLOATING_POINT_64bits;
 
+/**
+ * Floating point 16 bits-length (IEEE 754 half precision). Each value is
+ * stored as raw bits in a @c uint16_t, see my_math_halfToFloat.
+ */
+extern MknnDatatype MKNN_DATATYPE_FLOATING_POINT_16bits;
+
+/**
+ * Brain floating point 16 bits-length (bfloat16, the upper half of a @c float).
+ * Each value is stored as raw bits in a @c uint16_t, see my_math_bfloat16ToFloat.
+ */
+extern MknnDatatype MKNN_DATATYPE_BRAIN_FLOATING_POINT_16bits;
+
 /**
  * Returns whether the given datatype is one of the signed integer types.
  * @param datatype one of the constants @c MKNN_DATATYPE_xxx.
@@ -90,6 +102,8 @@ bool mknn_datatype_isAnyUnsignedInteger(const MknnDatatype datatype);
  * Returns whether the given datatype is one of the floating point types.
  * @param datatype one of the constants @c MKNN_DATATYPE_xxx.
  * @return true if datatype is
+ * #MKNN_DATATYPE_FLOATING_POINT_16bits or
+ * #MKNN_DATATYPE_BRAIN_FLOATING_POINT_16bits or
  * #MKNN_DATATYPE_FLOATING_POINT_32bits or
  * #MKNN_DATATYPE_FLOATING_POINT_64bits, false otherwise.
  */
@@ -105,6 +119,8 @@ bool mknn_datatype_isUInt32(const MknnDatatype datatype);
 bool mknn_datatype_isUInt64(const MknnDatatype datatype);
 bool mknn_datatype_isFloat(const MknnDatatype datatype);
 bool mknn_datatype_isDouble(const MknnDatatype datatype);
+bool mknn_datatype_isFloat16(const MknnDatatype datatype);
+bool mknn_datatype_isBFloat16(const MknnDatatype datatype);
 
 /**
  * Returns if two datatypes are identical.
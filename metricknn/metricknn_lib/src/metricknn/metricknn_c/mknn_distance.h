@@ -177,6 +177,14 @@ MknnDistanceParams *mknn_distance_getParameters(MknnDistance *distance);
  */
 const char *mknn_distance_getIdPredefinedDistance(MknnDistance *distance);
 
+/**
+ * The function that computes the custom distance.
+ * @param distance a custom distance.
+ * @return the function given to #mknn_distance_newCustom or NULL if it is not a custom distance.
+ */
+mknn_function_distanceEval_eval mknn_distance_getCustomFunctionEval(
+		MknnDistance *distance);
+
 /**
  * The distance is saved to a file.
  * It may create other files using @p filename_write as prefix.
@@ -62,6 +62,15 @@ int64_t mknn_kmeans_getNumCentroids(MknnKmeansAlgorithm *kmeans);
 void mknn_kmeans_setMaxThreads(MknnKmeansAlgorithm *kmeans,
 		int64_t max_threads);
 
+/**
+ * Makes the selection of initial centroids and the samples of subset runs
+ * reproducible.
+ * @param kmeans
+ * @param seed the same seed selects the same centroids and samples. By
+ * default they are taken from the global random generator.
+ */
+void mknn_kmeans_setSeed(MknnKmeansAlgorithm *kmeans, int64_t seed);
+
 void mknn_kmeans_setTermitationCriteria(MknnKmeansAlgorithm *kmeans,
 		int64_t maxIteration, double maxSecondsProcess,
 		double pctOrNumberMinMovedVectors, double pctOrNumberMinMovedCentroids);
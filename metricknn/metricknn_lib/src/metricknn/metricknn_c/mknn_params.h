@@ -627,6 +627,16 @@ void mknn_resolverParams_setRange(MknnResolverParams *params, double range);
  */
 void mknn_resolverParams_setMaxThreads(MknnResolverParams *params,
 		int64_t max_threads);
+/**
+ * Enables the collection of per-query statistics (search time and candidates
+ * discarded by lower bounds). Disabled by default.
+ * It can also be enabled with the parameter <tt>statistics=true</tt>.
+ *
+ * @param params parameters
+ * @param statistics
+ */
+void mknn_resolverParams_setStatistics(MknnResolverParams *params,
+		bool statistics);
 /**
  *
  * @param params
@@ -645,6 +655,12 @@ double mknn_resolverParams_getRange(MknnResolverParams *params);
  * @return
  */
 int64_t mknn_resolverParams_getMaxThreads(MknnResolverParams *params);
+/**
+ *
+ * @param params
+ * @return
+ */
+bool mknn_resolverParams_getStatistics(MknnResolverParams *params);
 
 /**
  * @}
@@ -22,6 +22,22 @@ typedef void (*mknn_pca_func_transformVector)(MknnPcaAlgorithm *pca,
 
 MknnPcaAlgorithm *mknn_pca_new();
 
+/**
+ *
+ * @param pca
+ * @param max_threads maximum number of threads to use when computing the
+ * statistics of a dataset. By default it is the number of cores reported by
+ * the OS.
+ */
+void mknn_pca_setMaxThreads(MknnPcaAlgorithm *pca, int64_t max_threads);
+
+/**
+ * Adds the vectors of @p dataset to the statistics used to compute PCA.
+ * It can be called several times to process data that does not fit in memory.
+ *
+ * @param pca
+ * @param dataset
+ */
 void mknn_pca_addDatasetToVectorStats(MknnPcaAlgorithm *pca, MknnDataset *dataset);
 
 void mknn_pca_computeTransformationMatrix(MknnPcaAlgorithm *pca);
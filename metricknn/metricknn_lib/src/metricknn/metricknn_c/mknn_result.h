@@ -63,6 +63,36 @@ MknnDataset *mknn_result_getQueryDataset(MknnResult *result);
  */
 MknnResultQuery *mknn_result_getResultQuery(MknnResult *result,
 		int64_t num_query);
+/**
+ * Statistics are collected when the resolver was created with #mknn_resolverParams_setStatistics.
+ * @param result
+ * @return true if the search collected per-query statistics.
+ */
+bool mknn_result_hasStatistics(MknnResult *result);
+/**
+ *
+ * @param result
+ * @return total amount of objects that were discarded by lower bounds, i.e., their distance was not evaluated.
+ */
+int64_t mknn_result_getTotalDiscardedCandidates(MknnResult *result);
+/**
+ * Returns the search time of a query at a given quantile (e.g. 0.5 for the median, 0.99 for p99).
+ * @param result
+ * @param quantile a value between 0 and 1.
+ * @return time in seconds, or 0 if the result has no statistics.
+ */
+double mknn_result_getQuerySearchTimeQuantile(MknnResult *result,
+		double quantile);
+/**
+ * Returns the histogram of query search times. The bin 0 counts queries resolved in less than
+ * 1 microsecond and the bin @c i counts queries between 2^(i-1) and 2^i microseconds.
+ * The last bin also counts the slower queries.
+ * @param result
+ * @param out_num_bins returns the number of bins.
+ * @return the count for each bin (it is released during #mknn_result_release), or NULL if the result has no statistics.
+ */
+const int64_t *mknn_result_getQuerySearchTimeHistogram(MknnResult *result,
+		int64_t *out_num_bins);
 /**
  * Releases the result of a search (including the result for each query) that may have been returned by #mknn_result_getResultQuery.
  *
@@ -78,6 +108,8 @@ struct MknnResultQuery {
 	double *nn_distance; /**< the distance of each nearest neighbor to the query object. */
 	int64_t *nn_position; /**< the position in the search dataset of each nearest neighbor. The actual object can be retrieved by calling #mknn_dataset_getObject. */
 	int64_t num_distance_evaluations; /**< amount of distances evaluated for resolving this query. */
+	int64_t num_discarded_candidates; /**< amount of objects discarded by lower bounds without evaluating their distance. */
+	double search_time; /**< time in seconds for resolving this query, only when statistics are enabled. */
 };
 
 #ifdef __cplusplus
@@ -62,6 +62,16 @@ public:
 	 */
 	static const std::string FLOATING_POINT_64bits;
 
+	/**
+	 * Floating point 16 bits-length (IEEE 754 half precision), stored as raw bits in a @c uint16_t.
+	 */
+	static const std::string FLOATING_POINT_16bits;
+
+	/**
+	 * Brain floating point 16 bits-length (bfloat16), stored as raw bits in a @c uint16_t.
+	 */
+	static const std::string BRAIN_FLOATING_POINT_16bits;
+
 	/**
 	 * Returns the size in bytes of the given datatype (a number between 1 and 8).
 	 * @param datatype one of the constants
@@ -95,6 +105,8 @@ public:
 	 * Returns whether the given datatype is one of the floating point types.
 	 * @param datatype one of the constants
 	 * @return true if datatype is
+	 * #FLOATING_POINT_16bits or
+	 * #BRAIN_FLOATING_POINT_16bits or
 	 * #FLOATING_POINT_32bits or
 	 * #FLOATING_POINT_64bits, false otherwise.
 	 */
@@ -93,6 +93,8 @@ public:
 	double *nn_distance; /**< the distance of each nearest neighbor to the query object. */
 	long long *nn_position; /**< the position in the search dataset of each nearest neighbor. The actual object can be retrieved by calling Dataset::getObject. */
 	long long num_distance_evaluations; /**< amount of distances evaluated for resolving this query. */
+	long long num_discarded_candidates; /**< amount of objects discarded by lower bounds without evaluating their distance. */
+	double search_time; /**< time in seconds for resolving this query, only when statistics are enabled. */
 };
 
 }
@@ -62,13 +62,16 @@ typedef struct MyVectorObj MyVectorObj;
 typedef struct MyMapObjObj MyMapObjObj;
 typedef struct MyMapStringObj MyMapStringObj;
 typedef struct MyLineReader MyLineReader;
+typedef struct MyBlockReader MyBlockReader;
 typedef struct MyProgress MyProgress;
 typedef struct MyTimer MyTimer;
+typedef struct MyArena MyArena;
 typedef struct {
 	int8_t my_datatype_code;
 } MyDatatype;
 
 #include "myutils_c/mem_util.h"
+#include "myutils_c/mem_arena.h"
 #include "myutils_c/log_util.h"
 #include "myutils_c/timer_util.h"
 #include "myutils_c/collection_util.h"
@@ -14,7 +14,7 @@ struct Node {
 	struct Node *left, *right;
 };
 struct MyMapIntObj {
-	bool is_array, is_ABB;
+	bool is_array, is_ABB, is_hash;
 	int64_t size;
 //array
 	int64_t *array_keys;
@@ -22,6 +22,14 @@ struct MyMapIntObj {
 	int64_t buffer_size;
 //ABB i2o
 	struct Node *abb_root;
+//hash: open addressing with linear probing, capacity is a power of two.
+//the array is used as a sorted copy, it is built on demand by getKeyAt,
+//getObjAt and valuesVector
+	int64_t *hash_keys;
+	void **hash_objects;
+	bool *hash_used;
+	int64_t hash_capacity;
+	bool array_updated;
 };
 
 MyMapIntObj *my_mapIntObj_new_array() {
@@ -34,6 +42,86 @@ MyMapIntObj *my_mapIntObj_new_ABB() {
 	map->is_ABB = true;
 	return map;
 }
+MyMapIntObj *my_mapIntObj_new_HASH() {
+	MyMapIntObj *map = MY_MALLOC(1, MyMapIntObj);
+	map->is_hash = true;
+	return map;
+}
+static uint64_t hash_int(int64_t key) {
+	uint64_t h = key;
+	h ^= h >> 33;
+	h *= UINT64_C(0xff51afd7ed558ccd);
+	h ^= h >> 33;
+	return h;
+}
+//returns true if key is found, otherwise out_pos is an empty slot
+static bool hash_find(MyMapIntObj *map, int64_t key, int64_t *out_pos) {
+	int64_t mask = map->hash_capacity - 1;
+	int64_t pos = hash_int(key) & mask;
+	while (map->hash_used[pos]) {
+		if (map->hash_keys[pos] == key) {
+			*out_pos = pos;
+			return true;
+		}
+		pos = (pos + 1) & mask;
+	}
+	*out_pos = pos;
+	return false;
+}
+static void hash_resize(MyMapIntObj *map, int64_t new_capacity) {
+	int64_t old_capacity = map->hash_capacity;
+	int64_t *old_keys = map->hash_keys;
+	void **old_objects = map->hash_objects;
+	bool *old_used = map->hash_used;
+	map->hash_capacity = new_capacity;
+	map->hash_keys = MY_MALLOC_NOINIT(new_capacity, int64_t);
+	map->hash_objects = MY_MALLOC_NOINIT(new_capacity, void*);
+	map->hash_used = MY_MALLOC(new_capacity, bool);
+	for (int64_t i = 0; i < old_capacity; ++i) {
+		if (!old_used[i])
+			continue;
+		int64_t pos = -1;
+		hash_find(map, old_keys[i], &pos);
+		map->hash_keys[pos] = old_keys[i];
+		map->hash_objects[pos] = old_objects[i];
+		map->hash_used[pos] = true;
+	}
+	MY_FREE_MULTI(old_keys, old_objects, old_used);
+}
+struct KeyObj {
+	int64_t key;
+	void *object;
+};
+static int compare_keyObj(const void *a, const void *b) {
+	int64_t k1 = ((const struct KeyObj*) a)->key;
+	int64_t k2 = ((const struct KeyObj*) b)->key;
+	return (k1 < k2) ? -1 : (k1 > k2) ? 1 : 0;
+}
+static void hash_updateArray(MyMapIntObj *map) {
+	if (map->array_updated)
+		return;
+	struct KeyObj *pairs = MY_MALLOC_NOINIT(MAX(1, map->size), struct KeyObj);
+	int64_t n = 0;
+	for (int64_t i = 0; i < map->hash_capacity; ++i) {
+		if (map->hash_used[i]) {
+			pairs[n].key = map->hash_keys[i];
+			pairs[n].object = map->hash_objects[i];
+			n++;
+		}
+	}
+	qsort(pairs, n, sizeof(struct KeyObj), compare_keyObj);
+	if (map->size > map->buffer_size) {
+		map->buffer_size = map->size;
+		MY_REALLOC(map->array_keys, map->buffer_size, int64_t);
+		MY_REALLOC(map->array_objects, map->buffer_size, void*);
+	}
+	for (int64_t i = 0; i < n; ++i) {
+		map->array_keys[i] = pairs[i].key;
+		map->array_objects[i] = pairs[i].object;
+	}
+	MY_FREE(pairs);
+	map->array_updated = true;
+}
 static struct Node *newNode(int64_t key, void *object) {
 	struct Node *n = MY_MALLOC(1, struct Node);
 	n->key = key;
@@ -91,6 +179,22 @@ void *my_mapIntObj_add(MyMapIntObj *map, int64_t key, void *object) {
 			}
 		}
 		return NULL;
+	} else if (map->is_hash) {
+		map->array_updated = false;
+		//load factor at most 0.75
+		if (4 * (map->size + 1) > 3 * map->hash_capacity)
+			hash_resize(map, MAX(16, 2 * map->hash_capacity));
+		int64_t pos = -1;
+		if (hash_find(map, key, &pos)) {
+			void *old = map->hash_objects[pos];
+			map->hash_objects[pos] = object;
+			return old;
+		}
+		map->hash_keys[pos] = key;
+		map->hash_objects[pos] = object;
+		map->hash_used[pos] = true;
+		map->size++;
+		return NULL;
 	}
 	my_log_error("todo addObj_mapInt\n");
 	return NULL;
@@ -113,6 +217,10 @@ void *my_mapIntObj_get(MyMapIntObj *map, int64_t key) {
 				return nodo->object;
 			}
 		}
+	} else if (map->is_hash) {
+		int64_t pos = -1;
+		if (map->size > 0 && hash_find(map, key, &pos))
+			return map->hash_objects[pos];
 	}
 	return NULL;
 }
@@ -120,10 +228,14 @@ int64_t my_mapIntObj_size(MyMapIntObj *map) {
 	return map->size;
 }
 MyVectorObj *my_mapIntObj_valuesVector(MyMapIntObj *map) {
+	if (map->is_hash)
+		hash_updateArray(map);
 	return my_vectorObj_new_wrapper(map->size, map->array_objects, false);
 }
 int64_t my_mapIntObj_getKeyAt(MyMapIntObj *map, int64_t position) {
-	if (map->is_array) {
+	if (map->is_hash)
+		hash_updateArray(map);
+	if (map->is_array || map->is_hash) {
 		my_assert_indexRangeInt("array index", position, map->size);
 		return map->array_keys[position];
 	}
@@ -131,7 +243,9 @@ int64_t my_mapIntObj_getKeyAt(MyMapIntObj *map, int64_t position) {
 	return -1;
 }
 void *my_mapIntObj_getObjAt(MyMapIntObj *map, int64_t position) {
-	if (map->is_array) {
+	if (map->is_hash)
+		hash_updateArray(map);
+	if (map->is_array || map->is_hash) {
 		my_assert_indexRangeInt("array index", position, map->size);
 		return map->array_objects[position];
 	}
@@ -157,6 +271,13 @@ void my_mapIntObj_release(MyMapIntObj *map, bool freeEachObject) {
 		MY_FREE(map->array_objects);
 	} else if (map->is_ABB) {
 		my_map_releaseABB_i2o_rec(map->abb_root, freeEachObject);
+	} else if (map->is_hash) {
+		if (freeEachObject)
+			for (int64_t i = 0; i < map->hash_capacity; ++i)
+				if (map->hash_used[i])
+					MY_FREE(map->hash_objects[i]);
+		MY_FREE_MULTI(map->hash_keys, map->hash_objects, map->hash_used,
+				map->array_keys, map->array_objects);
 	}
 	MY_FREE(map);
 }
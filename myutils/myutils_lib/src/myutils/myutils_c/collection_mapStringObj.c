@@ -14,6 +14,13 @@ struct MyMapStringObj {
 	int64_t buffer_size;
 	const char**array_keys;
 	void **array_objects;
+//hash: open addressing with linear probing, capacity is a power of two.
+//the array is used as a sorted copy, it is built on demand by getKeyAt,
+//getObjAt and valuesVector
+	bool is_hash, array_updated;
+	const char **hash_keys;
+	void **hash_objects;
+	int64_t hash_capacity;
 };
 
 MyMapStringObj *my_mapStringObj_newCaseSensitive() {
@@ -26,8 +33,143 @@ MyMapStringObj *my_mapStringObj_newIgnoreCase() {
 	map->func_compare_keys = my_compare_string_ignorecase;
 	return map;
 }
+MyMapStringObj *my_mapStringObj_newHashCaseSensitive() {
+	MyMapStringObj *map = my_mapStringObj_newCaseSensitive();
+	map->is_hash = true;
+	return map;
+}
+MyMapStringObj *my_mapStringObj_newHashIgnoreCase() {
+	MyMapStringObj *map = my_mapStringObj_newIgnoreCase();
+	map->is_hash = true;
+	return map;
+}
+//FNV-1a
+static uint64_t hash_string(MyMapStringObj *map, const char *key) {
+	uint64_t h = UINT64_C(14695981039346656037);
+	const unsigned char *p = (const unsigned char*) key;
+	if (map->func_compare_keys == my_compare_string_ignorecase) {
+		for (; *p != '\0'; ++p)
+			h = (h ^ tolower(*p)) * UINT64_C(1099511628211);
+	} else {
+		for (; *p != '\0'; ++p)
+			h = (h ^ *p) * UINT64_C(1099511628211);
+	}
+	return h;
+}
+//returns true if key is found, otherwise out_pos is an empty slot
+static bool hash_find(MyMapStringObj *map, const char *key, int64_t *out_pos) {
+	int64_t mask = map->hash_capacity - 1;
+	int64_t pos = hash_string(map, key) & mask;
+	while (map->hash_keys[pos] != NULL) {
+		if (map->func_compare_keys(key, map->hash_keys[pos]) == 0) {
+			*out_pos = pos;
+			return true;
+		}
+		pos = (pos + 1) & mask;
+	}
+	*out_pos = pos;
+	return false;
+}
+static void hash_resize(MyMapStringObj *map, int64_t new_capacity) {
+	int64_t old_capacity = map->hash_capacity;
+	const char **old_keys = map->hash_keys;
+	void **old_objects = map->hash_objects;
+	map->hash_capacity = new_capacity;
+	map->hash_keys = MY_MALLOC(new_capacity, const char*);
+	map->hash_objects = MY_MALLOC(new_capacity, void*);
+	for (int64_t i = 0; i < old_capacity; ++i) {
+		if (old_keys[i] == NULL)
+			continue;
+		int64_t pos = -1;
+		hash_find(map, old_keys[i], &pos);
+		map->hash_keys[pos] = old_keys[i];
+		map->hash_objects[pos] = old_objects[i];
+	}
+	MY_FREE_MULTI(old_keys, old_objects);
+}
+struct KeyObj {
+	const char *key;
+	void *object;
+};
+static int compare_keyObj(const void *a, const void *b) {
+	return strcmp(((const struct KeyObj*) a)->key,
+			((const struct KeyObj*) b)->key);
+}
+static int compare_keyObj_ignorecase(const void *a, const void *b) {
+	return strcasecmp(((const struct KeyObj*) a)->key,
+			((const struct KeyObj*) b)->key);
+}
+static void hash_updateArray(MyMapStringObj *map) {
+	if (map->array_updated)
+		return;
+	struct KeyObj *pairs = MY_MALLOC_NOINIT(MAX(1, map->size), struct KeyObj);
+	int64_t n = 0;
+	for (int64_t i = 0; i < map->hash_capacity; ++i) {
+		if (map->hash_keys[i] != NULL) {
+			pairs[n].key = map->hash_keys[i];
+			pairs[n].object = map->hash_objects[i];
+			n++;
+		}
+	}
+	qsort(pairs, n, sizeof(struct KeyObj),
+			(map->func_compare_keys == my_compare_string_ignorecase) ?
+					compare_keyObj_ignorecase : compare_keyObj);
+	if (map->size > map->buffer_size) {
+		map->buffer_size = map->size;
+		MY_REALLOC(map->array_keys, map->buffer_size, const char*);
+		MY_REALLOC(map->array_objects, map->buffer_size, void*);
+	}
+	for (int64_t i = 0; i < n; ++i) {
+		map->array_keys[i] = pairs[i].key;
+		map->array_objects[i] = pairs[i].object;
+	}
+	MY_FREE(pairs);
+	map->array_updated = true;
+}
+static void *hash_add(MyMapStringObj *map, const char *key, void *value) {
+	map->array_updated = false;
+	//load factor at most 0.75
+	if (4 * (map->size + 1) > 3 * map->hash_capacity)
+		hash_resize(map, MAX(16, 2 * map->hash_capacity));
+	int64_t pos = -1;
+	if (hash_find(map, key, &pos)) {
+		void *old = map->hash_objects[pos];
+		map->hash_objects[pos] = value;
+		return old;
+	}
+	map->hash_keys[pos] = key;
+	map->hash_objects[pos] = value;
+	map->size++;
+	return NULL;
+}
+static void *hash_remove(MyMapStringObj *map, const char *key) {
+	int64_t pos = -1;
+	if (map->size == 0 || !hash_find(map, key, &pos))
+		return NULL;
+	void *old = map->hash_objects[pos];
+	//backward shift deletion, no tombstones
+	int64_t mask = map->hash_capacity - 1;
+	int64_t empty = pos;
+	for (int64_t i = (pos + 1) & mask; map->hash_keys[i] != NULL;
+			i = (i + 1) & mask) {
+		int64_t home = hash_string(map, map->hash_keys[i]) & mask;
+		//moves the entry if its home is not between the empty slot and i
+		if (((i - home) & mask) >= ((i - empty) & mask)) {
+			map->hash_keys[empty] = map->hash_keys[i];
+			map->hash_objects[empty] = map->hash_objects[i];
+			empty = i;
+		}
+	}
+	map->hash_keys[empty] = NULL;
+	map->hash_objects[empty] = NULL;
+	map->size--;
+	map->array_updated = false;
+	return old;
+}
 //retorna el que objeto que estaba o NULL si no existe la llave
 void *my_mapStringObj_add(MyMapStringObj *map, const char *key, void *value) {
+	if (map->is_hash)
+		return hash_add(map, key, value);
 	int64_t pos = -1;
 	if (my_binsearch_objArr((void*) key, (void**) map->array_keys, map->size,
 			map->func_compare_keys, &pos)) {
@@ -54,6 +196,12 @@ void *my_mapStringObj_add(MyMapStringObj *map, const char *key, void *value) {
 void *my_mapStringObj_get(MyMapStringObj *map, const char *key) {
 	if (map == NULL)
 		return NULL;
+	if (map->is_hash) {
+		int64_t pos = -1;
+		if (map->size > 0 && hash_find(map, key, &pos))
+			return map->hash_objects[pos];
+		return NULL;
+	}
 	int64_t pos = 0;
 	if (my_binsearch_objArr((void*) key, (void**) map->array_keys, map->size,
 			map->func_compare_keys, &pos))
@@ -61,6 +209,8 @@ void *my_mapStringObj_get(MyMapStringObj *map, const char *key) {
 	return NULL;
 }
 void *my_mapStringObj_remove(MyMapStringObj *map, void *key) {
+	if (map->is_hash)
+		return hash_remove(map, key);
 	int64_t pos = -1;
 	if (!my_binsearch_objArr(key, (void**) map->array_keys, map->size,
 			map->func_compare_keys, &pos))
@@ -74,6 +224,8 @@ void *my_mapStringObj_remove(MyMapStringObj *map, void *key) {
 	return old;
 }
 MyVectorObj *my_mapStringObj_valuesVector(MyMapStringObj *map) {
+	if (map->is_hash)
+		hash_updateArray(map);
 	return my_vectorObj_new_wrapper(map->size, map->array_objects, false);
 }
 
@@ -83,10 +235,14 @@ int64_t my_mapStringObj_size(MyMapStringObj *map) {
 	return map->size;
 }
 const char *my_mapStringObj_getKeyAt(MyMapStringObj *map, int64_t position) {
+	if (map->is_hash)
+		hash_updateArray(map);
 	my_assert_indexRangeInt("array index", position, map->size);
 	return map->array_keys[position];
 }
 void *my_mapStringObj_getObjAt(MyMapStringObj *map, int64_t position) {
+	if (map->is_hash)
+		hash_updateArray(map);
 	my_assert_indexRangeInt("array index", position, map->size);
 	return map->array_objects[position];
 }
@@ -97,6 +253,19 @@ void my_mapStringObj_addAll(MyMapStringObj *map, const char **keys,
 }
 void my_mapStringObj_release(MyMapStringObj *map, bool freeEachKey,
 bool freeEachValue) {
+	if (map->is_hash) {
+		for (int64_t i = 0; i < map->hash_capacity; ++i) {
+			if (map->hash_keys[i] == NULL)
+				continue;
+			if (freeEachKey)
+				MY_FREE(map->hash_keys[i]);
+			if (freeEachValue)
+				MY_FREE(map->hash_objects[i]);
+		}
+		MY_FREE_MULTI(map->hash_keys, map->hash_objects, map->array_keys,
+				map->array_objects, map);
+		return;
+	}
 	if (freeEachKey)
 		for (int64_t i = 0; i < map->size; ++i)
 			MY_FREE(map->array_keys[i]);
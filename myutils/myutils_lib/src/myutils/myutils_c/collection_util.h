@@ -155,6 +155,12 @@ void my_vectorString_release(MyVectorString *al, bool freeEachString);
 char **my_vectorString_releaseReturnBuffer(MyVectorString *al);
 
 MyVectorObj *my_vectorObj_new();
+/**
+ * The vector and its array are allocated in @p arena. The objects are
+ * expected to be allocated in the arena too, thus my_vectorObj_release
+ * does not release memory and ignores freeEachObject.
+ */
+MyVectorObj *my_vectorObj_newArena(MyArena *arena);
 void my_vectorObj_setArrayOptions(MyVectorObj *al, bool keepSorted,
 bool removeDuplicates, my_func_compareObj func_compare);
 MyVectorObj *my_vectorObj_new_wrapper(int64_t largo, void **array,
@@ -198,6 +204,12 @@ typedef struct MyMapIntObj MyMapIntObj;
 
 MyMapIntObj *my_mapIntObj_new_array();
 MyMapIntObj *my_mapIntObj_new_ABB();
+/**
+ * Hash map (open addressing): O(1) add and get for any key order.
+ * getKeyAt, getObjAt and valuesVector follow the order of the keys, they
+ * sort a copy of the map after it is modified.
+ */
+MyMapIntObj *my_mapIntObj_new_HASH();
 void *my_mapIntObj_add(MyMapIntObj *map, int64_t key, void *object);
 void *my_mapIntObj_get(MyMapIntObj *map, int64_t key);
 int64_t my_mapIntObj_size(MyMapIntObj *map);
@@ -228,6 +240,13 @@ bool freeEachValue);
 
 MyMapStringObj *my_mapStringObj_newCaseSensitive();
 MyMapStringObj *my_mapStringObj_newIgnoreCase();
+/**
+ * Hash map (open addressing): O(1) add, get and remove.
+ * getKeyAt, getObjAt and valuesVector follow the order of the keys, they
+ * sort a copy of the map after it is modified.
+ */
+MyMapStringObj *my_mapStringObj_newHashCaseSensitive();
+MyMapStringObj *my_mapStringObj_newHashIgnoreCase();
 void *my_mapStringObj_add(MyMapStringObj *map, const char *key, void *value);
 void *my_mapStringObj_get(MyMapStringObj *map, const char *key);
 void *my_mapStringObj_remove(MyMapStringObj *map, void *key);
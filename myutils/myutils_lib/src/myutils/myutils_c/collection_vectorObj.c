@@ -15,6 +15,7 @@ struct MyVectorObj {
 	bool keepSorted, removeDuplicates;
 	my_func_compareObj func_compare;
 	bool free_array_on_release;
+	MyArena *arena;
 };
 MyVectorObj *my_vectorObj_new() {
 	MyVectorObj *al = MY_MALLOC(1, MyVectorObj);
@@ -27,6 +28,11 @@ bool removeDuplicates, my_func_compareObj func_compare) {
 	al->removeDuplicates = removeDuplicates;
 	al->func_compare = func_compare;
 }
+MyVectorObj *my_vectorObj_newArena(MyArena *arena) {
+	MyVectorObj *al = MY_ARENA_MALLOC(arena, 1, MyVectorObj);
+	al->arena = arena;
+	return al;
+}
 MyVectorObj *my_vectorObj_new_wrapper(int64_t length, void **array,
 bool free_array_on_release) {
 	MyVectorObj *al = MY_MALLOC(1, MyVectorObj);
@@ -56,8 +62,13 @@ bool my_vectorObj_add(MyVectorObj *al, void* value) {
 			return false;
 	}
 	if (al->length == al->buffer_size) {
-		al->buffer_size = MAX(2 * al->buffer_size, 4);
-		MY_REALLOC(al->array, al->buffer_size, void*);
+		int64_t new_size = MAX(2 * al->buffer_size, 4);
+		if (al->arena != NULL)
+			MY_ARENA_REALLOC(al->arena, al->array, al->buffer_size, new_size,
+					void*);
+		else
+			MY_REALLOC(al->array, new_size, void*);
+		al->buffer_size = new_size;
 	}
 	for (int64_t i = al->length; i > pos; --i) {
 		al->array[i] = al->array[i - 1];
@@ -141,6 +152,8 @@ int64_t my_vectorObj_indexOf_binsearch(MyVectorObj *al,
 void my_vectorObj_release(MyVectorObj *al, bool freeEachObject) {
 	if (al == NULL)
 		return;
+	if (al->arena != NULL)
+		return;
 	if (freeEachObject) {
 		for (int64_t i = 0; i < al->length; ++i)
 			MY_FREE(al->array[i]);
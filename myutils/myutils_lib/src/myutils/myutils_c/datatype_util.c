@@ -18,6 +18,8 @@
 #define UN32 75
 #define UN64 76
 
+#define BF16 83
+#define FL16 84
 #define FL32 85
 #define FL64 86
 
@@ -33,6 +35,8 @@ MyDatatype MY_DATATYPE_UINT64 = { UN64 }; //L
 
 MyDatatype MY_DATATYPE_FLOAT32 = { FL32 }; //U
 MyDatatype MY_DATATYPE_FLOAT64 = { FL64 }; //V
+MyDatatype MY_DATATYPE_FLOAT16 = { FL16 }; //T
+MyDatatype MY_DATATYPE_BFLOAT16 = { BF16 }; //S
 
 size_t my_datatype_sizeof(const MyDatatype datatype) {
 	switch (datatype.my_datatype_code) {
@@ -41,6 +45,8 @@ size_t my_datatype_sizeof(const MyDatatype datatype) {
 		return 1;
 	case IN16:
 	case UN16:
+	case FL16:
+	case BF16:
 		return 2;
 	case IN32:
 	case UN32:
@@ -93,6 +99,8 @@ bool my_datatype_isAnyUnsignedInteger(const MyDatatype datatype) {
 }
 bool my_datatype_isAnyFloatingPoint(const MyDatatype datatype) {
 	switch (datatype.my_datatype_code) {
+	case FL16:
+	case BF16:
 	case FL32:
 	case FL64:
 		return true;
@@ -131,6 +139,12 @@ bool my_datatype_isFloat(const MyDatatype datatype) {
 bool my_datatype_isDouble(const MyDatatype datatype) {
 	return datatype.my_datatype_code == FL64;
 }
+bool my_datatype_isFloat16(const MyDatatype datatype) {
+	return datatype.my_datatype_code == FL16;
+}
+bool my_datatype_isBFloat16(const MyDatatype datatype) {
+	return datatype.my_datatype_code == BF16;
+}
 bool my_datatype_areEqual(const MyDatatype datatype1,
 		const MyDatatype datatype2) {
 	return datatype1.my_datatype_code == datatype2.my_datatype_code;
@@ -158,6 +172,10 @@ const char *my_datatype_codeToDescription(const MyDatatype datatype) {
 		return "UINT64";
 	case FL64:
 		return "FLOAT64";
+	case FL16:
+		return "FLOAT16";
+	case BF16:
+		return "BFLOAT16";
 	default:
 		return "?";
 	}
@@ -183,6 +201,10 @@ MyDatatype my_datatype_descriptionToCode(const char *description) {
 		return MY_DATATYPE_UINT64;
 	else if (strcmp(description, "FLOAT64") == 0)
 		return MY_DATATYPE_FLOAT64;
+	else if (strcmp(description, "FLOAT16") == 0)
+		return MY_DATATYPE_FLOAT16;
+	else if (strcmp(description, "BFLOAT16") == 0)
+		return MY_DATATYPE_BFLOAT16;
 	else
 		my_log_error("unknown datatype %s\n", description);
 	MyDatatype d = { 0 };
@@ -209,6 +231,12 @@ static char *value_to_string_FL32(float value) {
 static char *value_to_string_FL64(double value) {
 	return my_newString_double(value);
 }
+static char *value_to_string_FL16(my_float16_t value) {
+	return my_newString_float(my_math_halfToFloat(value));
+}
+static char *value_to_string_BF16(my_bfloat16_t value) {
+	return my_newString_float(my_math_bfloat16ToFloat(value));
+}
 
 #define FUNC_ARRAY_TOSTRING(datatype, typeVector, functionName) \
 static char *array_to_string_##datatype(void *array, size_t array_length, const char *prefix,\
@@ -238,6 +266,8 @@ FUNC_ARRAY_TOSTRING(IN64, int64_t, value_to_string_IN64)
 FUNC_ARRAY_TOSTRING(UN64, uint64_t, value_to_string_UN64)
 FUNC_ARRAY_TOSTRING(FL32, float, value_to_string_FL32)
 FUNC_ARRAY_TOSTRING(FL64, double, value_to_string_FL64)
+FUNC_ARRAY_TOSTRING(FL16, my_float16_t, value_to_string_FL16)
+FUNC_ARRAY_TOSTRING(BF16, my_bfloat16_t, value_to_string_BF16)
 
 #define INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, constantDatatype) \
 if (varDatatype.my_datatype_code == constantDatatype) { \
@@ -254,7 +284,9 @@ INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, UN16 ) \
 INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, UN32 ) \
 INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, UN64 ) \
 INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, FL32 ) \
-INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, FL64 )
+INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, FL64 ) \
+INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, FL16 ) \
+INTERNAL_TEST_SINGLE_ASSIGN(varDatatype, namePrefix, BF16 )
 
 my_function_to_string my_datatype_getFunctionToString(const MyDatatype datatype) {
 	RETURN_SINGLE_DATATYPE(datatype, array_to_string_)
@@ -280,6 +312,15 @@ FUNC_PARSE(UN64, uint64_t, my_parse_int)
 FUNC_PARSE(FL32, float, my_parse_double)
 FUNC_PARSE(FL64, double, my_parse_double)
 
+static my_float16_t parse_float16(const char *string) {
+	return my_math_floatToHalf(my_parse_double(string));
+}
+static my_bfloat16_t parse_bfloat16(const char *string) {
+	return my_math_floatToBfloat16(my_parse_double(string));
+}
+FUNC_PARSE(FL16, my_float16_t, parse_float16)
+FUNC_PARSE(BF16, my_bfloat16_t, parse_bfloat16)
+
 my_function_parse_string my_datatype_getFunctionParseVector(
 		const MyDatatype datatype) {
 	RETURN_SINGLE_DATATYPE(datatype, convert_from_string_)
@@ -289,23 +330,50 @@ my_function_parse_string my_datatype_getFunctionParseVector(
 
 /*************************************/
 
+//values are converted by casting, except for 16 bits floating points
+#define LOAD_int8_t(value) (value)
+#define LOAD_int16_t(value) (value)
+#define LOAD_int32_t(value) (value)
+#define LOAD_int64_t(value) (value)
+#define LOAD_uint8_t(value) (value)
+#define LOAD_uint16_t(value) (value)
+#define LOAD_uint32_t(value) (value)
+#define LOAD_uint64_t(value) (value)
+#define LOAD_float(value) (value)
+#define LOAD_double(value) (value)
+#define LOAD_my_float16_t(value) my_math_halfToFloat(value)
+#define LOAD_my_bfloat16_t(value) my_math_bfloat16ToFloat(value)
+
+#define STORE_int8_t(value) ((int8_t) (value))
+#define STORE_int16_t(value) ((int16_t) (value))
+#define STORE_int32_t(value) ((int32_t) (value))
+#define STORE_int64_t(value) ((int64_t) (value))
+#define STORE_uint8_t(value) ((uint8_t) (value))
+#define STORE_uint16_t(value) ((uint16_t) (value))
+#define STORE_uint32_t(value) ((uint32_t) (value))
+#define STORE_uint64_t(value) ((uint64_t) (value))
+#define STORE_float(value) ((float) (value))
+#define STORE_double(value) ((double) (value))
+#define STORE_my_float16_t(value) my_math_floatToHalf((float) (value))
+#define STORE_my_bfloat16_t(value) my_math_floatToBfloat16((float) (value))
+
 #define FUNC_COPY_VECTOR(datatypeSrc, typeSrc, datatypeDst, typeDst) \
 static void copy_vector_##datatypeSrc##_##datatypeDst(void *ptr_vector_src, void *ptr_vector_dst, size_t dimensions) {\
 	typeSrc *vector_src = ptr_vector_src; \
 	typeDst *vector_dst = ptr_vector_dst; \
 	size_t numN = dimensions / 4; \
 	while (numN > 0) { \
-		vector_dst[0] = (typeDst) (vector_src[0]); \
-		vector_dst[1] = (typeDst) (vector_src[1]); \
-		vector_dst[2] = (typeDst) (vector_src[2]); \
-		vector_dst[3] = (typeDst) (vector_src[3]); \
+		vector_dst[0] = STORE_##typeDst(LOAD_##typeSrc(vector_src[0])); \
+		vector_dst[1] = STORE_##typeDst(LOAD_##typeSrc(vector_src[1])); \
+		vector_dst[2] = STORE_##typeDst(LOAD_##typeSrc(vector_src[2])); \
+		vector_dst[3] = STORE_##typeDst(LOAD_##typeSrc(vector_src[3])); \
 		vector_src += 4; \
 		vector_dst += 4; \
 		numN--; \
 	} \
 	size_t numB = dimensions % 4; \
 	while (numB > 0) { \
-		vector_dst[0] = (typeDst) (vector_src[0]); \
+		vector_dst[0] = STORE_##typeDst(LOAD_##typeSrc(vector_src[0])); \
 		vector_src += 1; \
 		vector_dst += 1; \
 		numB--; \
@@ -322,7 +390,9 @@ VAR_NAME(datatype1, type1, UN32 , uint32_t ) \
 VAR_NAME(datatype1, type1, IN64 ,  int64_t ) \
 VAR_NAME(datatype1, type1, UN64 , uint64_t ) \
 VAR_NAME(datatype1, type1, FL32 ,    float ) \
-VAR_NAME(datatype1, type1, FL64 ,   double )
+VAR_NAME(datatype1, type1, FL64 ,   double ) \
+VAR_NAME(datatype1, type1, FL16 ,  my_float16_t ) \
+VAR_NAME(datatype1, type1, BF16 , my_bfloat16_t )
 
 #define GENERATE_TWO_DATATYPES(VAR_NAME) \
 INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, IN08 ,   int8_t ) \
@@ -334,10 +404,50 @@ INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, UN32 , uint32_t ) \
 INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, IN64 ,  int64_t ) \
 INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, UN64 , uint64_t ) \
 INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, FL32 ,    float ) \
-INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, FL64 ,   double )
+INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, FL64 ,   double ) \
+INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, FL16 ,  my_float16_t ) \
+INTERNAL_GENERATE_TWO_DATATYPES(VAR_NAME, BF16 , my_bfloat16_t )
 
 GENERATE_TWO_DATATYPES(FUNC_COPY_VECTOR)
 
+//conversions between float and 16 bits floating points are vectorized
+static void convert_array_FL16_FL32(void *ptr_vector_src, void *ptr_vector_dst,
+		size_t dimensions) {
+	my_math_halfToFloatArray(ptr_vector_src, ptr_vector_dst, dimensions);
+}
+static void convert_array_BF16_FL32(void *ptr_vector_src, void *ptr_vector_dst,
+		size_t dimensions) {
+	my_math_bfloat16ToFloatArray(ptr_vector_src, ptr_vector_dst, dimensions);
+}
+static void convert_array_FL32_FL16(void *ptr_vector_src, void *ptr_vector_dst,
+		size_t dimensions) {
+	my_math_floatToHalfArray(ptr_vector_src, ptr_vector_dst, dimensions);
+}
+static void convert_array_FL32_BF16(void *ptr_vector_src, void *ptr_vector_dst,
+		size_t dimensions) {
+	my_math_floatToBfloat16Array(ptr_vector_src, ptr_vector_dst, dimensions);
+}
+static void convert_array_16bits(void *ptr_vector_src, void *ptr_vector_dst,
+		size_t dimensions) {
+	memmove(ptr_vector_dst, ptr_vector_src, dimensions * sizeof(uint16_t));
+}
+static my_function_copy_vector priv_getConvertArray(
+		const MyDatatype datatype_src, const MyDatatype datatype_dst) {
+	int8_t src = datatype_src.my_datatype_code;
+	int8_t dst = datatype_dst.my_datatype_code;
+	if (src == dst && (src == FL16 || src == BF16))
+		return convert_array_16bits;
+	else if (src == FL16 && dst == FL32)
+		return convert_array_FL16_FL32;
+	else if (src == BF16 && dst == FL32)
+		return convert_array_BF16_FL32;
+	else if (src == FL32 && dst == FL16)
+		return convert_array_FL32_FL16;
+	else if (src == FL32 && dst == BF16)
+		return convert_array_FL32_BF16;
+	return NULL;
+}
+
 #define INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, constantDatatype2) \
 if (varDatatype1.my_datatype_code == constantDatatype1 && varDatatype2.my_datatype_code == constantDatatype2) { \
 	return namePrefix##constantDatatype1##_##constantDatatype2; \
@@ -353,7 +463,9 @@ INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, UN1
 INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, UN32 ) \
 INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, UN64 ) \
 INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, FL32 ) \
-INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, FL64 )
+INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, FL64 ) \
+INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, FL16 ) \
+INTERNAL_TEST_TWO(varDatatype1, varDatatype2, namePrefix, constantDatatype1, BF16 )
 
 #define RETURN_TWO_DATATYPES(varDatatype1, varDatatype2, namePrefix) \
 INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, IN08 ) \
@@ -365,10 +477,16 @@ INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, UN16 ) \
 INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, UN32 ) \
 INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, UN64 ) \
 INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, FL32 ) \
-INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, FL64 )
+INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, FL64 ) \
+INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, FL16 ) \
+INTERNAL_RETURN_TWO(varDatatype1, varDatatype2, namePrefix, BF16 )
 
 my_function_copy_vector my_datatype_getFunctionCopyVector(
 		const MyDatatype datatype_src, const MyDatatype datatype_dst) {
+	my_function_copy_vector func = priv_getConvertArray(datatype_src,
+			datatype_dst);
+	if (func != NULL)
+		return func;
 	RETURN_TWO_DATATYPES(datatype_src, datatype_dst, copy_vector_)
 	my_log_error("unknown my datatypes codes %i %i\n",
 			datatype_src.my_datatype_code, datatype_dst.my_datatype_code);
@@ -383,17 +501,17 @@ static void copyOperate_vector_##datatypeSrc##_##datatypeDst(void *ptr_vector_sr
 	typeDst *vector_dst = ptr_vector_dst; \
 	size_t numN = dimensions / 4; \
 	while (numN > 0) { \
-		vector_dst[0] = (typeDst) funcOperate((double) vector_src[0]); \
-		vector_dst[1] = (typeDst) funcOperate((double) vector_src[1]); \
-		vector_dst[2] = (typeDst) funcOperate((double) vector_src[2]); \
-		vector_dst[3] = (typeDst) funcOperate((double) vector_src[3]); \
+		vector_dst[0] = STORE_##typeDst(funcOperate((double) LOAD_##typeSrc(vector_src[0]))); \
+		vector_dst[1] = STORE_##typeDst(funcOperate((double) LOAD_##typeSrc(vector_src[1]))); \
+		vector_dst[2] = STORE_##typeDst(funcOperate((double) LOAD_##typeSrc(vector_src[2]))); \
+		vector_dst[3] = STORE_##typeDst(funcOperate((double) LOAD_##typeSrc(vector_src[3]))); \
 		vector_src += 4; \
 		vector_dst += 4; \
 		numN--; \
 	} \
 	size_t numB = dimensions % 4; \
 	while (numB > 0) { \
-		vector_dst[0] = (typeDst) funcOperate((double) vector_src[0]); \
+		vector_dst[0] = STORE_##typeDst(funcOperate((double) LOAD_##typeSrc(vector_src[0]))); \
 		vector_src += 1; \
 		vector_dst += 1; \
 		numB--; \
@@ -53,6 +53,23 @@ extern MyDatatype MY_DATATYPE_FLOAT32;
  * Floating point 64 bits-length. Corresponds to standard C type @c double.
  */
 extern MyDatatype MY_DATATYPE_FLOAT64;
+/**
+ * Floating point 16 bits-length (IEEE 754 half precision). Values are
+ * stored as raw bits in a #my_float16_t.
+ */
+extern MyDatatype MY_DATATYPE_FLOAT16;
+/**
+ * Brain floating point 16 bits-length (the upper half of a @c float). Values
+ * are stored as raw bits in a #my_bfloat16_t.
+ */
+extern MyDatatype MY_DATATYPE_BFLOAT16;
+
+/**
+ * Storage types for #MY_DATATYPE_FLOAT16 and #MY_DATATYPE_BFLOAT16. They must
+ * be converted with my_math_halfToFloat and my_math_bfloat16ToFloat.
+ */
+typedef uint16_t my_float16_t;
+typedef uint16_t my_bfloat16_t;
 
 /**
  * @param datatype
@@ -90,6 +107,8 @@ bool my_datatype_isUInt32(const MyDatatype datatype);
 bool my_datatype_isUInt64(const MyDatatype datatype);
 bool my_datatype_isFloat(const MyDatatype datatype);
 bool my_datatype_isDouble(const MyDatatype datatype);
+bool my_datatype_isFloat16(const MyDatatype datatype);
+bool my_datatype_isBFloat16(const MyDatatype datatype);
 
 bool my_datatype_areEqual(const MyDatatype datatype1,
 		const MyDatatype datatype2);
@@ -201,6 +220,8 @@ my_function_parse_string my_datatype_getFunctionParseVector(
 /**
  * Returns a function that can copy values between any two datatypes.
  * The conversion between different datatypes is resolved by casting values.
+ * Values of #MY_DATATYPE_FLOAT16 and #MY_DATATYPE_BFLOAT16 are converted
+ * through @c float.
  *
  * Basically, the implementation is the following (without considering any validation):
  *
@@ -7,29 +7,67 @@
  */
 
 #include "io_lreader_util.h"
+#include <sys/stat.h>
+#if IS_LINUX
+#include <sys/mman.h>
+#endif
 
+//Regular files are mapped in memory, other inputs (pipes) are read in
+//chunks of buffer_size. In both cases buffer[pos_buffer, buffer_filled)
+//holds the unread bytes and line ends are located with memchr.
 struct MyLineReader {
 	FILE *inFile;
 	char *buffer, *line;
 	bool ignoreComments, eof;
 	int64_t buffer_size, buffer_filled, line_size, pos_buffer;
+	//a line ending in '\r' ('\n') also consumes a following '\n' ('\r')
+	char skip_next;
+	//mapped file: buffer points to the whole file and pos_buffer starts at
+	//the position of inFile when the reader was opened
+	const void *mapped;
+	int64_t mapped_size;
 };
 
+static void priv_mapFile(MyLineReader *reader) {
+#if IS_LINUX
+	struct stat st;
+	int fd = fileno(reader->inFile);
+	if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)
+			|| st.st_size <= 0)
+		return;
+	int64_t start = ftello(reader->inFile);
+	if (start < 0 || start >= st.st_size)
+		return;
+	void *bytes = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (bytes == MAP_FAILED)
+		return;
+	posix_madvise(bytes, st.st_size, POSIX_MADV_SEQUENTIAL);
+	reader->mapped = bytes;
+	reader->mapped_size = st.st_size;
+	reader->buffer = (char*) bytes;
+	reader->pos_buffer = start;
+	reader->buffer_filled = st.st_size;
+#endif
+}
 MyLineReader *my_lreader_open_params(FILE *inFile, int64_t buffer_size) {
 	if (inFile == NULL)
 		return NULL;
 	MyLineReader *reader = MY_MALLOC(1, MyLineReader);
 	reader->inFile = inFile;
 	reader->eof = false;
-	reader->line_size = reader->buffer_size = buffer_size;
-	reader->buffer = MY_MALLOC(reader->buffer_size, char);
-	reader->line = MY_MALLOC(reader->line_size, char);
-	reader->buffer_filled = reader->pos_buffer = 0;
 	reader->ignoreComments = true;
+	reader->line_size = 256;
+	reader->line = MY_MALLOC(reader->line_size, char);
+	priv_mapFile(reader);
+	if (reader->mapped == NULL) {
+		reader->buffer_size = MAX(1, buffer_size);
+		reader->buffer = MY_MALLOC(reader->buffer_size, char);
+		reader->buffer_filled = reader->pos_buffer = 0;
+	}
 	return reader;
 }
 MyLineReader *my_lreader_open(FILE *inFile) {
-	return my_lreader_open_params(inFile, 8192);
+	return my_lreader_open_params(inFile, 1024 * 1024);
 }
 static void verify_header(MyLineReader *reader, const char *software_name,
 		const char *format_file, int64_t major_version, int64_t minor_version) {
@@ -60,57 +98,98 @@ MyLineReader *my_lreader_config_open(FILE *inFile, const char *software_name,
 			minor_version);
 	return reader;
 }
-static void priv_loadBuffer(MyLineReader *reader) {
+//keeps the unread bytes and appends more data, returns false at the end
+static bool priv_loadBuffer(MyLineReader *reader) {
+	if (reader->mapped != NULL)
+		return false;
+	int64_t unread = reader->buffer_filled - reader->pos_buffer;
+	if (unread > 0 && reader->pos_buffer > 0)
+		memmove(reader->buffer, reader->buffer + reader->pos_buffer, unread);
 	reader->pos_buffer = 0;
-	reader->buffer_filled = fread(reader->buffer, sizeof(char),
-			reader->buffer_size, reader->inFile);
-	if (reader->buffer_filled == 0)
-		reader->eof = true;
+	reader->buffer_filled = unread;
+	if (unread == reader->buffer_size) {
+		reader->buffer_size *= 2;
+		MY_REALLOC(reader->buffer, reader->buffer_size, char);
+	}
+	int64_t n = fread(reader->buffer + unread, sizeof(char),
+			reader->buffer_size - unread, reader->inFile);
+	reader->buffer_filled += n;
+	return n > 0;
 }
-static char priv_nextChar(MyLineReader *reader) {
-	if (reader->eof)
-		return '\0';
-	else if (reader->pos_buffer >= reader->buffer_filled)
-		priv_loadBuffer(reader);
+static bool priv_nextLineView(MyLineReader *reader, const char **out_line,
+		int64_t *out_length) {
 	if (reader->eof)
-		return '\0';
-	char c = reader->buffer[reader->pos_buffer];
-	reader->pos_buffer++;
-	return c;
-}
-static void priv_loadNextLineFromBuffer(MyLineReader *reader) {
-	int64_t pos_linea = 0;
-	char c;
-	while ((c = priv_nextChar(reader)) != '\0') {
-		if (c == '\r') {
-			c = priv_nextChar(reader);
-			if (c != '\n' && c != '\0')
-				reader->pos_buffer--;
-			break;
-		} else if (c == '\n') {
-			c = priv_nextChar(reader);
-			if (c != '\r' && c != '\0')
-				reader->pos_buffer--;
-			break;
+		return false;
+	int64_t searched = 0;
+	for (;;) {
+		int64_t unread = reader->buffer_filled - reader->pos_buffer;
+		if (reader->skip_next != '\0' && unread > 0) {
+			if (reader->buffer[reader->pos_buffer] == reader->skip_next) {
+				reader->pos_buffer++;
+				unread--;
+			}
+			reader->skip_next = '\0';
 		}
-		if (pos_linea >= reader->line_size - 1) {
-			reader->line_size++;
-			MY_REALLOC(reader->line, reader->line_size, char);
+		char *start = reader->buffer + reader->pos_buffer;
+		//'\r' is searched only before the first '\n'
+		char *end = memchr(start + searched, '\n', unread - searched);
+		char *end_cr = memchr(start + searched, '\r',
+				((end == NULL) ? unread : end - start) - searched);
+		if (end_cr != NULL)
+			end = end_cr;
+		if (end != NULL) {
+			*out_line = start;
+			*out_length = end - start;
+			reader->skip_next = (*end == '\n') ? '\r' : '\n';
+			reader->pos_buffer += *out_length + 1;
+			return true;
+		}
+		searched = unread;
+		if (!priv_loadBuffer(reader)) {
+			reader->eof = true;
+			if (unread == 0)
+				return false;
+			//last line without line break
+			*out_line = reader->buffer + reader->pos_buffer;
+			*out_length = unread;
+			reader->pos_buffer += unread;
+			return true;
 		}
-		reader->line[pos_linea] = c;
-		pos_linea++;
 	}
-	reader->line[pos_linea] = '\0';
+	return false;
+}
+static bool priv_acceptLine(MyLineReader *reader, const char *line,
+		int64_t length) {
+	return !reader->ignoreComments || (length > 0 && line[0] != '#');
 }
 const char *my_lreader_readLine(MyLineReader *reader) {
 	if (reader == NULL)
 		return NULL;
-	while (!reader->eof) {
-		priv_loadNextLineFromBuffer(reader);
-		if (!reader->ignoreComments
-				|| (reader->ignoreComments && reader->line[0] != '\0'
-						&& reader->line[0] != '#')) {
-			return reader->line;
+	const char *view;
+	int64_t length;
+	while (priv_nextLineView(reader, &view, &length)) {
+		if (!priv_acceptLine(reader, view, length))
+			continue;
+		if (length >= reader->line_size) {
+			reader->line_size = MAX(2 * reader->line_size, length + 1);
+			MY_REALLOC(reader->line, reader->line_size, char);
+		}
+		memcpy(reader->line, view, length);
+		reader->line[length] = '\0';
+		return reader->line;
+	}
+	return NULL;
+}
+const char *my_lreader_readLineView(MyLineReader *reader,
+		int64_t *out_length) {
+	if (reader == NULL)
+		return NULL;
+	const char *view;
+	int64_t length;
+	while (priv_nextLineView(reader, &view, &length)) {
+		if (priv_acceptLine(reader, view, length)) {
+			*out_length = length;
+			return view;
 		}
 	}
 	return NULL;
@@ -125,12 +204,37 @@ const char *my_lreader_readLineOrComment(MyLineReader *reader) {
 char *my_lreader_readLine_newString(MyLineReader *reader) {
 	return my_newString_string(my_lreader_readLine(reader));
 }
+//leaves inFile after the consumed bytes, plus the byte following the last
+//line break (the previous implementation always read it)
+static void priv_restoreFilePosition(MyLineReader *reader) {
+	int64_t extra = (reader->skip_next != '\0') ? 1 : 0;
+	if (reader->mapped != NULL) {
+		fseeko(reader->inFile, reader->pos_buffer + extra, SEEK_SET);
+		return;
+	}
+	int64_t unread = reader->buffer_filled - reader->pos_buffer;
+	if (extra > 0 && unread > 0)
+		unread--;
+	else if (extra > 0)
+		fgetc(reader->inFile);
+	if (unread > 0)
+		fseeko(reader->inFile, -unread, SEEK_CUR);
+}
 void my_lreader_close(MyLineReader *reader, bool close_input_file) {
 	if (reader == NULL)
 		return;
 	if (close_input_file)
 		fclose(reader->inFile);
+	else
+		priv_restoreFilePosition(reader);
+#if IS_LINUX
+	if (reader->mapped != NULL)
+		munmap((void*) reader->mapped, reader->mapped_size);
+	else
+		MY_FREE(reader->buffer);
+#else
 	MY_FREE(reader->buffer);
+#endif
 	MY_FREE(reader->line);
 	MY_FREE(reader);
 }
@@ -20,6 +20,16 @@ MyLineReader *my_lreader_config_open_params(FILE *inFile, int64_t buffer_size,
 		int64_t major_version, int64_t minor_version);
 const char *my_lreader_readLine(MyLineReader *reader);
 const char *my_lreader_readLineOrComment(MyLineReader *reader);
+/**
+ * Same as my_lreader_readLine but the line is returned in place, without
+ * copying it: the line is NOT terminated by '\0' and it is valid until the
+ * next read.
+ * @param reader
+ * @param out_length number of chars in the line
+ * @return NULL at the end of the file
+ */
+const char *my_lreader_readLineView(MyLineReader *reader,
+		int64_t *out_length);
 char *my_lreader_readLine_newString(MyLineReader *reader);
 void my_lreader_close(MyLineReader *reader, bool close_input_file);
 
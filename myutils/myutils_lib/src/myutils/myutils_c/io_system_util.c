@@ -6,8 +6,22 @@
  * MultimediaTools is made available under the terms of the BSD 2-Clause License.
  */
 
+#if defined __linux || defined __linux__
+#ifndef _GNU_SOURCE
+//pipe2
+#define _GNU_SOURCE
+#endif
+#endif
 #include "io_util.h"
 #include <errno.h>
+#if IS_LINUX
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+extern char **environ;
+#endif
 
 MY_MUTEX_NEWSTATIC(mutex_system);
 static bool first = true;
@@ -42,3 +56,167 @@ void my_io_system_setSystemImpl(my_io_system_function system_function) {
 		my_system = system_function;
 	MY_MUTEX_UNLOCK(mutex_system);
 }
+
+struct PipeOutput {
+	char *buffer;
+	int64_t size, capacity;
+};
+static void priv_output_reserve(struct PipeOutput *out, int64_t min_free) {
+	if (out->size + min_free + 1 <= out->capacity)
+		return;
+	out->capacity = MAX(2 * out->capacity, out->size + min_free + 1);
+	MY_REALLOC(out->buffer, out->capacity, char);
+}
+#if IS_LINUX
+static int priv_system_pipe_spawn(const char *command_line, const char *input,
+		int64_t input_size, struct PipeOutput *out) {
+	//stdin is a socket to write with MSG_NOSIGNAL (no SIGPIPE if the command ends)
+	//other commands executed in parallel must not inherit these descriptors,
+	//then close-on-exec is set atomically at creation
+	int fd_in[2], fd_out[2];
+#if defined SOCK_CLOEXEC && defined O_CLOEXEC
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fd_in) != 0)
+		return -1;
+	if (pipe2(fd_out, O_CLOEXEC) != 0) {
+		close(fd_in[0]);
+		close(fd_in[1]);
+		return -1;
+	}
+#else
+	//a command spawned by another thread between creation and fcntl may
+	//inherit them
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd_in) != 0)
+		return -1;
+	if (pipe(fd_out) != 0) {
+		close(fd_in[0]);
+		close(fd_in[1]);
+		return -1;
+	}
+	fcntl(fd_in[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fd_in[1], F_SETFD, FD_CLOEXEC);
+	fcntl(fd_out[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fd_out[1], F_SETFD, FD_CLOEXEC);
+#endif
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, fd_in[1], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, fd_out[1], STDOUT_FILENO);
+	posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null",
+	O_WRONLY, 0);
+	char *argv[] = { "sh", "-c", (char*) command_line, NULL };
+	pid_t pid;
+	int ret = posix_spawn(&pid, "/bin/sh", &actions, NULL, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	close(fd_in[1]);
+	close(fd_out[1]);
+	if (ret != 0) {
+		close(fd_in[0]);
+		close(fd_out[0]);
+		return -1;
+	}
+	int64_t written = 0;
+	if (input_size <= 0)
+		shutdown(fd_in[0], SHUT_WR);
+	bool input_open = (input_size > 0), output_open = true;
+	while (output_open) {
+		struct pollfd fds[2] = { { 0 } };
+		int nfds = 0;
+		fds[nfds].fd = fd_out[0];
+		fds[nfds++].events = POLLIN;
+		if (input_open) {
+			fds[nfds].fd = fd_in[0];
+			fds[nfds++].events = POLLOUT;
+		}
+		if (poll(fds, nfds, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (input_open && fds[1].revents != 0) {
+			ssize_t n = send(fd_in[0], input + written, input_size - written,
+			MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (n > 0)
+				written += n;
+			if ((n < 0 && errno != EAGAIN && errno != EINTR)
+					|| written == input_size) {
+				shutdown(fd_in[0], SHUT_WR);
+				input_open = false;
+			}
+		}
+		if (fds[0].revents != 0) {
+			priv_output_reserve(out, 64 * 1024);
+			ssize_t n = read(fd_out[0], out->buffer + out->size,
+					out->capacity - out->size - 1);
+			if (n > 0)
+				out->size += n;
+			else if (n == 0 || errno != EINTR)
+				output_open = false;
+		}
+	}
+	close(fd_in[0]);
+	close(fd_out[0]);
+	int status = 0;
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR)
+			return -1;
+	}
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+#endif
+//uses temporal files and my_io_system, thus the command is executed by the
+//system implementation
+static int priv_system_pipe_files(const char *command_line, const char *input,
+		int64_t input_size, struct PipeOutput *out) {
+	char *fileIn = my_io_temp_createNewFile(".in");
+	char *fileOut = my_io_temp_createNewFile(".out");
+	my_io_saveBytesFile(fileIn, input, MAX(0, input_size));
+	char *cmd = my_newString_format("%s < %s > %s 2> %s", command_line, fileIn,
+			fileOut, IS_WINDOWS ? "NUL" : "/dev/null");
+	int exitCode = my_io_system(cmd);
+	if (my_io_existsFile(fileOut)) {
+		int64_t size = 0;
+		char *bytes = my_io_loadFileBytes(fileOut, &size);
+		priv_output_reserve(out, size);
+		memcpy(out->buffer + out->size, bytes, size);
+		out->size += size;
+		MY_FREE(bytes);
+	}
+	my_io_deleteFile(fileIn, false);
+	my_io_deleteFile(fileOut, false);
+	MY_FREE_MULTI(fileIn, fileOut, cmd);
+	return exitCode;
+}
+static my_io_system_pipe_function my_system_pipe = NULL;
+
+void my_io_system_setPipeImpl(my_io_system_pipe_function pipe_function) {
+	MY_MUTEX_LOCK(mutex_system);
+	my_system_pipe = pipe_function;
+	MY_MUTEX_UNLOCK(mutex_system);
+}
+int my_io_system_pipe(const char *command_line, const void *input,
+		int64_t input_size, char **out_output, int64_t *out_output_size) {
+	if (my_system_pipe != NULL)
+		return my_system_pipe(command_line, input, input_size, out_output,
+				out_output_size);
+	struct PipeOutput out = { 0 };
+	int exitCode;
+#if IS_LINUX
+	//a system implementation set by the user also executes the pipes
+	if (my_system == my_io_system_sequential)
+		exitCode = priv_system_pipe_spawn(command_line, input, input_size,
+				&out);
+	else
+		exitCode = priv_system_pipe_files(command_line, input, input_size,
+				&out);
+#else
+	exitCode = priv_system_pipe_files(command_line, input, input_size, &out);
+#endif
+	if (exitCode != 0)
+		my_log_info("system exit_code=%i: %s\n", exitCode, command_line);
+	priv_output_reserve(&out, 0);
+	out.buffer[out.size] = '\0';
+	*out_output = out.buffer;
+	if (out_output_size != NULL)
+		*out_output_size = out.size;
+	return exitCode;
+}
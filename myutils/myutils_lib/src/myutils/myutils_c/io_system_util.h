@@ -24,4 +24,30 @@ int my_io_system(const char *command_line);
 //(default system may throw segmentation fault if it is called in parallel)
 void my_io_system_setSystemImpl(my_io_system_function system_function);
 
+typedef int (*my_io_system_pipe_function)(const char *command_line,
+		const void *input, int64_t input_size, char **out_output,
+		int64_t *out_output_size);
+
+/**
+ * Replaces the implementation of my_io_system_pipe (NULL restores the
+ * default). When it is not set and a system implementation was set with
+ * my_io_system_setSystemImpl, the pipe uses temporal files and that
+ * implementation.
+ */
+void my_io_system_setPipeImpl(my_io_system_pipe_function pipe_function);
+
+/**
+ * Executes a command line (using the shell) writing @p input into its
+ * standard input and returning its standard output. The standard error
+ * is discarded. Unlike "system" it may be called in parallel.
+ * @param command_line
+ * @param input bytes to write into standard input (may be NULL)
+ * @param input_size
+ * @param out_output the standard output (it is NUL-terminated). It must be released.
+ * @param out_output_size number of bytes in standard output (may be NULL)
+ * @return the exit code of the command, -1 if it could not be executed.
+ */
+int my_io_system_pipe(const char *command_line, const void *input,
+		int64_t input_size, char **out_output, int64_t *out_output_size);
+
 #endif
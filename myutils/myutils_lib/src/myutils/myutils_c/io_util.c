@@ -9,6 +9,10 @@
 #include "io_util.h"
 #include <sys/stat.h>
 #include <dirent.h>
+#if IS_LINUX
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
 
 //hay que hacer free de lo retornado
 char *my_io_getFilename(const char* filePath) {
@@ -253,6 +257,129 @@ void* my_io_loadFileBytes(const char *filename, int64_t *out_filesize) {
 		*out_filesize = filesize;
 	return bytes;
 }
+const void* my_io_mapFileRead(const char *filename, int64_t *out_filesize,
+bool failOnError) {
+#if IS_LINUX
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		if (failOnError)
+			my_log_error("can't open %s\n", filename);
+		return NULL;
+	}
+	struct stat st;
+	void *bytes = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+		bytes = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (bytes == MAP_FAILED) {
+		if (failOnError)
+			my_log_error("can't map %s\n", filename);
+		return NULL;
+	}
+	if (out_filesize != NULL)
+		*out_filesize = st.st_size;
+	return bytes;
+#else
+	if (!my_io_existsFile(filename)) {
+		if (failOnError)
+			my_log_error("can't open %s\n", filename);
+		return NULL;
+	}
+	return my_io_loadFileBytes(filename, out_filesize);
+#endif
+}
+void my_io_unmapFile(const void *bytes, int64_t filesize) {
+	if (bytes == NULL)
+		return;
+#if IS_LINUX
+	munmap((void*) bytes, filesize);
+#else
+	MY_FREE(bytes);
+#endif
+}
+
+struct MyBlockReader {
+	int64_t filesize;
+#if IS_LINUX
+	int fd;
+#else
+	FILE *in;
+	pthread_mutex_t mutex;
+#endif
+};
+MyBlockReader *my_io_blockReader_open(const char *filename, bool failOnError) {
+#if IS_LINUX
+	int fd = open(filename, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		if (fd >= 0)
+			close(fd);
+		if (failOnError)
+			my_log_error("can't open %s\n", filename);
+		return NULL;
+	}
+	MyBlockReader *reader = MY_MALLOC(1, MyBlockReader);
+	reader->fd = fd;
+	reader->filesize = st.st_size;
+#else
+	FILE *in = my_io_openFileRead1(filename, failOnError);
+	if (in == NULL)
+		return NULL;
+	MyBlockReader *reader = MY_MALLOC(1, MyBlockReader);
+	reader->in = in;
+	reader->filesize = my_io_getFilesize2(in);
+	MY_MUTEX_INIT(reader->mutex);
+#endif
+	return reader;
+}
+int64_t my_io_blockReader_getFilesize(MyBlockReader *reader) {
+	return reader->filesize;
+}
+void my_io_blockReader_read(MyBlockReader *reader, int64_t offset,
+		void *buffer, int64_t numBytes) {
+	if (offset < 0 || numBytes < 0 || offset + numBytes > reader->filesize)
+		my_log_error(
+				"invalid block %"PRIi64"+%"PRIi64" (file size %"PRIi64")\n",
+				offset, numBytes, reader->filesize);
+#if IS_LINUX
+	char *ptr = buffer;
+	while (numBytes > 0) {
+		ssize_t n = pread(reader->fd, ptr, numBytes, offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			my_log_error("error reading block at %"PRIi64" (errno=%i)\n",
+					offset, errno);
+		ptr += n;
+		offset += n;
+		numBytes -= n;
+	}
+#else
+	MY_MUTEX_LOCK(reader->mutex);
+	if (fseeko(reader->in, offset, SEEK_SET) != 0)
+		my_log_error("can't seek to %"PRIi64"\n", offset);
+	my_io_readBytesFile(reader->in, buffer, numBytes, false);
+	MY_MUTEX_UNLOCK(reader->mutex);
+#endif
+}
+void my_io_blockReader_willNeed(MyBlockReader *reader, int64_t offset,
+		int64_t numBytes) {
+#if IS_LINUX && defined(POSIX_FADV_WILLNEED)
+	if (numBytes > 0)
+		posix_fadvise(reader->fd, offset, numBytes, POSIX_FADV_WILLNEED);
+#endif
+}
+void my_io_blockReader_close(MyBlockReader *reader) {
+	if (reader == NULL)
+		return;
+#if IS_LINUX
+	close(reader->fd);
+#else
+	fclose(reader->in);
+	MY_MUTEX_DESTROY(reader->mutex);
+#endif
+	MY_FREE(reader);
+}
 
 bool my_io_deleteFile(const char* filename, bool fail) {
 	if (!my_io_existsFile(filename)) {
@@ -369,6 +496,20 @@ int64_t my_io_getFilesize2(FILE *file) {
 	my_log_error("could not get filesize\n");
 	return -1;
 }
+int64_t my_io_getModificationTime(const char* filename) {
+	struct stat st;
+	if (stat(filename, &st) != 0)
+		return -1;
+	//nanoseconds, a file rewritten within the same second must differ
+#if IS_LINUX
+	return st.st_mtim.tv_sec * INT64_C(1000000000) + st.st_mtim.tv_nsec;
+#elif defined __APPLE__
+	return st.st_mtimespec.tv_sec * INT64_C(1000000000)
+			+ st.st_mtimespec.tv_nsec;
+#else
+	return st.st_mtime * INT64_C(1000000000);
+#endif
+}
 void my_io_createDir(const char *path, bool fail) {
 	if (
 #if IS_WINDOWS
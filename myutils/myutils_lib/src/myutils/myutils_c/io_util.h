@@ -48,6 +48,36 @@ char *my_io_getConfigFileHeader(const char *software_name,
 void my_io_readBytesFile(FILE *in, void *buffer, int64_t numBytes,
 bool validateEOF);
 void* my_io_loadFileBytes(const char *filename, int64_t *out_filesize);
+/**
+ * Maps the whole file read-only in memory (mmap). Systems without mmap
+ * load the file with my_io_loadFileBytes.
+ * @param filename
+ * @param out_filesize the size of the mapping
+ * @param failOnError
+ * @return NULL when the file can't be mapped and @p failOnError is false.
+ */
+const void* my_io_mapFileRead(const char *filename, int64_t *out_filesize,
+bool failOnError);
+void my_io_unmapFile(const void *bytes, int64_t filesize);
+
+/**
+ * Reads blocks at any offset of a file kept open (pread). Reads do not share
+ * a file position, thus one reader can be used by several threads.
+ * @param filename
+ * @param failOnError
+ * @return NULL when the file can't be opened and @p failOnError is false.
+ */
+MyBlockReader *my_io_blockReader_open(const char *filename, bool failOnError);
+int64_t my_io_blockReader_getFilesize(MyBlockReader *reader);
+void my_io_blockReader_read(MyBlockReader *reader, int64_t offset,
+		void *buffer, int64_t numBytes);
+/**
+ * Announces that the range will be read soon, the system can start reading
+ * it in background (posix_fadvise). It may do nothing.
+ */
+void my_io_blockReader_willNeed(MyBlockReader *reader, int64_t offset,
+		int64_t numBytes);
+void my_io_blockReader_close(MyBlockReader *reader);
 bool my_io_deleteFile(const char* filename, bool fail);
 bool my_io_moveFile(const char* filenameOrig, const char* filenameDest, bool fail);
 void my_io_copyFile(const char* filenameOrig, const char* filenameDest);
@@ -58,6 +88,11 @@ bool my_io_notExists(const char* filename);
 bool my_io_notExists2(const char *path, const char* file);
 int64_t my_io_getFilesize(const char* filename);
 int64_t my_io_getFilesize2(FILE *file);
+/**
+ * @param filename
+ * @return last modification time (nanoseconds since epoch, with the resolution of the file system), or -1 if the file does not exist.
+ */
+int64_t my_io_getModificationTime(const char* filename);
 void my_io_createDir(const char *path, bool fail);
 void my_io_createParentDir(const char *file_path);
 
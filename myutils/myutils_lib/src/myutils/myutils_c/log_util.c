@@ -7,6 +7,9 @@
  */
 
 #include "log_util.h"
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
 
 MY_MUTEX_NEWSTATIC(priv_log_mutex);
 
@@ -24,12 +27,223 @@ static void my_log_forceExit() {
 
 static void (*func_onError)() = my_log_forceExit;
 
+//asynchronous mode: every thread formats its messages into its own ring
+//(single producer, single consumer) and a background thread writes them.
+//Threads only wait when their ring is full.
+#define ASYNC_RING_SIZE (1 << 16)
+#define ASYNC_MESSAGE_SIZE 1024
+#define ASYNC_WRITER_SLEEP_NS 10000000
+
+struct LogRing {
+	char buffer[ASYNC_RING_SIZE];
+	uint64_t head, tail;
+	//rings of finished threads are reused by new threads
+	bool in_use;
+	struct LogRing *next;
+};
+static struct LogRing *async_rings = NULL;
+static bool async_enabled = false, async_running = false;
+static pthread_t async_writer;
+static pthread_key_t async_key;
+static __thread struct LogRing *thread_ring = NULL;
+MY_MUTEX_NEWSTATIC(priv_drain_mutex);
+//only used by the writer to sleep, threads signal it without locking
+MY_MUTEX_NEWSTATIC(priv_writer_mutex);
+static pthread_cond_t priv_writer_cond = PTHREAD_COND_INITIALIZER;
+
 static void my_log_default_init() {
 	setvbuf(stdin, NULL, _IONBF, 0);
 	setvbuf(stdout, NULL, _IONBF, 0);
 	setvbuf(stderr, NULL, _IONBF, 0);
 	INIT_LOG = 1;
 }
+static void priv_writeAll(int fd, const char *buffer, size_t length) {
+	while (length > 0) {
+		ssize_t n = write(fd, buffer, length);
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR)
+				continue;
+			return;
+		}
+		buffer += n;
+		length -= n;
+	}
+}
+//called holding priv_drain_mutex
+static void priv_writeOutputs(const char *buffer, size_t length) {
+	if (WITH_LOG_TO_STDOUT)
+		priv_writeAll(STDOUT_FILENO, buffer, length);
+	if (priv_file_log != NULL)
+		priv_writeAll(fileno(priv_file_log), buffer, length);
+}
+static int64_t priv_drainRings() {
+	int64_t total = 0;
+	for (struct LogRing *ring = __atomic_load_n(&async_rings, __ATOMIC_ACQUIRE);
+			ring != NULL; ring = ring->next) {
+		uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		uint64_t tail = ring->tail;
+		if (head == tail)
+			continue;
+		uint64_t pos = tail % ASYNC_RING_SIZE;
+		uint64_t length = head - tail;
+		uint64_t first = MIN(length, ASYNC_RING_SIZE - pos);
+		priv_writeOutputs(ring->buffer + pos, first);
+		if (first < length)
+			priv_writeOutputs(ring->buffer, length - first);
+		__atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+		total += length;
+	}
+	return total;
+}
+static void *priv_asyncWriter(void *param) {
+	while (__atomic_load_n(&async_running, __ATOMIC_ACQUIRE)) {
+		MY_MUTEX_LOCK(priv_drain_mutex);
+		int64_t n = priv_drainRings();
+		MY_MUTEX_UNLOCK(priv_drain_mutex);
+		if (n == 0) {
+			struct timespec to = { 0 };
+			clock_gettime(CLOCK_REALTIME, &to);
+			to.tv_nsec += ASYNC_WRITER_SLEEP_NS;
+			if (to.tv_nsec >= 1000000000) {
+				to.tv_sec++;
+				to.tv_nsec -= 1000000000;
+			}
+			MY_MUTEX_LOCK(priv_writer_mutex);
+			pthread_cond_timedwait(&priv_writer_cond, &priv_writer_mutex, &to);
+			MY_MUTEX_UNLOCK(priv_writer_mutex);
+		}
+	}
+	return NULL;
+}
+static void priv_releaseThreadRing(void *ptr) {
+	struct LogRing *ring = ptr;
+	__atomic_store_n(&ring->in_use, false, __ATOMIC_RELEASE);
+}
+static struct LogRing *priv_getThreadRing() {
+	if (thread_ring != NULL)
+		return thread_ring;
+	struct LogRing *ring = __atomic_load_n(&async_rings, __ATOMIC_ACQUIRE);
+	for (; ring != NULL; ring = ring->next) {
+		bool expected = false;
+		if (__atomic_compare_exchange_n(&ring->in_use, &expected, true, false,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			break;
+	}
+	if (ring == NULL) {
+		ring = MY_MALLOC(1, struct LogRing);
+		ring->in_use = true;
+		ring->next = __atomic_load_n(&async_rings, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&async_rings, &ring->next, ring,
+				false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+			;
+	}
+	pthread_setspecific(async_key, ring);
+	thread_ring = ring;
+	return ring;
+}
+static void priv_pushRing(const char *message, uint64_t length) {
+	struct LogRing *ring = priv_getThreadRing();
+	while (length > 0) {
+		uint64_t chunk = MIN(length, ASYNC_RING_SIZE / 2);
+		uint64_t head = ring->head;
+		//waits for the writer when the ring is full
+		while (ASYNC_RING_SIZE
+				- (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+				< chunk) {
+			pthread_cond_signal(&priv_writer_cond);
+			sched_yield();
+		}
+		uint64_t pos = head % ASYNC_RING_SIZE;
+		uint64_t first = MIN(chunk, ASYNC_RING_SIZE - pos);
+		memcpy(ring->buffer + pos, message, first);
+		if (first < chunk)
+			memcpy(ring->buffer, message + first, chunk - first);
+		__atomic_store_n(&ring->head, head + chunk, __ATOMIC_RELEASE);
+		//wakes up the writer before the ring gets full
+		if (head + chunk - __atomic_load_n(&ring->tail, __ATOMIC_RELAXED)
+				> ASYNC_RING_SIZE / 2)
+			pthread_cond_signal(&priv_writer_cond);
+		message += chunk;
+		length -= chunk;
+	}
+}
+static void priv_asyncLog(const char *prefix, const char *fmt, va_list args) {
+	char stack_buffer[ASYNC_MESSAGE_SIZE];
+	int len_prefix = (prefix == NULL) ? 0 : strlen(prefix);
+	if (len_prefix >= ASYNC_MESSAGE_SIZE / 2) {
+		priv_pushRing(prefix, len_prefix);
+		len_prefix = 0;
+	} else if (len_prefix > 0) {
+		memcpy(stack_buffer, prefix, len_prefix);
+	}
+	va_list args_copy;
+	va_copy(args_copy, args);
+	int len = vsnprintf(stack_buffer + len_prefix,
+	ASYNC_MESSAGE_SIZE - len_prefix, fmt, args);
+	if (len < 0) {
+		va_end(args_copy);
+		return;
+	}
+	if (len < ASYNC_MESSAGE_SIZE - len_prefix) {
+		priv_pushRing(stack_buffer, len_prefix + len);
+	} else {
+		char *buffer = MY_MALLOC_NOINIT(len_prefix + len + 1, char);
+		memcpy(buffer, stack_buffer, len_prefix);
+		vsnprintf(buffer + len_prefix, len + 1, fmt, args_copy);
+		priv_pushRing(buffer, len_prefix + len);
+		MY_FREE(buffer);
+	}
+	va_end(args_copy);
+}
+static void priv_signalHandler(int sig) {
+	//best effort, other threads may be stopped in any state
+	if (__atomic_load_n(&async_enabled, __ATOMIC_ACQUIRE))
+		priv_drainRings();
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+//keeps SIG_IGN when it was inherited (e.g. processes started with nohup)
+static void priv_installSignalHandler(int sig) {
+	struct sigaction current;
+	if (sigaction(sig, NULL, &current) == 0 && current.sa_handler == SIG_IGN)
+		return;
+	signal(sig, priv_signalHandler);
+}
+static void priv_atExit() {
+	my_log_setAsync(false);
+}
+void my_log_setAsync(bool async) {
+	static bool handlers_installed = false;
+	if (async && !async_enabled) {
+		if (!INIT_LOG)
+			my_log_default_init();
+		if (!handlers_installed) {
+			int ret = pthread_key_create(&async_key, priv_releaseThreadRing);
+			my_assert_equalInt("pthread_key_create", ret, 0);
+			atexit(priv_atExit);
+			priv_installSignalHandler(SIGABRT);
+			priv_installSignalHandler(SIGSEGV);
+			priv_installSignalHandler(SIGTERM);
+			priv_installSignalHandler(SIGINT);
+			handlers_installed = true;
+		}
+		__atomic_store_n(&async_running, true, __ATOMIC_RELEASE);
+		int ret = pthread_create(&async_writer, NULL, priv_asyncWriter, NULL);
+		my_assert_equalInt("pthread_create", ret, 0);
+		__atomic_store_n(&async_enabled, true, __ATOMIC_RELEASE);
+	} else if (!async && async_enabled) {
+		__atomic_store_n(&async_enabled, false, __ATOMIC_RELEASE);
+		__atomic_store_n(&async_running, false, __ATOMIC_RELEASE);
+		int ret = pthread_join(async_writer, NULL);
+		my_assert_equalInt("pthread_join", ret, 0);
+		my_log_flush();
+	}
+}
+void my_log_flush() {
+	MY_MUTEX_LOCK(priv_drain_mutex);
+	priv_drainRings();
+	MY_MUTEX_UNLOCK(priv_drain_mutex);
+}
 void my_log_noOutputStdout() {
 	MY_MUTEX_LOCK(priv_log_mutex);
 	if (!INIT_LOG)
@@ -44,25 +258,40 @@ void my_log_setErrorFunction(void (*func_executeOnError)()) {
 	func_onError = func_executeOnError;
 	MY_MUTEX_UNLOCK(priv_log_mutex);
 }
+//the file is replaced or closed holding priv_drain_mutex, the writer thread
+//only reads priv_file_log while holding it
 void my_log_setOutputFile(FILE *out) {
 	MY_MUTEX_LOCK(priv_log_mutex);
 	if (!INIT_LOG)
 		my_log_default_init();
+	MY_MUTEX_LOCK(priv_drain_mutex);
+	priv_drainRings();
 	priv_file_log = out;
 	setvbuf(priv_file_log, NULL, _IONBF, 0);
+	MY_MUTEX_UNLOCK(priv_drain_mutex);
 	MY_MUTEX_UNLOCK(priv_log_mutex);
 }
 void my_log_closeOutputFile() {
 	MY_MUTEX_LOCK(priv_log_mutex);
 	if (!INIT_LOG)
 		my_log_default_init();
+	MY_MUTEX_LOCK(priv_drain_mutex);
+	priv_drainRings();
 	if (priv_file_log != NULL) {
 		fclose(priv_file_log);
 		priv_file_log = NULL;
 	}
+	MY_MUTEX_UNLOCK(priv_drain_mutex);
 	MY_MUTEX_UNLOCK(priv_log_mutex);
 }
 void my_log_info(char* fmt, ...) {
+	if (__atomic_load_n(&async_enabled, __ATOMIC_ACQUIRE)) {
+		va_list args;
+		va_start(args, fmt);
+		priv_asyncLog(NULL, fmt, args);
+		va_end(args);
+		return;
+	}
 	MY_MUTEX_LOCK(priv_log_mutex);
 	if (!INIT_LOG)
 		my_log_default_init();
@@ -81,6 +310,17 @@ void my_log_info(char* fmt, ...) {
 	MY_MUTEX_UNLOCK(priv_log_mutex);
 }
 void my_log_info_time(char* fmt, ...) {
+	if (__atomic_load_n(&async_enabled, __ATOMIC_ACQUIRE)) {
+		char *time_buff = my_timer_currentClock_newString();
+		char prefix[64];
+		snprintf(prefix, sizeof(prefix), "[%s] ", time_buff);
+		MY_FREE(time_buff);
+		va_list args;
+		va_start(args, fmt);
+		priv_asyncLog(prefix, fmt, args);
+		va_end(args);
+		return;
+	}
 	MY_MUTEX_LOCK(priv_log_mutex);
 	if (!INIT_LOG)
 		my_log_default_init();
@@ -103,6 +343,8 @@ void my_log_info_time(char* fmt, ...) {
 	MY_MUTEX_UNLOCK(priv_log_mutex);
 }
 void my_log_error(char* fmt, ...) {
+	//pending messages are written before the error
+	my_log_flush();
 	MY_MUTEX_LOCK(priv_log_mutex);
 	if (!INIT_LOG)
 		my_log_default_init();
@@ -19,6 +19,18 @@ void my_log_info(char* fmt, ...) __attribute__ ((format (printf, 1, 2)));
 void my_log_info_time(char* fmt, ...) __attribute__ ((format (printf, 1, 2)));
 void my_log_error(char* fmt, ...) __attribute__ ((format (printf, 1, 2)));
 
+/**
+ * Enables or disables the asynchronous mode. In asynchronous mode
+ * my_log_info and my_log_info_time do not take locks nor write, the messages
+ * are copied to a buffer of the calling thread and written by a background
+ * thread. Messages of the same thread keep their order.
+ * Pending messages are written by my_log_flush, my_log_error, on exit and
+ * when the process receives SIGABRT, SIGSEGV, SIGTERM or SIGINT.
+ * @param async
+ */
+void my_log_setAsync(bool async);
+void my_log_flush();
+
 void my_log_setOutputFile(FILE *out);
 void my_log_closeOutputFile();
 
@@ -100,6 +100,204 @@ my_math_computeStats_addSample my_math_computeStats_getAddSampleFunction(
 	return NULL;
 }
 
+//samples accumulated by a thread between two merges
+#define BLOCK_SAMPLES 256
+//side of the square tiles of the co-moment matrix
+#define BLOCK_DIMS 64
+
+struct PartialStats {
+	int64_t num_samples;
+	double *min, *max, *avg;
+	//sum (x_i-avg_i)*(x_j-avg_j), only the upper triangle (j>=i) is used
+	double *comoment;
+	//one block of samples in double, plus one row for the merge
+	double *block, *block_avg;
+};
+struct AddSamplesState {
+	int64_t num_dimensions;
+	void **samples;
+	my_function_copy_vector func_copy;
+	struct PartialStats *partials;
+};
+
+static void partial_init(struct PartialStats *ps, int64_t num_dimensions) {
+	ps->min = MY_MALLOC_NOINIT(num_dimensions, double);
+	ps->max = MY_MALLOC_NOINIT(num_dimensions, double);
+	ps->avg = MY_MALLOC(num_dimensions, double);
+	ps->comoment = MY_MALLOC(num_dimensions * num_dimensions, double);
+	ps->block = MY_MALLOC_NOINIT((BLOCK_SAMPLES + 1) * num_dimensions, double);
+	ps->block_avg = MY_MALLOC_NOINIT(num_dimensions, double);
+}
+static void partial_release(struct PartialStats *ps) {
+	MY_FREE_MULTI(ps->min, ps->max, ps->avg, ps->comoment, ps->block,
+			ps->block_avg);
+}
+//comoment += block^T * block, computed by tiles to reuse the cache
+static void accumulate_comoment(double *comoment, double *block,
+		int64_t num_rows, int64_t num_dimensions) {
+	for (int64_t ti = 0; ti < num_dimensions; ti += BLOCK_DIMS) {
+		int64_t ti_end = MIN(ti + BLOCK_DIMS, num_dimensions);
+		for (int64_t tj = ti; tj < num_dimensions; tj += BLOCK_DIMS) {
+			int64_t tj_end = MIN(tj + BLOCK_DIMS, num_dimensions);
+			int64_t r = 0;
+			//four rows at a time, to load and store the tile less often
+			for (; r + 4 <= num_rows; r += 4) {
+				double *row0 = block + r * num_dimensions;
+				double *row1 = row0 + num_dimensions;
+				double *row2 = row1 + num_dimensions;
+				double *row3 = row2 + num_dimensions;
+				for (int64_t i = ti; i < ti_end; ++i) {
+					double v0 = row0[i], v1 = row1[i], v2 = row2[i], v3 =
+							row3[i];
+					double *com = comoment + i * num_dimensions;
+					for (int64_t j = MAX(i, tj); j < tj_end; ++j)
+						com[j] += v0 * row0[j] + v1 * row1[j] + v2 * row2[j]
+								+ v3 * row3[j];
+				}
+			}
+			for (; r < num_rows; ++r) {
+				double *row = block + r * num_dimensions;
+				for (int64_t i = ti; i < ti_end; ++i) {
+					double value_i = row[i];
+					double *com = comoment + i * num_dimensions;
+					for (int64_t j = MAX(i, tj); j < tj_end; ++j)
+						com[j] += value_i * row[j];
+				}
+			}
+		}
+	}
+}
+static void addSamples_thread(int64_t start_process,
+		int64_t end_process_notIncluded, void *state_object, MyProgress *lt,
+		int64_t current_thread) {
+	struct AddSamplesState *state = state_object;
+	struct PartialStats *ps = state->partials + current_thread;
+	int64_t dims = state->num_dimensions;
+	int64_t num_rows = end_process_notIncluded - start_process;
+	if (ps->comoment == NULL)
+		partial_init(ps, dims);
+	for (int64_t r = 0; r < num_rows; ++r) {
+		double *row = ps->block + r * dims;
+		state->func_copy(state->samples[start_process + r], row, dims);
+		for (int64_t i = 0; i < dims; ++i) {
+			if ((ps->num_samples == 0 && r == 0) || row[i] < ps->min[i])
+				ps->min[i] = row[i];
+			if ((ps->num_samples == 0 && r == 0) || row[i] > ps->max[i])
+				ps->max[i] = row[i];
+		}
+	}
+	//two-pass over the block: average first, then centered co-moments
+	for (int64_t i = 0; i < dims; ++i)
+		ps->block_avg[i] = 0;
+	for (int64_t r = 0; r < num_rows; ++r) {
+		double *row = ps->block + r * dims;
+		for (int64_t i = 0; i < dims; ++i)
+			ps->block_avg[i] += row[i];
+	}
+	for (int64_t i = 0; i < dims; ++i)
+		ps->block_avg[i] /= num_rows;
+	for (int64_t r = 0; r < num_rows; ++r) {
+		double *row = ps->block + r * dims;
+		for (int64_t i = 0; i < dims; ++i)
+			row[i] -= ps->block_avg[i];
+	}
+	//Chan et al. merge with the accumulated moments: the correction term
+	//delta*delta^T*n_a*n_b/n is added as one extra row of the block
+	int64_t n = ps->num_samples + num_rows;
+	if (ps->num_samples > 0) {
+		double *row = ps->block + num_rows * dims;
+		double factor = sqrt(ps->num_samples * (double) num_rows / n);
+		for (int64_t i = 0; i < dims; ++i)
+			row[i] = (ps->block_avg[i] - ps->avg[i]) * factor;
+		accumulate_comoment(ps->comoment, ps->block, num_rows + 1, dims);
+	} else {
+		accumulate_comoment(ps->comoment, ps->block, num_rows, dims);
+	}
+	for (int64_t i = 0; i < dims; ++i)
+		ps->avg[i] += (ps->block_avg[i] - ps->avg[i]) * num_rows / n;
+	ps->num_samples = n;
+	if (lt != NULL)
+		my_progress_addN(lt, num_rows);
+}
+static void merge_partials(struct PartialStats *ps, struct PartialStats *ps2,
+		int64_t dims) {
+	if (ps2->num_samples == 0)
+		return;
+	if (ps->num_samples == 0) {
+		struct PartialStats tmp = *ps;
+		*ps = *ps2;
+		*ps2 = tmp;
+		return;
+	}
+	int64_t n = ps->num_samples + ps2->num_samples;
+	double factor = ps->num_samples * (double) ps2->num_samples / n;
+	double *delta = ps->block_avg;
+	for (int64_t i = 0; i < dims; ++i)
+		delta[i] = ps2->avg[i] - ps->avg[i];
+	for (int64_t i = 0; i < dims; ++i) {
+		double *com = ps->comoment + i * dims;
+		double *com2 = ps2->comoment + i * dims;
+		for (int64_t j = i; j < dims; ++j)
+			com[j] += com2[j] + delta[i] * delta[j] * factor;
+		ps->avg[i] += delta[i] * ps2->num_samples / n;
+		ps->min[i] = MIN(ps->min[i], ps2->min[i]);
+		ps->max[i] = MAX(ps->max[i], ps2->max[i]);
+	}
+	ps->num_samples = n;
+}
+static void merge_into_compute(struct MyDataStatsCompute *dsc,
+		struct PartialStats *ps) {
+	if (ps->num_samples == 0)
+		return;
+	int64_t dims = dsc->num_dimensions;
+	int64_t n = dsc->cont_samples + ps->num_samples;
+	double factor = dsc->cont_samples * (double) ps->num_samples / n;
+	double *delta = ps->block_avg;
+	for (int64_t i = 0; i < dims; ++i)
+		delta[i] = ps->avg[i] - dsc->stats_by_dimension[i].avg;
+	for (int64_t i = 0; i < dims; ++i) {
+		struct DataStats *dim_stats = dsc->stats_by_dimension + i;
+		double *com = ps->comoment + i * dims;
+		dim_stats->sum_diffs += com[i] + delta[i] * delta[i] * factor;
+		for (int64_t j = i + 1; j < dims; ++j)
+			dim_stats->sum_codiff[j] += com[j] + delta[i] * delta[j] * factor;
+		dim_stats->avg += delta[i] * ps->num_samples / n;
+		if (dsc->cont_samples == 0 || ps->min[i] < dim_stats->min)
+			dim_stats->min = ps->min[i];
+		if (dsc->cont_samples == 0 || ps->max[i] > dim_stats->max)
+			dim_stats->max = ps->max[i];
+	}
+	dsc->cont_samples = n;
+}
+void my_math_computeStats_addSamples(struct MyDataStatsCompute *dsc,
+		int64_t num_samples, void **samples, MyDatatype dtype_vector,
+		int64_t max_threads) {
+	if (num_samples <= 0)
+		return;
+	int64_t num_blocks = my_math_ceil_int(num_samples / (double) BLOCK_SAMPLES);
+	if (max_threads <= 0)
+		max_threads = my_parallel_getNumberOfCores();
+	int64_t num_threads = MAX(1, MIN(max_threads, num_blocks));
+	struct AddSamplesState state = { 0 };
+	state.num_dimensions = dsc->num_dimensions;
+	state.samples = samples;
+	state.func_copy = my_datatype_getFunctionCopyVector(dtype_vector,
+			MY_DATATYPE_FLOAT64);
+	state.partials = MY_MALLOC(num_threads, struct PartialStats);
+	my_parallel_buffered(num_samples, &state, addSamples_thread, NULL,
+			num_threads, BLOCK_SAMPLES);
+	//pairwise reduction of the partial moments
+	for (int64_t step = 1; step < num_threads; step *= 2) {
+		for (int64_t i = 0; i + step < num_threads; i += 2 * step)
+			merge_partials(state.partials + i, state.partials + i + step,
+					dsc->num_dimensions);
+	}
+	merge_into_compute(dsc, state.partials);
+	for (int64_t i = 0; i < num_threads; ++i)
+		partial_release(state.partials + i);
+	free(state.partials);
+}
+
 void my_math_computeStats_getStats(struct MyDataStatsCompute *dsc,
 		int64_t id_dimension, struct MyDataStats *out_stats) {
 	struct DataStats *dim_stats = dsc->stats_by_dimension + id_dimension;
@@ -29,6 +29,22 @@ int64_t my_math_computeStats_getNumDimensions(struct MyDataStatsCompute *dsc);
 my_math_computeStats_addSample my_math_computeStats_getAddSampleFunction(
 		MyDatatype dtype_vector);
 
+/**
+ * Adds a chunk of samples using several threads. Each thread accumulates
+ * blocks of samples into its own partial moments, and the partial results are
+ * merged pairwise at the end. It can be called repeatedly with consecutive
+ * chunks to process data that does not fit in memory.
+ *
+ * @param dsc the statistics to update.
+ * @param num_samples number of vectors in @p samples.
+ * @param samples array of pointers to the vectors.
+ * @param dtype_vector datatype of the vectors.
+ * @param max_threads maximum number of threads (<=0 means number of cores).
+ */
+void my_math_computeStats_addSamples(struct MyDataStatsCompute *dsc,
+		int64_t num_samples, void **samples, MyDatatype dtype_vector,
+		int64_t max_threads);
+
 void my_math_computeStats_getStats(struct MyDataStatsCompute *dsc,
 		int64_t id_dimension, struct MyDataStats *out_stats);
 
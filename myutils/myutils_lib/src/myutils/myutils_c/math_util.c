@@ -8,6 +8,19 @@
 
 #include "math_util.h"
 
+#if defined(__GNUC__) && !defined(__F16C__) \
+	&& (defined(__x86_64__) || defined(__i386__))
+//F16C instructions are selected at runtime when they are not enabled at
+//compile time (e.g. -mf16c or -march=native)
+#define MY_F16C_RUNTIME 1
+#else
+#define MY_F16C_RUNTIME 0
+#endif
+
+#if defined(__F16C__) || defined(__SSE2__) || MY_F16C_RUNTIME
+#include <immintrin.h>
+#endif
+
 double my_math_pctIntersection(double start1, double end1, double start2,
 		double end2) {
 	if (end1 <= start2 || end2 <= start1) {
@@ -196,6 +209,155 @@ void my_math_normalizeMax1_double(double *array, int64_t length) {
 	if (max > 0)
 		my_math_scaleDoubleArray(array, length, 1 / max);
 }
+uint16_t my_math_floatToHalf(float value) {
+	uint32_t f;
+	memcpy(&f, &value, sizeof(f));
+	uint16_t sign = (f >> 16) & 0x8000;
+	uint32_t abs = f & 0x7FFFFFFF;
+	uint32_t exp = abs >> 23;
+	if (abs > 0x7F800000)
+		return sign | 0x7E00;
+	if (exp >= 143)
+		return sign | 0x7C00;
+	uint32_t h, rem, tie;
+	if (exp >= 113) {
+		h = ((exp - 112) << 10) | ((abs >> 13) & 0x3FF);
+		rem = abs & 0x1FFF;
+		tie = 0x1000;
+	} else if (exp >= 102) {
+		//subnormal half
+		uint32_t mant = (abs & 0x7FFFFF) | 0x800000;
+		uint32_t shift = 126 - exp;
+		h = mant >> shift;
+		rem = mant & ((1u << shift) - 1);
+		tie = 1u << (shift - 1);
+	} else {
+		return sign;
+	}
+	//the carry may round up to the next exponent or to infinity
+	if (rem > tie || (rem == tie && (h & 1)))
+		h++;
+	return sign | h;
+}
+float my_math_halfToFloat(uint16_t value) {
+	uint32_t sign = ((uint32_t) value & 0x8000) << 16;
+	uint32_t exp = (value >> 10) & 0x1F;
+	uint32_t mant = value & 0x3FF;
+	uint32_t f;
+	if (exp == 0x1F) {
+		f = sign | 0x7F800000 | (mant << 13);
+	} else if (exp > 0) {
+		f = sign | ((exp + 112) << 23) | (mant << 13);
+	} else if (mant == 0) {
+		f = sign;
+	} else {
+		exp = 113;
+		while ((mant & 0x400) == 0) {
+			mant <<= 1;
+			exp--;
+		}
+		f = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+	}
+	float result;
+	memcpy(&result, &f, sizeof(result));
+	return result;
+}
+uint16_t my_math_floatToBfloat16(float value) {
+	uint32_t f;
+	memcpy(&f, &value, sizeof(f));
+	//keep NaN quiet, the rounding could turn it into infinity
+	if ((f & 0x7FFFFFFF) > 0x7F800000)
+		return (f >> 16) | 0x0040;
+	f += 0x7FFF + ((f >> 16) & 1);
+	return f >> 16;
+}
+float my_math_bfloat16ToFloat(uint16_t value) {
+	uint32_t f = ((uint32_t) value) << 16;
+	float result;
+	memcpy(&result, &f, sizeof(result));
+	return result;
+}
+#if defined(__F16C__) || MY_F16C_RUNTIME
+//they return the number of converted values (a multiple of 8)
+#if MY_F16C_RUNTIME
+__attribute__((target("avx,f16c")))
+#endif
+static int64_t priv_halfToFloatArray_f16c(const uint16_t *src, float *dst,
+		int64_t length) {
+	int64_t i = 0;
+	for (; i + 8 <= length; i += 8) {
+		__m128i h = _mm_loadu_si128((const __m128i*) (src + i));
+		_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+	}
+	return i;
+}
+#if MY_F16C_RUNTIME
+__attribute__((target("avx,f16c")))
+#endif
+static int64_t priv_floatToHalfArray_f16c(const float *src, uint16_t *dst,
+		int64_t length) {
+	int64_t i = 0;
+	for (; i + 8 <= length; i += 8) {
+		__m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+				_MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i*) (dst + i), h);
+	}
+	return i;
+}
+static bool priv_useF16C() {
+#if defined(__F16C__)
+	return true;
+#else
+	static int supported = -1;
+	int value = __atomic_load_n(&supported, __ATOMIC_RELAXED);
+	if (value < 0) {
+		__builtin_cpu_init();
+		value = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+		__atomic_store_n(&supported, value, __ATOMIC_RELAXED);
+	}
+	return value;
+#endif
+}
+#endif
+void my_math_halfToFloatArray(const uint16_t *src, float *dst, int64_t length) {
+	int64_t i = 0;
+#if defined(__F16C__) || MY_F16C_RUNTIME
+	if (priv_useF16C())
+		i = priv_halfToFloatArray_f16c(src, dst, length);
+#endif
+	for (; i < length; ++i)
+		dst[i] = my_math_halfToFloat(src[i]);
+}
+void my_math_floatToHalfArray(const float *src, uint16_t *dst, int64_t length) {
+	int64_t i = 0;
+#if defined(__F16C__) || MY_F16C_RUNTIME
+	if (priv_useF16C())
+		i = priv_floatToHalfArray_f16c(src, dst, length);
+#endif
+	for (; i < length; ++i)
+		dst[i] = my_math_floatToHalf(src[i]);
+}
+void my_math_bfloat16ToFloatArray(const uint16_t *src, float *dst,
+		int64_t length) {
+	int64_t i = 0;
+#ifdef __SSE2__
+	//interleaving with zeros shifts each value to the upper 16 bits
+	__m128i zero = _mm_setzero_si128();
+	for (; i + 8 <= length; i += 8) {
+		__m128i b = _mm_loadu_si128((const __m128i*) (src + i));
+		_mm_storeu_si128((__m128i*) (dst + i), _mm_unpacklo_epi16(zero, b));
+		_mm_storeu_si128((__m128i*) (dst + i + 4),
+				_mm_unpackhi_epi16(zero, b));
+	}
+#endif
+	for (; i < length; ++i)
+		dst[i] = my_math_bfloat16ToFloat(src[i]);
+}
+void my_math_floatToBfloat16Array(const float *src, uint16_t *dst,
+		int64_t length) {
+	for (int64_t i = 0; i < length; ++i)
+		dst[i] = my_math_floatToBfloat16(src[i]);
+}
 
 /*******************/
 struct MyLinearMatrix my_linear2d_new(int64_t length_d1, int64_t length_d2) {
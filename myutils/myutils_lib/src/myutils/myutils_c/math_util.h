@@ -70,6 +70,29 @@ void my_math_normalizeNorm1_double(double *array, int64_t length);
 void my_math_normalizeMax1_float(float *array, int64_t length);
 void my_math_normalizeMax1_double(double *array, int64_t length);
 
+/**
+ * IEEE 754 half precision (binary16), rounding to nearest even.
+ */
+uint16_t my_math_floatToHalf(float value);
+float my_math_halfToFloat(uint16_t value);
+
+/**
+ * bfloat16 (the upper 16 bits of a float), rounding to nearest even.
+ */
+uint16_t my_math_floatToBfloat16(float value);
+float my_math_bfloat16ToFloat(uint16_t value);
+
+/**
+ * Array versions of the conversions above. The half precision versions use
+ * F16C instructions when the CPU supports them.
+ */
+void my_math_halfToFloatArray(const uint16_t *src, float *dst, int64_t length);
+void my_math_floatToHalfArray(const float *src, uint16_t *dst, int64_t length);
+void my_math_bfloat16ToFloatArray(const uint16_t *src, float *dst,
+		int64_t length);
+void my_math_floatToBfloat16Array(const float *src, uint16_t *dst,
+		int64_t length);
+
 struct MyLinearMatrix {
 	int64_t num_dimensions;
 	int64_t length_d1, length_d2, length_d3;
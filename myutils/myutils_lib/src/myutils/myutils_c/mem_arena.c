@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of MultimediaTools. https://github.com/juanbarrios/multimedia_tools
+ * MultimediaTools is made available under the terms of the BSD 2-Clause License.
+ */
+
+#include "mem_arena.h"
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+struct ArenaBlock {
+	struct ArenaBlock *next;
+	int64_t size, used;
+	//data follows the header
+};
+struct MyArena {
+	int64_t block_size;
+	//the current block is the first of the list
+	struct ArenaBlock *blocks, *last_block;
+	void *last_alloc;
+	int64_t allocated_bytes;
+};
+
+#define BLOCK_HEADER_SIZE ((int64_t) ((sizeof(struct ArenaBlock) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT))
+#define BLOCK_DATA(block) (((char*) (block)) + BLOCK_HEADER_SIZE)
+
+MyArena *my_arena_new(int64_t block_size) {
+	MyArena *arena = MY_MALLOC(1, MyArena);
+	arena->block_size =
+			(block_size > 0) ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+	return arena;
+}
+static struct ArenaBlock *priv_newBlock(int64_t size) {
+	struct ArenaBlock *block = my_memory_alloc(BLOCK_HEADER_SIZE + size, 1,
+	false);
+	block->size = size;
+	block->used = 0;
+	block->next = NULL;
+	return block;
+}
+static void *priv_alloc(MyArena *arena, int64_t num_bytes) {
+	num_bytes = (num_bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+	struct ArenaBlock *current = arena->blocks;
+	if (current == NULL || current->used + num_bytes > current->size) {
+		if (num_bytes > arena->block_size / 4) {
+			//large objects take their own block behind the current one
+			struct ArenaBlock *block = priv_newBlock(num_bytes);
+			block->used = num_bytes;
+			if (current == NULL) {
+				arena->blocks = arena->last_block = block;
+			} else {
+				block->next = current->next;
+				current->next = block;
+				if (arena->last_block == current)
+					arena->last_block = block;
+			}
+			arena->allocated_bytes += num_bytes;
+			arena->last_alloc = NULL;
+			return BLOCK_DATA(block);
+		}
+		struct ArenaBlock *block = priv_newBlock(arena->block_size);
+		block->next = current;
+		if (current == NULL)
+			arena->last_block = block;
+		arena->blocks = current = block;
+	}
+	void *ptr = BLOCK_DATA(current) + current->used;
+	current->used += num_bytes;
+	arena->allocated_bytes += num_bytes;
+	arena->last_alloc = ptr;
+	return ptr;
+}
+void *my_arena_alloc(MyArena *arena, int64_t num_objs, size_t size_objs,
+bool initWithZeros) {
+	int64_t num_bytes = num_objs * (int64_t) size_objs;
+	if (num_bytes < 0)
+		my_log_error("internal error. %"PRIi64" * %"PRIi64" requested\n",
+				num_objs, (int64_t) size_objs);
+	else if (num_bytes == 0)
+		return NULL;
+	void *ptr = priv_alloc(arena, num_bytes);
+	if (initWithZeros)
+		memset(ptr, 0, num_bytes);
+	return ptr;
+}
+void *my_arena_realloc(MyArena *arena, void *ptr, int64_t old_num_objs,
+		int64_t new_num_objs, size_t size_objs) {
+	if (ptr == NULL)
+		return my_arena_alloc(arena, new_num_objs, size_objs, false);
+	int64_t old_bytes = (old_num_objs * (int64_t) size_objs + ARENA_ALIGNMENT
+			- 1) & ~(ARENA_ALIGNMENT - 1);
+	int64_t new_bytes = (new_num_objs * (int64_t) size_objs + ARENA_ALIGNMENT
+			- 1) & ~(ARENA_ALIGNMENT - 1);
+	if (new_bytes <= old_bytes)
+		return ptr;
+	struct ArenaBlock *current = arena->blocks;
+	if (ptr == arena->last_alloc
+			&& current->used - old_bytes + new_bytes <= current->size) {
+		current->used += new_bytes - old_bytes;
+		arena->allocated_bytes += new_bytes - old_bytes;
+		return ptr;
+	}
+	void *new_ptr = priv_alloc(arena, new_bytes);
+	memcpy(new_ptr, ptr, old_num_objs * size_objs);
+	return new_ptr;
+}
+char *my_arena_newStringLength(MyArena *arena, const char *string,
+		int64_t length) {
+	char *st = priv_alloc(arena, length + 1);
+	memcpy(st, string, length);
+	st[length] = '\0';
+	return st;
+}
+char *my_arena_newString(MyArena *arena, const char *string) {
+	if (string == NULL)
+		return NULL;
+	return my_arena_newStringLength(arena, string, strlen(string));
+}
+void my_arena_merge(MyArena *dst, MyArena *src) {
+	if (src->blocks != NULL) {
+		//src blocks go behind the current block of dst
+		if (dst->blocks == NULL) {
+			dst->blocks = src->blocks;
+			dst->last_block = src->last_block;
+		} else {
+			src->last_block->next = dst->blocks->next;
+			dst->blocks->next = src->blocks;
+			if (dst->last_block == dst->blocks)
+				dst->last_block = src->last_block;
+		}
+		dst->allocated_bytes += src->allocated_bytes;
+	}
+	MY_FREE(src);
+}
+void my_arena_clear(MyArena *arena) {
+	struct ArenaBlock *first = NULL, *block = arena->blocks;
+	while (block != NULL) {
+		struct ArenaBlock *next = block->next;
+		if (first == NULL && block->size == arena->block_size)
+			first = block;
+		else
+			MY_FREE(block);
+		block = next;
+	}
+	if (first != NULL) {
+		first->used = 0;
+		first->next = NULL;
+	}
+	arena->blocks = arena->last_block = first;
+	arena->last_alloc = NULL;
+	arena->allocated_bytes = 0;
+}
+int64_t my_arena_getAllocatedBytes(MyArena *arena) {
+	return arena->allocated_bytes;
+}
+void my_arena_release(MyArena *arena) {
+	if (arena == NULL)
+		return;
+	struct ArenaBlock *block = arena->blocks;
+	while (block != NULL) {
+		struct ArenaBlock *next = block->next;
+		MY_FREE(block);
+		block = next;
+	}
+	MY_FREE(arena);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of MultimediaTools. https://github.com/juanbarrios/multimedia_tools
+ * MultimediaTools is made available under the terms of the BSD 2-Clause License.
+ */
+
+#ifndef MY_MEM_ARENA_H
+#define MY_MEM_ARENA_H
+
+#include "../myutils_c.h"
+
+/**
+ * Region allocator: objects are allocated by moving a pointer inside large
+ * blocks and they are all released together by my_arena_release (or
+ * my_arena_clear). Objects allocated in an arena must not be freed with
+ * MY_FREE. An arena must not be used by two threads at the same time.
+ */
+
+#define MY_ARENA_MALLOC(arena, num, type) ((type*) my_arena_alloc((arena), (num), sizeof(type), true))
+#define MY_ARENA_MALLOC_NOINIT(arena, num, type) ((type*) my_arena_alloc((arena), (num), sizeof(type), false))
+#define MY_ARENA_REALLOC(arena, ptr, old_num, new_num, type) ((ptr)=(type *) my_arena_realloc((arena), (ptr), (old_num), (new_num), sizeof(type)))
+
+/**
+ * @param block_size size in bytes of each block, 0 for the default (64KB).
+ * @return
+ */
+MyArena *my_arena_new(int64_t block_size);
+
+void *my_arena_alloc(MyArena *arena, int64_t num_objs, size_t size_objs,
+bool initWithZeros);
+
+/**
+ * Resizes an array allocated in the arena. The last allocation grows in
+ * place, otherwise the content is copied to a new position.
+ */
+void *my_arena_realloc(MyArena *arena, void *ptr, int64_t old_num_objs,
+		int64_t new_num_objs, size_t size_objs);
+
+char *my_arena_newString(MyArena *arena, const char *string);
+
+char *my_arena_newStringLength(MyArena *arena, const char *string,
+		int64_t length);
+
+/**
+ * Moves every block of @p src to @p dst and releases @p src. Objects of both
+ * arenas remain valid until @p dst is released. It does not depend on the
+ * number of blocks (the last block of each arena is kept).
+ */
+void my_arena_merge(MyArena *dst, MyArena *src);
+
+/**
+ * Releases every object and keeps the first block for new allocations.
+ */
+void my_arena_clear(MyArena *arena);
+
+int64_t my_arena_getAllocatedBytes(MyArena *arena);
+
+void my_arena_release(MyArena *arena);
+
+#endif
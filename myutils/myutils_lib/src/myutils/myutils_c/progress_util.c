@@ -43,33 +43,38 @@ static double getSecondsLeft(double elapsedSeconds, int64_t numObjCompleted,
 		return 0;
 	return (elapsedSeconds * numObjLeft) / ((double) numObjCompleted);
 }
+//contCompleted is updated without locks
+static int64_t getCompleted(MyProgress *lt) {
+	return __atomic_load_n(&lt->contCompleted, __ATOMIC_RELAXED);
+}
 static char *getProgressString(MyProgress *lt, bool isFinished) {
 	double elapsedSeconds = my_timer_getSeconds(lt->startTimer);
 	if (elapsedSeconds < 5)
 		return NULL;
-	char *stRate = getProgressRateString(lt->contCompleted, elapsedSeconds);
+	int64_t contCompleted = getCompleted(lt);
+	char *stRate = getProgressRateString(contCompleted, elapsedSeconds);
 	char *progress;
 	if (isFinished) {
 		char *totalTime = my_newString_hhmmss(elapsedSeconds);
 		char *stThreads = getActiveThreadsSuffix(lt->maxActiveThreads);
 		progress = my_newString_format("%"PRIi64" in %1.1lf seconds %s (%s%s)",
-				lt->contCompleted, elapsedSeconds, totalTime, stRate,
+				contCompleted, elapsedSeconds, totalTime, stRate,
 				stThreads);
 		MY_FREE_MULTI(totalTime, stThreads);
 	} else if (lt->isUnknownMaximum) {
 		char *stThreads = getActiveThreadsSuffix(lt->currentActiveThreads);
-		progress = my_newString_format("%"PRIi64" (%s%s)", lt->contCompleted,
+		progress = my_newString_format("%"PRIi64" (%s%s)", contCompleted,
 				stRate, stThreads);
 		MY_FREE(stThreads);
 	} else {
-		double secLeft = getSecondsLeft(elapsedSeconds, lt->contCompleted,
-				lt->contMaximum - lt->contCompleted);
+		double secLeft = getSecondsLeft(elapsedSeconds, contCompleted,
+				lt->contMaximum - contCompleted);
 		char *timeLeft = my_newString_hhmmss(secLeft);
 		char *stThreads = getActiveThreadsSuffix(lt->currentActiveThreads);
 		progress = my_newString_format(
 				"%"PRIi64"/%"PRIi64" (%2.0lf%%) left %s (%s%s)",
-				lt->contCompleted, lt->contMaximum,
-				(100.0 * lt->contCompleted) / lt->contMaximum, timeLeft, stRate,
+				contCompleted, lt->contMaximum,
+				(100.0 * contCompleted) / lt->contMaximum, timeLeft, stRate,
 				stThreads);
 		MY_FREE_MULTI(timeLeft, stThreads);
 	}
@@ -84,23 +89,24 @@ static void* logger_thread(void *params_threads) {
 	MyProgress *lt = (MyProgress*) params_threads;
 	MY_MUTEX_LOCK(lt->logger_mutex);
 	for (;;) {
-		if (lt->contCompleted >= lt->contMaximum)
+		if (getCompleted(lt) >= lt->contMaximum)
 			break;
-		int64_t prev_completed = lt->contCompleted;
+		int64_t prev_completed = getCompleted(lt);
 		int64_t prev_maximum = lt->contMaximum;
 		MY_MUTEX_TIMEDWAIT(lt->logger_cond, lt->logger_mutex,
 				SECONDS_SHORT_WAIT);
-		if (lt->contCompleted >= lt->contMaximum) {
+		if (getCompleted(lt) >= lt->contMaximum) {
 			break;
-		} else if (prev_completed == lt->contCompleted
+		} else if (prev_completed == getCompleted(lt)
 				&& prev_maximum == lt->contMaximum) {
 			//nothing has changed
-			lt->isInLongWait = true;
-			MY_MUTEX_TIMEDWAIT(lt->logger_cond, lt->logger_mutex,
-					SECONDS_LONG_WAIT);
-			lt->isInLongWait = false;
+			__atomic_store_n(&lt->isInLongWait, true, __ATOMIC_SEQ_CST);
+			if (prev_completed == getCompleted(lt))
+				MY_MUTEX_TIMEDWAIT(lt->logger_cond, lt->logger_mutex,
+						SECONDS_LONG_WAIT);
+			__atomic_store_n(&lt->isInLongWait, false, __ATOMIC_SEQ_CST);
 		}
-		if (lt->contCompleted >= lt->contMaximum)
+		if (getCompleted(lt) >= lt->contMaximum)
 			break;
 		char *progress = getProgressString(lt, false);
 		if (progress != NULL) {
@@ -132,38 +138,38 @@ MyProgress* my_progress_new(const char *logger_name, int64_t contMaximum,
 	return lt;
 }
 static void updated(MyProgress *lt, bool forced) {
-	if (lt->contCompleted > lt->contMaximum)
-		lt->contMaximum = lt->contCompleted;
+	if (getCompleted(lt) > lt->contMaximum)
+		lt->contMaximum = getCompleted(lt);
 	if (lt->isInLongWait || forced) {
 		int est = pthread_cond_broadcast(&lt->logger_cond);
 		my_assert_equalInt("pthread_cond_signal", est, 0);
 	}
 }
-//thread-safe
+//thread-safe, the lock is taken only when the counter reaches the maximum
+//or to wake up the logger after a long wait
 void my_progress_addN(MyProgress *lt, int64_t n) {
 	if (lt == NULL || n == 0)
 		return;
-	MY_MUTEX_LOCK(lt->logger_mutex);
-	lt->contCompleted += n;
-	updated(lt, false);
-	MY_MUTEX_UNLOCK(lt->logger_mutex);
+	int64_t completed = __atomic_add_fetch(&lt->contCompleted, n,
+			__ATOMIC_SEQ_CST);
+	if (completed >= __atomic_load_n(&lt->contMaximum, __ATOMIC_RELAXED)
+			|| __atomic_load_n(&lt->isInLongWait, __ATOMIC_SEQ_CST)) {
+		MY_MUTEX_LOCK(lt->logger_mutex);
+		updated(lt, false);
+		MY_MUTEX_UNLOCK(lt->logger_mutex);
+	}
 }
 //thread-safe
 void my_progress_add1(MyProgress *lt) {
-	if (lt == NULL)
-		return;
-	MY_MUTEX_LOCK(lt->logger_mutex);
-	lt->contCompleted += 1;
-	updated(lt, false);
-	MY_MUTEX_UNLOCK(lt->logger_mutex);
+	my_progress_addN(lt, 1);
 }
 //thread-safe
 void my_progress_setN(MyProgress *lt, int64_t n) {
 	if (lt == NULL)
 		return;
 	MY_MUTEX_LOCK(lt->logger_mutex);
-	if (n != lt->contCompleted) {
-		lt->contCompleted = n;
+	if (n != getCompleted(lt)) {
+		__atomic_store_n(&lt->contCompleted, n, __ATOMIC_SEQ_CST);
 		updated(lt, false);
 	}
 	MY_MUTEX_UNLOCK(lt->logger_mutex);
@@ -192,7 +198,7 @@ void my_progress_release(MyProgress *lt) {
 	if (lt == NULL)
 		return;
 	MY_MUTEX_LOCK(lt->logger_mutex);
-	lt->contMaximum = lt->contCompleted;
+	lt->contMaximum = getCompleted(lt);
 	updated(lt, true);
 	MY_MUTEX_UNLOCK(lt->logger_mutex);
 	int ret = pthread_join(lt->logger_id, NULL);
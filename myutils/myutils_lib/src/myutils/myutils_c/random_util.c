@@ -9,219 +9,181 @@
 #include "random_util.h"
 #include <time.h>
 
-#define MAX_SEEDED_THREADS 20
+//xoshiro256** generator, see http://prng.di.unimi.it/
+struct MyRandom {
+	uint64_t s[4];
+};
 
-static int last_seeded = -1;
-static int cont_seeded = 0;
-static pthread_t seeded_threads[MAX_SEEDED_THREADS];
-
-static bool was_seeded_thread(pthread_t thread) {
-	if (cont_seeded == 0)
-		return false;
-	if (seeded_threads[last_seeded] == thread)
-		return true;
-	for (int i = 0; i < cont_seeded; ++i) {
-		if (seeded_threads[i] == thread)
-			return true;
-	}
-	return false;
+static uint64_t splitmix64(uint64_t *x) {
+	uint64_t z = (*x += UINT64_C(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+	return z ^ (z >> 31);
 }
-
-static void add_new_seeded_thread(pthread_t thread) {
-	last_seeded = (last_seeded + 1) % MAX_SEEDED_THREADS;
-	seeded_threads[last_seeded] = thread;
-	if (cont_seeded < MAX_SEEDED_THREADS)
-		cont_seeded++;
-}
-
-static unsigned int current_seed = 0;
-
-static void internal_ensure_seed() {
-	//in linux seeds are stored per process
-	//in windows seeds are stored per thread
-	//therefore we seed every new thread that has not been seeded
-	//we store a memory of the last MAX_SEEDED_THREADS
-	pthread_t current_thread = pthread_self();
-	if (was_seeded_thread(current_thread))
-		return;
-	if (current_seed == 0) {
-		current_seed = (unsigned int) time(NULL);
-		if (current_seed == 0)
-			current_seed = 1;
-	} else {
-		current_seed += 10;
-	}
-	srand(current_seed);
-	add_new_seeded_thread(current_thread);
+static void internal_seed(struct MyRandom *rnd, int64_t seed,
+		int64_t num_stream) {
+	//each stream starts from an unrelated state of the same seed
+	uint64_t x = (uint64_t) seed;
+	uint64_t y = splitmix64(&x) ^ (uint64_t) num_stream;
+	for (int i = 0; i < 4; ++i)
+		rnd->s[i] = splitmix64(&y);
 }
-
-#if (RAND_MAX >= 0x7FFFFFFF)
-
-static int64_t MAX_RANDOM_31b = 0x7FFFFFFF;
-static int64_t MAX_RANDOM_52b = 0xFFFFFFFFFFFFF;
-static int64_t MAX_RANDOM_62b = 0x3FFFFFFFFFFFFFFF;
-
-static int64_t internal_random_int_31b() {
-	int64_t a0 = (rand() & 0x7FFFFFFF); //31-bits
-	return a0;
+static inline uint64_t rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
 }
-static int64_t internal_random_int_52b() {
-	int64_t a0 = (rand() & 0x3FFFFFF); //26-bits
-	int64_t a1 = (rand() & 0x3FFFFFF);//26-bits
-	return a0 | (a1 << 26);
+static inline uint64_t internal_next(struct MyRandom *rnd) {
+	uint64_t *s = rnd->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
 }
-static int64_t internal_random_int_62b() {
-	int64_t a0 = (rand() & 0x7FFFFFFF); //31-bits
-	int64_t a1 = (rand() & 0x7FFFFFFF);//31-bits
-	return a0 | (a1 << 31);
+//uniform in [0, maxValueNotIncluded), rejects the values that bias the modulo
+static int64_t internal_random_int(struct MyRandom *rnd,
+		int64_t maxValueNotIncluded) {
+	uint64_t range = (uint64_t) maxValueNotIncluded;
+	uint64_t threshold = (-range) % range;
+	for (;;) {
+		uint64_t val = internal_next(rnd);
+		if (val >= threshold)
+			return (int64_t) (val % range);
+	}
 }
-static int64_t internal_random_int(int64_t maxValueNotIncluded) {
-	my_assert_greaterInt("random_int maxValue", maxValueNotIncluded, 0);
-	int64_t val = 0;
-	if (maxValueNotIncluded <= MAX_RANDOM_31b)
-	val = internal_random_int_31b();
-	else if (maxValueNotIncluded <= MAX_RANDOM_62b)
-	val = internal_random_int_62b();
-	else
-	my_log_error("random_int maxValue too large\n");
-	//TODO: remove bias to small values
-	int64_t rnd = val % maxValueNotIncluded;
-	return rnd;
+static double internal_random_double(struct MyRandom *rnd,
+		double maxValueNotIncluded) {
+	for (;;) {
+		//53 bits in [0,1)
+		double val = (internal_next(rnd) >> 11) * (1.0 / 9007199254740992.0);
+		double ret = val * maxValueNotIncluded;
+		if (ret < maxValueNotIncluded)
+			return ret;
+	}
 }
-#elif (RAND_MAX >= 0x7FFF)
-
-static int64_t MAX_RANDOM_15b = 0x7FFF;
-static int64_t MAX_RANDOM_30b = 0x3FFFFFFF;
-static int64_t MAX_RANDOM_45b = 0x1FFFFFFFFFFF;
-static int64_t MAX_RANDOM_52b = 0xFFFFFFFFFFFFF;
-static int64_t MAX_RANDOM_60b = 0xFFFFFFFFFFFFFFF;
 
-static int64_t internal_random_int_15b() {
-	int64_t a0 = (rand() & 0x7FFF); //15-bits
-	return a0;
-}
-static int64_t internal_random_int_30b() {
-	int64_t a0 = (rand() & 0x7FFF); //15-bits
-	int64_t a1 = (rand() & 0x7FFF); //15-bits
-	return a0 | (a1 << 15);
-}
-static int64_t internal_random_int_45b() {
-	int64_t a0 = (rand() & 0x7FFF); //15-bits
-	int64_t a1 = (rand() & 0x7FFF); //15-bits
-	int64_t a2 = (rand() & 0x7FFF); //15-bits
-	return a0 | (a1 << 15) | (a2 << 30);
-}
-static int64_t internal_random_int_52b() {
-	int64_t a0 = (rand() & 0x1FFF); //13-bits
-	int64_t a1 = (rand() & 0x1FFF); //13-bits
-	int64_t a2 = (rand() & 0x1FFF); //13-bits
-	int64_t a3 = (rand() & 0x1FFF); //13-bits
-	return a0 | (a1 << 13) | (a2 << 26) | (a3 << 39);
-}
-static int64_t internal_random_int_60b() {
-	int64_t a0 = (rand() & 0x7FFF); //15-bits
-	int64_t a1 = (rand() & 0x7FFF); //15-bits
-	int64_t a2 = (rand() & 0x7FFF); //15-bits
-	int64_t a3 = (rand() & 0x7FFF); //15-bits
-	return a0 | (a1 << 15) | (a2 << 30) | (a3 << 45);
-}
-static int64_t internal_random_int(int64_t maxValueNotIncluded) {
-	my_assert_greaterInt("random_int maxValue", maxValueNotIncluded, 0);
-	int64_t val = 0;
-	if (maxValueNotIncluded <= MAX_RANDOM_15b)
-		val = internal_random_int_15b();
-	else if (maxValueNotIncluded <= MAX_RANDOM_30b)
-		val = internal_random_int_30b();
-	else if (maxValueNotIncluded <= MAX_RANDOM_45b)
-		val = internal_random_int_45b();
-	else if (maxValueNotIncluded <= MAX_RANDOM_60b)
-		val = internal_random_int_60b();
-	else
-		my_log_error("random_int maxValue too large\n");
-	//TODO: remove bias to small values
-	int64_t rnd = val % maxValueNotIncluded;
+MyRandom *my_random_newStream(int64_t seed, int64_t num_stream) {
+	MyRandom *rnd = MY_MALLOC(1, MyRandom);
+	internal_seed(rnd, seed, num_stream);
 	return rnd;
 }
-#endif
-
-static double internal_random_double(double maxValueNotIncluded) {
-	double rnd = ((double) internal_random_int_52b())
-			/ ((double) MAX_RANDOM_52b);
-	double ret = rnd * maxValueNotIncluded;
-	if (ret >= maxValueNotIncluded)
-		return internal_random_double(maxValueNotIncluded);
-	return ret;
-}
-
-MY_MUTEX_NEWSTATIC(rnd_mutex);
-
-void my_random_setSeed(int64_t seed) {
-	MY_MUTEX_LOCK(rnd_mutex);
-	current_seed = (unsigned int) seed;
-	srand(current_seed);
-	add_new_seeded_thread(pthread_self());
-	MY_MUTEX_UNLOCK(rnd_mutex);
-}
-
-int64_t my_random_int(int64_t minValueIncluded, int64_t maxValueNotIncluded) {
-	MY_MUTEX_LOCK(rnd_mutex);
-	internal_ensure_seed();
+int64_t my_random_nextInt(MyRandom *rnd, int64_t minValueIncluded,
+		int64_t maxValueNotIncluded) {
 	int64_t interval_size = maxValueNotIncluded - minValueIncluded;
 	my_assert_greaterInt("random interval", interval_size, 0);
-	int64_t rnd = minValueIncluded + internal_random_int(interval_size);
-	MY_MUTEX_UNLOCK(rnd_mutex);
-	return rnd;
+	return minValueIncluded + internal_random_int(rnd, interval_size);
 }
-void my_random_intList(int64_t minValueIncluded, int64_t maxValueNotIncluded,
-		int64_t *array, int64_t size) {
-	MY_MUTEX_LOCK(rnd_mutex);
-	internal_ensure_seed();
+void my_random_nextIntList(MyRandom *rnd, int64_t minValueIncluded,
+		int64_t maxValueNotIncluded, int64_t *array, int64_t size) {
 	int64_t interval_size = maxValueNotIncluded - minValueIncluded;
 	my_assert_greaterInt("random interval", interval_size, 0);
-	for (int64_t i = 0; i < size; ++i) {
-		array[i] = minValueIncluded + internal_random_int(interval_size);
-	}
-	MY_MUTEX_UNLOCK(rnd_mutex);
+	for (int64_t i = 0; i < size; ++i)
+		array[i] = minValueIncluded + internal_random_int(rnd, interval_size);
 }
-double my_random_double(double minValueIncluded, double maxValueNotIncluded) {
-	MY_MUTEX_LOCK(rnd_mutex);
-	internal_ensure_seed();
+double my_random_nextDouble(MyRandom *rnd, double minValueIncluded,
+		double maxValueNotIncluded) {
 	double interval_size = maxValueNotIncluded - minValueIncluded;
 	my_assert_greaterDouble("random interval", interval_size, 0);
-	double rnd = minValueIncluded + internal_random_double(interval_size);
-	MY_MUTEX_UNLOCK(rnd_mutex);
-	return rnd;
+	return minValueIncluded + internal_random_double(rnd, interval_size);
 }
-void my_random_doubleList(double minValueIncluded, double maxValueNotIncluded,
-		double *array, int64_t size) {
-	MY_MUTEX_LOCK(rnd_mutex);
-	internal_ensure_seed();
+void my_random_nextDoubleList(MyRandom *rnd, double minValueIncluded,
+		double maxValueNotIncluded, double *array, int64_t size) {
 	double interval_size = maxValueNotIncluded - minValueIncluded;
 	my_assert_greaterDouble("random interval", interval_size, 0);
-	for (int64_t i = 0; i < size; ++i) {
-		array[i] = minValueIncluded + internal_random_double(interval_size);
-	}
-	MY_MUTEX_UNLOCK(rnd_mutex);
+	for (int64_t i = 0; i < size; ++i)
+		array[i] = minValueIncluded
+				+ internal_random_double(rnd, interval_size);
 }
-int64_t *my_random_newPermutation(int64_t minValueIncluded,
+int64_t *my_random_nextPermutation(MyRandom *rnd, int64_t minValueIncluded,
 		int64_t maxValueNotIncluded) {
 	int64_t interval_size = maxValueNotIncluded - minValueIncluded;
 	my_assert_greaterInt("random interval", interval_size, 0);
 	int64_t *array = MY_MALLOC(interval_size, int64_t);
 	for (int64_t i = 0; i < interval_size; ++i)
 		array[i] = minValueIncluded + i;
-	MY_MUTEX_LOCK(rnd_mutex);
-	internal_ensure_seed();
 	for (int64_t i = 0; i < interval_size - 1; i++) {
-		int64_t rnd = internal_random_int(interval_size - i);
-		int64_t pos = i + rnd;
+		int64_t pos = i + internal_random_int(rnd, interval_size - i);
 		int64_t swp = array[i];
 		array[i] = array[pos];
 		array[pos] = swp;
 	}
-	MY_MUTEX_UNLOCK(rnd_mutex);
 	return array;
 }
+void my_random_release(MyRandom *rnd) {
+	MY_FREE(rnd);
+}
+
+//the global seed is versioned, every thread reseeds its own generator when
+//the version changes. The thread that calls my_random_setSeed uses stream 0,
+//other threads take the following streams in the order of their first call.
+static int64_t global_seed = 0;
+static int64_t global_version = 0;
+static int64_t global_next_stream = 0;
+static __thread struct MyRandom thread_random;
+static __thread int64_t thread_version = 0;
+
+static pthread_once_t default_seed_once = PTHREAD_ONCE_INIT;
+
+static void internal_default_seed() {
+	if (__atomic_load_n(&global_version, __ATOMIC_ACQUIRE) != 0)
+		return;
+	global_seed = (int64_t) time(NULL);
+	__atomic_store_n(&global_next_stream, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&global_version, 1, __ATOMIC_RELEASE);
+}
+static struct MyRandom *internal_thread_random() {
+	int64_t version = __atomic_load_n(&global_version, __ATOMIC_ACQUIRE);
+	//version 0 means no seed, thread_version starts at 0 too
+	if (version == thread_version && version != 0)
+		return &thread_random;
+	if (version == 0) {
+		pthread_once(&default_seed_once, internal_default_seed);
+		version = __atomic_load_n(&global_version, __ATOMIC_ACQUIRE);
+	}
+	int64_t num_stream = __atomic_fetch_add(&global_next_stream, 1,
+			__ATOMIC_RELAXED);
+	internal_seed(&thread_random, global_seed, num_stream);
+	thread_version = version;
+	return &thread_random;
+}
+MyRandom *my_random_getThreadStream() {
+	return internal_thread_random();
+}
+
+void my_random_setSeed(int64_t seed) {
+	global_seed = seed;
+	__atomic_store_n(&global_next_stream, 1, __ATOMIC_RELAXED);
+	int64_t version = __atomic_add_fetch(&global_version, 1, __ATOMIC_RELEASE);
+	internal_seed(&thread_random, seed, 0);
+	thread_version = version;
+}
+
+int64_t my_random_int(int64_t minValueIncluded, int64_t maxValueNotIncluded) {
+	return my_random_nextInt(internal_thread_random(), minValueIncluded,
+			maxValueNotIncluded);
+}
+void my_random_intList(int64_t minValueIncluded, int64_t maxValueNotIncluded,
+		int64_t *array, int64_t size) {
+	my_random_nextIntList(internal_thread_random(), minValueIncluded,
+			maxValueNotIncluded, array, size);
+}
+double my_random_double(double minValueIncluded, double maxValueNotIncluded) {
+	return my_random_nextDouble(internal_thread_random(), minValueIncluded,
+			maxValueNotIncluded);
+}
+void my_random_doubleList(double minValueIncluded, double maxValueNotIncluded,
+		double *array, int64_t size) {
+	my_random_nextDoubleList(internal_thread_random(), minValueIncluded,
+			maxValueNotIncluded, array, size);
+}
+int64_t *my_random_newPermutation(int64_t minValueIncluded,
+		int64_t maxValueNotIncluded) {
+	return my_random_nextPermutation(internal_thread_random(),
+			minValueIncluded, maxValueNotIncluded);
+}
 void my_random_intList_noRepetitions(int64_t minValueIncluded,
 		int64_t maxValueNotIncluded, int64_t *array, int64_t sample_size) {
 	int64_t interval_size = maxValueNotIncluded - minValueIncluded;
@@ -236,10 +198,10 @@ void my_random_intList_noRepetitions(int64_t minValueIncluded,
 		memcpy(array, ids, sample_size * sizeof(int64_t));
 		MY_FREE(ids);
 	} else {
-		MY_MUTEX_LOCK(rnd_mutex);
-		internal_ensure_seed();
+		struct MyRandom *rnd_state = internal_thread_random();
 		for (int64_t i = 0; i < sample_size; ++i) {
-			array[i] = minValueIncluded + internal_random_int(interval_size);
+			array[i] = minValueIncluded
+					+ internal_random_int(rnd_state, interval_size);
 			for (int64_t j = 0; j < i; ++j) {
 				if (array[i] == array[j]) {
 					i--;
@@ -247,7 +209,6 @@ void my_random_intList_noRepetitions(int64_t minValueIncluded,
 				}
 			}
 		}
-		MY_MUTEX_UNLOCK(rnd_mutex);
 	}
 }
 MyVectorInt *my_random_sampleNoRepetitionsSorted(int64_t minValueIncluded,
@@ -11,8 +11,58 @@
 
 #include "../myutils_c.h"
 
+/**
+ * Random numbers use a xoshiro256** generator per thread, no locks are
+ * taken. The global functions use the generator of the calling thread, which
+ * is seeded from the global seed (current time by default). Sequences are
+ * reproducible for a given seed in the thread that calls my_random_setSeed.
+ * Parallel code that must be reproducible should use explicit streams, e.g.
+ * one stream per thread or per process of my_parallel_*.
+ */
+typedef struct MyRandom MyRandom;
+
+/**
+ * Sets the global seed. The calling thread restarts at stream 0, other
+ * threads reseed on their next call.
+ * @param seed
+ */
 void my_random_setSeed(int64_t seed);
 
+/**
+ * Creates an independent generator. The same seed and stream always produce
+ * the same sequence, different streams produce unrelated sequences.
+ * @param seed
+ * @param num_stream
+ * @return
+ */
+MyRandom *my_random_newStream(int64_t seed, int64_t num_stream);
+
+/**
+ * @return the generator used by the calling thread (must not be released).
+ */
+MyRandom *my_random_getThreadStream();
+
+int64_t my_random_nextInt(MyRandom *rnd, int64_t minValueIncluded,
+		int64_t maxValueNotIncluded);
+
+void my_random_nextIntList(MyRandom *rnd, int64_t minValueIncluded,
+		int64_t maxValueNotIncluded, int64_t *array, int64_t size);
+
+double my_random_nextDouble(MyRandom *rnd, double minValueIncluded,
+		double maxValueNotIncluded);
+
+void my_random_nextDoubleList(MyRandom *rnd, double minValueIncluded,
+		double maxValueNotIncluded, double *array, int64_t size);
+
+/**
+ * @return a new array with a random permutation of the values in
+ * [minValueIncluded, maxValueNotIncluded).
+ */
+int64_t* my_random_nextPermutation(MyRandom *rnd, int64_t minValueIncluded,
+		int64_t maxValueNotIncluded);
+
+void my_random_release(MyRandom *rnd);
+
 int64_t my_random_int(int64_t minValueIncluded, int64_t maxValueNotIncluded);
 
 void my_random_intList(int64_t minValueIncluded, int64_t maxValueNotIncluded,
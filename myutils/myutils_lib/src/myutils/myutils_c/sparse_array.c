@@ -17,14 +17,25 @@ struct MySparseArray {
 	int32_t filled_slots;
 	struct ArraySlot *slots_buffer;
 	int32_t slots_buffer_size;
+	//slots_buffer points to serialized bytes (my_sparseArray_deserializeView)
+	bool is_view;
 };
 
 MySparseArray *my_sparseArray_new() {
 	MySparseArray *sparseArray = MY_MALLOC(1, MySparseArray);
 	return sparseArray;
 }
+//the slots are overwritten, a view just forgets the serialized bytes
+static void priv_forgetView(MySparseArray *sparseArray) {
+	if (!sparseArray->is_view)
+		return;
+	sparseArray->slots_buffer = NULL;
+	sparseArray->slots_buffer_size = 0;
+	sparseArray->is_view = false;
+}
 void my_sparseArray_storeArrayDouble(MySparseArray *sparseArray, double *array,
 		int32_t array_size) {
+	priv_forgetView(sparseArray);
 	sparseArray->filled_slots = 0;
 	for (int32_t i = 0; i < array_size; ++i) {
 		if (array[i] == 0)
@@ -58,6 +69,15 @@ void my_sparseArray_restoreArrayFloat(MySparseArray *sparseArray, float *array,
 		array[slot->id_dimension] = slot->weight_dimension;
 	}
 }
+int32_t my_sparseArray_getNumSlots(MySparseArray *sparseArray) {
+	return sparseArray->filled_slots;
+}
+void my_sparseArray_getSlot(MySparseArray *sparseArray, int32_t num_slot,
+		int32_t *out_id_dimension, float *out_weight_dimension) {
+	struct ArraySlot *slot = sparseArray->slots_buffer + num_slot;
+	*out_id_dimension = slot->id_dimension;
+	*out_weight_dimension = slot->weight_dimension;
+}
 double my_sparseArray_multiplyWeightsEqualId(MySparseArray *sparseArray1,
 		MySparseArray *sparseArray2) {
 	if (sparseArray1->filled_slots == 0 || sparseArray2->filled_slots == 0)
@@ -86,7 +106,7 @@ double my_sparseArray_multiplyWeightsEqualId(MySparseArray *sparseArray1,
 void my_sparseArray_release(MySparseArray *sparseArray) {
 	if (sparseArray == NULL)
 		return;
-	if (sparseArray->slots_buffer != NULL)
+	if (sparseArray->slots_buffer != NULL && !sparseArray->is_view)
 		free(sparseArray->slots_buffer);
 	free(sparseArray);
 }
@@ -142,6 +162,7 @@ size_t my_sparseArray_deserialize(void *data_buffer, MySparseArray *sparseArray)
 	if (data_buffer == NULL)
 		return 0;
 	int32_t *header = data_buffer;
+	priv_forgetView(sparseArray);
 	sparseArray->filled_slots = header[0];
 	if (sparseArray->filled_slots > 0) {
 		sparseArray->slots_buffer_size = sparseArray->filled_slots;
@@ -154,3 +175,105 @@ size_t my_sparseArray_deserialize(void *data_buffer, MySparseArray *sparseArray)
 	return sizeof(int32_t)
 			+ sparseArray->filled_slots * sizeof(struct ArraySlot);
 }
+size_t my_sparseArray_deserializeView(void *data_buffer,
+		MySparseArray *sparseArray) {
+	if (data_buffer == NULL)
+		return 0;
+	int32_t *header = data_buffer;
+	void *start_slots = (header + 1);
+	if (((uintptr_t) start_slots) % sizeof(int32_t) != 0)
+		return my_sparseArray_deserialize(data_buffer, sparseArray);
+	if (!sparseArray->is_view)
+		MY_FREE(sparseArray->slots_buffer);
+	sparseArray->filled_slots = header[0];
+	sparseArray->slots_buffer = start_slots;
+	sparseArray->slots_buffer_size = sparseArray->filled_slots;
+	sparseArray->is_view = true;
+	return sizeof(int32_t)
+			+ sparseArray->filled_slots * sizeof(struct ArraySlot);
+}
+
+//compact format: varint(filled_slots), varint(id - previous_id - 1) for each
+//slot, and the weights in half precision
+static uint8_t *priv_writeVarint(uint8_t *ptr, uint32_t value) {
+	while (value >= 0x80) {
+		*ptr++ = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	*ptr++ = value;
+	return ptr;
+}
+static const uint8_t *priv_readVarint(const uint8_t *ptr, uint32_t *value) {
+	uint32_t val = 0;
+	for (int shift = 0;; shift += 7) {
+		uint8_t b = *ptr++;
+		val |= ((uint32_t) (b & 0x7F)) << shift;
+		if ((b & 0x80) == 0)
+			break;
+	}
+	*value = val;
+	return ptr;
+}
+size_t my_sparseArray_serializeCompactMaxBytes(MySparseArray *sparseArray) {
+	return 5 + sparseArray->filled_slots * (5 + sizeof(uint16_t));
+}
+size_t my_sparseArray_serializeCompact(MySparseArray *sparseArray,
+		void *data_buffer) {
+	uint8_t *ptr = priv_writeVarint(data_buffer, sparseArray->filled_slots);
+	int32_t previous = -1;
+	for (int32_t i = 0; i < sparseArray->filled_slots; ++i) {
+		struct ArraySlot *slot = sparseArray->slots_buffer + i;
+		if (slot->id_dimension <= previous)
+			my_log_error("sparse array ids must be increasing\n");
+		ptr = priv_writeVarint(ptr, slot->id_dimension - previous - 1);
+		previous = slot->id_dimension;
+	}
+	for (int32_t i = 0; i < sparseArray->filled_slots; ++i) {
+		uint16_t h = my_math_floatToHalf(
+				sparseArray->slots_buffer[i].weight_dimension);
+		memcpy(ptr, &h, sizeof(uint16_t));
+		ptr += sizeof(uint16_t);
+	}
+	return ptr - (uint8_t*) data_buffer;
+}
+size_t my_sparseArray_deserializeCompactPredictReadBytes(void *data_buffer) {
+	if (data_buffer == NULL)
+		return 0;
+	uint32_t filled_slots = 0;
+	const uint8_t *ptr = priv_readVarint(data_buffer, &filled_slots);
+	for (uint32_t i = 0; i < filled_slots; ++i) {
+		while (*ptr & 0x80)
+			ptr++;
+		ptr++;
+	}
+	ptr += filled_slots * sizeof(uint16_t);
+	return ptr - (const uint8_t*) data_buffer;
+}
+size_t my_sparseArray_deserializeCompact(void *data_buffer,
+		MySparseArray *sparseArray) {
+	if (data_buffer == NULL)
+		return 0;
+	priv_forgetView(sparseArray);
+	uint32_t filled_slots = 0;
+	const uint8_t *ptr = priv_readVarint(data_buffer, &filled_slots);
+	sparseArray->filled_slots = filled_slots;
+	if (sparseArray->filled_slots > sparseArray->slots_buffer_size) {
+		sparseArray->slots_buffer_size = sparseArray->filled_slots;
+		MY_REALLOC(sparseArray->slots_buffer, sparseArray->slots_buffer_size,
+				struct ArraySlot);
+	}
+	int32_t previous = -1;
+	for (int32_t i = 0; i < sparseArray->filled_slots; ++i) {
+		uint32_t delta = 0;
+		ptr = priv_readVarint(ptr, &delta);
+		previous += delta + 1;
+		sparseArray->slots_buffer[i].id_dimension = previous;
+	}
+	for (int32_t i = 0; i < sparseArray->filled_slots; ++i) {
+		uint16_t h;
+		memcpy(&h, ptr, sizeof(uint16_t));
+		ptr += sizeof(uint16_t);
+		sparseArray->slots_buffer[i].weight_dimension = my_math_halfToFloat(h);
+	}
+	return ptr - (const uint8_t*) data_buffer;
+}
@@ -28,6 +28,30 @@ size_t my_sparseArray_serialize(MySparseArray *sparseArray, void *data_buffer);
 size_t my_sparseArray_deserializePredictReadBytes(void *data_buffer);
 size_t my_sparseArray_deserialize(void *data_buffer,
 		MySparseArray *sparseArray);
+/**
+ * Same as my_sparseArray_deserialize but the slots are read in place, thus
+ * @p data_buffer must remain valid until @p sparseArray is released.
+ */
+size_t my_sparseArray_deserializeView(void *data_buffer,
+		MySparseArray *sparseArray);
+/**
+ * Compact serialization: ids are delta-encoded varints and weights are
+ * stored in half precision (lossy). Ids must be increasing, as
+ * my_sparseArray_storeArrayDouble leaves them.
+ * @return upper bound of the bytes written by my_sparseArray_serializeCompact.
+ */
+size_t my_sparseArray_serializeCompactMaxBytes(MySparseArray *sparseArray);
+size_t my_sparseArray_serializeCompact(MySparseArray *sparseArray,
+		void *data_buffer);
+size_t my_sparseArray_deserializeCompactPredictReadBytes(void *data_buffer);
+size_t my_sparseArray_deserializeCompact(void *data_buffer,
+		MySparseArray *sparseArray);
+int32_t my_sparseArray_getNumSlots(MySparseArray *sparseArray);
+/**
+ * Reads a non-zero dimension. Slots are sorted by increasing id_dimension.
+ */
+void my_sparseArray_getSlot(MySparseArray *sparseArray, int32_t num_slot,
+		int32_t *out_id_dimension, float *out_weight_dimension);
 double my_sparseArray_multiplyWeightsEqualId(MySparseArray *sparseArray1,
 		MySparseArray *sparseArray2);
 
@@ -12,11 +12,25 @@ struct MyStringBuffer {
 	char *buffer;
 	size_t end_position;
 	size_t buffer_size;
+	MyArena *arena;
 };
 MyStringBuffer *my_stringbuf_new() {
 	MyStringBuffer *sb = MY_MALLOC(1, MyStringBuffer);
 	return sb;
 }
+MyStringBuffer *my_stringbuf_newArena(MyArena *arena) {
+	MyStringBuffer *sb = MY_ARENA_MALLOC(arena, 1, MyStringBuffer);
+	sb->arena = arena;
+	return sb;
+}
+static void priv_resize(MyStringBuffer *sb, size_t new_size) {
+	if (sb->arena != NULL)
+		MY_ARENA_REALLOC(sb->arena, sb->buffer, sb->buffer_size, new_size,
+				char);
+	else
+		MY_REALLOC(sb->buffer, new_size, char);
+	sb->buffer_size = new_size;
+}
 void my_stringbuf_appendString(MyStringBuffer *sb, const char* text) {
 	if (text == NULL)
 		text = "null";
@@ -24,17 +38,15 @@ void my_stringbuf_appendString(MyStringBuffer *sb, const char* text) {
 	if (length == 0)
 		return;
 	if (sb->end_position + length >= sb->buffer_size) {
-		sb->buffer_size = MAX(2 * sb->buffer_size,
-				sb->end_position + length + 64);
-		MY_REALLOC(sb->buffer, sb->buffer_size, char);
+		priv_resize(sb,
+				MAX(2 * sb->buffer_size, sb->end_position + length + 64));
 	}
 	strcpy(sb->buffer + sb->end_position, text);
 	sb->end_position += length;
 }
 void my_stringbuf_appendChar(MyStringBuffer *sb, char character) {
 	if (sb->end_position + 1 >= sb->buffer_size) {
-		sb->buffer_size = MAX(2 * sb->buffer_size, 64);
-		MY_REALLOC(sb->buffer, sb->buffer_size, char);
+		priv_resize(sb, MAX(2 * sb->buffer_size, 64));
 	}
 	sb->buffer[sb->end_position] = character;
 	sb->buffer[sb->end_position + 1] = '\0';
@@ -68,12 +80,16 @@ const char *my_stringbuf_getCurrentBuffer(MyStringBuffer *sb) {
 	return sb->buffer;
 }
 void my_stringbuf_release(MyStringBuffer *sb) {
+	if (sb->arena != NULL)
+		return;
 	free(sb->buffer);
 	free(sb);
 }
 //must free the returned string
 char *my_stringbuf_releaseReturnBuffer(MyStringBuffer *sb) {
 	char *st = sb->buffer;
+	if (sb->arena != NULL)
+		return st;
 	free(sb);
 	return st;
 }
@@ -14,6 +14,12 @@
 typedef struct MyStringBuffer MyStringBuffer;
 
 MyStringBuffer *my_stringbuf_new();
+/**
+ * Same as my_stringbuf_new, but the buffer is allocated in @p arena.
+ * my_stringbuf_release does not release memory and
+ * my_stringbuf_releaseReturnBuffer returns a string of the arena.
+ */
+MyStringBuffer *my_stringbuf_newArena(MyArena *arena);
 void my_stringbuf_appendString(MyStringBuffer *sb, const char* text);
 void my_stringbuf_appendChar(MyStringBuffer *sb, char character);
 void my_stringbuf_appendInt(MyStringBuffer *sb, int64_t number);
@@ -22,6 +28,11 @@ void my_stringbuf_appendDouble(MyStringBuffer *sb, double number);
 void my_stringbuf_appendDoubleRound(MyStringBuffer *sb, double number, int64_t maxDecimals) ;
 const char *my_stringbuf_getCurrentBuffer(MyStringBuffer *sb);
 void my_stringbuf_release(MyStringBuffer *sb);
+/**
+ * Releases the buffer and returns its string, which must be freed with
+ * MY_FREE. When the buffer was created by my_stringbuf_newArena the string
+ * belongs to the arena and must not be freed.
+ */
 char *my_stringbuf_releaseReturnBuffer(MyStringBuffer *sb);
 
 #endif
@@ -15,6 +15,7 @@ struct MyTokenizer {
 	int64_t buffer_size;
 	bool useBrackets, joinMultipleDelimiters;
 	char open_bracket, close_bracket;
+	MyArena *arena;
 };
 
 MyTokenizer *my_tokenizer_new(const char* line, char token_delimiter) {
@@ -24,6 +25,26 @@ MyTokenizer *my_tokenizer_new(const char* line, char token_delimiter) {
 	tk->delimiter2 = tk->delimiter3 = '\0';
 	return tk;
 }
+MyTokenizer *my_tokenizer_newArena(const char* line, char token_delimiter,
+		MyArena *arena) {
+	MyTokenizer *tk = MY_ARENA_MALLOC(arena, 1, MyTokenizer);
+	tk->original_line = tk->line = line;
+	tk->delimiter1 = token_delimiter;
+	tk->delimiter2 = tk->delimiter3 = '\0';
+	tk->arena = arena;
+	return tk;
+}
+static void priv_ensureBuffer(MyTokenizer *tk, int64_t pos) {
+	if (tk->buffer_size > pos)
+		return;
+	int64_t new_size = MAX(2 * tk->buffer_size, pos + 1 + 64);
+	if (tk->arena != NULL)
+		MY_ARENA_REALLOC(tk->arena, tk->buffer, tk->buffer_size, new_size,
+				char);
+	else
+		MY_REALLOC(tk->buffer, new_size, char);
+	tk->buffer_size = new_size;
+}
 
 void my_tokenizer_addDelimiter(MyTokenizer *tk, char other_delimiter) {
 	if (tk->delimiter1 == '\0' || tk->delimiter1 == other_delimiter)
@@ -95,10 +116,7 @@ const char *my_tokenizer_nextToken(MyTokenizer *tk) {
 	}
 	if (contOpenBrackets > 0)
 		my_log_error("unbalanced brackets %s\n", tk->original_line);
-	if (tk->buffer_size <= pos) {
-		tk->buffer_size = MAX(2 * tk->buffer_size, pos + 1 + 64);
-		MY_REALLOC(tk->buffer, tk->buffer_size, char);
-	}
+	priv_ensureBuffer(tk, pos);
 	if (tk->useBrackets && tk->line[0] == tk->open_bracket
 			&& tk->line[pos - 1] == tk->close_bracket
 			&& my_is_matched_bracket(tk->line, 0, pos - 1, tk->open_bracket,
@@ -138,10 +156,7 @@ static const char *my_tokenizer_nextWord(MyTokenizer *tk) {
 			break;
 		pos++;
 	}
-	if (tk->buffer_size <= pos) {
-		tk->buffer_size = MAX(2 * tk->buffer_size, pos + 1 + 64);
-		MY_REALLOC(tk->buffer, tk->buffer_size, char);
-	}
+	priv_ensureBuffer(tk, pos);
 	strncpy(tk->buffer, tk->line, pos);
 	tk->buffer[pos] = '\0';
 	if (tk->line[pos] == '\0')
@@ -214,6 +229,8 @@ const char *my_tokenizer_getCurrentTail(MyTokenizer *tk) {
 	return tk->line;
 }
 void my_tokenizer_release(MyTokenizer *tk) {
+	if (tk->arena != NULL)
+		return;
 	MY_FREE(tk->buffer);
 	MY_FREE(tk);
 }
@@ -14,6 +14,12 @@
 typedef struct MyTokenizer MyTokenizer;
 
 MyTokenizer *my_tokenizer_new(const char* line, char token_delimiter);
+/**
+ * Same as my_tokenizer_new, but the tokenizer and its token buffer are
+ * allocated in @p arena. my_tokenizer_release does not release memory.
+ */
+MyTokenizer *my_tokenizer_newArena(const char* line, char token_delimiter,
+		MyArena *arena);
 
 void my_tokenizer_addDelimiter(MyTokenizer *tk, char other_delimiter);
 void my_tokenizer_setJoinMultipleDelimiters(MyTokenizer *tk);
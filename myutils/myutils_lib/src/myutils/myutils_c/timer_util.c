@@ -85,6 +85,9 @@ void my_timer_release(MyTimer *timer) {
 	if (timer != NULL)
 		free(timer);
 }
+double my_timer_getMonotonicSeconds() {
+	return getTickCount() / ((double) getTickFrequency());
+}
 char *my_timer_currentClock_newString() {
 	time_t l = time(NULL);
 	char time_buff[40];
@@ -19,6 +19,13 @@ double my_timer_updateToNow(MyTimer *timer);
 
 void my_timer_release(MyTimer *timer);
 
+/**
+ * Reads the monotonic clock without creating a timer. Only the difference
+ * between two readings is meaningful.
+ * @return seconds since an unspecified starting point
+ */
+double my_timer_getMonotonicSeconds();
+
 char *my_timer_currentClock_newString();
 
 #endif
@@ -19,6 +19,7 @@ extern "C" {
 #include "myutilsimage_c/color.h"
 #include "myutilsimage_c/histogram.h"
 #include "myutilsimage_c/image_util.h"
+#include "myutilsimage_c/image_stats.h"
 #include "myutilsimage_c/image_stitching.h"
 #include "myutilsimage_c/videowrite.h"
 #include "myutilsimage_c/local/local.h"
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of MultimediaTools. https://github.com/juanbarrios/multimedia_tools
+ * MultimediaTools is made available under the terms of the BSD 2-Clause License.
+ */
+
+#include "image_stats.h"
+#include <myutils/myutils_c.h>
+
+#ifndef NO_OPENCV
+
+struct MyImageStats {
+	int64_t width, height;
+	int64_t num_images, rows_current_image;
+	//row-major, the variance is updated directly (M2/n) to keep values bounded
+	float *means, *variances;
+	//convergence test
+	int64_t check_interval;
+	double tolerance, last_change;
+	float *prev_means;
+	bool converged;
+};
+
+MyImageStats *my_imageStats_new(int64_t width, int64_t height) {
+	my_assert_greaterInt("width", width, 0);
+	my_assert_greaterInt("height", height, 0);
+	MyImageStats *stats = MY_MALLOC(1, MyImageStats);
+	stats->width = width;
+	stats->height = height;
+	stats->means = MY_MALLOC(width * height, float);
+	stats->variances = MY_MALLOC(width * height, float);
+	return stats;
+}
+void my_imageStats_setConvergence(MyImageStats *stats, int64_t check_interval,
+		double tolerance) {
+	stats->check_interval = MAX(1, check_interval);
+	stats->tolerance = tolerance;
+	stats->converged = false;
+	if (tolerance > 0 && stats->prev_means == NULL)
+		stats->prev_means = MY_MALLOC(stats->width * stats->height, float);
+}
+static void priv_updateRow(float *restrict means, float *restrict variances,
+		const uchar *restrict pixels, int64_t width, float inv_n) {
+	//Welford's online algorithm, no branches nor reductions inside the loop
+	for (int64_t x = 0; x < width; ++x) {
+		float value = pixels[x];
+		float delta = value - means[x];
+		means[x] += delta * inv_n;
+		variances[x] += (delta * (value - means[x]) - variances[x]) * inv_n;
+	}
+}
+static void priv_testConvergence(MyImageStats *stats) {
+	int64_t size = stats->width * stats->height;
+	double sum_change = 0;
+	for (int64_t i = 0; i < size; ++i) {
+		sum_change += fabsf(stats->means[i] - stats->prev_means[i]);
+		stats->prev_means[i] = stats->means[i];
+	}
+	//the first test compares against zeros, it never converges
+	stats->last_change = sum_change / size;
+	stats->converged = stats->num_images > stats->check_interval
+			&& stats->last_change <= stats->tolerance;
+}
+static void priv_endImage(MyImageStats *stats) {
+	stats->num_images++;
+	stats->rows_current_image = 0;
+	if (stats->tolerance > 0
+			&& stats->num_images % stats->check_interval == 0)
+		priv_testConvergence(stats);
+}
+void my_imageStats_addRow(MyImageStats *stats, int64_t numRow,
+		const uchar *pixels) {
+	my_assert_indexRangeInt("numRow", numRow, stats->height);
+	float inv_n = 1.0f / (stats->num_images + 1);
+	int64_t offset = numRow * stats->width;
+	priv_updateRow(stats->means + offset, stats->variances + offset, pixels,
+			stats->width, inv_n);
+	stats->rows_current_image++;
+	if (stats->rows_current_image == stats->height)
+		priv_endImage(stats);
+}
+void my_imageStats_addImage(MyImageStats *stats, IplImage *imgGray) {
+	my_assert_equalInt("depth", imgGray->depth, IPL_DEPTH_8U);
+	my_assert_equalInt("nChannels", imgGray->nChannels, 1);
+	my_assert_equalInt("width", imgGray->width, stats->width);
+	my_assert_equalInt("height", imgGray->height, stats->height);
+	my_assert_equalInt("rows_current_image", stats->rows_current_image, 0);
+	float inv_n = 1.0f / (stats->num_images + 1);
+	for (int64_t y = 0; y < stats->height; ++y) {
+		const uchar *ptr = (uchar*) (imgGray->imageData
+				+ imgGray->widthStep * y);
+		int64_t offset = y * stats->width;
+		priv_updateRow(stats->means + offset, stats->variances + offset, ptr,
+				stats->width, inv_n);
+	}
+	priv_endImage(stats);
+}
+int64_t my_imageStats_getNumImages(MyImageStats *stats) {
+	return stats->num_images;
+}
+bool my_imageStats_hasConverged(MyImageStats *stats) {
+	return stats->converged;
+}
+float *my_imageStats_getMeans(MyImageStats *stats) {
+	return stats->means;
+}
+float *my_imageStats_getVariances(MyImageStats *stats) {
+	return stats->variances;
+}
+static IplImage *priv_newImage(float *values, int64_t width, int64_t height,
+		double max_val) {
+	IplImage *image = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
+	if (max_val <= 0) {
+		for (int64_t i = 0; i < width * height; ++i) {
+			if (values[i] > max_val)
+				max_val = values[i];
+		}
+	}
+	double factor = (max_val > 0) ? 255 / max_val : 0;
+	for (int64_t y = 0; y < height; ++y) {
+		uchar *ptr = (uchar*) (image->imageData + image->widthStep * y);
+		float *row = values + y * width;
+		for (int64_t x = 0; x < width; ++x) {
+			double val = (max_val == 255) ? row[x] : row[x] * factor;
+			ptr[x] = (uchar) MIN(255, val);
+		}
+	}
+	return image;
+}
+IplImage *my_imageStats_newImageMeans(MyImageStats *stats, double max_val) {
+	return priv_newImage(stats->means, stats->width, stats->height, max_val);
+}
+IplImage *my_imageStats_newImageVariances(MyImageStats *stats,
+		double max_val) {
+	return priv_newImage(stats->variances, stats->width, stats->height,
+			max_val);
+}
+void my_imageStats_release(MyImageStats *stats) {
+	if (stats == NULL)
+		return;
+	MY_FREE_MULTI(stats->means, stats->variances, stats->prev_means, stats);
+}
+#endif
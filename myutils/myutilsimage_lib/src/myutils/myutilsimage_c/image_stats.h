@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of MultimediaTools. https://github.com/juanbarrios/multimedia_tools
+ * MultimediaTools is made available under the terms of the BSD 2-Clause License.
+ */
+
+#ifndef MYUTILSIMAGE_IMAGE_STATS_H
+#define MYUTILSIMAGE_IMAGE_STATS_H
+
+#include "../myutilsimage_c.h"
+
+#ifndef NO_OPENCV
+
+#include <opencv2/core/core_c.h>
+
+/**
+ * Running mean and variance for every pixel of a sequence of gray images.
+ * Values are stored row-major (same layout than the image rows) in order to
+ * process each image row with a single vectorizable loop.
+ */
+typedef struct MyImageStats MyImageStats;
+
+MyImageStats *my_imageStats_new(int64_t width, int64_t height);
+
+/**
+ * Enables the convergence test. Every @p check_interval added images the
+ * average absolute change of the means is compared to @p tolerance.
+ * A tolerance less or equal than zero disables the test (default).
+ * @param stats
+ * @param check_interval number of images between two consecutive tests
+ * @param tolerance maximum average change (in gray levels) to consider that means converged
+ */
+void my_imageStats_setConvergence(MyImageStats *stats, int64_t check_interval,
+		double tolerance);
+
+/**
+ * Updates the statistics with the pixels of @p imgGray (8-bit, 1 channel).
+ * The ROI is not considered, the image must have the same size than the stats.
+ * @param stats
+ * @param imgGray
+ */
+void my_imageStats_addImage(MyImageStats *stats, IplImage *imgGray);
+
+/**
+ * Updates the statistics of row @p numRow. Every row must be updated once
+ * for each image, the counter of images is increased by
+ * my_imageStats_addImage or after updating the last row.
+ * @param stats
+ * @param numRow
+ * @param pixels at least width values
+ */
+void my_imageStats_addRow(MyImageStats *stats, int64_t numRow,
+		const uchar *pixels);
+
+int64_t my_imageStats_getNumImages(MyImageStats *stats);
+
+/**
+ * @param stats
+ * @return true if the convergence test is enabled and the last test passed.
+ */
+bool my_imageStats_hasConverged(MyImageStats *stats);
+
+/**
+ * @param stats
+ * @return row-major array of width*height means
+ */
+float *my_imageStats_getMeans(MyImageStats *stats);
+/**
+ * @param stats
+ * @return row-major array of width*height variances (population variance)
+ */
+float *my_imageStats_getVariances(MyImageStats *stats);
+
+/**
+ * Creates a gray image with the means. Same as my_image_newFromArray: when
+ * @p max_val is zero values are scaled to the maximum mean.
+ */
+IplImage *my_imageStats_newImageMeans(MyImageStats *stats, double max_val);
+/**
+ * Creates a gray image with the variances. Same as my_image_newFromArray:
+ * when @p max_val is zero values are scaled to the maximum variance.
+ */
+IplImage *my_imageStats_newImageVariances(MyImageStats *stats,
+		double max_val);
+
+void my_imageStats_release(MyImageStats *stats);
+
+#endif
+#endif
@@ -182,6 +182,9 @@ struct MyConvolutionKernel *my_convolution_newKernel(int64_t width,
 	kc->center_x = kc->size_x / 2;
 	kc->center_y = kc->size_y / 2;
 	kc->valores = MY_MALLOC_MATRIX(kc->size_x, kc->size_y, double);
+	kc->coefs = MY_MALLOC(kc->size, float);
+	kc->coefs_x = MY_MALLOC(kc->size_x, float);
+	kc->coefs_y = MY_MALLOC(kc->size_y, float);
 	return kc;
 }
 void my_convolution_initKernel(struct MyConvolutionKernel *kc, double *valores) {
@@ -200,48 +203,151 @@ void my_convolution_releaseKernel(struct MyConvolutionKernel *kc) {
 	if (kc == NULL)
 		return;
 	MY_FREE_MATRIX(kc->valores, kc->size_x);
-	MY_FREE(kc);
+	MY_FREE_MULTI(kc->coefs, kc->coefs_x, kc->coefs_y, kc->padded, kc->temp,
+			kc);
 }
 
 #define PIXC_8U(img, x, y, nc) (((uchar*) ((img)->imageData + (img)->widthStep * (y)))[img->nChannels*(x)+(nc)])
 
-static double priv_calcular_kernel(IplImage *imgIn, int64_t pix_x,
-		int64_t pix_y, int64_t nc, struct MyConvolutionKernel *kc) {
-	double sum = 0;
-	int64_t i, j;
+//copies valores (which may be modified after init) to row-major coefficients
+//and tests whether the kernel is the outer product of a column and a row
+static void priv_prepareKernel(struct MyConvolutionKernel *kc) {
+	int64_t i, j, max_i = 0, max_j = 0;
+	double max_abs = 0;
 	for (j = 0; j < kc->size_y; ++j) {
-		int64_t posy = pix_y - kc->center_y + j;
-		if (posy < 0)
-			posy = 0;
-		else if (posy >= imgIn->height)
-			posy = imgIn->height - 1;
 		for (i = 0; i < kc->size_x; ++i) {
-			int64_t posx = pix_x - kc->center_x + i;
-			if (posx < 0)
-				posx = 0;
-			else if (posx >= imgIn->width)
-				posx = imgIn->width - 1;
-			double value = 0;
-			if (imgIn->depth == IPL_DEPTH_8U)
-				value = PIXC_8U(imgIn, posx, posy, nc);
-			else
-				my_log_error("no soportado por my_convolution_perform\n");
-			sum += value * kc->valores[i][j];
+			double v = kc->valores[i][j];
+			kc->coefs[j * kc->size_x + i] = v;
+			if (fabs(v) > max_abs) {
+				max_abs = fabs(v);
+				max_i = i;
+				max_j = j;
+			}
+		}
+	}
+	kc->is_separable = false;
+	if (kc->size_x == 1 || kc->size_y == 1 || max_abs == 0)
+		return;
+	double pivot = kc->valores[max_i][max_j];
+	for (i = 0; i < kc->size_x; ++i)
+		kc->coefs_x[i] = kc->valores[i][max_j];
+	for (j = 0; j < kc->size_y; ++j)
+		kc->coefs_y[j] = kc->valores[max_i][j] / pivot;
+	for (j = 0; j < kc->size_y; ++j) {
+		for (i = 0; i < kc->size_x; ++i) {
+			double diff = kc->valores[i][j]
+					- kc->valores[i][max_j] * kc->valores[max_i][j] / pivot;
+			if (fabs(diff) > 1e-6 * max_abs)
+				return;
+		}
+	}
+	kc->is_separable = true;
+}
+//copies one channel into a float plane with (size_x-1) extra columns and
+//(size_y-1) extra rows, replicating the border pixels
+static void priv_padChannel(IplImage *imgIn, int64_t nc,
+		struct MyConvolutionKernel *kc, float *padded) {
+	int64_t width = imgIn->width, height = imgIn->height;
+	int64_t nch = imgIn->nChannels;
+	int64_t padded_w = width + kc->size_x - 1;
+	int64_t padded_h = height + kc->size_y - 1;
+	int64_t right = kc->size_x - 1 - kc->center_x;
+	for (int64_t py = 0; py < padded_h; ++py) {
+		int64_t y = MIN(MAX(py - kc->center_y, 0), height - 1);
+		float *row = padded + py * padded_w;
+		float *dst = row + kc->center_x;
+		if (imgIn->depth == IPL_DEPTH_8U) {
+			uchar *src = (uchar*) (imgIn->imageData + imgIn->widthStep * y);
+			for (int64_t x = 0; x < width; ++x)
+				dst[x] = src[x * nch + nc];
+		} else if (imgIn->depth == IPL_DEPTH_32F) {
+			float *src = (float*) (imgIn->imageData + imgIn->widthStep * y);
+			for (int64_t x = 0; x < width; ++x)
+				dst[x] = src[x * nch + nc];
+		} else {
+			my_log_error("unsupported depth %i for convolution\n",
+					imgIn->depth);
+		}
+		for (int64_t x = 0; x < kc->center_x; ++x)
+			row[x] = dst[0];
+		for (int64_t x = 0; x < right; ++x)
+			dst[width + x] = dst[width - 1];
+	}
+}
+//dst += k * src, the loop is vectorized by the compiler
+static void priv_addScaledRow(float *restrict dst, const float *restrict src,
+		float k, int64_t length) {
+	for (int64_t x = 0; x < length; ++x)
+		dst[x] += k * src[x];
+}
+static void priv_convolvePlane(struct MyConvolutionKernel *kc,
+		const float *padded, int64_t width, int64_t height, float *output) {
+	int64_t padded_w = width + kc->size_x - 1;
+	int64_t padded_h = height + kc->size_y - 1;
+	MY_SETZERO(output, width * height, float);
+	if (kc->is_separable) {
+		//row pass on every padded row, then column pass
+		float *temp = kc->temp;
+		MY_SETZERO(temp, width * padded_h, float);
+		for (int64_t py = 0; py < padded_h; ++py) {
+			for (int64_t i = 0; i < kc->size_x; ++i)
+				priv_addScaledRow(temp + py * width,
+						padded + py * padded_w + i, kc->coefs_x[i], width);
+		}
+		for (int64_t y = 0; y < height; ++y) {
+			for (int64_t j = 0; j < kc->size_y; ++j)
+				priv_addScaledRow(output + y * width, temp + (y + j) * width,
+						kc->coefs_y[j], width);
 		}
+	} else {
+		for (int64_t y = 0; y < height; ++y) {
+			for (int64_t j = 0; j < kc->size_y; ++j) {
+				const float *src = padded + (y + j) * padded_w;
+				const float *coefs = kc->coefs + j * kc->size_x;
+				for (int64_t i = 0; i < kc->size_x; ++i) {
+					if (coefs[i] != 0)
+						priv_addScaledRow(output + y * width, src + i,
+								coefs[i], width);
+				}
+			}
+		}
+	}
+}
+void my_convolution_performBuffer(IplImage *imgIn,
+		struct MyConvolutionKernel *kc, float *output) {
+	int64_t width = imgIn->width, height = imgIn->height;
+	int64_t padded_h = height + kc->size_y - 1;
+	int64_t padded_size = (width + kc->size_x - 1) * padded_h;
+	if (padded_size > kc->padded_size) {
+		MY_REALLOC(kc->padded, padded_size, float);
+		kc->padded_size = padded_size;
+	}
+	if (width * padded_h > kc->temp_size) {
+		MY_REALLOC(kc->temp, width * padded_h, float);
+		kc->temp_size = width * padded_h;
+	}
+	priv_prepareKernel(kc);
+	for (int64_t nc = 0; nc < imgIn->nChannels; ++nc) {
+		priv_padChannel(imgIn, nc, kc, kc->padded);
+		priv_convolvePlane(kc, kc->padded, width, height,
+				output + nc * width * height);
 	}
-	return sum;
 }
 void my_convolution_perform(IplImage *imgIn, struct MyConvolutionKernel *kc,
 		double ***my_convolution_perform) {
+	int64_t width = imgIn->width, height = imgIn->height;
+	float *output = MY_MALLOC_NOINIT(imgIn->nChannels * width * height, float);
+	my_convolution_performBuffer(imgIn, kc, output);
 	int64_t x, y, nc;
 	for (nc = 0; nc < imgIn->nChannels; ++nc) {
-		for (y = 0; y < imgIn->height; ++y) {
-			for (x = 0; x < imgIn->width; ++x) {
-				my_convolution_perform[nc][x][y] = priv_calcular_kernel(imgIn,
-						x, y, nc, kc);
+		float *plane = output + nc * width * height;
+		for (y = 0; y < height; ++y) {
+			for (x = 0; x < width; ++x) {
+				my_convolution_perform[nc][x][y] = plane[y * width + x];
 			}
 		}
 	}
+	MY_FREE(output);
 }
 IplImage *my_image_newFromArray(double **matriz, int64_t width, int64_t height,
 		double max_val) {
@@ -298,6 +404,33 @@ void my_image_copyArrayToPixels(double ***my_convolution_perform,
 		}
 	}
 }
+void my_image_copyBufferToPixels(const float *buffer, double max_val,
+		uchar abs, IplImage *imgOut) {
+	int64_t width = imgOut->width, height = imgOut->height;
+	int64_t nch = imgOut->nChannels, plane = width * height;
+	if (max_val == 0) {
+		for (int64_t i = 0; i < nch * plane; ++i) {
+			double v = buffer[i];
+			if (v > max_val)
+				max_val = v;
+			if (abs && -v > max_val)
+				max_val = -v;
+		}
+	}
+	double escala = max_val == 0 ? 1 : 256.0 / max_val;
+	for (int64_t y = 0; y < height; ++y) {
+		uchar *ptr = (uchar*) (imgOut->imageData + imgOut->widthStep * y);
+		for (int64_t nc = 0; nc < nch; ++nc) {
+			const float *row = buffer + nc * plane + y * width;
+			for (int64_t x = 0; x < width; ++x) {
+				double v = row[x];
+				if (abs && v < 0)
+					v = -v;
+				ptr[x * nch + nc] = my_math_round_uint8(v * escala);
+			}
+		}
+	}
+}
 int64_t my_image_copyPixelsToUcharArray(IplImage *imgGray, uchar **prt_buffer) {
 	my_assert_equalInt("depth", imgGray->depth, 8);
 	my_assert_equalInt("nChannels", imgGray->nChannels, 1);
@@ -332,6 +465,24 @@ void my_image_pgm_saveBuffer(const char *filePgm, IplImage *imgGray,
 	fwrite(*prt_buffer, sizeof(uchar), nBytes, out);
 	fclose(out);
 }
+int64_t my_image_pgm_encodeBuffer(IplImage *imgGray, uchar **prt_buffer) {
+	my_assert_equalInt("depth", imgGray->depth, 8);
+	my_assert_equalInt("nChannels", imgGray->nChannels, 1);
+	char header[64];
+	int64_t nHeader = snprintf(header, sizeof(header), "P5\n%i %i\n255\n",
+			imgGray->width, imgGray->height);
+	int64_t nBytes = nHeader + imgGray->width * imgGray->height;
+	MY_REALLOC(*prt_buffer, nBytes, uchar);
+	uchar *buffer = *prt_buffer;
+	memcpy(buffer, header, nHeader);
+	int64_t y, cont = nHeader;
+	for (y = 0; y < imgGray->height; ++y) {
+		memcpy(buffer + cont, imgGray->imageData + imgGray->widthStep * y,
+				imgGray->width);
+		cont += imgGray->width;
+	}
+	return cont;
+}
 uchar my_image_pgm_loadBuffer(const char *filePgm, uchar **prt_buffer,
 		IplImage **ptr_imgGris) {
 	FILE* in = my_io_openFileRead1(filePgm, 0);
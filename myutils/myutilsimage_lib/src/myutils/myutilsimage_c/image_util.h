@@ -35,12 +35,27 @@ void my_image_fill_squares(IplImage *img);
 struct MyConvolutionKernel {
 	int64_t size_x, size_y, center_x, center_y, size;
 	double **valores;
+	//internal: coefficients and border-padded planes used by perform
+	float *coefs, *coefs_x, *coefs_y, *padded, *temp;
+	bool is_separable;
+	int64_t padded_size, temp_size;
 };
 struct MyConvolutionKernel *my_convolution_newKernel(int64_t width,
 		int64_t height);
 void my_convolution_initKernel(struct MyConvolutionKernel *kc, double *valores);
 void my_convolution_initAverageKernel(struct MyConvolutionKernel *kc);
 void my_convolution_releaseKernel(struct MyConvolutionKernel *kc);
+/**
+ * Convolves every channel of @p imgIn (8U or 32F) replicating the border
+ * pixels. Separable kernels (rank one) are computed as a row pass followed
+ * by a column pass.
+ * @param imgIn
+ * @param kc
+ * @param output nChannels*height*width values, one row-major plane per channel
+ */
+void my_convolution_performBuffer(IplImage *imgIn,
+		struct MyConvolutionKernel *kc, float *output);
+//same as my_convolution_performBuffer, the output is indexed [nc][x][y]
 void my_convolution_perform(IplImage *imgIn, struct MyConvolutionKernel *kc,
 		double ***my_convolution_perform);
 
@@ -48,12 +63,17 @@ IplImage *my_image_newFromArray(double **matriz, int64_t width, int64_t height,
 		double max_val);
 void my_image_copyArrayToPixels(double ***my_convolution_perform,
 		double max_val, uchar abs, IplImage *imgOut);
+//same as my_image_copyArrayToPixels for the output of my_convolution_performBuffer
+void my_image_copyBufferToPixels(const float *buffer, double max_val,
+		uchar abs, IplImage *imgOut);
 
 int64_t my_image_copyPixelsToUcharArray(IplImage *imgGray, uchar **prt_buffer);
 int64_t my_image_copyPixelsToFloatArray(IplImage *imgGray, float **prt_buffer);
 
 void my_image_pgm_saveBuffer(const char *filePgm, IplImage *imgGris,
 		uchar **prt_buffer);
+//encodes the image as pgm (header and pixels) in *prt_buffer. Returns the number of bytes.
+int64_t my_image_pgm_encodeBuffer(IplImage *imgGray, uchar **prt_buffer);
 uchar my_image_pgm_loadBuffer(const char *filePgm, uchar **prt_buffer,
 		IplImage **ptr_imgGris);
 void my_image_pgm_saveImage(const char *filePgm, IplImage *imgGris);
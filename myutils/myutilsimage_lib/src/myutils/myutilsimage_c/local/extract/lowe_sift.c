@@ -11,12 +11,29 @@
 
 //SIFT reference implementation
 //Downloaded from: http://www.cs.ubc.ca/~lowe/keypoints/
-static void parse_file_lowe(char *filenameTxt, MyLocalDescriptors *descriptors) {
-	if (!my_io_existsFile(filenameTxt))
-		return;
-	MyVectorString *lines = my_io_loadLinesFile(filenameTxt);
-	if (my_vectorString_size(lines) < 2)
+
+//non-empty lines of the standard output
+static MyVectorString *split_lines(const char *text) {
+	MyVectorString *lines = my_vectorString_new();
+	MyTokenizer *tk = my_tokenizer_new(text, '\n');
+	while (my_tokenizer_hasNext(tk)) {
+		const char *line = my_tokenizer_nextToken(tk);
+		int64_t len = strlen(line);
+		if (len > 0 && line[len - 1] == '\r')
+			len--;
+		if (len > 0)
+			my_vectorString_add(lines, my_subStringI_fromTo(line, 0, len));
+	}
+	my_tokenizer_release(tk);
+	return lines;
+}
+static void parse_output_lowe(const char *output,
+		MyLocalDescriptors *descriptors) {
+	MyVectorString *lines = split_lines(output);
+	if (my_vectorString_size(lines) < 2) {
+		my_vectorString_release(lines, true);
 		return;
+	}
 	MyVectorString *values1 = my_tokenizer_splitLine(
 			my_vectorString_get(lines, 0), ' ');
 	int64_t numDesc = my_parse_int(my_vectorString_get(values1, 0));
@@ -57,36 +74,34 @@ static void parse_file_lowe(char *filenameTxt, MyLocalDescriptors *descriptors)
 	}
 	my_vectorString_release(lines, true);
 }
-static void extract_lowe(const char *filename, MyLocalDescriptors *descriptors) {
+//the pgm is written to the standard input and the keypoints are read from
+//the standard output, no temporal files are created
+static void extract_lowe(const void *pgm_bytes, int64_t num_bytes,
+		MyLocalDescriptors *descriptors) {
 	my_localDescriptors_redefineNumDescriptors(descriptors, 0);
 	const char *binary = my_env_getString_def2("COMPUTEDESCRIPTORS",
 			"siftWin32.exe", "sift");
-	char *fLog = my_newString_format("%s.log", filename);
-	char *fDesc = my_newString_format("%s.desc", filename);
-	my_io_deleteFile(fLog, false);
-	my_io_deleteFile(fDesc, false);
-	char *cmd = my_newString_format("%s < %s > %s 2> %s", binary, filename,
-			fDesc, fLog);
-	my_io_system(cmd);
-	parse_file_lowe(fDesc, descriptors);
-	my_io_deleteFile(fLog, false);
-	my_io_deleteFile(fDesc, false);
-	MY_FREE_MULTI(fLog, fDesc, cmd);
+	char *output = NULL;
+	my_io_system_pipe(binary, pgm_bytes, num_bytes, &output, NULL);
+	parse_output_lowe(output, descriptors);
+	MY_FREE(output);
 }
 
 void my_local_lowe_extract_filenamePgm(const char *filename,
 		MyLocalDescriptors *descriptors) {
-	extract_lowe(filename, descriptors);
+	int64_t num_bytes = 0;
+	void *bytes = my_io_loadFileBytes(filename, &num_bytes);
+	extract_lowe(bytes, num_bytes, descriptors);
+	MY_FREE(bytes);
 }
 
 #ifndef NO_OPENCV
 #include <opencv2/core/core_c.h>
 
 void my_local_lowe_extract(IplImage *image, MyLocalDescriptors *descriptors) {
-	char *filename = my_io_temp_createNewFile(".pgm");
-	my_image_pgm_saveImage(filename, image);
-	extract_lowe(filename, descriptors);
-	my_io_deleteFile(filename, false);
-	free(filename);
+	uchar *buffer = NULL;
+	int64_t num_bytes = my_image_pgm_encodeBuffer(image, &buffer);
+	extract_lowe(buffer, num_bytes, descriptors);
+	MY_FREE(buffer);
 }
 #endif
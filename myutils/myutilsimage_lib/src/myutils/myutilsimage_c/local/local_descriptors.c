@@ -18,6 +18,10 @@ struct MyLocalDescriptors {
 	char *vectors_buffer;
 	int64_t keypoints_buffer_size;
 	struct MyLocalKeypoint *keypoints_buffer;
+	//views (my_localDescriptors_deserializeView) read the serialized bytes in
+	//place: keypoints may be unaligned so they are copied one by one on read
+	const char *view_keypoints;
+	bool view_vectors;
 };
 
 MyLocalDescriptors *my_localDescriptors_new(int64_t num_descriptors,
@@ -40,9 +44,30 @@ int64_t my_localDescriptors_getVectorDimensions(MyLocalDescriptors *ldes) {
 int64_t my_localDescriptors_getNumDescriptors(MyLocalDescriptors *ldes) {
 	return ldes->num_descriptors;
 }
+//a view copies the serialized data before any modification
+static void priv_detachView(MyLocalDescriptors *ldes) {
+	if (ldes->view_keypoints != NULL) {
+		struct MyLocalKeypoint *kps = MY_MALLOC_NOINIT(
+				MAX(1, ldes->num_descriptors), struct MyLocalKeypoint);
+		memcpy(kps, ldes->view_keypoints,
+				ldes->num_descriptors * sizeof(struct MyLocalKeypoint));
+		ldes->keypoints_buffer = kps;
+		ldes->keypoints_buffer_size = ldes->num_descriptors;
+		ldes->view_keypoints = NULL;
+	}
+	if (ldes->view_vectors) {
+		size_t size = ldes->num_descriptors * ldes->size_bytes_one_vector;
+		char *vectors = MY_MALLOC_NOINIT(MAX(1, size), char);
+		memcpy(vectors, ldes->vectors_buffer, size);
+		ldes->vectors_buffer = vectors;
+		ldes->vectors_buffer_size = size;
+		ldes->view_vectors = false;
+	}
+}
 void my_localDescriptors_redefineVectorDatatype(MyLocalDescriptors *ldes,
 		MyDatatype vector_datatype, int64_t vector_dimensions,
 		int64_t num_descriptors) {
+	priv_detachView(ldes);
 	ldes->vector_datatype = vector_datatype;
 	ldes->vector_dimensions = vector_dimensions;
 	ldes->size_bytes_one_vector = my_datatype_sizeof(vector_datatype)
@@ -51,6 +76,7 @@ void my_localDescriptors_redefineVectorDatatype(MyLocalDescriptors *ldes,
 }
 void my_localDescriptors_redefineNumDescriptors(MyLocalDescriptors *ldes,
 		int64_t num_descriptors) {
+	priv_detachView(ldes);
 	if (num_descriptors > ldes->keypoints_buffer_size) {
 		MY_REALLOC(ldes->keypoints_buffer, num_descriptors,
 				struct MyLocalKeypoint);
@@ -77,19 +103,30 @@ void my_localDescriptors_setKeypoint(MyLocalDescriptors *ldes,
 	kp.radius = radius;
 	kp.angle = angle;
 	validateRadiusAngle(kp.radius, kp.angle);
+	priv_detachView(ldes);
 	ldes->keypoints_buffer[idDescriptor] = kp;
 }
 void my_localDescriptors_setKeypointSt(MyLocalDescriptors *ldes,
 		int64_t idDescriptor, struct MyLocalKeypoint kp) {
 	validateRadiusAngle(kp.radius, kp.angle);
+	priv_detachView(ldes);
 	ldes->keypoints_buffer[idDescriptor] = kp;
 }
 struct MyLocalKeypoint my_localDescriptors_getKeypoint(MyLocalDescriptors *ldes,
 		int64_t idDescriptor) {
+	if (ldes->view_keypoints != NULL) {
+		struct MyLocalKeypoint kp;
+		memcpy(&kp,
+				ldes->view_keypoints
+						+ idDescriptor * sizeof(struct MyLocalKeypoint),
+				sizeof(struct MyLocalKeypoint));
+		return kp;
+	}
 	return ldes->keypoints_buffer[idDescriptor];
 }
 void my_localDescriptors_setVector(MyLocalDescriptors *ldes,
 		int64_t idDescriptor, const void *vector) {
+	priv_detachView(ldes);
 	char *first = ldes->vectors_buffer
 			+ idDescriptor * ldes->size_bytes_one_vector;
 	memcpy(first, vector, ldes->size_bytes_one_vector);
@@ -128,7 +165,7 @@ void my_localDescriptors_release(MyLocalDescriptors *ldes) {
 		return;
 	if (ldes->keypoints_buffer != NULL)
 		free(ldes->keypoints_buffer);
-	if (ldes->vectors_buffer != NULL)
+	if (ldes->vectors_buffer != NULL && !ldes->view_vectors)
 		free(ldes->vectors_buffer);
 	free(ldes);
 }
@@ -149,6 +186,7 @@ void my_localDescriptors_rescaleKeypoints(MyLocalDescriptors *ldes,
 	double scaleInvX = new_width / ((double) processed_width);
 	double scaleInvY = new_height / ((double) processed_height);
 	double scaleInvAvg = (scaleInvX + scaleInvY) / 2.0;
+	priv_detachView(ldes);
 	for (int64_t i = 0; i < ldes->num_descriptors; ++i) {
 		struct MyLocalKeypoint *kp = ldes->keypoints_buffer + i;
 		validateKpPosition(kp->x, kp->y, processed_width, processed_height);
@@ -177,7 +215,8 @@ char *my_localDescriptors_toString(MyLocalDescriptors *ldes) {
 	MyStringBuffer *sb = my_stringbuf_new();
 	my_stringbuf_appendInt(sb, ldes->num_descriptors);
 	for (int64_t i = 0; i < ldes->num_descriptors; ++i) {
-		char *st_kp = keypoint_to_string(ldes->keypoints_buffer + i);
+		struct MyLocalKeypoint kp = my_localDescriptors_getKeypoint(ldes, i);
+		char *st_kp = keypoint_to_string(&kp);
 		void *vector = my_localDescriptors_getVector(ldes, i);
 		char *st_vc = vectorToString(vector, ldes->vector_dimensions, "", " ",
 				"");
@@ -201,7 +240,10 @@ MyLocalDescriptors *my_localDescriptors_clone(MyLocalDescriptors *ldes) {
 			* my_datatype_sizeof(ldes->vector_datatype);
 	MyLocalDescriptors *newdes = my_localDescriptors_new(ldes->num_descriptors,
 			ldes->vector_datatype, ldes->vector_dimensions);
-	memcpy(newdes->keypoints_buffer, ldes->keypoints_buffer, size_kp);
+	memcpy(newdes->keypoints_buffer,
+			ldes->view_keypoints != NULL ?
+					(const void*) ldes->view_keypoints :
+					(const void*) ldes->keypoints_buffer, size_kp);
 	memcpy(newdes->vectors_buffer, ldes->vectors_buffer, size_vectors);
 	return newdes;
 }
@@ -231,7 +273,10 @@ size_t my_localDescriptors_serialize(MyLocalDescriptors *ldes,
 	((int64_t*) start_header)[1] = ldes->vector_dimensions;
 	((MyDatatype*) (start_header + 2 * sizeof(int64_t)))[0] =
 			ldes->vector_datatype;
-	memcpy(start_kp, ldes->keypoints_buffer, size_kp);
+	memcpy(start_kp,
+			ldes->view_keypoints != NULL ?
+					(const void*) ldes->view_keypoints :
+					(const void*) ldes->keypoints_buffer, size_kp);
 	memcpy(start_vector, ldes->vectors_buffer, size_vectors);
 	return size_header + size_kp + size_vectors;
 }
@@ -275,6 +320,203 @@ size_t my_localDescriptors_deserialize(void *data_buffer,
 	return size_header + size_kp + size_vectors;
 }
 
+size_t my_localDescriptors_deserializeView(void *data_buffer,
+		MyLocalDescriptors *ldes) {
+	if (data_buffer == NULL)
+		return 0;
+	int64_t num_descriptors = ((int64_t*) data_buffer)[0];
+	if (num_descriptors == 0)
+		return sizeof(int64_t);
+	size_t size_header = 2 * sizeof(int64_t) + sizeof(MyDatatype);
+	char *start_header = data_buffer;
+	int64_t vector_dimensions = ((int64_t*) start_header)[1];
+	MyDatatype vector_datatype = ((MyDatatype*) (start_header
+			+ 2 * sizeof(int64_t)))[0];
+	size_t size_type = my_datatype_sizeof(vector_datatype);
+	size_t size_kp = num_descriptors * sizeof(struct MyLocalKeypoint);
+	size_t size_vectors = num_descriptors * vector_dimensions * size_type;
+	char *start_kp = start_header + size_header;
+	char *start_vector = start_header + size_header + size_kp;
+	//vectors are returned as pointers, they can't be read in place when they
+	//are not aligned to the datatype
+	if (((uintptr_t) start_vector) % size_type != 0)
+		return my_localDescriptors_deserialize(data_buffer, ldes);
+	MY_FREE(ldes->keypoints_buffer);
+	if (!ldes->view_vectors)
+		MY_FREE(ldes->vectors_buffer);
+	ldes->keypoints_buffer = NULL;
+	ldes->keypoints_buffer_size = 0;
+	ldes->vector_datatype = vector_datatype;
+	ldes->vector_dimensions = vector_dimensions;
+	ldes->size_bytes_one_vector = size_type * vector_dimensions;
+	ldes->num_descriptors = num_descriptors;
+	ldes->view_keypoints = start_kp;
+	ldes->vectors_buffer = start_vector;
+	ldes->vectors_buffer_size = size_vectors;
+	ldes->view_vectors = true;
+	return size_header + size_kp + size_vectors;
+}
+
+//compact format: the header adds the vector encoding and its scale, the
+//keypoints are stored in single precision
+#define COMPACT_HEADER_SIZE (2 * sizeof(int64_t) + sizeof(MyDatatype) + sizeof(uint8_t) + sizeof(float))
+static size_t priv_compactVectorSize(int64_t encoding, MyDatatype datatype) {
+	if (encoding == MY_LOCALDESCRIPTORS_COMPACT_FLOAT16)
+		return sizeof(uint16_t);
+	else if (encoding == MY_LOCALDESCRIPTORS_COMPACT_INT8)
+		return sizeof(int8_t);
+	return my_datatype_sizeof(datatype);
+}
+double my_localDescriptors_getMaxAbsValue(MyLocalDescriptors *ldes) {
+	int64_t elements = ldes->vector_dimensions * ldes->num_descriptors;
+	if (elements == 0)
+		return 0;
+	double *buffer = MY_MALLOC_NOINIT(elements, double);
+	my_datatype_getFunctionCopyVector(ldes->vector_datatype,
+			MY_DATATYPE_FLOAT64)(ldes->vectors_buffer, buffer, elements);
+	double max = 0;
+	for (int64_t i = 0; i < elements; ++i)
+		max = MAX(max, fabs(buffer[i]));
+	MY_FREE(buffer);
+	return max;
+}
+size_t my_localDescriptors_serializeCompactMaxBytes(MyLocalDescriptors *ldes) {
+	if (ldes->num_descriptors <= 0)
+		return sizeof(int64_t);
+	return COMPACT_HEADER_SIZE + ldes->num_descriptors * 4 * sizeof(float)
+			+ ldes->num_descriptors * ldes->size_bytes_one_vector;
+}
+size_t my_localDescriptors_serializeCompact(MyLocalDescriptors *ldes,
+		int64_t encoding, float scale, void *data_buffer) {
+	int64_t num = ldes->num_descriptors;
+	if (num <= 0) {
+		memcpy(data_buffer, &num, sizeof(int64_t));
+		return sizeof(int64_t);
+	}
+	//integer vectors are kept as they are
+	if (!my_datatype_isAnyFloatingPoint(ldes->vector_datatype)
+			|| (encoding == MY_LOCALDESCRIPTORS_COMPACT_INT8 && scale <= 0))
+		encoding = MY_LOCALDESCRIPTORS_COMPACT_NONE;
+	uint8_t enc = encoding;
+	char *ptr = data_buffer;
+	memcpy(ptr, &num, sizeof(int64_t));
+	memcpy(ptr + sizeof(int64_t), &ldes->vector_dimensions, sizeof(int64_t));
+	ptr += 2 * sizeof(int64_t);
+	memcpy(ptr, &ldes->vector_datatype, sizeof(MyDatatype));
+	ptr += sizeof(MyDatatype);
+	memcpy(ptr, &enc, sizeof(uint8_t));
+	ptr += sizeof(uint8_t);
+	memcpy(ptr, &scale, sizeof(float));
+	ptr += sizeof(float);
+	for (int64_t i = 0; i < num; ++i) {
+		struct MyLocalKeypoint kp = my_localDescriptors_getKeypoint(ldes, i);
+		float values[4] = { kp.x, kp.y, kp.radius, kp.angle };
+		memcpy(ptr, values, sizeof(values));
+		ptr += sizeof(values);
+	}
+	int64_t elements = num * ldes->vector_dimensions;
+	if (encoding == MY_LOCALDESCRIPTORS_COMPACT_NONE) {
+		memcpy(ptr, ldes->vectors_buffer, num * ldes->size_bytes_one_vector);
+		ptr += num * ldes->size_bytes_one_vector;
+	} else {
+		float *values = MY_MALLOC_NOINIT(elements, float);
+		my_datatype_getFunctionCopyVector(ldes->vector_datatype,
+				MY_DATATYPE_FLOAT32)(ldes->vectors_buffer, values, elements);
+		if (encoding == MY_LOCALDESCRIPTORS_COMPACT_FLOAT16) {
+			for (int64_t i = 0; i < elements; ++i) {
+				uint16_t h = my_math_floatToHalf(values[i]);
+				memcpy(ptr, &h, sizeof(uint16_t));
+				ptr += sizeof(uint16_t);
+			}
+		} else {
+			int8_t *out = (int8_t*) ptr;
+			for (int64_t i = 0; i < elements; ++i) {
+				float q = roundf(values[i] * scale);
+				out[i] = (int8_t) MAX(-127, MIN(127, q));
+			}
+			ptr += elements;
+		}
+		MY_FREE(values);
+	}
+	return ptr - (char*) data_buffer;
+}
+size_t my_localDescriptors_deserializeCompactPredictReadBytes(void *data_buffer) {
+	if (data_buffer == NULL)
+		return 0;
+	int64_t num = 0, dims = 0;
+	MyDatatype datatype;
+	uint8_t enc = 0;
+	char *ptr = data_buffer;
+	memcpy(&num, ptr, sizeof(int64_t));
+	if (num == 0)
+		return sizeof(int64_t);
+	memcpy(&dims, ptr + sizeof(int64_t), sizeof(int64_t));
+	memcpy(&datatype, ptr + 2 * sizeof(int64_t), sizeof(MyDatatype));
+	memcpy(&enc, ptr + 2 * sizeof(int64_t) + sizeof(MyDatatype),
+			sizeof(uint8_t));
+	return COMPACT_HEADER_SIZE + num * 4 * sizeof(float)
+			+ num * dims * priv_compactVectorSize(enc, datatype);
+}
+size_t my_localDescriptors_deserializeCompact(void *data_buffer,
+		MyLocalDescriptors *ldes) {
+	if (data_buffer == NULL)
+		return 0;
+	int64_t num = 0, dims = 0;
+	MyDatatype datatype;
+	uint8_t enc = 0;
+	float scale = 0;
+	char *ptr = data_buffer;
+	memcpy(&num, ptr, sizeof(int64_t));
+	if (num == 0)
+		return sizeof(int64_t);
+	memcpy(&dims, ptr + sizeof(int64_t), sizeof(int64_t));
+	ptr += 2 * sizeof(int64_t);
+	memcpy(&datatype, ptr, sizeof(MyDatatype));
+	ptr += sizeof(MyDatatype);
+	memcpy(&enc, ptr, sizeof(uint8_t));
+	ptr += sizeof(uint8_t);
+	memcpy(&scale, ptr, sizeof(float));
+	ptr += sizeof(float);
+	my_localDescriptors_redefineVectorDatatype(ldes, datatype, dims, num);
+	for (int64_t i = 0; i < num; ++i) {
+		float values[4];
+		memcpy(values, ptr, sizeof(values));
+		ptr += sizeof(values);
+		struct MyLocalKeypoint *kp = ldes->keypoints_buffer + i;
+		kp->x = values[0];
+		kp->y = values[1];
+		kp->radius = values[2];
+		kp->angle = values[3];
+	}
+	int64_t elements = num * dims;
+	if (enc == MY_LOCALDESCRIPTORS_COMPACT_NONE) {
+		memcpy(ldes->vectors_buffer, ptr, num * ldes->size_bytes_one_vector);
+		ptr += num * ldes->size_bytes_one_vector;
+	} else {
+		float *values = MY_MALLOC_NOINIT(elements, float);
+		if (enc == MY_LOCALDESCRIPTORS_COMPACT_FLOAT16) {
+			for (int64_t i = 0; i < elements; ++i) {
+				uint16_t h;
+				memcpy(&h, ptr, sizeof(uint16_t));
+				ptr += sizeof(uint16_t);
+				values[i] = my_math_halfToFloat(h);
+			}
+		} else if (enc == MY_LOCALDESCRIPTORS_COMPACT_INT8) {
+			const int8_t *in = (const int8_t*) ptr;
+			float inv_scale = 1.0f / scale;
+			for (int64_t i = 0; i < elements; ++i)
+				values[i] = in[i] * inv_scale;
+			ptr += elements;
+		} else {
+			my_log_error("unknown vector encoding %i\n", enc);
+		}
+		my_datatype_getFunctionCopyVector(MY_DATATYPE_FLOAT32, datatype)(values,
+				ldes->vectors_buffer, elements);
+		MY_FREE(values);
+	}
+	return ptr - (char*) data_buffer;
+}
+
 static int64_t my_localDescriptors_getNumObjects(void *data_pointer) {
 	MyLocalDescriptors *local_descriptors = data_pointer;
 	return my_localDescriptors_getNumDescriptors(local_descriptors);
@@ -322,11 +564,13 @@ MknnDataset *my_localDescriptors_createConcatenateMknnDataset_vectors(
 MknnDataset *my_localDescriptors_createMknnDataset_positions(
 		MyLocalDescriptors *local_descriptors,
 		bool free_descriptors_on_dataset_release) {
-	float *positions = MY_MALLOC_NOINIT(local_descriptors->num_descriptors,
+	float *positions = MY_MALLOC_NOINIT(2 * local_descriptors->num_descriptors,
 			float);
 	for (int64_t i = 0; i < local_descriptors->num_descriptors; ++i) {
-		positions[2 * i] = local_descriptors->keypoints_buffer[i].x;
-		positions[2 * i + 1] = local_descriptors->keypoints_buffer[i].y;
+		struct MyLocalKeypoint kp = my_localDescriptors_getKeypoint(
+				local_descriptors, i);
+		positions[2 * i] = kp.x;
+		positions[2 * i + 1] = kp.y;
 	}
 	return mknn_datasetLoader_PointerCompactVectors(positions, true,
 			local_descriptors->num_descriptors, 2,
@@ -49,6 +49,43 @@ size_t my_localDescriptors_serialize(MyLocalDescriptors *ldes,
 size_t my_localDescriptors_deserializePredictReadBytes(void *data_buffer);
 size_t my_localDescriptors_deserialize(void *data_buffer,
 		MyLocalDescriptors *ldes);
+/**
+ * Same as my_localDescriptors_deserialize but without copying: keypoints and
+ * vectors are read in place, thus @p data_buffer must remain valid (and
+ * unmodified) until @p ldes is released. Any modification of @p ldes first
+ * copies the data to its own buffers.
+ * Vectors not aligned to their datatype are copied as usual.
+ * @param data_buffer
+ * @param ldes
+ * @return the number of bytes read.
+ */
+size_t my_localDescriptors_deserializeView(void *data_buffer,
+		MyLocalDescriptors *ldes);
+
+#define MY_LOCALDESCRIPTORS_COMPACT_NONE 0
+#define MY_LOCALDESCRIPTORS_COMPACT_FLOAT16 1
+#define MY_LOCALDESCRIPTORS_COMPACT_INT8 2
+
+/**
+ * @return the maximum absolute value in the vectors, e.g. to compute the
+ * scale of MY_LOCALDESCRIPTORS_COMPACT_INT8 for a set of descriptors.
+ */
+double my_localDescriptors_getMaxAbsValue(MyLocalDescriptors *ldes);
+/**
+ * Compact serialization (lossy): keypoints in single precision, and
+ * floating point vectors either in half precision
+ * (MY_LOCALDESCRIPTORS_COMPACT_FLOAT16) or as round(value*scale) in int8
+ * (MY_LOCALDESCRIPTORS_COMPACT_INT8, usually scale=127/maxAbsValue).
+ * Integer vectors are stored as they are.
+ * Deserialization restores the original vector datatype.
+ * @return upper bound of the bytes written by my_localDescriptors_serializeCompact.
+ */
+size_t my_localDescriptors_serializeCompactMaxBytes(MyLocalDescriptors *ldes);
+size_t my_localDescriptors_serializeCompact(MyLocalDescriptors *ldes,
+		int64_t encoding, float scale, void *data_buffer);
+size_t my_localDescriptors_deserializeCompactPredictReadBytes(void *data_buffer);
+size_t my_localDescriptors_deserializeCompact(void *data_buffer,
+		MyLocalDescriptors *ldes);
 
 MknnDataset *my_localDescriptors_createMknnDataset_vectors(
 		MyLocalDescriptors *local_descriptors,
@@ -14,6 +14,8 @@
 struct MatchesAndModel {
 	int64_t numMatches;
 	int64_t *idVectorQ, *idVectorR;
+	//distance between the matched vectors, NULL when unknown
+	double *distances;
 };
 
 struct PairMatcher;
@@ -20,6 +20,7 @@ struct PairMatcher_Basic {
 	//output
 	int64_t numVectorsQ, numMatches, current_maxNumVectorsQ;
 	int64_t *vector_nn;
+	double *vector_dist;
 	struct MatchesAndModel *lastOutputMatches;
 };
 
@@ -97,6 +98,7 @@ int64_t pairMatcherBasic_computeMatches(struct PairMatcher_Basic *es,
 	es->numVectorsQ = numVectorsQ;
 	if (numVectorsQ > es->current_maxNumVectorsQ) {
 		MY_REALLOC(es->vector_nn, numVectorsQ, int64_t);
+		MY_REALLOC(es->vector_dist, numVectorsQ, double);
 		es->current_maxNumVectorsQ = numVectorsQ;
 	}
 	MknnResult *result = mknn_resolver_search(es->resolver, false, dataset_Q,
@@ -111,9 +113,11 @@ int64_t pairMatcherBasic_computeMatches(struct PairMatcher_Basic *es,
 			if (dist1NN != DBL_MAX && dist2NN != DBL_MAX
 					&& dist1NN / dist2NN <= es->ratio_2NN) {
 				es->vector_nn[i] = r->nn_position[0];
+				es->vector_dist[i] = dist1NN;
 			}
 		} else if (r->num_nns > 0) {
 			es->vector_nn[i] = r->nn_position[0];
+			es->vector_dist[i] = r->nn_distance[0];
 		}
 		if (es->vector_nn[i] >= 0)
 			es->numMatches++;
@@ -126,9 +130,10 @@ int64_t pairMatcherBasic_computeMatches(struct PairMatcher_Basic *es,
 void pairMatcherBasic_release(struct PairMatcher_Basic *es) {
 	if (es->lastOutputMatches != NULL)
 		MY_FREE_MULTI(es->lastOutputMatches->idVectorQ,
-				es->lastOutputMatches->idVectorR, es->lastOutputMatches);
+				es->lastOutputMatches->idVectorR,
+				es->lastOutputMatches->distances, es->lastOutputMatches);
 	mknn_distance_release(es->distance);
-	MY_FREE_MULTI(es->vector_nn, es);
+	MY_FREE_MULTI(es->vector_nn, es->vector_dist, es);
 }
 
 struct MatchesAndModel *pairMatcherBasic_getLastMatches(
@@ -141,11 +146,13 @@ struct MatchesAndModel *pairMatcherBasic_getLastMatches(
 		return outM;
 	MY_REALLOC(outM->idVectorQ, outM->numMatches, int64_t);
 	MY_REALLOC(outM->idVectorR, outM->numMatches, int64_t);
+	MY_REALLOC(outM->distances, outM->numMatches, double);
 	int64_t cont = 0;
 	for (int64_t i = 0; i < es->numVectorsQ; ++i) {
 		if (es->vector_nn[i] >= 0) {
 			outM->idVectorQ[cont] = i;
 			outM->idVectorR[cont] = es->vector_nn[i];
+			outM->distances[cont] = es->vector_dist[i];
 			cont++;
 		}
 	}
@@ -18,11 +18,19 @@ struct C_TransfModel {
 	bool *isInlier;
 	int64_t contInliers;
 };
+struct LOrder {
+	double distance;
+	int64_t numPair;
+};
 struct PairMatcher_Ransac {
 	int64_t numCycles, modelType, minMatches, minSamplesModel;
 	double minWidth, maxWidth, minHeight, maxHeight, minRatioWH, maxRatioWH;
-	double distMaxInliers;
-	bool useLScorrection;
+	double distMaxInliers, confidence;
+	bool useLScorrection, useProsac;
+	//workspace, reused between cycles and between pairs
+	struct C_TransfModel *ws_current, *ws_candidate, *ws_best;
+	int64_t ws_capacity, *sample;
+	struct LOrder *order;
 	//eval
 	struct MatchesAndModel *inputMatches;
 	struct C_TransfModel *lastModel;
@@ -37,10 +45,29 @@ struct PairMatcher_Ransac {
 #define MODEL_AFFINE 4
 #define MODEL_PERSPECTIVE 5
 
-static struct C_TransfModel *loc_newModel(struct PairMatcher_Ransac *es) {
-	struct C_TransfModel *m = MY_MALLOC(1, struct C_TransfModel);
-	m->isInlier = MY_MALLOC(es->inputMatches->numMatches, bool);
-	return m;
+static struct C_TransfModel *loc_newModel() {
+	return MY_MALLOC(1, struct C_TransfModel);
+}
+static void loc_resetModel(struct C_TransfModel *m) {
+	bool *isInlier = m->isInlier;
+	MY_SETZERO(m, 1, struct C_TransfModel);
+	m->isInlier = isInlier;
+}
+static void loc_swapModels(struct C_TransfModel **m1,
+		struct C_TransfModel **m2) {
+	struct C_TransfModel *m = *m1;
+	*m1 = *m2;
+	*m2 = m;
+}
+static void loc_reserveWorkspace(struct PairMatcher_Ransac *es,
+		int64_t numMatches) {
+	if (numMatches <= es->ws_capacity)
+		return;
+	MY_REALLOC(es->ws_current->isInlier, numMatches, bool);
+	MY_REALLOC(es->ws_candidate->isInlier, numMatches, bool);
+	MY_REALLOC(es->ws_best->isInlier, numMatches, bool);
+	MY_REALLOC(es->order, numMatches, struct LOrder);
+	es->ws_capacity = numMatches;
 }
 struct LMatch {
 	struct MyLocalKeypoint src, des;
@@ -54,43 +81,41 @@ static struct LMatch loc_getMatchingPair(struct PairMatcher_Ransac *es,
 	lm.des = my_localDescriptors_getKeypoint(es->descriptorR, numR);
 	return lm;
 }
-static struct C_TransfModel *loc_fixModel1_trans(struct PairMatcher_Ransac *es,
-		int64_t numInlier) {
+static bool loc_fixModel1_trans(struct PairMatcher_Ransac *es,
+		struct C_TransfModel *m, int64_t numInlier) {
 	struct LMatch lm = loc_getMatchingPair(es, numInlier);
-	struct C_TransfModel *m = loc_newModel(es);
 	m->tx = lm.des.x - lm.src.x;
 	m->ty = lm.des.y - lm.src.y;
-	return m;
+	return true;
 }
-static struct C_TransfModel *loc_fixModel2_siftScale(
-		struct PairMatcher_Ransac *es, int64_t numInlier) {
+static bool loc_fixModel2_siftScale(struct PairMatcher_Ransac *es,
+		struct C_TransfModel *m, int64_t numInlier) {
 	struct LMatch lm = loc_getMatchingPair(es, numInlier);
-	struct C_TransfModel *m = loc_newModel(es);
 	if (lm.des.radius == 0 || lm.src.radius == 0)
 		my_log_error("keypoints do not have scale\n");
 	m->scalex = m->scaley = lm.des.radius / lm.src.radius;
 	m->tx = lm.des.x - m->scalex * lm.src.x;
 	m->ty = lm.des.y - m->scaley * lm.src.y;
-	return m;
+	return true;
 }
-static struct C_TransfModel *loc_fixModel2_twoScales(
-		struct PairMatcher_Ransac *es, int64_t numInlier1, int64_t numInlier2) {
+static bool loc_fixModel2_twoScales(struct PairMatcher_Ransac *es,
+		struct C_TransfModel *m, int64_t numInlier1, int64_t numInlier2) {
 	if (numInlier1 == numInlier2)
-		return NULL;
+		return false;
 	struct LMatch lm1 = loc_getMatchingPair(es, numInlier1);
 	struct LMatch lm2 = loc_getMatchingPair(es, numInlier2);
-	struct C_TransfModel *m = loc_newModel(es);
 	m->scalex = (lm1.des.x - lm2.des.x) / (lm1.src.x - lm2.src.x);
 	m->scaley = (lm1.des.y - lm2.des.y) / (lm1.src.y - lm2.src.y);
 	m->tx = lm1.des.x - m->scalex * lm1.src.x;
 	m->ty = lm1.des.y - m->scaley * lm1.src.y;
-	return m;
+	return true;
 }
-static struct C_TransfModel *loc_fixModel3_affine(struct PairMatcher_Ransac *es,
-		int64_t numInlier1, int64_t numInlier2, int64_t numInlier3) {
+static bool loc_fixModel3_affine(struct PairMatcher_Ransac *es,
+		struct C_TransfModel *m, int64_t numInlier1, int64_t numInlier2,
+		int64_t numInlier3) {
 	if (numInlier1 == numInlier2 || numInlier1 == numInlier3
 			|| numInlier2 == numInlier3)
-		return NULL;
+		return false;
 	struct LMatch lm1 = loc_getMatchingPair(es, numInlier1);
 	struct LMatch lm2 = loc_getMatchingPair(es, numInlier2);
 	struct LMatch lm3 = loc_getMatchingPair(es, numInlier3);
@@ -100,25 +125,24 @@ static struct C_TransfModel *loc_fixModel3_affine(struct PairMatcher_Ransac *es,
 	CvPoint2D32f pts_dst[3] = { cvPoint2D32f(lm1.des.x, lm1.des.y),
 			cvPoint2D32f(lm2.des.x, lm2.des.y), cvPoint2D32f(lm3.des.x,
 					lm3.des.y) };
-	CvMat* mapMatrix = cvCreateMat(2, 3, CV_32FC1);
-	cvGetAffineTransform(pts_src, pts_dst, mapMatrix);
-	struct C_TransfModel *m = loc_newModel(es);
-	m->a = cvGetReal2D(mapMatrix, 0, 0);
-	m->b = cvGetReal2D(mapMatrix, 0, 1);
-	m->c = cvGetReal2D(mapMatrix, 0, 2);
-	m->d = cvGetReal2D(mapMatrix, 1, 0);
-	m->e = cvGetReal2D(mapMatrix, 1, 1);
-	m->f = cvGetReal2D(mapMatrix, 1, 2);
-	cvReleaseMat(&mapMatrix);
-	return m;
-}
-static struct C_TransfModel *loc_fixModel4_hom(struct PairMatcher_Ransac *es,
-		int64_t numInlier1, int64_t numInlier2, int64_t numInlier3,
-		int64_t numInlier4) {
+	float data[6];
+	CvMat mapMatrix = cvMat(2, 3, CV_32FC1, data);
+	cvGetAffineTransform(pts_src, pts_dst, &mapMatrix);
+	m->a = data[0];
+	m->b = data[1];
+	m->c = data[2];
+	m->d = data[3];
+	m->e = data[4];
+	m->f = data[5];
+	return true;
+}
+static bool loc_fixModel4_hom(struct PairMatcher_Ransac *es,
+		struct C_TransfModel *m, int64_t numInlier1, int64_t numInlier2,
+		int64_t numInlier3, int64_t numInlier4) {
 	if (numInlier1 == numInlier2 || numInlier1 == numInlier3
 			|| numInlier1 == numInlier4 || numInlier2 == numInlier3
 			|| numInlier2 == numInlier4 || numInlier3 == numInlier4)
-		return NULL;
+		return false;
 	struct LMatch lm1 = loc_getMatchingPair(es, numInlier1);
 	struct LMatch lm2 = loc_getMatchingPair(es, numInlier2);
 	struct LMatch lm3 = loc_getMatchingPair(es, numInlier3);
@@ -129,20 +153,19 @@ static struct C_TransfModel *loc_fixModel4_hom(struct PairMatcher_Ransac *es,
 	CvPoint2D32f pts_dst[4] = { cvPoint2D32f(lm1.des.x, lm1.des.y),
 			cvPoint2D32f(lm2.des.x, lm2.des.y), cvPoint2D32f(lm3.des.x,
 					lm3.des.y), cvPoint2D32f(lm4.des.x, lm4.des.y) };
-	CvMat* mapMatrix = cvCreateMat(3, 3, CV_32FC1);
-	cvGetPerspectiveTransform(pts_src, pts_dst, mapMatrix);
-	struct C_TransfModel *m = loc_newModel(es);
-	m->a = cvGetReal2D(mapMatrix, 0, 0);
-	m->b = cvGetReal2D(mapMatrix, 0, 1);
-	m->c = cvGetReal2D(mapMatrix, 0, 2);
-	m->d = cvGetReal2D(mapMatrix, 1, 0);
-	m->e = cvGetReal2D(mapMatrix, 1, 1);
-	m->f = cvGetReal2D(mapMatrix, 1, 2);
-	m->g = cvGetReal2D(mapMatrix, 2, 0);
-	m->h = cvGetReal2D(mapMatrix, 2, 1);
-	m->i = cvGetReal2D(mapMatrix, 2, 2);
-	cvReleaseMat(&mapMatrix);
-	return m;
+	float data[9];
+	CvMat mapMatrix = cvMat(3, 3, CV_32FC1, data);
+	cvGetPerspectiveTransform(pts_src, pts_dst, &mapMatrix);
+	m->a = data[0];
+	m->b = data[1];
+	m->c = data[2];
+	m->d = data[3];
+	m->e = data[4];
+	m->f = data[5];
+	m->g = data[6];
+	m->h = data[7];
+	m->i = data[8];
+	return true;
 }
 static int64_t minSamplesPerModel(int64_t modelType) {
 	switch (modelType) {
@@ -159,24 +182,26 @@ static int64_t minSamplesPerModel(int64_t modelType) {
 	my_log_error("unknown transformation model %"PRIi64"\n", modelType);
 	return 0;
 }
-static struct C_TransfModel *loc_fixModel(struct PairMatcher_Ransac *es,
-		int64_t *randomSample) {
+static bool loc_fixModel(struct PairMatcher_Ransac *es,
+		struct C_TransfModel *m, int64_t *randomSample) {
+	loc_resetModel(m);
 	switch (es->modelType) {
 	case MODEL_TRANSLATION:
-		return loc_fixModel1_trans(es, randomSample[0]);
+		return loc_fixModel1_trans(es, m, randomSample[0]);
 	case MODEL_SCALE_SIFT:
-		return loc_fixModel2_siftScale(es, randomSample[0]);
+		return loc_fixModel2_siftScale(es, m, randomSample[0]);
 	case MODEL_SCALE_FREE:
-		return loc_fixModel2_twoScales(es, randomSample[0], randomSample[1]);
+		return loc_fixModel2_twoScales(es, m, randomSample[0],
+				randomSample[1]);
 	case MODEL_AFFINE:
-		return loc_fixModel3_affine(es, randomSample[0], randomSample[1],
+		return loc_fixModel3_affine(es, m, randomSample[0], randomSample[1],
 				randomSample[2]);
 	case MODEL_PERSPECTIVE:
-		return loc_fixModel4_hom(es, randomSample[0], randomSample[1],
+		return loc_fixModel4_hom(es, m, randomSample[0], randomSample[1],
 				randomSample[2], randomSample[3]);
 	}
 	my_log_error("unknown transformation model %"PRIi64"\n", es->modelType);
-	return NULL;
+	return false;
 }
 static double euclideanDist2D(double x1, double y1, double x2, double y2) {
 	double dx = x2 - x1;
@@ -218,10 +243,10 @@ static bool evaluateLocalMatch(struct C_TransfModel *m,
 #define STRICT_SCALE 1
 #define actMinMax(val,varMin,varMax) varMin=MIN(varMin,val);varMax=MAX(varMax,val)
 
+//the evaluation stops as soon as the model cannot get more than minToBeat
+//inliers, in that case the model is discarded with zero inliers
 static void evaluateModel(struct C_TransfModel *m,
-		struct PairMatcher_Ransac *es) {
-	if (m == NULL)
-		return;
+		struct PairMatcher_Ransac *es, int64_t minToBeat) {
 	m->contInliers = 0;
 	if (es->modelType == MODEL_SCALE_FREE) {
 		if (!MY_BETWEEN(m->scalex, 0.2, 5) || !MY_BETWEEN(m->scaley, 0.2 ,5)
@@ -234,10 +259,14 @@ static void evaluateModel(struct C_TransfModel *m,
 				return;
 		}
 	}
-	for (int64_t pos = 0; pos < es->inputMatches->numMatches; ++pos) {
+	int64_t numMatches = es->inputMatches->numMatches;
+	for (int64_t pos = 0; pos < numMatches; ++pos) {
 		m->isInlier[pos] = evaluateLocalMatch(m, es, pos);
 		if (m->isInlier[pos]) {
 			m->contInliers++;
+		} else if (m->contInliers + numMatches - pos - 1 <= minToBeat) {
+			m->contInliers = 0;
+			return;
 		}
 	}
 	if (m->contInliers > 0
@@ -287,8 +316,8 @@ static void loc_promPos(struct PairMatcher_Ransac *es, bool *inlierPairs,
 		*p2y_prom += (pair.des.y - *p2y_prom) / ((double) cont);
 	}
 }
-static struct C_TransfModel* loc_correctModel2_siftScale(
-		struct PairMatcher_Ransac *es, bool *inlierPairs) {
+static bool loc_correctModel2_siftScale(struct PairMatcher_Ransac *es,
+		bool *inlierPairs, struct C_TransfModel *m) {
 	double p1x_prom = 0, p1y_prom = 0, p2x_prom = 0, p2y_prom = 0;
 	loc_promPos(es, inlierPairs, &p1x_prom, &p1y_prom, &p2x_prom, &p2y_prom);
 //formula for single scale: sigma_x == sigma_y
@@ -307,16 +336,16 @@ static struct C_TransfModel* loc_correctModel2_siftScale(
 	double tx = p2x_prom - sigma * p1x_prom;
 	double ty = p2y_prom - sigma * p1y_prom;
 	if (MY_IS_REAL(sigma) && MY_IS_REAL(tx) && MY_IS_REAL(ty)) {
-		struct C_TransfModel *m = loc_newModel(es);
+		loc_resetModel(m);
 		m->scalex = m->scaley = sigma;
 		m->tx = tx;
 		m->ty = ty;
-		return m;
+		return true;
 	}
-	return NULL;
+	return false;
 }
-static struct C_TransfModel* loc_correctModel2_twoScales(
-		struct PairMatcher_Ransac *es, bool *inlierPairs) {
+static bool loc_correctModel2_twoScales(struct PairMatcher_Ransac *es,
+		bool *inlierPairs, struct C_TransfModel *m) {
 	double p1x_prom = 0, p1y_prom = 0, p2x_prom = 0, p2y_prom = 0;
 	loc_promPos(es, inlierPairs, &p1x_prom, &p1y_prom, &p2x_prom, &p2y_prom);
 //formula for independent scales: sigma_x and sigma_y
@@ -337,25 +366,25 @@ static struct C_TransfModel* loc_correctModel2_twoScales(
 	double ty = p2y_prom - sigmaY * p1y_prom;
 	if (MY_IS_REAL(
 			sigmaX) && MY_IS_REAL(sigmaY) && MY_IS_REAL(tx) && MY_IS_REAL(ty)) {
-		struct C_TransfModel *m = loc_newModel(es);
+		loc_resetModel(m);
 		m->scalex = sigmaX;
 		m->scaley = sigmaY;
 		m->tx = tx;
 		m->ty = ty;
-		return m;
+		return true;
 	}
-	return NULL;
+	return false;
 }
-static struct C_TransfModel* loc_correctModel(struct PairMatcher_Ransac *es,
-bool *inlierPairs) {
+static bool loc_correctModel(struct PairMatcher_Ransac *es, bool *inlierPairs,
+		struct C_TransfModel *m) {
 	switch (es->modelType) {
 	case MODEL_SCALE_SIFT:
-		return loc_correctModel2_siftScale(es, inlierPairs);
+		return loc_correctModel2_siftScale(es, inlierPairs, m);
 	case MODEL_SCALE_FREE:
-		return loc_correctModel2_twoScales(es, inlierPairs);
+		return loc_correctModel2_twoScales(es, inlierPairs, m);
 	}
 	my_log_error("this model does not support correction\n");
-	return NULL;
+	return false;
 }
 static char* loc_printModel(int64_t modelType, struct C_TransfModel *m) {
 	switch (modelType) {
@@ -379,17 +408,95 @@ static char* loc_printModel(int64_t modelType, struct C_TransfModel *m) {
 	return NULL;
 }
 static void loc_releaseModel(struct C_TransfModel *m) {
+	if (m == NULL)
+		return;
 	MY_FREE(m->isInlier);
 	MY_FREE(m);
 }
+//number of cycles to draw an all-inliers sample with the given confidence
+static int64_t loc_adaptiveNumCycles(struct PairMatcher_Ransac *es,
+		int64_t contInliers) {
+	if (es->confidence <= 0 || es->confidence >= 1)
+		return es->numCycles;
+	double ratio = contInliers / (double) es->inputMatches->numMatches;
+	double probGoodSample = pow(ratio, es->minSamplesModel);
+	if (probGoodSample >= 1)
+		return 0;
+	double cycles = log(1 - es->confidence) / log(1 - probGoodSample);
+	if (!MY_IS_REAL(cycles) || cycles >= es->numCycles)
+		return es->numCycles;
+	return (int64_t) ceil(cycles);
+}
+static int loc_compareOrder(const void *a, const void *b) {
+	const struct LOrder *o1 = a;
+	const struct LOrder *o2 = b;
+	if (o1->distance != o2->distance)
+		return (o1->distance < o2->distance) ? -1 : 1;
+	return (o1->numPair < o2->numPair) ? -1 : (o1->numPair > o2->numPair);
+}
+//samples have at most 4 values, rejecting repetitions avoids the
+//permutation that my_random_intList_noRepetitions builds for small ranges
+static void loc_randomSample(int64_t maxValueNotIncluded, int64_t *sample,
+		int64_t sample_size) {
+	for (int64_t i = 0; i < sample_size; ++i) {
+		sample[i] = my_random_int(0, maxValueNotIncluded);
+		for (int64_t j = 0; j < i; ++j) {
+			if (sample[i] == sample[j]) {
+				i--;
+				break;
+			}
+		}
+	}
+}
+struct ProsacState {
+	int64_t subsetSize, nextGrowth;
+	double numSamplesSubset;
+};
+//PROSAC (Chum and Matas, 2005): samples are drawn from a subset of the
+//best matches which grows following the expected number of samples of
+//the uniform RANSAC
+static void loc_prosacInit(struct PairMatcher_Ransac *es,
+		struct ProsacState *ps) {
+	int64_t numMatches = es->inputMatches->numMatches;
+	for (int64_t i = 0; i < numMatches; ++i) {
+		es->order[i].distance = es->inputMatches->distances[i];
+		es->order[i].numPair = i;
+	}
+	qsort(es->order, numMatches, sizeof(struct LOrder), loc_compareOrder);
+	ps->subsetSize = es->minSamplesModel;
+	ps->numSamplesSubset = es->numCycles;
+	for (int64_t i = 0; i < es->minSamplesModel; ++i)
+		ps->numSamplesSubset *= (es->minSamplesModel - i)
+				/ (double) (numMatches - i);
+	ps->nextGrowth = 1;
+}
+static void loc_prosacSample(struct PairMatcher_Ransac *es,
+		struct ProsacState *ps, int64_t numCycle) {
+	int64_t numMatches = es->inputMatches->numMatches;
+	int64_t m = es->minSamplesModel;
+	if (numCycle + 1 > ps->nextGrowth && ps->subsetSize < numMatches) {
+		double next = ps->numSamplesSubset * (ps->subsetSize + 1)
+				/ (ps->subsetSize + 1 - m);
+		ps->nextGrowth += (int64_t) ceil(next - ps->numSamplesSubset);
+		ps->numSamplesSubset = next;
+		ps->subsetSize++;
+	}
+	if (ps->subsetSize >= numMatches) {
+		loc_randomSample(numMatches, es->sample, m);
+	} else {
+		//the newest match of the subset is always in the sample
+		if (m > 1)
+			loc_randomSample(ps->subsetSize - 1, es->sample, m - 1);
+		es->sample[m - 1] = ps->subsetSize - 1;
+	}
+	for (int64_t i = 0; i < m; ++i)
+		es->sample[i] = es->order[es->sample[i]].numPair;
+}
 
 int64_t pairMatcherRansac_computeMatches(struct PairMatcher_Ransac *es,
 		MyLocalDescriptors *descriptorQ, MyLocalDescriptors *descriptorR,
 		struct MatchesAndModel *inputMatches) {
-	if (es->lastModel != NULL) {
-		loc_releaseModel(es->lastModel);
-		es->lastModel = NULL;
-	}
+	es->lastModel = NULL;
 	int64_t numVectorsQ = my_localDescriptors_getNumDescriptors(descriptorQ);
 	int64_t numVectorsR = my_localDescriptors_getNumDescriptors(descriptorR);
 	es->descriptorQ = descriptorQ;
@@ -401,37 +508,47 @@ int64_t pairMatcherRansac_computeMatches(struct PairMatcher_Ransac *es,
 			es->inputMatches->numMatches);
 	if (es->inputMatches->numMatches < es->minMatches)
 		return 0;
+	loc_reserveWorkspace(es, es->inputMatches->numMatches);
+	bool useProsac = es->useProsac && es->inputMatches->distances != NULL;
+	struct ProsacState ps = { 0 };
+	if (useProsac)
+		loc_prosacInit(es, &ps);
 	struct C_TransfModel *bestModel = NULL;
+	int64_t maxCycles = es->numCycles;
 	int64_t i = 0;
-	for (i = 0; i < es->numCycles; ++i) {
-		int64_t *randomSample = MY_MALLOC(es->minSamplesModel, int64_t);
-		my_random_intList_noRepetitions(0, es->inputMatches->numMatches,
-				randomSample, es->minSamplesModel);
-		struct C_TransfModel *m = loc_fixModel(es, randomSample);
-		evaluateModel(m, es);
-		free(randomSample);
-		if (es->useLScorrection && m != NULL && m->contInliers > 0) {
+	for (i = 0; i < maxCycles; ++i) {
+		if (useProsac)
+			loc_prosacSample(es, &ps, i);
+		else
+			loc_randomSample(es->inputMatches->numMatches, es->sample,
+					es->minSamplesModel);
+		if (!loc_fixModel(es, es->ws_current, es->sample))
+			continue;
+		//the correction may improve a model with few inliers
+		int64_t minToBeat =
+				(bestModel == NULL || es->useLScorrection) ?
+						0 : bestModel->contInliers;
+		evaluateModel(es->ws_current, es, minToBeat);
+		if (es->useLScorrection && es->ws_current->contInliers > 0) {
 			for (;;) {
-				struct C_TransfModel *m2 = loc_correctModel(es, m->isInlier);
-				if (m2 == NULL)
+				if (!loc_correctModel(es, es->ws_current->isInlier,
+						es->ws_candidate))
 					break;
-				evaluateModel(m2, es);
-				if (m2->contInliers > m->contInliers) {
-					loc_releaseModel(m);
-					m = m2;
-				} else {
-					loc_releaseModel(m2);
+				evaluateModel(es->ws_candidate, es,
+						es->ws_current->contInliers);
+				if (es->ws_candidate->contInliers
+						> es->ws_current->contInliers)
+					loc_swapModels(&es->ws_current, &es->ws_candidate);
+				else
 					break;
-				}
 			}
 		}
-		if (m != NULL && m->contInliers > 0
+		struct C_TransfModel *m = es->ws_current;
+		if (m->contInliers > 0
 				&& (bestModel == NULL || m->contInliers > bestModel->contInliers)) {
-			if (bestModel != NULL)
-				loc_releaseModel(bestModel);
-			bestModel = m;
-		} else if (m != NULL) {
-			loc_releaseModel(m);
+			loc_swapModels(&es->ws_current, &es->ws_best);
+			bestModel = es->ws_best;
+			maxCycles = loc_adaptiveNumCycles(es, bestModel->contInliers);
 		}
 	}
 	if (bestModel == NULL) {
@@ -440,13 +557,14 @@ int64_t pairMatcherRansac_computeMatches(struct PairMatcher_Ransac *es,
 	char *st = loc_printModel(es->modelType, bestModel);
 	my_log_info("MODEL type=%"PRIi64" %s\n", es->modelType, st);
 	MY_FREE(st);
-	my_log_info("matches post-ransac: %"PRIi64"\n", bestModel->contInliers);
+	my_log_info("matches post-ransac: %"PRIi64" (%"PRIi64" cycles)\n",
+			bestModel->contInliers, i);
 	es->lastModel = bestModel;
 	//double d = (numVectorsQ - bestModel->contInliers) / ((double) numVectorsQ);
 	return bestModel->contInliers;
 }
 char *pairMatcherRansac_help() {
-	return "(modelType:1..5)_numCycles_distMaxInliers_[opt:MINMATCHES_num]_[opt:CORRECTION]_[opt:MINWIDTH_w]_[opt:MINHEIGHT_h]_[opt:MAXWIDTH_w]_[opt:MAXHEIGHT_h]_[opt:MINRATIOWH_p]_[opt:MAXRATIOWH_p]  Ej: RANSAC,0.8_L2,2_300_2.5";
+	return "(modelType:1..5)_numCycles_distMaxInliers_[opt:MINMATCHES_num]_[opt:CORRECTION]_[opt:MINWIDTH_w]_[opt:MINHEIGHT_h]_[opt:MAXWIDTH_w]_[opt:MAXHEIGHT_h]_[opt:MINRATIOWH_p]_[opt:MAXRATIOWH_p]_[opt:CONFIDENCE_p]_[opt:PROSAC]  (CONFIDENCE stops before numCycles, e.g. CONFIDENCE_0.99)  Ej: RANSAC,0.8_L2,2_300_2.5";
 }
 struct PairMatcher_Ransac* pairMatcherRansac_new(const char *parameters) {
 	MyTokenizer *tk = my_tokenizer_new(parameters, '_');
@@ -457,6 +575,8 @@ struct PairMatcher_Ransac* pairMatcherRansac_new(const char *parameters) {
 	es->modelType = my_tokenizer_nextInt(tk);
 	es->numCycles = my_tokenizer_nextInt(tk);
 	es->distMaxInliers = my_tokenizer_nextDouble(tk);
+	//by default all the numCycles are run
+	es->confidence = 1;
 	while (my_tokenizer_hasNext(tk)) {
 		if (my_tokenizer_isNext(tk, "MINMATCHES"))
 			es->minMatches = my_tokenizer_nextInt(tk);
@@ -474,6 +594,10 @@ struct PairMatcher_Ransac* pairMatcherRansac_new(const char *parameters) {
 			es->minRatioWH = my_tokenizer_nextFraction(tk);
 		else if (my_tokenizer_isNext(tk, "MAXRATIOWH"))
 			es->maxRatioWH = my_tokenizer_nextFraction(tk);
+		else if (my_tokenizer_isNext(tk, "CONFIDENCE"))
+			es->confidence = my_tokenizer_nextFraction(tk);
+		else if (my_tokenizer_isNext(tk, "PROSAC"))
+			es->useProsac = true;
 		else
 			break;
 	}
@@ -481,6 +605,10 @@ struct PairMatcher_Ransac* pairMatcherRansac_new(const char *parameters) {
 	es->minSamplesModel = minSamplesPerModel(es->modelType);
 	if (es->minMatches < es->minSamplesModel)
 		es->minMatches = es->minSamplesModel;
+	es->ws_current = loc_newModel();
+	es->ws_candidate = loc_newModel();
+	es->ws_best = loc_newModel();
+	es->sample = MY_MALLOC(es->minSamplesModel, int64_t);
 	if (true) {
 		MyStringBuffer *sb = my_stringbuf_new();
 		my_stringbuf_appendString(sb, "numCycles=");
@@ -519,18 +647,27 @@ struct PairMatcher_Ransac* pairMatcherRansac_new(const char *parameters) {
 			my_stringbuf_appendString(sb, " maxRatioWH=");
 			my_stringbuf_appendDouble(sb, es->maxRatioWH);
 		}
+		if (es->confidence > 0 && es->confidence < 1) {
+			my_stringbuf_appendString(sb, " confidence=");
+			my_stringbuf_appendDouble(sb, es->confidence);
+		}
+		if (es->useProsac)
+			my_stringbuf_appendString(sb, " prosac");
 		my_log_info("RANSAC with %s\n", my_stringbuf_getCurrentBuffer(sb));
 		my_stringbuf_release(sb);
 	}
 	return es;
 }
 void pairMatcherRansac_release(struct PairMatcher_Ransac* es) {
-	if (es->lastModel != NULL)
-		loc_releaseModel(es->lastModel);
+	loc_releaseModel(es->ws_current);
+	loc_releaseModel(es->ws_candidate);
+	loc_releaseModel(es->ws_best);
 	if (es->lastOutputMatches != NULL) {
 		MY_FREE_MULTI(es->lastOutputMatches->idVectorQ,
-				es->lastOutputMatches->idVectorR, es->lastOutputMatches);
+				es->lastOutputMatches->idVectorR,
+				es->lastOutputMatches->distances, es->lastOutputMatches);
 	}
+	MY_FREE_MULTI(es->sample, es->order);
 	if (es->lastTransform != NULL) {
 		cvReleaseMat(&es->lastTransform);
 	}
@@ -639,11 +776,15 @@ struct MatchesAndModel *pairMatcherRansac_getLastModel(
 	outM->numMatches = m->contInliers;
 	MY_REALLOC(outM->idVectorQ, outM->numMatches, int64_t);
 	MY_REALLOC(outM->idVectorR, outM->numMatches, int64_t);
+	if (es->inputMatches->distances != NULL)
+		MY_REALLOC(outM->distances, outM->numMatches, double);
 	int64_t pos, cont = 0;
 	for (pos = 0; pos < es->inputMatches->numMatches; ++pos) {
 		if (m->isInlier[pos]) {
 			outM->idVectorQ[cont] = es->inputMatches->idVectorQ[pos];
 			outM->idVectorR[cont] = es->inputMatches->idVectorR[pos];
+			if (es->inputMatches->distances != NULL)
+				outM->distances[cont] = es->inputMatches->distances[pos];
 			cont++;
 		}
 	}
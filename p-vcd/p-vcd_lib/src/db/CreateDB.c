@@ -182,7 +182,7 @@ static void pre_procesarFile(int64_t currentProcess, void* state,
 //file format: original_filename\tnew_filename\tnew_fps
 static MyMapStringObj *priv_loadNewFilenames(const char *dataTxt) {
 	my_log_info("loading filenames from %s\n", dataTxt);
-	MyMapStringObj *data = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *data = my_mapStringObj_newHashCaseSensitive();
 	const char *line;
 	MyLineReader *reader = my_lreader_open(my_io_openFileRead1(dataTxt, 1));
 	while ((line = my_lreader_readLine(reader)) != NULL) {
@@ -209,7 +209,7 @@ static MyMapStringObj *priv_loadNewFilenames(const char *dataTxt) {
 //done
 static MyMapStringObj *priv_loadVideoLimits(const char *filename) {
 	my_log_info("loading partitions from %s\n", filename);
-	MyMapStringObj *data = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *data = my_mapStringObj_newHashCaseSensitive();
 	const char *line;
 	MyLineReader *reader = my_lreader_open(my_io_openFileRead1(filename, 1));
 	while ((line = my_lreader_readLine(reader)) != NULL) {
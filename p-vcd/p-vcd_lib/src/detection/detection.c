@@ -44,7 +44,7 @@ struct DetectionsFile *loadDetectionsFile(const char *filename,
 	struct DetectionsFile *df = MY_MALLOC(1, struct DetectionsFile);
 	df->allDetections = my_vectorObj_new();
 	parseDetectionsFile(filename, profile, df->allDetections);
-	df->detectionsPerQuery = my_mapStringObj_newCaseSensitive();
+	df->detectionsPerQuery = my_mapStringObj_newHashCaseSensitive();
 	for (int64_t i = 0; i < my_vectorObj_size(df->allDetections); ++i) {
 		struct Detection *d = my_vectorObj_get(df->allDetections, i);
 		MyVectorObj *listQ = my_mapStringObj_get(df->detectionsPerQuery,
@@ -24,11 +24,14 @@ struct ParamsVoting {
 	double maxDistLoad;
 	int singleDetection;
 	bool useDistWeight;
+	//engine
+	bool useHough;
+	int64_t maxBins;
 	//to print
 	const char *matchVote_st, *missCost_st, *rankWeight_st, *stepSize_st,
 			*matchType_st, *minimumLength_st, *singleDetection_st,
 			*useDistWeight_st, *maxNNLoad_st, *maxDistLoad_st,
-			*maxDetections_st;
+			*maxDetections_st, *engine_st, *maxBins_st;
 };
 
 void det_reportDetection(struct SearchSegment *desde_q,
@@ -37,6 +40,8 @@ void det_reportDetection(struct SearchSegment *desde_q,
 		int64_t numSinVotos, void *stateVot);
 void det_detectByVoting(void *qqueryVideo, struct ParamsVoting *pv,
 		int64_t numThreads, void *stateVot);
+void det_detectByHough(void *qqueryVideo, struct ParamsVoting *pv,
+		int64_t numThreads, void *stateVot);
 
 struct Detection {
 	struct SearchFile *videoQ, *videoR;
@@ -185,19 +185,32 @@ void det_reportDetection(struct SearchSegment *desde_q,
 }
 
 static char *printParameters(bool shortVersion, struct ParamsVoting *pv) {
-	if (shortVersion)
-		return my_newString_format(
+	if (shortVersion) {
+		char *st = my_newString_format(
 				"maxd_%s,maxnn_%s,maxd_%s,step_%s,wrank_%s,match_%s,miss_%s,mt_%s,minlen_%s,wdist_%s,single_%i",
 				pv->maxDetections_st, pv->maxNNLoad_st, pv->maxDistLoad_st,
 				pv->stepSize_st, pv->rankWeight_st, pv->matchVote_st,
 				pv->missCost_st, pv->matchType_st, pv->minimumLength_st,
 				pv->useDistWeight_st, pv->singleDetection);
-	return my_newString_format(
+		if (!pv->useHough)
+			return st;
+		char *st2 = my_newString_format("%s,hough_%s", st, pv->maxBins_st);
+		MY_FREE(st);
+		return st2;
+	}
+	char *st = my_newString_format(
 			"maxDetections=%s maxNNLoad=%s maxDistLoad=%s stepSize=%s rankWeight=%s matchVote=%s missCost=%s matchType=%s minLength=%s useDistHistogram=%s singleDetection=%s",
 			pv->maxDetections_st, pv->maxNNLoad_st, pv->maxDistLoad_st,
 			pv->stepSize_st, pv->rankWeight_st, pv->matchVote_st,
 			pv->missCost_st, pv->matchType_st, pv->minimumLength_st,
 			pv->useDistWeight_st, pv->singleDetection_st);
+	//the default engine keeps the previous output
+	if (!pv->useHough)
+		return st;
+	char *st2 = my_newString_format("%s engine=%s maxBins=%s", st,
+			pv->engine_st, pv->maxBins_st);
+	MY_FREE(st);
+	return st2;
 }
 static FILE *det_createOutputFile(struct StateDetectionsGlobal *stateGlob) {
 	if (stateGlob->filenameOut == NULL) {
@@ -244,7 +257,10 @@ static void det_detect_thread(int64_t currentProcess, void* stateg,
 	state->stateGlob = stateGlob;
 	state->candidates = my_vectorObj_new();
 	MY_MUTEX_INIT(state->mutex);
-	det_detectByVoting(queryVideo, stateGlob->pv, NUM_CORES, state);
+	if (stateGlob->pv->useHough)
+		det_detectByHough(queryVideo, stateGlob->pv, NUM_CORES, state);
+	else
+		det_detectByVoting(queryVideo, stateGlob->pv, NUM_CORES, state);
 	if (my_vectorObj_size(state->candidates) > 0) {
 		int64_t pos = locateMaximumScorePos(state->candidates);
 		struct Detection *bestDet = my_vectorObj_get(state->candidates, pos);
@@ -275,6 +291,8 @@ void loc_new_copyDetection(CmdParams *cmd_params, char *argOption) {
 	pv->minimumLength_st = "1s";
 	pv->singleDetection_st = "SegmentQ_SegmentR";
 	pv->useDistWeight_st = "0";
+	pv->engine_st = "probes";
+	pv->maxBins_st = "0";
 	if (!hasNextParam(cmd_params)) {
 		my_log_info("%s %s\n", getBinaryName(cmd_params), argOption);
 		my_log_info(
@@ -300,6 +318,12 @@ void loc_new_copyDetection(CmdParams *cmd_params, char *argOption) {
 		my_log_info(
 				"  -singleDetection (VideoQ|SegmentQ)_(AnyR|VideoR|SegmentR)    Unique detection between Q and R. default=%s\n",
 				pv->singleDetection_st);
+		my_log_info(
+				"  -engine (probes|hough)   Optional. probes=tests every offset interval of each reference video. hough=accumulates an offset histogram in one pass and tests only its peaks. default=%s\n",
+				pv->engine_st);
+		my_log_info(
+				"  -maxBins num         Optional. Max histogram peaks to test per query video with hough engine (0=unlimited). default=%s\n",
+				pv->maxBins_st);
 		my_log_info(
 				"  -out filename        Optional. Set filename out. Default value depends on parameters.\n");
 		return;
@@ -335,6 +359,10 @@ void loc_new_copyDetection(CmdParams *cmd_params, char *argOption) {
 			pv->missCost_st = nextParam(cmd_params);
 		} else if (isNextParam(cmd_params, "-matchType")) {
 			pv->matchType_st = nextParam(cmd_params);
+		} else if (isNextParam(cmd_params, "-engine")) {
+			pv->engine_st = nextParam(cmd_params);
+		} else if (isNextParam(cmd_params, "-maxBins")) {
+			pv->maxBins_st = nextParam(cmd_params);
 		} else if (isNextParam(cmd_params, "-out")) {
 			stateGlob->filenameOut = nextParam(cmd_params);
 		} else
@@ -350,6 +378,11 @@ void loc_new_copyDetection(CmdParams *cmd_params, char *argOption) {
 	pv->stepSize = my_parse_fraction(pv->stepSize_st);
 	parseMinimumLengthParam(pv->minimumLength_st, pv);
 	pv->useDistWeight = my_parse_uint8(pv->useDistWeight_st);
+	pv->maxBins = my_parse_int(pv->maxBins_st);
+	if (my_string_equals_ignorecase(pv->engine_st, "hough"))
+		pv->useHough = true;
+	else if (!my_string_equals_ignorecase(pv->engine_st, "probes"))
+		my_log_error("unknown engine %s\n", pv->engine_st);
 	my_assert_notNull("-ss", stateGlob->filenameIn);
 	my_assert_greaterDouble("rankWeight", pv->rankWeight, 0);
 	my_assert_lessEqualDouble("rankWeight", pv->rankWeight, 1);
@@ -358,6 +391,7 @@ void loc_new_copyDetection(CmdParams *cmd_params, char *argOption) {
 	my_assert_greaterDouble("matchVote", pv->matchVote, 0);
 	my_assert_greaterEqual_int("matchType", pv->matchType, 0);
 	my_assert_lessEqualInt("matchType", pv->matchType, 2);
+	my_assert_greaterEqual_int("maxBins", pv->maxBins, 0);
 	if (my_string_equals_ignorecase(pv->singleDetection_st, "VideoQ_AnyR"))
 		pv->singleDetection = SIMILAR_VideoQ_AnyR;
 	else if (my_string_equals_ignorecase(pv->singleDetection_st,
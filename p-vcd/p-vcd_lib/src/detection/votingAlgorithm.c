@@ -12,6 +12,8 @@ struct V_VideoOffset {
 	struct SearchFile *videoR;
 	double offset_min, offset_max;
 	int64_t numVoters;
+	//range of query frames to test [first_frame, last_frame)
+	int64_t first_frame, last_frame;
 };
 
 static double det_voteNN(struct SearchSegment *kfQuery,
@@ -44,6 +46,16 @@ static double det_voteNN(struct SearchSegment *kfQuery,
 	}
 	return pv->missCost;
 }
+static double det_weightDistance(struct D_Match *nn, struct ParamsVoting *pv) {
+	if (pv->dist_hist == NULL)
+		return 1;
+	//double dist = nn->distancia / maxDist;
+	double alpha = mknn_histogram_getQuantile(pv->dist_hist, nn->distance);
+	double weight_dist = 1 - alpha;
+	if (weight_dist < 0)
+		weight_dist = -weight_dist;
+	return weight_dist;
+}
 static double det_voteSegment(MyMapIntObj *mapVotes, struct D_Frame *frame,
 		struct V_VideoOffset *probe, struct ParamsVoting *pv,
 		struct SearchSegment **nn_voto) {
@@ -62,15 +74,7 @@ static double det_voteSegment(MyMapIntObj *mapVotes, struct D_Frame *frame,
 			double v = det_voteNN(kfQuery, kfRef, probe->offset_min,
 					probe->offset_max, pv);
 			if (v > 0) {
-				double weight_dist = 1;
-				if (pv->dist_hist != NULL) {
-					//double dist = nn->distancia / maxDist;
-					double alpha = mknn_histogram_getQuantile(pv->dist_hist, nn->distance);
-					weight_dist = 1 - alpha;
-					if (weight_dist < 0)
-						weight_dist = -weight_dist;
-				}
-				v *= weight_dist * weight_rank;
+				v *= det_weightDistance(nn, pv) * weight_rank;
 				if (v > max_vote) {
 					max_vote = v;
 					*nn_voto = kfRef;
@@ -135,7 +139,7 @@ static void reinitMatcher(struct V_Matcher *m) {
 		m->mapVotes = NULL;
 	}
 	if (m->mapVotes == NULL)
-		m->mapVotes = my_mapIntObj_new_ABB();
+		m->mapVotes = my_mapIntObj_new_HASH();
 	m->bestMatch.desde_q = m->currentMatch.desde_q = NULL;
 	m->bestMatch.hasta_q = m->currentMatch.hasta_q = NULL;
 	m->bestMatch.desde_r = m->currentMatch.desde_r = NULL;
@@ -149,7 +153,7 @@ static void det_testOffsetInVideo(struct D_Query* queryVideo,
 	struct V_Matcher *m = MY_MALLOC(1, struct V_Matcher);
 	reinitMatcher(m);
 	int64_t i;
-	for (i = 0; i < queryVideo->numFrames; ++i) {
+	for (i = probe->first_frame; i < probe->last_frame; ++i) {
 		struct D_Frame *frame = queryVideo->frames[i];
 		struct SearchSegment *nn_voto = NULL;
 		double voto = det_voteSegment(m->mapVotes, frame, probe, pv, &nn_voto);
@@ -169,44 +173,49 @@ static void det_testOffsetInVideo(struct D_Query* queryVideo,
 	MY_FREE(m);
 }
 
-static void det_contabilizar_offset(struct SearchFile *videoR, double ofMin,
-		double ofMax, MyVectorObj ***ptr_listPerVideoR, int64_t *ptr_lengthList) {
-	if (*ptr_listPerVideoR == NULL) {
-		*ptr_listPerVideoR = MY_MALLOC(videoR->col->numFiles, MyVectorObj *);
-		*ptr_lengthList = videoR->col->numFiles;
-	}
-	my_assert_indexRangeInt("id", videoR->id_seq, *ptr_lengthList);
-	MyVectorObj **listPerVideoR = *ptr_listPerVideoR;
-	if (listPerVideoR[videoR->id_seq] == NULL)
-		listPerVideoR[videoR->id_seq] = my_vectorObj_new();
-	MyVectorObj *vs = listPerVideoR[videoR->id_seq];
-	int64_t i, numVoters = 1;
-	for (i = 0; i < my_vectorObj_size(vs); ++i) {
-		struct V_VideoOffset *desf = my_vectorObj_get(vs, i);
-		if (desf->videoR != videoR)
-			my_log_error("error in videoR\n");
-		if (MY_INTERSECT(desf->offset_min, desf->offset_max, ofMin, ofMax)) {
-			ofMin = MIN(desf->offset_min, ofMin);
-			ofMax = MAX(desf->offset_max, ofMax);
-			numVoters += desf->numVoters;
-			my_vectorObj_remove(vs, i);
-			i = -1;
-		}
-	}
-	struct V_VideoOffset *desf = MY_MALLOC(1, struct V_VideoOffset);
-	desf->videoR = videoR;
-	desf->offset_min = ofMin;
-	desf->offset_max = ofMax;
-	desf->numVoters = numVoters;
-	my_vectorObj_add(vs, desf);
-}
-
 #define INVALID_OFFSET_SAME_VIDEO 10*60
+#define MIN_VOTERS_OFFSET 6
 
-static void det_gatherVideoOffsets(struct D_Query* queryVideo,
-		struct ParamsVoting *pv, MyVectorObj ***ptr_listPerVideoR,
-		int64_t *ptr_lengthList) {
-	int64_t i, j;
+static bool det_validOffsetRange(struct SearchFile *fileQ,
+		struct VideoSegment *segmentQ, struct SearchFile *fileR,
+		struct VideoSegment *segmentR, struct ParamsVoting *pv,
+		double *out_ofMin, double *out_ofMax) {
+	double of1 = segmentR->start_second - segmentQ->start_second;
+	double of2 = segmentR->start_second - segmentQ->end_second;
+	double of3 = segmentR->end_second - segmentQ->start_second;
+	double of4 = segmentR->end_second - segmentQ->end_second;
+	double ofMin = MIN(MIN(of1,of2),MIN(of3,of4)) - pv->stepSize;
+	double ofMax = MAX(MAX(of1,of2),MAX(of3,of4)) + pv->stepSize;
+	if ((fileQ == fileR)
+			&& MY_INTERSECT(ofMin, ofMax, -INVALID_OFFSET_SAME_VIDEO,
+					INVALID_OFFSET_SAME_VIDEO))
+		return false;
+	*out_ofMin = ofMin;
+	*out_ofMax = ofMax;
+	return true;
+}
+struct V_OffsetInterval {
+	struct SearchFile *videoR;
+	double offset_min, offset_max;
+};
+static int det_compare_offsetInterval(const void *a, const void *b) {
+	const struct V_OffsetInterval *ia = a;
+	const struct V_OffsetInterval *ib = b;
+	if (ia->videoR->id_seq != ib->videoR->id_seq)
+		return (ia->videoR->id_seq < ib->videoR->id_seq) ? -1 : 1;
+	if (ia->offset_min != ib->offset_min)
+		return (ia->offset_min < ib->offset_min) ? -1 : 1;
+	return 0;
+}
+//the offset intervals of every NN, sorted by reference video and offset
+static struct V_OffsetInterval *det_gatherOffsetIntervals(
+		struct D_Query* queryVideo, struct ParamsVoting *pv,
+		int64_t *out_numIntervals) {
+	int64_t i, j, maxIntervals = 0, numIntervals = 0;
+	for (i = 0; i < queryVideo->numFrames; ++i)
+		maxIntervals += queryVideo->frames[i]->numNNs;
+	struct V_OffsetInterval *intervals = MY_MALLOC_NOINIT(
+			MAX(1, maxIntervals), struct V_OffsetInterval);
 	for (i = 0; i < queryVideo->numFrames; ++i) {
 		struct D_Frame *frameQ = queryVideo->frames[i];
 		struct VideoSegment *segmentQ = frameQ->ssegmentQuery->segment;
@@ -215,22 +224,96 @@ static void det_gatherVideoOffsets(struct D_Query* queryVideo,
 			struct D_Match *nn = frameQ->nns[j];
 			struct 	VideoSegment *segmentR = nn->ssegmentRef->segment;
 			struct SearchFile *fileR = nn->ssegmentRef->sfile;
-			double of1 = segmentR->start_second - segmentQ->start_second;
-			double of2 = segmentR->start_second - segmentQ->end_second;
-			double of3 = segmentR->end_second - segmentQ->start_second;
-			double of4 = segmentR->end_second - segmentQ->end_second;
-			double ofMin = MIN(MIN(of1,of2),MIN(of3,of4)) - pv->stepSize;
-			double ofMax = MAX(MAX(of1,of2),MAX(of3,of4)) + pv->stepSize;
-			if ((fileQ == fileR)
-					&& MY_INTERSECT(ofMin, ofMax, -INVALID_OFFSET_SAME_VIDEO,
-							INVALID_OFFSET_SAME_VIDEO)) {
+			double ofMin, ofMax;
+			if (!det_validOffsetRange(fileQ, segmentQ, fileR, segmentR, pv,
+					&ofMin, &ofMax))
 				continue;
-			}
-			det_contabilizar_offset(fileR, ofMin, ofMax, ptr_listPerVideoR,
-					ptr_lengthList);
+			struct V_OffsetInterval *in = &intervals[numIntervals++];
+			in->videoR = fileR;
+			in->offset_min = ofMin;
+			in->offset_max = ofMax;
+		}
+	}
+	qsort(intervals, numIntervals, sizeof(struct V_OffsetInterval),
+			det_compare_offsetInterval);
+	*out_numIntervals = numIntervals;
+	return intervals;
+}
+static void det_addProbesOffset(struct D_Query* queryVideo,
+		struct V_VideoOffset *desf, struct ParamsVoting *pv,
+		MyVectorObj *probes) {
+	if (desf->numVoters < MIN_VOTERS_OFFSET)
+		return;
+	double start, len = pv->stepSize;
+	for (start = desf->offset_min - len / 2.0; start < desf->offset_max; start +=
+			len) {
+		struct V_VideoOffset *probe = MY_MALLOC(1, struct V_VideoOffset);
+		probe->videoR = desf->videoR;
+		probe->offset_min = start;
+		probe->offset_max = start + len;
+		probe->first_frame = 0;
+		probe->last_frame = queryVideo->numFrames;
+		my_vectorObj_add(probes, probe);
+	}
+}
+struct OptionsOffsets {
+	struct D_Query* queryVideo;
+	struct ParamsVoting *pv;
+	struct V_OffsetInterval *intervals;
+	//intervals of video k are in [startPerVideo[k], startPerVideo[k+1])
+	int64_t *startPerVideo;
+	MyVectorObj **probesPerVideo;
+};
+//merges the intersecting intervals of a reference video and creates its probes
+static void det_offsets_thread(int64_t currentProcess, void* optptr,
+		int64_t numThread) {
+	struct OptionsOffsets *opt = optptr;
+	MyVectorObj *probes = opt->probesPerVideo[currentProcess] =
+			my_vectorObj_new();
+	int64_t i = opt->startPerVideo[currentProcess];
+	int64_t end = opt->startPerVideo[currentProcess + 1];
+	struct V_VideoOffset desf = { 0 };
+	while (i < end) {
+		struct V_OffsetInterval *in = &opt->intervals[i++];
+		desf.videoR = in->videoR;
+		desf.offset_min = in->offset_min;
+		desf.offset_max = in->offset_max;
+		desf.numVoters = 1;
+		while (i < end && opt->intervals[i].offset_min <= desf.offset_max) {
+			desf.offset_max = MAX(desf.offset_max, opt->intervals[i].offset_max);
+			desf.numVoters++;
+			i++;
 		}
+		det_addProbesOffset(opt->queryVideo, &desf, opt->pv, probes);
 	}
 }
+static MyVectorObj *det_computeProbes(struct D_Query* queryVideo,
+		struct ParamsVoting *pv, int64_t numThreads) {
+	int64_t i, numIntervals = 0, numVideos = 0;
+	struct V_OffsetInterval *intervals = det_gatherOffsetIntervals(queryVideo,
+			pv, &numIntervals);
+	int64_t *startPerVideo = MY_MALLOC_NOINIT(numIntervals + 1, int64_t);
+	for (i = 0; i < numIntervals; ++i) {
+		if (i == 0 || intervals[i].videoR != intervals[i - 1].videoR)
+			startPerVideo[numVideos++] = i;
+	}
+	startPerVideo[numVideos] = numIntervals;
+	struct OptionsOffsets opt = { 0 };
+	opt.queryVideo = queryVideo;
+	opt.pv = pv;
+	opt.intervals = intervals;
+	opt.startPerVideo = startPerVideo;
+	opt.probesPerVideo = MY_MALLOC(MAX(1, numVideos), MyVectorObj*);
+	my_parallel_incremental(numVideos, &opt, det_offsets_thread, NULL,
+			numThreads);
+	MyVectorObj *probes = my_vectorObj_new();
+	for (i = 0; i < numVideos; ++i) {
+		my_vectorObj_addAll(probes, opt.probesPerVideo[i]);
+		my_vectorObj_release(opt.probesPerVideo[i], 0);
+	}
+	MY_FREE_MULTI(opt.probesPerVideo, startPerVideo, intervals);
+	return probes;
+}
 struct Options {
 	MyVectorObj* probes;
 	struct D_Query* queryVideo;
@@ -242,37 +325,8 @@ static void det_voting_thread(int64_t currentProcess, void* optptr, int64_t numT
 	struct V_VideoOffset *probe = my_vectorObj_get(opt->probes, currentProcess);
 	det_testOffsetInVideo(opt->queryVideo, probe, opt->pv, opt->stateVot);
 }
-void det_detectByVoting(void *qqueryVideo, struct ParamsVoting *pv,
-		int64_t numThreads, void *stateVot) {
-	struct D_Query *queryVideo = qqueryVideo;
-	MyVectorObj **listPerVideoR = NULL;
-	int64_t lengthList = 0;
-	det_gatherVideoOffsets(queryVideo, pv, &listPerVideoR, &lengthList);
-	MyVectorObj* probes = my_vectorObj_new();
-	int64_t k;
-	for (k = 0; k < lengthList; ++k) {
-		MyVectorObj* vs = listPerVideoR[k];
-		if (vs == NULL)
-			continue;
-		int64_t i;
-		for (i = 0; i < my_vectorObj_size(vs); ++i) {
-			struct V_VideoOffset *desf = my_vectorObj_get(vs, i);
-			if (desf->numVoters < 6)
-				continue;
-			double start, len = pv->stepSize;
-			for (start = desf->offset_min - len / 2.0; start < desf->offset_max;
-					start += len) {
-				struct V_VideoOffset *probe = MY_MALLOC(1,
-						struct V_VideoOffset);
-				probe->videoR = desf->videoR;
-				probe->offset_min = start;
-				probe->offset_max = start + len;
-				my_vectorObj_add(probes, probe);
-			}
-		}
-		my_vectorObj_release(vs, 1);
-	}
-	MY_FREE(listPerVideoR);
+static void det_testProbes(struct D_Query *queryVideo, MyVectorObj *probes,
+		struct ParamsVoting *pv, int64_t numThreads, void *stateVot) {
 	struct Options opt;
 	opt.pv = pv;
 	opt.probes = probes;
@@ -280,6 +334,227 @@ void det_detectByVoting(void *qqueryVideo, struct ParamsVoting *pv,
 	opt.stateVot = stateVot;
 	my_parallel_incremental(my_vectorObj_size(probes), &opt, det_voting_thread,
 			"voting", numThreads);
+}
+void det_detectByVoting(void *qqueryVideo, struct ParamsVoting *pv,
+		int64_t numThreads, void *stateVot) {
+	struct D_Query *queryVideo = qqueryVideo;
+	MyVectorObj *probes = det_computeProbes(queryVideo, pv, numThreads);
+	det_testProbes(queryVideo, probes, pv, numThreads, stateVot);
 	my_vectorObj_release(probes, 1);
 }
 
+
+
+/**
+ * Offset histogram (Hough) engine: every NN votes once for the bin
+ * (videoR, offset/stepSize), then only the peaks are tested with the
+ * sequential matcher, restricted to the query frames that voted for them.
+ */
+struct V_OffsetVote {
+	struct SearchFile *videoR;
+	int64_t bin, numFrame;
+	double vote;
+};
+struct V_OffsetBin {
+	struct SearchFile *videoR;
+	int64_t bin, numVoters, first_frame, last_frame;
+	double score;
+	//including adjacent bins
+	double peakScore;
+	int64_t peakVoters;
+};
+
+static int det_compare_offsetVote(const void *a, const void *b) {
+	const struct V_OffsetVote *va = a;
+	const struct V_OffsetVote *vb = b;
+	if (va->videoR->id_seq != vb->videoR->id_seq)
+		return (va->videoR->id_seq < vb->videoR->id_seq) ? -1 : 1;
+	if (va->bin != vb->bin)
+		return (va->bin < vb->bin) ? -1 : 1;
+	if (va->numFrame != vb->numFrame)
+		return (va->numFrame < vb->numFrame) ? -1 : 1;
+	return 0;
+}
+static int det_compare_peakScore_may_men(const void *a, const void *b) {
+	double sa = (*(struct V_OffsetBin **) a)->peakScore;
+	double sb = (*(struct V_OffsetBin **) b)->peakScore;
+	return (sa == sb) ? 0 : (sa > sb ? -1 : 1);
+}
+//bins are sorted by video and offset
+static int det_compare_binPosition(const void *a, const void *b) {
+	struct V_OffsetBin *ba = *(struct V_OffsetBin **) a;
+	struct V_OffsetBin *bb = *(struct V_OffsetBin **) b;
+	return (ba == bb) ? 0 : (ba < bb ? -1 : 1);
+}
+static struct V_OffsetVote *det_houghCollectVotes(struct D_Query *queryVideo,
+		struct ParamsVoting *pv, int64_t *out_numVotes) {
+	int64_t i, j, maxVotes = 0, numVotes = 0;
+	for (i = 0; i < queryVideo->numFrames; ++i)
+		maxVotes += queryVideo->frames[i]->numNNs;
+	struct V_OffsetVote *votes = MY_MALLOC_NOINIT(MAX(1, maxVotes),
+			struct V_OffsetVote);
+	for (i = 0; i < queryVideo->numFrames; ++i) {
+		struct D_Frame *frameQ = queryVideo->frames[i];
+		struct VideoSegment *segmentQ = frameQ->ssegmentQuery->segment;
+		struct SearchFile *fileQ = frameQ->ssegmentQuery->sfile;
+		double weight_rank = 1.0;
+		for (j = 0; j < frameQ->numNNs; ++j) {
+			struct D_Match *nn = frameQ->nns[j];
+			struct VideoSegment *segmentR = nn->ssegmentRef->segment;
+			struct SearchFile *fileR = nn->ssegmentRef->sfile;
+			double ofMin, ofMax;
+			if (det_validOffsetRange(fileQ, segmentQ, fileR, segmentR, pv,
+					&ofMin, &ofMax)) {
+				double offset = segmentR->start_second
+						- segmentQ->start_second;
+				struct V_OffsetVote *v = &votes[numVotes++];
+				v->videoR = fileR;
+				v->bin = (int64_t) floor(offset / pv->stepSize);
+				v->numFrame = i;
+				v->vote = pv->matchVote * weight_rank
+						* det_weightDistance(nn, pv);
+			}
+			weight_rank *= pv->rankWeight;
+		}
+	}
+	*out_numVotes = numVotes;
+	return votes;
+}
+static struct V_OffsetBin *det_houghAccumulate(struct V_OffsetVote *votes,
+		int64_t numVotes, int64_t *out_numBins) {
+	qsort(votes, numVotes, sizeof(struct V_OffsetVote), det_compare_offsetVote);
+	struct V_OffsetBin *bins = MY_MALLOC(MAX(1, numVotes), struct V_OffsetBin);
+	int64_t i, numBins = 0;
+	struct V_OffsetBin *b = NULL;
+	double lastVote = 0;
+	for (i = 0; i < numVotes; ++i) {
+		struct V_OffsetVote *v = &votes[i];
+		if (b == NULL || b->videoR != v->videoR || b->bin != v->bin) {
+			b = &bins[numBins++];
+			b->videoR = v->videoR;
+			b->bin = v->bin;
+			b->first_frame = v->numFrame;
+		} else if (b->last_frame == v->numFrame + 1) {
+			//one vote per query frame, the best one
+			if (v->vote > lastVote) {
+				b->score += v->vote - lastVote;
+				lastVote = v->vote;
+			}
+			continue;
+		}
+		b->score += v->vote;
+		b->numVoters++;
+		b->last_frame = v->numFrame + 1;
+		lastVote = v->vote;
+	}
+	*out_numBins = numBins;
+	return bins;
+}
+static bool det_houghAreNeighbors(struct V_OffsetBin *b1,
+		struct V_OffsetBin *b2, int64_t maxDiff) {
+	return b1->videoR == b2->videoR && llabs(b1->bin - b2->bin) <= maxDiff;
+}
+static MyVectorObj *det_houghSelectPeaks(struct V_OffsetBin *bins,
+		int64_t numBins, int64_t maxBins) {
+	int64_t i;
+	for (i = 0; i < numBins; ++i) {
+		struct V_OffsetBin *b = &bins[i];
+		b->peakScore = b->score;
+		b->peakVoters = b->numVoters;
+		if (i > 0 && det_houghAreNeighbors(b, &bins[i - 1], 1)) {
+			b->peakScore += bins[i - 1].score;
+			b->peakVoters += bins[i - 1].numVoters;
+		}
+		if (i + 1 < numBins && det_houghAreNeighbors(b, &bins[i + 1], 1)) {
+			b->peakScore += bins[i + 1].score;
+			b->peakVoters += bins[i + 1].numVoters;
+		}
+	}
+	MyVectorObj *peaks = my_vectorObj_new();
+	for (i = 0; i < numBins; ++i) {
+		struct V_OffsetBin *b = &bins[i];
+		if (b->peakVoters < MIN_VOTERS_OFFSET)
+			continue;
+		if (i > 0 && det_houghAreNeighbors(b, &bins[i - 1], 1)
+				&& bins[i - 1].peakScore > b->peakScore)
+			continue;
+		if (i + 1 < numBins && det_houghAreNeighbors(b, &bins[i + 1], 1)
+				&& bins[i + 1].peakScore >= b->peakScore)
+			continue;
+		my_vectorObj_add(peaks, b);
+	}
+	my_vectorObj_qsort(peaks, det_compare_peakScore_may_men);
+	if (maxBins > 0) {
+		while (my_vectorObj_size(peaks) > maxBins)
+			my_vectorObj_remove(peaks, my_vectorObj_size(peaks) - 1);
+	}
+	return peaks;
+}
+#define HOUGH_NEIGHBOR_BINS 2
+
+//probes the bins around the peaks from peaks[first] to peaks[last], which
+//are of the same video and their probed bins overlap
+static void det_houghAddProbes(struct V_OffsetBin *bins, int64_t numBins,
+		MyVectorObj *peaks, int64_t first, int64_t last,
+		struct D_Query *queryVideo, struct ParamsVoting *pv,
+		MyVectorObj *probes) {
+	struct V_OffsetBin *peakFirst = my_vectorObj_get(peaks, first);
+	struct V_OffsetBin *peakLast = my_vectorObj_get(peaks, last);
+	int64_t i, numVoters = 0;
+	for (i = first; i <= last; ++i) {
+		struct V_OffsetBin *peak = my_vectorObj_get(peaks, i);
+		numVoters = MAX(numVoters, peak->peakVoters);
+	}
+	//the votes of a segment may fall in a bin near to the tested offset
+	int64_t first_frame = peakFirst->first_frame, last_frame =
+			peakFirst->last_frame;
+	for (i = MAX(0, peakFirst - bins - HOUGH_NEIGHBOR_BINS);
+			i < MIN(numBins, peakLast - bins + HOUGH_NEIGHBOR_BINS + 1); ++i) {
+		if (bins[i].videoR == peakFirst->videoR
+				&& bins[i].bin >= peakFirst->bin - HOUGH_NEIGHBOR_BINS
+				&& bins[i].bin <= peakLast->bin + HOUGH_NEIGHBOR_BINS) {
+			first_frame = MIN(first_frame, bins[i].first_frame);
+			last_frame = MAX(last_frame, bins[i].last_frame);
+		}
+	}
+	int64_t bin;
+	for (bin = peakFirst->bin - 1; bin <= peakLast->bin + 1; ++bin) {
+		struct V_VideoOffset *probe = MY_MALLOC(1, struct V_VideoOffset);
+		probe->videoR = peakFirst->videoR;
+		probe->offset_min = bin * pv->stepSize;
+		probe->offset_max = probe->offset_min + pv->stepSize;
+		probe->numVoters = numVoters;
+		probe->first_frame = MAX(0, first_frame - 1);
+		probe->last_frame = MIN(queryVideo->numFrames, last_frame + 1);
+		my_vectorObj_add(probes, probe);
+	}
+}
+void det_detectByHough(void *qqueryVideo, struct ParamsVoting *pv,
+		int64_t numThreads, void *stateVot) {
+	struct D_Query *queryVideo = qqueryVideo;
+	int64_t numVotes = 0, numBins = 0;
+	struct V_OffsetVote *votes = det_houghCollectVotes(queryVideo, pv,
+			&numVotes);
+	struct V_OffsetBin *bins = det_houghAccumulate(votes, numVotes, &numBins);
+	MY_FREE(votes);
+	MyVectorObj *peaks = det_houghSelectPeaks(bins, numBins, pv->maxBins);
+	//each peak probes its bin and the two adjacent ones, peaks whose probed
+	//bins overlap are merged to avoid testing the same offset twice
+	my_vectorObj_qsort(peaks, det_compare_binPosition);
+	MyVectorObj *probes = my_vectorObj_new();
+	int64_t i, first = 0;
+	for (i = 0; i < my_vectorObj_size(peaks); ++i) {
+		struct V_OffsetBin *peak = my_vectorObj_get(peaks, i);
+		if (i + 1 < my_vectorObj_size(peaks)
+				&& det_houghAreNeighbors(peak, my_vectorObj_get(peaks, i + 1),
+						2))
+			continue;
+		det_houghAddProbes(bins, numBins, peaks, first, i, queryVideo, pv,
+				probes);
+		first = i + 1;
+	}
+	my_vectorObj_release(peaks, 0);
+	MY_FREE(bins);
+	det_testProbes(queryVideo, probes, pv, numThreads, stateVot);
+	my_vectorObj_release(probes, 1);
+}
@@ -131,23 +131,60 @@ double averageIntensity(IplImage *imgGray, int64_t startW, int64_t startH,
 		int64_t endWNotIncluded, int64_t endHNotIncluded);
 double *newKernel(double d00, double d01, double d10, double d11);
 
+//sums and squared sums of any rectangle of a gray image in O(1)
+struct IntegralImage;
+struct IntegralImage *newIntegralImage(bool withSquares);
+void integralImage_compute(struct IntegralImage *ii, IplImage *imgGray);
+double integralImage_average(struct IntegralImage *ii, int64_t startW,
+		int64_t startH, int64_t endWNotIncluded, int64_t endHNotIncluded);
+double integralImage_variance(struct IntegralImage *ii, int64_t startW,
+		int64_t startH, int64_t endWNotIncluded, int64_t endHNotIncluded);
+void releaseIntegralImage(struct IntegralImage *ii);
+
 struct Zone {
 	int64_t numZone;
 	double prop_start_w, prop_end_w, prop_start_h, prop_end_h;
 	int64_t pix_start_w, pix_end_w, pix_start_h, pix_end_h;
 	CvRect rect;
 };
+struct ZoningGrid {
+	int64_t numW, numH, firstZone;
+};
 struct Zoning {
 	int64_t numZones;
 	struct Zone **zones;
+	int64_t numGrids;
+	struct ZoningGrid *grids;
 	int64_t currentW, currentH;
 };
 struct Zoning *parseZoning(const char *paramsZoning);
 void processZoning(IplImage *image, struct Zoning *zoning,
 		void (*func_processZone)(IplImage *image, struct Zone *z, void *state),
 		void *state);
+//locates the zones containing (x,y), at most one zone per grid.
+//out_zones must have room for numGrids values. Returns the number of zones.
+int64_t locateZones(IplImage *image, struct Zoning *zoning, double x, double y,
+		int64_t *out_zones);
 void releaseZoning(struct Zoning *zoning);
 
+//histograms of every zone with a single pass over the pixels: each pixel is
+//counted in a cell of the lattice formed by all the zone boundaries, then
+//each zone adds its cells through an integral table over the lattice.
+struct ZoningHistograms;
+//bin_luts[nc][value] is the bin (between 0 and totalBins-1) of a value of channel nc
+struct ZoningHistograms *newZoningHistograms(struct Zoning *zoning,
+		int64_t numChannels, int64_t totalBins, int32_t **bin_luts);
+//replaces the bin_luts lookup: func_binRow writes the numChannels bins of each
+//pixel of a row, e.g. converting the color space and quantizing in one step
+void zoningHistograms_setBinRow(struct ZoningHistograms *zh,
+		void (*func_binRow)(const uchar *pixels, int64_t width,
+				int32_t *out_bins, void *state), void *state);
+void zoningHistograms_compute(struct ZoningHistograms *zh, IplImage *image);
+//adds the counts of zone numZone to bins[0..totalBins-1]
+void zoningHistograms_addZone(struct ZoningHistograms *zh, int64_t numZone,
+		double *bins);
+void releaseZoningHistograms(struct ZoningHistograms *zh);
+
 void applyPcaToLocalDescriptors(MknnPcaAlgorithm *pca,
 		MyLocalDescriptors *src_descriptor, MyLocalDescriptors *dst_descriptor);
 
@@ -10,6 +10,9 @@
 #include <myutils/myutils_c.h>
 
 #ifndef NO_OPENCV
+//number of precomputed segments quantized with a single search
+#define BOW_BATCH_SEGMENTS 64
+
 struct State_Bow {
 	struct Quantization quant;
 	struct Zoning *zoning;
@@ -21,8 +24,25 @@ struct State_Bow {
 	void *descriptor;
 	char *localDescriptorAlias;
 	struct DescriptorsFile *current_file;
+	//nearest centroid for each descriptor of the current batch
+	int64_t batch_first, batch_end;
+	int64_t *batch_offsets, *centroids, centroids_size;
+	int64_t *zones_buffer;
 };
 
+//PVCD_BOW_INDEX and PVCD_BOW_SEARCH replace the exact search for large
+//vocabularies, e.g. PVCD_BOW_INDEX="FLANN-KDTREE,num_trees=4"
+static MknnIndex *new_codebook_index(MknnDataset *centroids,
+		MknnDistance *distance) {
+	const char *index_options = my_env_getString("PVCD_BOW_INDEX");
+	if (index_options[0] == '\0')
+		return mknn_index_newPredefined(
+				mknn_predefIndex_LinearScan_indexParams(), true, centroids,
+				true, distance, true);
+	return mknn_index_newPredefined(
+			mknn_indexParams_newParseString(index_options), true, centroids,
+			true, distance, true);
+}
 static void ext_new_bow(const char *extCode, const char *extParameters,
 		void **out_state, DescriptorType *out_td, bool *out_useImgGray) {
 	MyTokenizer *tk = my_tokenizer_new(extParameters, '_');
@@ -44,70 +64,78 @@ static void ext_new_bow(const char *extCode, const char *extParameters,
 	MknnDistance *distance = mknn_distance_newPredefined(
 			mknn_distanceParams_newParseString(distanceName), true);
 	free(distanceName);
-	es->index = mknn_index_newPredefined(
-			mknn_predefIndex_LinearScan_indexParams(), true, centroids, true,
-			distance, true);
+	es->index = new_codebook_index(centroids, distance);
+	//extraction already runs one extractor per thread
 	es->resolver = mknn_index_newResolver(es->index,
-			mknn_predefIndex_LinearScan_resolverExactNearestNeighbors(1, 0, 0),
-			true);
+			mknn_resolverParams_newParseString(1, 0, 1,
+					my_env_getString("PVCD_BOW_SEARCH")), true);
 	es->numCentroids = mknn_dataset_getNumObjects(centroids);
 	es->descriptorLength = es->zoning->numZones * es->numCentroids;
 	es->bins = MY_MALLOC_NOINIT(es->descriptorLength, double);
 	es->descriptor = newDescriptorQuantize(es->quant, es->descriptorLength);
+	es->batch_offsets = MY_MALLOC(BOW_BATCH_SEGMENTS + 1, int64_t);
+	es->zones_buffer = MY_MALLOC(es->zoning->numGrids, int64_t);
 	*out_state = es;
 	*out_td = descriptorType(es->quant.dtype, es->descriptorLength,
 			es->zoning->numZones, es->numCentroids);
 	*out_useImgGray = false;
 }
-struct ParamsZones {
-	MyLocalDescriptors *ldes;
-	MknnResult *result;
-	struct State_Bow *es;
-};
-static void ext_func_processZone(IplImage *image, struct Zone *zone,
-		void *state) {
-	struct ParamsZones *p = state;
-	double *current_bins = p->es->bins + zone->numZone * p->es->numCentroids;
-	for (int64_t i = 0; i < my_localDescriptors_getNumDescriptors(p->ldes);
-			++i) {
-		struct MyLocalKeypoint kp = my_localDescriptors_getKeypoint(p->ldes, i);
-		if (!(zone->pix_start_w <= kp.x && kp.x < zone->pix_end_w
-				&& zone->pix_start_h <= kp.y && kp.y < zone->pix_end_h))
-			continue;
-		MknnResultQuery *res = mknn_result_getResultQuery(p->result, i);
-		if (res->num_nns == 0)
-			continue;
-		int64_t id_centroid = res->nn_position[0];
-		my_assert_indexRangeInt("id_centroid", id_centroid,
-				p->es->numCentroids);
-		current_bins[id_centroid]++;
+//computes the nearest centroids of many local descriptors in one search
+static void assign_centroids(struct State_Bow *es, int64_t num_ldes,
+		MyLocalDescriptors **ldes) {
+	MyLocalDescriptors *nonempty[num_ldes];
+	int64_t num_nonempty = 0, total = 0;
+	for (int64_t i = 0; i < num_ldes; ++i) {
+		es->batch_offsets[i] = total;
+		int64_t n = my_localDescriptors_getNumDescriptors(ldes[i]);
+		if (n > 0)
+			nonempty[num_nonempty++] = ldes[i];
+		total += n;
 	}
-}
-static void compute_bow(IplImage *frame, MyLocalDescriptors *ldes,
-		struct State_Bow *es) {
-	MY_SETZERO(es->bins, es->descriptorLength, double);
-	if (my_localDescriptors_getNumDescriptors(ldes) == 0)
+	es->batch_offsets[num_ldes] = total;
+	if (total == 0)
 		return;
-	//compute nearest centroids
-	MknnDataset *query_dataset = my_localDescriptors_createMknnDataset_vectors(
-			ldes, false);
+	if (total > es->centroids_size) {
+		MY_REALLOC(es->centroids, total, int64_t);
+		es->centroids_size = total;
+	}
+	MknnDataset *query_dataset =
+			my_localDescriptors_createConcatenateMknnDataset_vectors(
+					num_nonempty, nonempty, false);
 	MknnResult *result = mknn_resolver_search(es->resolver, false,
 			query_dataset, false);
-	//aggregate centroids
-	struct ParamsZones p = { 0 };
-	p.result = result;
-	p.ldes = ldes;
-	p.es = es;
-	processZoning(frame, es->zoning, ext_func_processZone, &p);
-	my_math_normalizeNorm1_double(es->bins, es->descriptorLength);
-	quantize(es->quant, es->bins, es->descriptor, es->descriptorLength);
+	for (int64_t i = 0; i < total; ++i) {
+		MknnResultQuery *res = mknn_result_getResultQuery(result, i);
+		int64_t id_centroid = (res->num_nns == 0) ? -1 : res->nn_position[0];
+		if (id_centroid >= es->numCentroids)
+			my_log_error("invalid id_centroid %"PRIi64"\n", id_centroid);
+		es->centroids[i] = id_centroid;
+	}
 	mknn_result_release(result);
 	mknn_dataset_release(query_dataset);
 }
+//aggregates centroids in a single pass over the keypoints
+static void compute_bow(IplImage *frame, MyLocalDescriptors *ldes,
+		const int64_t *centroids, struct State_Bow *es) {
+	MY_SETZERO(es->bins, es->descriptorLength, double);
+	for (int64_t i = 0; i < my_localDescriptors_getNumDescriptors(ldes);
+			++i) {
+		if (centroids[i] < 0)
+			continue;
+		struct MyLocalKeypoint kp = my_localDescriptors_getKeypoint(ldes, i);
+		int64_t num_zones = locateZones(frame, es->zoning, kp.x, kp.y,
+				es->zones_buffer);
+		for (int64_t j = 0; j < num_zones; ++j)
+			es->bins[es->zones_buffer[j] * es->numCentroids + centroids[i]]++;
+	}
+	my_math_normalizeNorm1_double(es->bins, es->descriptorLength);
+	quantize(es->quant, es->bins, es->descriptor, es->descriptorLength);
+}
 static void *ext_extract_bow(IplImage *image, void *state) {
 	struct State_Bow *es = state;
 	MyLocalDescriptors *ldes = extractVolatileDescriptor(es->local_ext, image);
-	compute_bow(image, ldes, es);
+	assign_centroids(es, 1, &ldes);
+	compute_bow(image, ldes, es->centroids, es);
 	return es->descriptor;
 }
 static void ext_release_bow(void *state) {
@@ -116,7 +144,8 @@ static void ext_release_bow(void *state) {
 	mknn_index_release(es->index);
 	releaseZoning(es->zoning);
 	releaseExtractor(es->local_ext);
-	MY_FREE_MULTI(es->localDescriptorAlias, es->bins, es->descriptor, es);
+	MY_FREE_MULTI(es->localDescriptorAlias, es->bins, es->descriptor,
+			es->batch_offsets, es->centroids, es->zones_buffer, es);
 }
 static void ext_func_init_video(struct Extractor_InitParams *ip, void *state) {
 	struct State_Bow *es = state;
@@ -125,6 +154,16 @@ static void ext_func_init_video(struct Extractor_InitParams *ip, void *state) {
 	if (loadDescriptors_getDescriptorType(dd).dtype != DTYPE_LOCAL_VECTORS)
 		my_log_error("BOW requires local descriptors\n");
 	es->current_file = loadDescriptorsFileDB(dd, ip->fileDB);
+	es->batch_first = es->batch_end = 0;
+}
+//the batch starts at the requested segment because each thread extracts a
+//different range of segments
+static void load_batch(struct State_Bow *es, int64_t idSegment) {
+	es->batch_first = idSegment;
+	es->batch_end = MIN(idSegment + BOW_BATCH_SEGMENTS,
+			es->current_file->numDescriptors);
+	assign_centroids(es, es->batch_end - es->batch_first,
+			(MyLocalDescriptors **) es->current_file->descriptors + idSegment);
 }
 static void *ext_segment_bow(struct Extractor_InitParams *ip, int64_t idSegment,
 		void *state) {
@@ -132,13 +171,17 @@ static void *ext_segment_bow(struct Extractor_InitParams *ip, int64_t idSegment,
 	seekVideoToFrame(ip->video_frame,
 			ip->segmentation->segments[idSegment].selected_frame);
 	IplImage *frame = getCurrentFrameOrig(ip->video_frame);
+	if (idSegment < es->batch_first || idSegment >= es->batch_end)
+		load_batch(es, idSegment);
 	MyLocalDescriptors *ldes = es->current_file->descriptors[idSegment];
-	compute_bow(frame, ldes, es);
+	int64_t offset = es->batch_offsets[idSegment - es->batch_first];
+	compute_bow(frame, ldes, es->centroids + offset, es);
 	return es->descriptor;
 }
 static void ext_func_end_video(struct Extractor_InitParams *ip, void* state) {
 	struct State_Bow *es = state;
 	releaseDescriptorsFile(es->current_file);
+	es->batch_first = es->batch_end = 0;
 }
 
 void ext_reg_bow() {
@@ -19,6 +19,7 @@ struct State_EHD {
 	struct Quantization quant;
 	uchar withAbs;
 	void *descriptor;
+	struct IntegralImage *integral;
 };
 
 static double **ehd_getKernels(int64_t numKernels) {
@@ -75,24 +76,25 @@ static void ext_config_ehd(const char *code, const char *parameters,
 	es->length = es->numDivisionsW * es->numDivisionsH * es->numKernels;
 	es->double_array = MY_MALLOC_NOINIT(es->length, double);
 	es->descriptor = newDescriptorQuantize(es->quant, es->length);
+	es->integral = newIntegralImage(false);
 	*out_state = es;
 	*out_td = descriptorType(es->quant.dtype, es->length, es->numDivisionsW,
 			es->numDivisionsH);
 	*out_useImgGray = true;
 }
 
-static int64_t ehd_getIdMaxKernel(IplImage *imgGray, int64_t posW, int64_t posH,
-		struct State_EHD *es) {
+static int64_t ehd_getIdMaxKernel(struct IntegralImage *ii, int64_t posW,
+		int64_t posH, struct State_EHD *es) {
 	int64_t startW = posW > 0 ? es->limitsW[posW - 1] : 0;
 	int64_t startH = posH > 0 ? es->limitsH[posH - 1] : 0;
 	int64_t medW = es->limitsW[posW];
 	int64_t medH = es->limitsH[posH];
 	int64_t endW = es->limitsW[posW + 1];
 	int64_t endH = es->limitsH[posH + 1];
-	double bloq_00 = averageIntensity(imgGray, startW, startH, medW, medH);
-	double bloq_01 = averageIntensity(imgGray, medW, startH, endW, medH);
-	double bloq_10 = averageIntensity(imgGray, startW, medH, medW, endH);
-	double bloq_11 = averageIntensity(imgGray, medW, medH, endW, endH);
+	double bloq_00 = integralImage_average(ii, startW, startH, medW, medH);
+	double bloq_01 = integralImage_average(ii, medW, startH, endW, medH);
+	double bloq_10 = integralImage_average(ii, startW, medH, medW, endH);
+	double bloq_11 = integralImage_average(ii, medW, medH, endW, endH);
 	int64_t k, idMaxKernel = -1; //default maximum
 	double maxVal = es->threshold; //minimum threshold
 	for (k = 0; k < es->numKernels; ++k) {
@@ -108,14 +110,14 @@ static int64_t ehd_getIdMaxKernel(IplImage *imgGray, int64_t posW, int64_t posH,
 	}
 	return idMaxKernel;
 }
-static void ehd_compute_histogram(IplImage *imgGray, int64_t numBloqW,
+static void ehd_compute_histogram(struct IntegralImage *ii, int64_t numBloqW,
 		int64_t numBloqH, double *values, struct State_EHD *es) {
 	int64_t i, j;
 	int64_t posH = 2 * es->numSubDivisionsH * numBloqH;
 	for (j = 0; j < es->numSubDivisionsH; ++j) {
 		int64_t posW = 2 * es->numSubDivisionsW * numBloqW;
 		for (i = 0; i < es->numSubDivisionsW; ++i) {
-			int64_t idKernel = ehd_getIdMaxKernel(imgGray, posW, posH, es);
+			int64_t idKernel = ehd_getIdMaxKernel(ii, posW, posH, es);
 			if (idKernel >= 0) {
 				values[idKernel]++;
 			}
@@ -138,9 +140,10 @@ static void *ext_extract_ehd(IplImage *image, void *state) {
 	}
 	MY_SETZERO(es->double_array, es->length, double);
 	double *double_array = es->double_array;
+	integralImage_compute(es->integral, image);
 	for (int64_t j = 0; j < es->numDivisionsH; ++j) {
 		for (int64_t i = 0; i < es->numDivisionsW; ++i) {
-			ehd_compute_histogram(image, i, j, double_array, es);
+			ehd_compute_histogram(es->integral, i, j, double_array, es);
 			double_array += es->numKernels;
 		}
 	}
@@ -149,6 +152,7 @@ static void *ext_extract_ehd(IplImage *image, void *state) {
 }
 static void ext_release_ehd(void *state) {
 	struct State_EHD *es = state;
+	releaseIntegralImage(es->integral);
 	MY_FREE_MULTI(es->descriptor, es->double_array, es->kernels, es->limitsW,
 			es->limitsH, es);
 }
@@ -16,6 +16,7 @@ struct Estado_EDGES {
 	int64_t numKernels;
 	double threshold, **kernels;
 	uchar *idsKernels;
+	struct IntegralImage *integral;
 };
 
 static void ext_config_edg(const char *code, const char *parameters, void **out_state,
@@ -43,13 +44,14 @@ static void ext_config_edg(const char *code, const char *parameters, void **out_
 	my_tokenizer_releaseValidateEnd(tk);
 	int64_t largo = es->numDivisionsW * es->numDivisionsH;
 	es->idsKernels = MY_MALLOC_NOINIT(largo, uchar);
+	es->integral = newIntegralImage(false);
 	*out_state = es;
 	*out_td = descriptorType(DTYPE_ARRAY_UCHAR, largo, es->numDivisionsW,
 			es->numDivisionsH);
 	*out_useImgGray = true;
 }
 
-static int64_t edg_buscarMaxKernel(IplImage *imgGris, int64_t numBloqW,
+static int64_t edg_buscarMaxKernel(struct IntegralImage *ii, int64_t numBloqW,
 		int64_t numBloqH, struct Estado_EDGES *es) {
 	int64_t iniW = numBloqW > 0 ? es->limitsW[2 * numBloqW - 1] : 0;
 	int64_t iniH = numBloqH > 0 ? es->limitsH[2 * numBloqH - 1] : 0;
@@ -57,10 +59,10 @@ static int64_t edg_buscarMaxKernel(IplImage *imgGris, int64_t numBloqW,
 	int64_t medH = es->limitsH[2 * numBloqH];
 	int64_t finW = es->limitsW[2 * numBloqW + 1];
 	int64_t finH = es->limitsH[2 * numBloqH + 1];
-	double bloq_00 = averageIntensity(imgGris, iniW, iniH, medW, medH);
-	double bloq_01 = averageIntensity(imgGris, medW, iniH, finW, medH);
-	double bloq_10 = averageIntensity(imgGris, iniW, medH, medW, finH);
-	double bloq_11 = averageIntensity(imgGris, medW, medH, finW, finH);
+	double bloq_00 = integralImage_average(ii, iniW, iniH, medW, medH);
+	double bloq_01 = integralImage_average(ii, medW, iniH, finW, medH);
+	double bloq_10 = integralImage_average(ii, iniW, medH, medW, finH);
+	double bloq_11 = integralImage_average(ii, medW, medH, finW, finH);
 	int64_t k, kernelMax = es->numKernels; //maximo por defecto
 	double val, valMax = es->threshold; //threshold minimo a superar
 	for (k = 0; k < es->numKernels; ++k) {
@@ -85,15 +87,18 @@ static void *ext_extraer_edg(IplImage *image, void *state) {
 		es->lastW = image->width;
 		es->lastH = image->height;
 	}
+	integralImage_compute(es->integral, image);
 	int64_t i, j, cont = 0;
 	for (j = 0; j < es->numDivisionsH; ++j)
 		for (i = 0; i < es->numDivisionsW; ++i)
-			es->idsKernels[cont++] = edg_buscarMaxKernel(image, i, j, es);
+			es->idsKernels[cont++] = edg_buscarMaxKernel(es->integral, i, j,
+					es);
 	return es->idsKernels;
 }
 
 static void ext_release_edg(void *estado) {
 	struct Estado_EDGES *es = estado;
+	releaseIntegralImage(es->integral);
 	MY_FREE_MULTI(es->kernels, es->idsKernels, es->limitsW, es->limitsH, es);
 }
 void ext_reg_edg() {
@@ -15,6 +15,11 @@ struct State_HistByChannel {
 	struct MyColorSpace colorSpace;
 	int64_t numBins1, numBins2, numBins3, totalBins;
 	int64_t *val2bin_1, *val2bin_2, *val2bin_3;
+	int32_t *bin_luts[3];
+	//fused YCrCb conversion: contributions to Y, and bins of Cr and Cb
+	int32_t *ycc_tabY, *ycc_binCr, *ycc_binCb;
+	struct ZoningHistograms *zoneHists;
+	bool fusedConversion;
 	int64_t descriptorLength;
 	struct Quantization quant;
 	char *zoning_text;
@@ -26,6 +31,89 @@ struct State_HistByChannel {
 	CvHistogram *cv_hist1, *cv_hist2, *cv_hist3;
 };
 
+//bin of each channel value, values over the channel max go to the last bin
+static int32_t *histByChannel_newChannelLut(int64_t *val2bin, int64_t maxVal,
+		int64_t offset) {
+	int32_t *lut = MY_MALLOC_NOINIT(256, int32_t);
+	for (int64_t v = 0; v < 256; ++v)
+		lut[v] = offset + val2bin[MIN(v, maxVal - 1)];
+	return lut;
+}
+static void histByChannel_newLut(struct State_HistByChannel *es) {
+	es->bin_luts[0] = histByChannel_newChannelLut(es->val2bin_1,
+			es->colorSpace.channel0_max, 0);
+	es->bin_luts[1] = histByChannel_newChannelLut(es->val2bin_2,
+			es->colorSpace.channel1_max, es->numBins1);
+	es->bin_luts[2] = histByChannel_newChannelLut(es->val2bin_3,
+			es->colorSpace.channel2_max, es->numBins1 + es->numBins2);
+}
+//same fixed-point arithmetic than the 8-bit BGR2YCrCb of OpenCV
+#define YCC_SHIFT 14
+#define YCC_R2Y 4899
+#define YCC_G2Y 9617
+#define YCC_B2Y 1868
+#define YCC_CR 11682
+#define YCC_CB 9241
+static int32_t *histByChannel_newYccDiffLut(int32_t *bin_lut, int64_t coef) {
+	//indexed by (value - Y + 255)
+	int32_t *lut = MY_MALLOC_NOINIT(511, int32_t);
+	for (int64_t d = -255; d <= 255; ++d) {
+		int64_t val = (d * coef + (128 << YCC_SHIFT) + (1 << (YCC_SHIFT - 1)))
+				>> YCC_SHIFT;
+		lut[d + 255] = bin_lut[MAX(0, MIN(255, val))];
+	}
+	return lut;
+}
+static void histByChannel_newYccLuts(struct State_HistByChannel *es) {
+	//contributions of B, G and R to Y (rounding included in B)
+	es->ycc_tabY = MY_MALLOC_NOINIT(3 * 256, int32_t);
+	for (int64_t v = 0; v < 256; ++v) {
+		es->ycc_tabY[v] = v * YCC_B2Y + (1 << (YCC_SHIFT - 1));
+		es->ycc_tabY[256 + v] = v * YCC_G2Y;
+		es->ycc_tabY[512 + v] = v * YCC_R2Y;
+	}
+	es->ycc_binCr = histByChannel_newYccDiffLut(es->bin_luts[1], YCC_CR);
+	es->ycc_binCb = histByChannel_newYccDiffLut(es->bin_luts[2], YCC_CB);
+}
+static void histByChannel_binRowYcc(const uchar *pixels, int64_t width,
+		int32_t *out_bins, void *state) {
+	struct State_HistByChannel *es = state;
+	const int32_t *restrict tabB = es->ycc_tabY, *restrict tabG = tabB + 256,
+			*restrict tabR = tabB + 512;
+	const int32_t *restrict binY = es->bin_luts[0];
+	const int32_t *restrict binCr = es->ycc_binCr, *restrict binCb =
+			es->ycc_binCb;
+	for (int64_t x = 0; x < width; ++x) {
+		const uchar *p = pixels + 3 * x;
+		int32_t y = (tabB[p[0]] + tabG[p[1]] + tabR[p[2]]) >> YCC_SHIFT;
+		out_bins[3 * x] = binY[y];
+		out_bins[3 * x + 1] = binCr[p[2] - y + 255];
+		out_bins[3 * x + 2] = binCb[p[0] - y + 255];
+	}
+}
+static void histByChannel_binRowRgb(const uchar *pixels, int64_t width,
+		int32_t *out_bins, void *state) {
+	struct State_HistByChannel *es = state;
+	const int32_t *restrict binR = es->bin_luts[0], *restrict binG =
+			es->bin_luts[1], *restrict binB = es->bin_luts[2];
+	for (int64_t x = 0; x < width; ++x) {
+		const uchar *p = pixels + 3 * x;
+		out_bins[3 * x] = binR[p[2]];
+		out_bins[3 * x + 1] = binG[p[1]];
+		out_bins[3 * x + 2] = binB[p[0]];
+	}
+}
+//converts from BGR while computing the bins when the conversion is cheap
+static void histByChannel_setFusedConversion(struct State_HistByChannel *es) {
+	if (my_string_equals(es->colorSpace.code, "RGB")) {
+		zoningHistograms_setBinRow(es->zoneHists, histByChannel_binRowRgb, es);
+		es->fusedConversion = true;
+	} else if (my_string_equals(es->colorSpace.code, "YCrCb")) {
+		histByChannel_newYccLuts(es);
+		zoningHistograms_setBinRow(es->zoneHists, histByChannel_binRowYcc, es);
+		es->fusedConversion = true;
+	}
+}
 static void ext_new_hist(const char *code, const char *parameters, void **out_state,
 		DescriptorType *out_td, bool *out_useImgGray) {
 	MyTokenizer *tk = my_tokenizer_new(parameters, '_');
@@ -68,6 +156,10 @@ static void ext_new_hist(const char *code, const char *parameters, void **out_st
 		es->val2bin_1 = hist_val2bin(es->numBins1, es->colorSpace.channel0_max);
 		es->val2bin_2 = hist_val2bin(es->numBins2, es->colorSpace.channel1_max);
 		es->val2bin_3 = hist_val2bin(es->numBins3, es->colorSpace.channel2_max);
+		histByChannel_newLut(es);
+		es->zoneHists = newZoningHistograms(es->zoning, 3, es->totalBins,
+				es->bin_luts);
+		histByChannel_setFusedConversion(es);
 	}
 	*out_state = es;
 	*out_td = descriptorType(es->quant.dtype, es->descriptorLength,
@@ -96,39 +188,16 @@ static void histByChannel_opencv(IplImage *image, CvRect rect,
 	for (i = 0; i < es->numBins3; i++)
 		es->bins[cont++] = cvGetReal1D(es->cv_hist3->bins, i);
 }
-static void histByChannel_accumBins(uchar pixelVal1, uchar pixelVal2,
-		uchar pixelVal3, void *state) {
-	struct State_HistByChannel *es = state;
-	if (pixelVal1 >= es->colorSpace.channel0_max)
-		pixelVal1 = es->colorSpace.channel0_max - 1;
-	if (pixelVal2 >= es->colorSpace.channel1_max)
-		pixelVal2 = es->colorSpace.channel1_max - 1;
-	if (pixelVal3 >= es->colorSpace.channel2_max)
-		pixelVal3 = es->colorSpace.channel2_max - 1;
-	int64_t bin1 = es->val2bin_1[pixelVal1];
-	int64_t bin2 = es->val2bin_2[pixelVal2];
-	int64_t bin3 = es->val2bin_3[pixelVal3];
-	es->current_bins[bin1]++;
-	es->current_bins[bin2 + es->numBins1]++;
-	es->current_bins[bin3 + es->numBins1 + es->numBins2]++;
-}
 static void histByChannel_processZone(IplImage *image, struct Zone *zone,
 		void *state) {
 	struct State_HistByChannel *es = state;
-	if (es->useOpenCV) {
-		histByChannel_opencv(image, zone->rect, es);
-	} else {
-		es->current_bins = es->bins + zone->numZone * es->totalBins;
-		hist_getBins3Channels(image, zone, histByChannel_accumBins, es);
-		if (es->normalize)
-			my_math_normalizeSum1_double(es->current_bins, es->totalBins);
-	}
+	histByChannel_opencv(image, zone->rect, es);
 }
 static void *ext_extract_hist(IplImage *image, void *state) {
 	struct State_HistByChannel *es = state;
 	MY_SETZERO(es->bins, es->descriptorLength, double);
-	IplImage *frame = my_imageColor_convertFromBGR(image, es->converter);
 	if (es->useOpenCV) {
+		IplImage *frame = my_imageColor_convertFromBGR(image, es->converter);
 		if (es->cv_plano0 == NULL || es->cv_plano0->width != frame->width
 				|| es->cv_plano0->height != frame->height) {
 			my_image_release(es->cv_plano0);
@@ -139,8 +208,21 @@ static void *ext_extract_hist(IplImage *image, void *state) {
 			es->cv_plano2 = cvCreateImage(cvGetSize(frame), 8, 1);
 		}
 		cvSplit(frame, es->cv_plano0, es->cv_plano1, es->cv_plano2, 0);
+		processZoning(frame, es->zoning, histByChannel_processZone, es);
+	} else {
+		//all the zones from one pass over the pixels
+		IplImage *frame =
+				es->fusedConversion ?
+						image :
+						my_imageColor_convertFromBGR(image, es->converter);
+		zoningHistograms_compute(es->zoneHists, frame);
+		for (int64_t i = 0; i < es->zoning->numZones; ++i) {
+			es->current_bins = es->bins + i * es->totalBins;
+			zoningHistograms_addZone(es->zoneHists, i, es->current_bins);
+			if (es->normalize)
+				my_math_normalizeSum1_double(es->current_bins, es->totalBins);
+		}
 	}
-	processZoning(frame, es->zoning, histByChannel_processZone, es);
 	quantize(es->quant, es->bins, es->descriptor, es->descriptorLength);
 	return es->descriptor;
 }
@@ -148,7 +230,7 @@ static void ext_release_hist(void *estado) {
 	struct State_HistByChannel *es = estado;
 	my_imageColor_release(es->converter);
 	releaseZoning(es->zoning);
-	releaseZoning(es->zoning);
+	releaseZoningHistograms(es->zoneHists);
 	if (es->useOpenCV) {
 		my_image_release(es->cv_plano0);
 		my_image_release(es->cv_plano1);
@@ -157,8 +239,9 @@ static void ext_release_hist(void *estado) {
 		cvReleaseHist(&es->cv_hist2);
 		cvReleaseHist(&es->cv_hist3);
 	}
-	MY_FREE_MULTI(es->val2bin_1, es->val2bin_2, es->val2bin_3, es->bins,
-			es->descriptor, es);
+	MY_FREE_MULTI(es->val2bin_1, es->val2bin_2, es->val2bin_3, es->bin_luts[0],
+			es->bin_luts[1], es->bin_luts[2], es->ycc_tabY, es->ycc_binCr,
+			es->ycc_binCb, es->bins, es->descriptor, es);
 }
 void ext_reg_histByChannel() {
 	addExtractorGlobalDef(false, "HISTBYCHANNEL",
@@ -14,6 +14,8 @@ struct State_HistGray {
 	uchar useOpenCV, normalize;
 	int64_t numBins;
 	int64_t *val2bin;
+	int32_t *bin_lut;
+	struct ZoningHistograms *zoneHists;
 	int64_t descriptorLength;
 	struct Quantization quant;
 	char *zoning_text;
@@ -44,6 +46,11 @@ static void ext_new_histg(const char *code, const char *parameters, void **out_s
 		es->cv_hist = cvCreateHist(1, hist_size, CV_HIST_ARRAY, cv_rangos, 1);
 	} else {
 		es->val2bin = hist_val2bin(es->numBins, 256);
+		es->bin_lut = MY_MALLOC_NOINIT(256, int32_t);
+		for (int64_t i = 0; i < 256; ++i)
+			es->bin_lut[i] = es->val2bin[i];
+		es->zoneHists = newZoningHistograms(es->zoning, 1, es->numBins,
+				&es->bin_lut);
 	}
 	*out_state = es;
 	*out_td = descriptorType(es->quant.dtype, es->descriptorLength,
@@ -61,27 +68,26 @@ static void histGray_opencv(IplImage *image, CvRect rect,
 	for (i = 0; i < es->numBins; i++)
 		es->bins[i] = cvGetReal1D(es->cv_hist->bins, i);
 }
-static void histGray_accumBins(uchar pixelVal, void *state) {
-	struct State_HistGray *es = state;
-	int64_t bin = es->val2bin[pixelVal];
-	es->current_bins[bin]++;
-}
 static void histGray_processZone(IplImage *image, struct Zone *zone,
 		void *state) {
 	struct State_HistGray *es = state;
-	if (es->useOpenCV) {
-		histGray_opencv(image, zone->rect, es);
-	} else {
-		es->current_bins = es->bins + zone->numZone * es->numBins;
-		hist_getBins1Channels(image, zone, histGray_accumBins, es);
-		if (es->normalize)
-			my_math_normalizeSum1_double(es->current_bins, es->numBins);
-	}
+	histGray_opencv(image, zone->rect, es);
 }
 static void *ext_extract_histg(IplImage *image, void *state) {
 	struct State_HistGray *es = state;
 	MY_SETZERO(es->bins, es->descriptorLength, double);
-	processZoning(image, es->zoning, histGray_processZone, es);
+	if (es->useOpenCV) {
+		processZoning(image, es->zoning, histGray_processZone, es);
+	} else {
+		//all the zones from one pass over the pixels
+		zoningHistograms_compute(es->zoneHists, image);
+		for (int64_t i = 0; i < es->zoning->numZones; ++i) {
+			es->current_bins = es->bins + i * es->numBins;
+			zoningHistograms_addZone(es->zoneHists, i, es->current_bins);
+			if (es->normalize)
+				my_math_normalizeSum1_double(es->current_bins, es->numBins);
+		}
+	}
 	quantize(es->quant, es->bins, es->descriptor, es->descriptorLength);
 	return es->descriptor;
 }
@@ -108,7 +114,8 @@ static void ext_release_histg(void *estado) {
 	releaseZoning(es->zoning);
 	if (es->useOpenCV)
 		cvReleaseHist(&es->cv_hist);
-	MY_FREE_MULTI(es->val2bin, es->bins, es->descriptor, es);
+	releaseZoningHistograms(es->zoneHists);
+	MY_FREE_MULTI(es->val2bin, es->bin_lut, es->bins, es->descriptor, es);
 }
 void ext_reg_histGray() {
 	addExtractorGlobalDef(false, "HISTGRAY",
@@ -71,7 +71,7 @@ static void new_local(const char *code, const char *parameters,
 	my_tokenizer_releaseValidateEnd(tk);
 	if (es->is_mk)
 		es->filenameImg = my_io_temp_createNewFile(".png");
-	else if (es->is_bay || es->is_lowe)
+	else if (es->is_bay)
 		es->filenameImg = my_io_temp_createNewFile(".pgm");
 	es->descriptor = my_localDescriptors_new(0, MY_DATATYPE_INT8, 0);
 	*out_state = es;
@@ -87,9 +87,8 @@ static void* extract_local(IplImage *image, void *state) {
 	IplImage *imgResized = my_imageResizer_resizeImage(image, es->resizer);
 	if (es->is_bay) {
 		my_image_pgm_saveBuffer(es->filenameImg, imgResized, &es->save_buffer);
-		my_local_bay_extract(imgResized, es->descriptor);
+		my_local_bay_extract_filenamePgm(es->filenameImg, es->descriptor);
 	} else if (es->is_lowe) {
-		my_image_pgm_saveBuffer(es->filenameImg, imgResized, &es->save_buffer);
 		my_local_lowe_extract(imgResized, es->descriptor);
 	} else if (es->is_mk) {
 		cvSaveImage(es->filenameImg, imgResized, NULL);
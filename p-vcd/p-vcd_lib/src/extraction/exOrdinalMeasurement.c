@@ -20,6 +20,7 @@ struct State_OMD {
 	int64_t lastW, lastH, *limitsW, *limitsH;
 	struct ZoneValue *zones;
 	uchar *positions;
+	struct IntegralImage *integral;
 };
 
 static void ext_config_omd(const char *code, const char *parameters,
@@ -34,6 +35,7 @@ static void ext_config_omd(const char *code, const char *parameters,
 	my_assert_lessEqualInt("zones", es->totalNumZones, 256);
 	es->positions = MY_MALLOC_NOINIT(es->totalNumZones, uchar);
 	es->zones = MY_MALLOC_NOINIT(es->totalNumZones, struct ZoneValue);
+	es->integral = newIntegralImage(false);
 	*out_state = es;
 	*out_td = descriptorType(DTYPE_ARRAY_UCHAR, es->totalNumZones,
 			es->numZonesW * es->numZonesH, 1);
@@ -62,6 +64,7 @@ static void *ext_extract_omd(IplImage *image, void *state) {
 		es->lastW = image->width;
 		es->lastH = image->height;
 	}
+	integralImage_compute(es->integral, image);
 	int64_t i, j, pos = 0;
 	for (j = 0; j < es->numZonesH; ++j) {
 		int64_t startH = (j == 0) ? 0 : es->limitsH[j - 1];
@@ -69,7 +72,8 @@ static void *ext_extract_omd(IplImage *image, void *state) {
 		for (i = 0; i < es->numZonesW; ++i) {
 			int64_t startW = (i == 0) ? 0 : es->limitsW[i - 1];
 			int64_t endW = es->limitsW[i];
-			double val = averageIntensity(image, startW, startH, endW, endH);
+			double val = integralImage_average(es->integral, startW, startH,
+					endW, endH);
 			//the value is rounded in order to reduce the impact of near-invisible artifacts
 			val = my_math_round_uint8(val / 4);
 			es->zones[pos].averageGray = val;
@@ -85,6 +89,7 @@ static void *ext_extract_omd(IplImage *image, void *state) {
 }
 static void ext_release_omd(void *state) {
 	struct State_OMD *es = state;
+	releaseIntegralImage(es->integral);
 	MY_FREE_MULTI(es->limitsW, es->limitsH, es->zones, es->positions, es);
 }
 void ext_reg_omd() {
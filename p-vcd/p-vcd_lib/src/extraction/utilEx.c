@@ -235,6 +235,90 @@ double averageIntensity(IplImage *imgGray, int64_t startW, int64_t startH,
 	return average;
 }
 
+struct IntegralImage {
+	bool withSquares;
+	int64_t width, height, capacity;
+	//(width+1)*(height+1) values, the first row and column are zeros
+	int64_t *sums, *squared_sums;
+};
+struct IntegralImage *newIntegralImage(bool withSquares) {
+	struct IntegralImage *ii = MY_MALLOC(1, struct IntegralImage);
+	ii->withSquares = withSquares;
+	return ii;
+}
+void integralImage_compute(struct IntegralImage *ii, IplImage *imgGray) {
+	my_assert_equalInt("depth", imgGray->depth, IPL_DEPTH_8U);
+	my_assert_equalInt("nChannels", imgGray->nChannels, 1);
+	int64_t stride = imgGray->width + 1;
+	int64_t size = stride * (imgGray->height + 1);
+	if (size > ii->capacity) {
+		MY_REALLOC(ii->sums, size, int64_t);
+		if (ii->withSquares)
+			MY_REALLOC(ii->squared_sums, size, int64_t);
+		ii->capacity = size;
+	}
+	ii->width = imgGray->width;
+	ii->height = imgGray->height;
+	MY_SETZERO(ii->sums, stride, int64_t);
+	if (ii->withSquares)
+		MY_SETZERO(ii->squared_sums, stride, int64_t);
+	for (int64_t y = 0; y < ii->height; ++y) {
+		uchar *ptr = (uchar*) (imgGray->imageData + imgGray->widthStep * y);
+		int64_t *prev = ii->sums + y * stride, *row = prev + stride;
+		int64_t sum = 0;
+		row[0] = 0;
+		for (int64_t x = 0; x < ii->width; ++x) {
+			sum += ptr[x];
+			row[x + 1] = prev[x + 1] + sum;
+		}
+		if (ii->withSquares) {
+			prev = ii->squared_sums + y * stride;
+			row = prev + stride;
+			sum = 0;
+			row[0] = 0;
+			for (int64_t x = 0; x < ii->width; ++x) {
+				sum += ptr[x] * ptr[x];
+				row[x + 1] = prev[x + 1] + sum;
+			}
+		}
+	}
+}
+static int64_t integralImage_sum(int64_t *table, int64_t stride,
+		int64_t startW, int64_t startH, int64_t endW, int64_t endH) {
+	return table[endH * stride + endW] - table[startH * stride + endW]
+			- table[endH * stride + startW] + table[startH * stride + startW];
+}
+double integralImage_average(struct IntegralImage *ii, int64_t startW,
+		int64_t startH, int64_t endWNotIncluded, int64_t endHNotIncluded) {
+	my_assert_lessEqualInt("endW", endWNotIncluded, ii->width);
+	my_assert_lessEqualInt("endH", endHNotIncluded, ii->height);
+	int64_t count = (endWNotIncluded - startW) * (endHNotIncluded - startH);
+	if (count <= 0)
+		return 0;
+	return integralImage_sum(ii->sums, ii->width + 1, startW, startH,
+			endWNotIncluded, endHNotIncluded) / (double) count;
+}
+double integralImage_variance(struct IntegralImage *ii, int64_t startW,
+		int64_t startH, int64_t endWNotIncluded, int64_t endHNotIncluded) {
+	if (!ii->withSquares)
+		my_log_error("integral image without squared sums\n");
+	my_assert_lessEqualInt("endW", endWNotIncluded, ii->width);
+	my_assert_lessEqualInt("endH", endHNotIncluded, ii->height);
+	int64_t count = (endWNotIncluded - startW) * (endHNotIncluded - startH);
+	if (count <= 0)
+		return 0;
+	double avg = integralImage_sum(ii->sums, ii->width + 1, startW, startH,
+			endWNotIncluded, endHNotIncluded) / (double) count;
+	double avg2 = integralImage_sum(ii->squared_sums, ii->width + 1, startW,
+			startH, endWNotIncluded, endHNotIncluded) / (double) count;
+	return MAX(0, avg2 - avg * avg);
+}
+void releaseIntegralImage(struct IntegralImage *ii) {
+	if (ii == NULL)
+		return;
+	MY_FREE_MULTI(ii->sums, ii->squared_sums, ii);
+}
+
 // ------> width
 // d00 d01
 // d10 d11
@@ -250,12 +334,18 @@ double *newKernel(double d00, double d01, double d10, double d11) {
 struct Zoning *parseZoning(const char *paramsZoning) {
 	MyTokenizer *tk = my_tokenizer_new(paramsZoning, '+');
 	MyVectorObj *zone_list = my_vectorObj_new();
+	struct Zoning *zoning = MY_MALLOC(1, struct Zoning);
 	while (my_tokenizer_hasNext(tk)) {
 		const char *param = my_tokenizer_nextToken(tk);
 		MyTokenizer *tk2 = my_tokenizer_new(param, 'x');
 		int64_t zw = my_tokenizer_nextInt(tk2);
 		int64_t zh = my_tokenizer_nextInt(tk2);
 		my_tokenizer_releaseValidateEnd(tk2);
+		MY_REALLOC(zoning->grids, zoning->numGrids + 1, struct ZoningGrid);
+		struct ZoningGrid *grid = &zoning->grids[zoning->numGrids++];
+		grid->numW = zw;
+		grid->numH = zh;
+		grid->firstZone = my_vectorObj_size(zone_list);
 		int64_t i, j;
 		for (i = 0; i < zh; ++i) {
 			for (j = 0; j < zw; ++j) {
@@ -270,34 +360,253 @@ struct Zoning *parseZoning(const char *paramsZoning) {
 		}
 	}
 	my_tokenizer_releaseValidateEnd(tk);
-	struct Zoning *zoning = MY_MALLOC(1, struct Zoning);
 	zoning->numZones = my_vectorObj_size(zone_list);
 	zoning->zones = (struct Zone **) my_vectorObj_array(zone_list);
 	MY_FREE(zone_list);
 	return zoning;
 }
+static void updateZoningSize(IplImage *image, struct Zoning *zoning) {
+	if (zoning->currentW == image->width && zoning->currentH == image->height)
+		return;
+	zoning->currentW = image->width;
+	zoning->currentH = image->height;
+	for (int64_t i = 0; i < zoning->numZones; ++i) {
+		struct Zone *z = zoning->zones[i];
+		z->pix_start_w = (int64_t) (z->prop_start_w * zoning->currentW);
+		z->pix_end_w = (int64_t) (z->prop_end_w * zoning->currentW);
+		z->pix_start_h = (int64_t) (z->prop_start_h * zoning->currentH);
+		z->pix_end_h = (int64_t) (z->prop_end_h * zoning->currentH);
+		z->rect = cvRect(z->pix_start_w, z->pix_start_h,
+				z->pix_end_w - z->pix_start_w, z->pix_end_h - z->pix_start_h);
+	}
+}
 void processZoning(IplImage *image, struct Zoning *zoning,
 		void (*func_processZone)(IplImage *image, struct Zone *zone,
 				void *state), void *state) {
-	if (zoning->currentW != image->width || zoning->currentH != image->height) {
-		zoning->currentW = image->width;
-		zoning->currentH = image->height;
-		for (int64_t i = 0; i < zoning->numZones; ++i) {
-			struct Zone *z = zoning->zones[i];
-			z->pix_start_w = (int64_t) (z->prop_start_w * zoning->currentW);
-			z->pix_end_w = (int64_t) (z->prop_end_w * zoning->currentW);
-			z->pix_start_h = (int64_t) (z->prop_start_h * zoning->currentH);
-			z->pix_end_h = (int64_t) (z->prop_end_h * zoning->currentH);
-			z->rect = cvRect(z->pix_start_w, z->pix_start_h,
-					z->pix_end_w - z->pix_start_w,
-					z->pix_end_h - z->pix_start_h);
-		}
-	}
+	updateZoningSize(image, zoning);
 	for (int64_t i = 0; i < zoning->numZones; ++i) {
 		struct Zone *z = zoning->zones[i];
 		func_processZone(image, z, state);
 	}
 }
+//the zone boundaries are truncated to pixels, thus the guessed cell is
+//corrected by comparing to its boundaries
+static int64_t locateCell(double pos, int64_t numCells, int64_t size,
+		struct Zone **zones, int64_t stride, bool horizontal) {
+	int64_t cell = (int64_t) (pos * numCells / size);
+	cell = MIN(MAX(cell, 0), numCells - 1);
+	for (;;) {
+		struct Zone *z = zones[cell * stride];
+		int64_t start = horizontal ? z->pix_start_w : z->pix_start_h;
+		int64_t end = horizontal ? z->pix_end_w : z->pix_end_h;
+		if (pos < start && cell > 0)
+			cell--;
+		else if (pos >= end && cell < numCells - 1)
+			cell++;
+		else if (start <= pos && pos < end)
+			return cell;
+		else
+			return -1;
+	}
+}
+int64_t locateZones(IplImage *image, struct Zoning *zoning, double x, double y,
+		int64_t *out_zones) {
+	updateZoningSize(image, zoning);
+	int64_t num = 0;
+	for (int64_t i = 0; i < zoning->numGrids; ++i) {
+		struct ZoningGrid *g = &zoning->grids[i];
+		struct Zone **zones = zoning->zones + g->firstZone;
+		int64_t col = locateCell(x, g->numW, zoning->currentW, zones, 1, true);
+		if (col < 0)
+			continue;
+		int64_t row = locateCell(y, g->numH, zoning->currentH, zones + col,
+				g->numW, false);
+		if (row < 0)
+			continue;
+		out_zones[num++] = g->firstZone + row * g->numW + col;
+	}
+	return num;
+}
+struct ZoningHistograms {
+	struct Zoning *zoning;
+	int64_t numChannels, totalBins;
+	int32_t **bin_luts;
+	void (*func_binRow)(const uchar *pixels, int64_t width, int32_t *out_bins,
+			void *state);
+	void *binRow_state;
+	int32_t *row_bins;
+	//lattice for the current image size
+	int64_t currentW, currentH, cellsW, cellsH;
+	int64_t *boundsW, *boundsH, *cellOfX, *cellOfY;
+	//for each zone: first and last boundary in each axis
+	int64_t *zoneBounds;
+	//counts per cell for even and odd columns (consecutive pixels usually fall
+	//in the same bin, two copies avoid chaining the increments), and integral
+	//of counts with (cellsW+1)*(cellsH+1) entries
+	int32_t *counts_even, *counts_odd, *integral;
+};
+struct ZoningHistograms *newZoningHistograms(struct Zoning *zoning,
+		int64_t numChannels, int64_t totalBins, int32_t **bin_luts) {
+	struct ZoningHistograms *zh = MY_MALLOC(1, struct ZoningHistograms);
+	zh->zoning = zoning;
+	zh->numChannels = numChannels;
+	zh->totalBins = totalBins;
+	zh->bin_luts = bin_luts;
+	zh->zoneBounds = MY_MALLOC(4 * zoning->numZones, int64_t);
+	return zh;
+}
+void zoningHistograms_setBinRow(struct ZoningHistograms *zh,
+		void (*func_binRow)(const uchar *pixels, int64_t width,
+				int32_t *out_bins, void *state), void *state) {
+	zh->func_binRow = func_binRow;
+	zh->binRow_state = state;
+}
+static int64_t zoningHistograms_bounds(int64_t numZones, struct Zone **zones,
+		bool horizontal, int64_t size, int64_t *bounds) {
+	int64_t num = 0;
+	bounds[num++] = 0;
+	bounds[num++] = size;
+	for (int64_t i = 0; i < numZones; ++i) {
+		struct Zone *z = zones[i];
+		bounds[num++] = horizontal ? z->pix_start_w : z->pix_start_h;
+		bounds[num++] = horizontal ? z->pix_end_w : z->pix_end_h;
+	}
+	my_qsort_int_array(bounds, num);
+	int64_t unique = 1;
+	for (int64_t i = 1; i < num; ++i) {
+		if (bounds[i] != bounds[unique - 1])
+			bounds[unique++] = bounds[i];
+	}
+	return unique;
+}
+static void zoningHistograms_cellOf(int64_t *bounds, int64_t numBounds,
+		int64_t size, int64_t *cellOf) {
+	int64_t cell = 0;
+	for (int64_t x = 0; x < size; ++x) {
+		while (cell + 1 < numBounds - 1 && x >= bounds[cell + 1])
+			cell++;
+		cellOf[x] = cell;
+	}
+}
+static int64_t zoningHistograms_findBound(int64_t *bounds, int64_t numBounds,
+		int64_t value) {
+	int64_t pos = 0;
+	if (!my_binsearch_intArr(value, bounds, numBounds, &pos))
+		my_log_error("zone boundary %"PRIi64" not found\n", value);
+	return pos;
+}
+static void zoningHistograms_updateSize(struct ZoningHistograms *zh,
+		IplImage *image) {
+	if (zh->currentW == image->width && zh->currentH == image->height)
+		return;
+	struct Zoning *zoning = zh->zoning;
+	int64_t numBounds = 2 * zoning->numZones + 2;
+	updateZoningSize(image, zoning);
+	MY_REALLOC(zh->boundsW, numBounds, int64_t);
+	MY_REALLOC(zh->boundsH, numBounds, int64_t);
+	int64_t numW = zoningHistograms_bounds(zoning->numZones, zoning->zones,
+			true, image->width, zh->boundsW);
+	int64_t numH = zoningHistograms_bounds(zoning->numZones, zoning->zones,
+			false, image->height, zh->boundsH);
+	zh->cellsW = numW - 1;
+	zh->cellsH = numH - 1;
+	MY_REALLOC(zh->cellOfX, image->width, int64_t);
+	MY_REALLOC(zh->cellOfY, image->height, int64_t);
+	zoningHistograms_cellOf(zh->boundsW, numW, image->width, zh->cellOfX);
+	zoningHistograms_cellOf(zh->boundsH, numH, image->height, zh->cellOfY);
+	for (int64_t i = 0; i < zoning->numZones; ++i) {
+		struct Zone *z = zoning->zones[i];
+		int64_t *zb = zh->zoneBounds + 4 * i;
+		zb[0] = zoningHistograms_findBound(zh->boundsW, numW, z->pix_start_w);
+		zb[1] = zoningHistograms_findBound(zh->boundsW, numW, z->pix_end_w);
+		zb[2] = zoningHistograms_findBound(zh->boundsH, numH, z->pix_start_h);
+		zb[3] = zoningHistograms_findBound(zh->boundsH, numH, z->pix_end_h);
+	}
+	MY_REALLOC(zh->counts_even, zh->cellsW * zh->cellsH * zh->totalBins,
+			int32_t);
+	MY_REALLOC(zh->counts_odd, zh->cellsW * zh->cellsH * zh->totalBins,
+			int32_t);
+	MY_REALLOC(zh->row_bins, image->width * zh->numChannels, int32_t);
+	MY_REALLOC(zh->integral,
+			(zh->cellsW + 1) * (zh->cellsH + 1) * zh->totalBins, int32_t);
+	zh->currentW = image->width;
+	zh->currentH = image->height;
+}
+static void zoningHistograms_lutRow(struct ZoningHistograms *zh,
+		const uchar *pixels, int64_t width) {
+	int64_t nch = zh->numChannels;
+	int32_t *restrict out = zh->row_bins;
+	for (int64_t nc = 0; nc < nch; ++nc) {
+		const int32_t *restrict lut = zh->bin_luts[nc];
+		for (int64_t x = 0; x < width; ++x)
+			out[x * nch + nc] = lut[pixels[x * nch + nc]];
+	}
+}
+void zoningHistograms_compute(struct ZoningHistograms *zh, IplImage *image) {
+	my_assert_equalInt("depth", image->depth, IPL_DEPTH_8U);
+	my_assert_equalInt("nChannels", image->nChannels, zh->numChannels);
+	zoningHistograms_updateSize(zh, image);
+	int64_t nb = zh->totalBins, nch = zh->numChannels;
+	MY_SETZERO(zh->counts_even, zh->cellsW * zh->cellsH * nb, int32_t);
+	MY_SETZERO(zh->counts_odd, zh->cellsW * zh->cellsH * nb, int32_t);
+	for (int64_t y = 0; y < image->height; ++y) {
+		uchar *ptr = (uchar*) (image->imageData + image->widthStep * y);
+		if (zh->func_binRow != NULL)
+			zh->func_binRow(ptr, image->width, zh->row_bins, zh->binRow_state);
+		else
+			zoningHistograms_lutRow(zh, ptr, image->width);
+		int64_t offset = zh->cellOfY[y] * zh->cellsW * nb;
+		int32_t *even = zh->counts_even + offset, *odd = zh->counts_odd + offset;
+		int32_t *bins = zh->row_bins;
+		int64_t x = 0;
+		for (; x + 1 < image->width; x += 2) {
+			int32_t *cell_e = even + zh->cellOfX[x] * nb;
+			int32_t *cell_o = odd + zh->cellOfX[x + 1] * nb;
+			for (int64_t nc = 0; nc < nch; ++nc) {
+				cell_e[bins[x * nch + nc]]++;
+				cell_o[bins[(x + 1) * nch + nc]]++;
+			}
+		}
+		if (x < image->width) {
+			int32_t *cell_e = even + zh->cellOfX[x] * nb;
+			for (int64_t nc = 0; nc < nch; ++nc)
+				cell_e[bins[x * nch + nc]]++;
+		}
+	}
+	//integral over the lattice
+	int64_t stride = (zh->cellsW + 1) * nb;
+	MY_SETZERO(zh->integral, stride, int32_t);
+	for (int64_t j = 0; j < zh->cellsH; ++j) {
+		int32_t *prev = zh->integral + j * stride, *row = prev + stride;
+		int32_t *even = zh->counts_even + j * zh->cellsW * nb;
+		int32_t *odd = zh->counts_odd + j * zh->cellsW * nb;
+		MY_SETZERO(row, nb, int32_t);
+		for (int64_t i = 0; i < zh->cellsW; ++i) {
+			int32_t *dst = row + (i + 1) * nb;
+			for (int64_t b = 0; b < nb; ++b)
+				dst[b] = dst[b - nb] + prev[(i + 1) * nb + b]
+						- prev[i * nb + b] + even[i * nb + b] + odd[i * nb + b];
+		}
+	}
+}
+void zoningHistograms_addZone(struct ZoningHistograms *zh, int64_t numZone,
+		double *bins) {
+	int64_t *zb = zh->zoneBounds + 4 * numZone;
+	int64_t nb = zh->totalBins, stride = (zh->cellsW + 1) * nb;
+	int32_t *i00 = zh->integral + zb[2] * stride + zb[0] * nb;
+	int32_t *i01 = zh->integral + zb[2] * stride + zb[1] * nb;
+	int32_t *i10 = zh->integral + zb[3] * stride + zb[0] * nb;
+	int32_t *i11 = zh->integral + zb[3] * stride + zb[1] * nb;
+	for (int64_t b = 0; b < nb; ++b)
+		bins[b] += i11[b] - i01[b] - i10[b] + i00[b];
+}
+void releaseZoningHistograms(struct ZoningHistograms *zh) {
+	if (zh == NULL)
+		return;
+	MY_FREE_MULTI(zh->boundsW, zh->boundsH, zh->cellOfX, zh->cellOfY,
+			zh->zoneBounds, zh->row_bins, zh->counts_even, zh->counts_odd,
+			zh->integral, zh);
+}
 void releaseZoning(struct Zoning *zoning) {
 	if (zoning == NULL)
 		return;
@@ -305,7 +614,7 @@ void releaseZoning(struct Zoning *zoning) {
 		struct Zone *z = zoning->zones[i];
 		free(z);
 	}
-	free(zoning);
+	MY_FREE_MULTI(zoning->grids, zoning);
 }
 void applyPcaToLocalDescriptors(MknnPcaAlgorithm *pca,
 		MyLocalDescriptors *src_descriptor, MyLocalDescriptors *dst_descriptor) {
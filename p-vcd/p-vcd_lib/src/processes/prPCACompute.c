@@ -28,6 +28,7 @@ static void computePca_new(const char *segCode, const char *segParameters,
 static void computePca_process(LoadDescriptors *desloader, void *state) {
 	struct State_ComputePca *es = state;
 	MknnPcaAlgorithm *pca = mknn_pca_new();
+	mknn_pca_setMaxThreads(pca, NUM_CORES);
 	DB *db = loadDescriptors_getDb(desloader);
 	for (int64_t i = 0; i < db->numFilesDb; ++i) {
 		struct DescriptorsFile *df = loadDescriptorsFileDB(desloader,
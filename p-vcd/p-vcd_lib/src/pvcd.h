@@ -75,6 +75,8 @@ typedef struct DB {
 	struct FileDB **filesDb;
 	struct FileDB **filesDb_sortId;
 	struct FileDB **filesDb_sortFilenameReal;
+	//not NULL when files were loaded from the binary catalog
+	struct DBCatalog *catalog;
 } DB;
 
 typedef struct VideoFrame VideoFrame;
@@ -84,7 +86,9 @@ extern int64_t NUM_CORES;
 
 #include "util/systemCall.h"
 #include "util/dbs.h"
+#include "util/dbCatalog.h"
 #include "util/videos.h"
+#include "util/preprocessCache.h"
 #include "util/utils.h"
 #include "util/audio.h"
 
@@ -163,8 +163,11 @@ static void search_queriesByFile(struct SearchKnnOptions *options) {
 	FILE *out = NULL;
 	for (i = 0; i < colQuery->numFiles; ++i) {
 		struct SearchFile *sfileQ = colQuery->sfiles[i];
-		if (options->load_descriptors_by_query)
+		if (options->load_descriptors_by_query) {
 			loadDescriptorsInSearchFile(sfileQ);
+			if (i + 1 < colQuery->numFiles)
+				prefetchDescriptorsInSearchFile(colQuery->sfiles[i + 1]);
+		}
 		MknnDataset *query_dataset = get_dataset_global_descriptors(colQuery,
 				sfileQ->ssegments, sfileQ->numSegments);
 		MknnResult *result = mknn_resolver_search(options->resolver, false,
@@ -265,8 +268,11 @@ static void search_byLocalVectors(struct SearchKnnOptions *options) {
 	FILE *out = NULL;
 	for (int64_t a = 0; a < colQuery->numFiles; ++a) {
 		struct SearchFile *sfileQ = colQuery->sfiles[a];
-		if (options->load_descriptors_by_query)
+		if (options->load_descriptors_by_query) {
 			loadDescriptorsInSearchFile(sfileQ);
+			if (a + 1 < colQuery->numFiles)
+				prefetchDescriptorsInSearchFile(colQuery->sfiles[a + 1]);
+		}
 		for (int64_t b = 0; b < sfileQ->numSegments; ++b) {
 			struct SearchSegment *ssegQ = sfileQ->ssegments[b];
 			MknnDataset *query_dataset = get_dataset_local_descriptors(colQuery,
@@ -61,6 +61,8 @@ void loadDescriptorsInCollection(struct SearchCollection *col);
 void unloadDescriptorsInCollection(struct SearchCollection *col);
 void loadDescriptorsInSearchFile(struct SearchFile *sfile);
 void unloadDescriptorsInSearchFile(struct SearchFile *sfile);
+//the descriptors of sfile will be loaded soon (reads them in background)
+void prefetchDescriptorsInSearchFile(struct SearchFile *sfile);
 
 void reorderSearchFiles(struct SearchCollection* col, char *criterion);
 void reorderSearchObjects(struct SearchCollection* col, char *criterion);
@@ -118,6 +120,10 @@ MknnDataset *profile_get_reference_globalDescriptors(
 MknnDataset *profile_get_query_globalDescriptors(struct SearchProfile *profile);
 
 MknnDistance *profile_get_mdistance(struct SearchProfile *profile);
+bool profile_is_sparseCosine_mdistance(MknnDistance *distance);
+
+//index_SparseInverted.c
+void pvcd_register_default_indexes();
 
 //////////////
 struct D_Match {
@@ -194,6 +200,8 @@ struct QueryTxt {
 	char **name_query;
 	//list of struct NNTxt* (column-2,3,...)
 	MyVectorObj **nns;
+	//owns the query, names, lists and NNs
+	MyArena *arena;
 };
 MyVectorObj *loadSsFileTxt(const char *filename, int64_t maxNNLoad,
 		double maxDistLoad);
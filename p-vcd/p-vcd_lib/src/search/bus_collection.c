@@ -296,6 +296,14 @@ void loadDescriptorsInSearchFile(struct SearchFile *sfile) {
 	my_log_info("loaded descriptors in %s: %s%s\n", sfile->name, sb, msg);
 	MY_FREE_MULTI(msg, sb);
 }
+void prefetchDescriptorsInSearchFile(struct SearchFile *sfile) {
+	struct InternalData *id = sfile->col->internalData;
+	struct SearchDB *sdb = id->sdb_by_sfile[sfile->id_seq];
+	for (int64_t j = 0; j < my_vectorObj_size(sdb->loaders); ++j) {
+		LoadDescriptors *loader = my_vectorObj_get(sdb->loaders, j);
+		loadDescriptors_prefetchFiles(loader, 1, &sfile->fdb);
+	}
+}
 void unloadDescriptorsInSearchFile(struct SearchFile *sfile) {
 	struct SearchCollection *col = sfile->col;
 	struct InternalData *id = col->internalData;
@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of P-VCD. http://p-vcd.org/
+ * P-VCD is made available under the terms of the BSD 2-Clause License.
+ */
+
+#include "bus.h"
+#include <metricknn/metricknn_c/metricknn_impl.h>
+
+//Inverted file for sparse arrays (text, bag of words). The score is the dot
+//product computed term-at-a-time, and the returned distance is the same than
+//SparseCosine: sqrt(2*|1-score|).
+//The pruning keeps the objects with highest scores, which are the nearest
+//only when the score is not greater than 1. It is enabled only when the
+//weights are non-negative and the L2 norms of the indexed objects and the
+//query are not greater than 1 (e.g. L2-normalized arrays or idf=true).
+struct SparseInverted_Index {
+	MknnDataset *search_dataset;
+	int64_t num_objects, num_dims;
+	//posting list of dimension d: positions [posting_start[d], posting_start[d+1])
+	int64_t *posting_start;
+	int32_t *posting_objects;
+	float *posting_weights;
+	//maximum weight of each posting list (upper bound of its contribution)
+	float *max_weights;
+	//NULL when weights are used as they are
+	float *idf;
+	bool all_nonnegative;
+	//maximum L2 norm of the indexed objects (after idf weighting)
+	double max_norm;
+};
+
+static float *loadIdfFile(const char *filename, int64_t *out_num_dims) {
+	MyLineReader *reader = my_lreader_config_open(
+			my_io_openFileRead1(filename, true), "PVCD", "IDF", 1, 0);
+	MyTokenizer *tk = my_tokenizer_new(my_lreader_readLine(reader), '\t');
+	int64_t num_dims = my_tokenizer_nextInt(tk);
+	int64_t cont_total = my_tokenizer_nextInt(tk);
+	my_tokenizer_releaseValidateEnd(tk);
+	float *idf = MY_MALLOC(num_dims, float);
+	for (int64_t i = 0; i < num_dims; ++i) {
+		const char *line = my_lreader_readLine(reader);
+		my_assert_notNull("line", line);
+		int64_t df = my_parse_int(line);
+		if (df > 0)
+			idf[i] = log(cont_total / (double) df);
+	}
+	my_lreader_close(reader, true);
+	*out_num_dims = num_dims;
+	return idf;
+}
+//tolerance for rounding errors when testing the norms
+#define MAX_NORM_PRUNING 1.0001
+//idf-weighted arrays are normalized to keep the score a cosine
+static double getNormIdf(MySparseArray *sparse, float *idf, int64_t num_dims) {
+	double sum = 0;
+	for (int32_t i = 0; i < my_sparseArray_getNumSlots(sparse); ++i) {
+		int32_t id;
+		float weight;
+		my_sparseArray_getSlot(sparse, i, &id, &weight);
+		if (id < num_dims) {
+			double w = weight * idf[id];
+			sum += w * w;
+		}
+	}
+	return (sum > 0) ? 1 / sqrt(sum) : 0;
+}
+static void sparseInverted_index_build(void *state_index, const char *id_index,
+		MknnIndexParams *params_index) {
+	struct SparseInverted_Index *state = state_index;
+	const char *idf_file = mknn_indexParams_getString(params_index,
+			"idf_file");
+	bool use_idf = mknn_indexParams_getBool(params_index, "idf");
+	int64_t num_objects = state->num_objects;
+	//document frequencies
+	int64_t num_dims = 0, df_size = 0;
+	int64_t *df = NULL;
+	for (int64_t i = 0; i < num_objects; ++i) {
+		MySparseArray *sparse = mknn_dataset_getObject(state->search_dataset,
+				i);
+		for (int32_t j = 0; j < my_sparseArray_getNumSlots(sparse); ++j) {
+			int32_t id;
+			float weight;
+			my_sparseArray_getSlot(sparse, j, &id, &weight);
+			if (id >= df_size) {
+				int64_t new_size = MAX(id + 1, 2 * df_size);
+				MY_REALLOC(df, new_size, int64_t);
+				MY_SETZERO(df + df_size, new_size - df_size, int64_t);
+				df_size = new_size;
+			}
+			num_dims = MAX(num_dims, id + 1);
+			df[id]++;
+			if (weight < 0)
+				state->all_nonnegative = false;
+		}
+	}
+	if (idf_file != NULL) {
+		int64_t idf_dims = 0;
+		state->idf = loadIdfFile(idf_file, &idf_dims);
+		if (idf_dims < num_dims)
+			my_log_error(
+					"idf file %s has %"PRIi64" dimensions, required %"PRIi64"\n",
+					idf_file, idf_dims, num_dims);
+	} else if (use_idf) {
+		state->idf = MY_MALLOC(MAX(1, num_dims), float);
+		for (int64_t d = 0; d < num_dims; ++d) {
+			if (df[d] > 0)
+				state->idf[d] = log(num_objects / (double) df[d]);
+		}
+	}
+	state->num_dims = num_dims;
+	state->posting_start = MY_MALLOC(num_dims + 1, int64_t);
+	for (int64_t d = 0; d < num_dims; ++d)
+		state->posting_start[d + 1] = state->posting_start[d] + df[d];
+	int64_t total_postings = state->posting_start[num_dims];
+	state->posting_objects = MY_MALLOC_NOINIT(MAX(1, total_postings),
+			int32_t);
+	state->posting_weights = MY_MALLOC_NOINIT(MAX(1, total_postings),
+			float);
+	state->max_weights = MY_MALLOC(MAX(1, num_dims), float);
+	//fill the posting lists, df is reused as the filling position
+	MY_SETZERO(df, num_dims, int64_t);
+	for (int64_t i = 0; i < num_objects; ++i) {
+		MySparseArray *sparse = mknn_dataset_getObject(state->search_dataset,
+				i);
+		double norm =
+				(state->idf == NULL) ?
+						1 : getNormIdf(sparse, state->idf, num_dims);
+		double sum_squares = 0;
+		for (int32_t j = 0; j < my_sparseArray_getNumSlots(sparse); ++j) {
+			int32_t id;
+			float weight;
+			my_sparseArray_getSlot(sparse, j, &id, &weight);
+			if (state->idf != NULL)
+				weight *= state->idf[id] * norm;
+			sum_squares += weight * (double) weight;
+			int64_t pos = state->posting_start[id] + df[id];
+			state->posting_objects[pos] = i;
+			state->posting_weights[pos] = weight;
+			state->max_weights[id] = MAX(state->max_weights[id],
+					fabsf(weight));
+			df[id]++;
+		}
+		state->max_norm = MAX(state->max_norm, sqrt(sum_squares));
+	}
+	MY_FREE(df);
+	char *st = my_newString_int(total_postings);
+	my_log_info(
+			"inverted index: %"PRIi64" objects, %"PRIi64" dimensions, %s postings\n",
+			num_objects, num_dims, st);
+	free(st);
+	if (!state->all_nonnegative || state->max_norm > MAX_NORM_PRUNING)
+		my_log_info(
+				"inverted index: objects are not L2-normalized and non-negative (max norm=%1.3lf), pruning is disabled\n",
+				state->max_norm);
+}
+static void sparseInverted_index_release(void *state_index) {
+	struct SparseInverted_Index *state = state_index;
+	MY_FREE_MULTI(state->posting_start, state->posting_objects,
+			state->posting_weights, state->max_weights, state->idf, state);
+}
+static struct MknnIndexInstance sparseInverted_index_new(const char *id_index,
+		MknnIndexParams *params_index, MknnDataset *search_dataset,
+		MknnDistance *distance) {
+	if (!profile_is_sparseCosine_mdistance(distance))
+		my_log_error("%s only supports the distance SparseCosine\n", id_index);
+	if (mknn_dataset_getNumObjects(search_dataset) > INT32_MAX)
+		my_log_error("too many objects for %s\n", id_index);
+	struct SparseInverted_Index *state = MY_MALLOC(1,
+			struct SparseInverted_Index);
+	state->search_dataset = search_dataset;
+	state->num_objects = mknn_dataset_getNumObjects(search_dataset);
+	state->all_nonnegative = true;
+	struct MknnIndexInstance newIdx = { 0 };
+	newIdx.state_index = state;
+	newIdx.func_index_build = sparseInverted_index_build;
+	newIdx.func_index_load = NULL;
+	newIdx.func_index_save = NULL;
+	newIdx.func_index_release = sparseInverted_index_release;
+	return newIdx;
+}
+/* ******************************************************* */
+struct QueryTerm {
+	int32_t id_dimension;
+	float weight, upper_bound;
+};
+struct SparseInverted_Thread {
+	double *scores;
+	bool *touched;
+	int32_t *touched_list;
+	struct QueryTerm *terms;
+	int64_t terms_size;
+	MknnHeap *heapNNs, *heapScores;
+};
+struct SparseInverted_Search {
+	int64_t knn;
+	double range;
+	int64_t max_threads;
+	bool pruning, with_statistics;
+	struct SparseInverted_Index *state_index;
+	struct SparseInverted_Thread *threads;
+	MknnDataset *query_dataset;
+	MknnResult *result;
+};
+
+static int compare_terms(const void *a, const void *b) {
+	const struct QueryTerm *t1 = a, *t2 = b;
+	return (t1->upper_bound > t2->upper_bound) ? -1 :
+			(t1->upper_bound < t2->upper_bound) ? 1 : 0;
+}
+static int64_t loadQueryTerms(struct SparseInverted_Index *idx,
+		struct SparseInverted_Thread *th, MySparseArray *query,
+		bool *out_nonnegative, double *out_norm) {
+	int64_t num_slots = my_sparseArray_getNumSlots(query);
+	if (num_slots > th->terms_size) {
+		MY_REALLOC(th->terms, num_slots, struct QueryTerm);
+		th->terms_size = num_slots;
+	}
+	double norm =
+			(idx->idf == NULL) ?
+					1 : getNormIdf(query, idx->idf, idx->num_dims);
+	int64_t num_terms = 0;
+	double sum_squares = 0;
+	*out_nonnegative = true;
+	for (int32_t i = 0; i < num_slots; ++i) {
+		int32_t id;
+		float weight;
+		my_sparseArray_getSlot(query, i, &id, &weight);
+		//dimensions not in the index do not add to the score
+		if (id >= idx->num_dims
+				|| idx->posting_start[id] == idx->posting_start[id + 1])
+			continue;
+		if (idx->idf != NULL)
+			weight *= idx->idf[id] * norm;
+		if (weight == 0)
+			continue;
+		if (weight < 0)
+			*out_nonnegative = false;
+		struct QueryTerm *term = th->terms + num_terms;
+		term->id_dimension = id;
+		term->weight = weight;
+		term->upper_bound = fabsf(weight) * idx->max_weights[id];
+		sum_squares += weight * (double) weight;
+		num_terms++;
+	}
+	*out_norm = sqrt(sum_squares);
+	return num_terms;
+}
+//lowest score among the current k highest scores
+static double getCurrentKthScore(struct SparseInverted_Thread *th,
+		int64_t num_touched) {
+	mknn_heap_reset(th->heapScores);
+	double kth_score = -DBL_MAX;
+	for (int64_t i = 0; i < num_touched; ++i) {
+		int32_t id = th->touched_list[i];
+		mknn_heap_storeBestDistances(th->scores[id], id, th->heapScores,
+				&kth_score);
+	}
+	return kth_score;
+}
+static void sparseInverted_resolveOneQuery(struct SparseInverted_Search *state,
+		int64_t query_id, struct SparseInverted_Thread *th) {
+	struct SparseInverted_Index *idx = state->state_index;
+	mknn_result_startQuery(state->result, query_id);
+	MySparseArray *query = mknn_dataset_getObject(state->query_dataset,
+			query_id);
+	bool nonnegative = false;
+	double query_norm = 0;
+	int64_t num_terms = loadQueryTerms(idx, th, query, &nonnegative,
+			&query_norm);
+	//the bound of untouched objects is valid only for non-negative weights,
+	//and the scores follow the distances only when they are not greater than 1
+	bool pruning = state->pruning && nonnegative && idx->all_nonnegative
+			&& query_norm * idx->max_norm <= MAX_NORM_PRUNING;
+	double remaining_bound = 0;
+	if (pruning) {
+		qsort(th->terms, num_terms, sizeof(struct QueryTerm), compare_terms);
+		for (int64_t t = 0; t < num_terms; ++t)
+			remaining_bound += th->terms[t].upper_bound;
+	}
+	//minimum score required by the range
+	double min_score =
+			(state->range == DBL_MAX) ?
+					-DBL_MAX : 1 - state->range * state->range / 2;
+	bool only_touched = false;
+	int64_t num_touched = 0;
+	double max_score = 0;
+	for (int64_t t = 0; t < num_terms; ++t) {
+		struct QueryTerm *term = th->terms + t;
+		//once an untouched object can not reach the k-th score, the remaining
+		//terms only update the objects already touched
+		if (pruning && !only_touched) {
+			double threshold = min_score;
+			//the k-th score is not greater than the maximum score
+			if (num_touched >= state->knn && remaining_bound < max_score)
+				threshold = MAX(threshold,
+						getCurrentKthScore(th, num_touched));
+			if (remaining_bound < threshold)
+				only_touched = true;
+			remaining_bound -= term->upper_bound;
+		}
+		int64_t start = idx->posting_start[term->id_dimension];
+		int64_t end = idx->posting_start[term->id_dimension + 1];
+		for (int64_t p = start; p < end; ++p) {
+			int32_t id = idx->posting_objects[p];
+			if (!th->touched[id]) {
+				if (only_touched)
+					continue;
+				th->touched[id] = true;
+				th->touched_list[num_touched++] = id;
+			}
+			th->scores[id] += term->weight * idx->posting_weights[p];
+			max_score = MAX(max_score, th->scores[id]);
+		}
+	}
+	MknnHeap *heapNNs = th->heapNNs;
+	mknn_heap_reset(heapNNs);
+	double rangeSearch = state->range;
+	for (int64_t i = 0; i < num_touched; ++i) {
+		int32_t id = th->touched_list[i];
+		double score = th->scores[id];
+		double dist = (score == 0) ? M_SQRT2 : sqrt(2 * fabs(1 - score));
+		mknn_heap_storeBestDistances(dist, id, heapNNs, &rangeSearch);
+	}
+	//objects without common dimensions are at sqrt(2), which may be nearer than
+	//touched objects with negative scores (same as a linear scan)
+	for (int64_t id = 0; id < idx->num_objects && M_SQRT2 < rangeSearch;
+			++id) {
+		if (!th->touched[id])
+			mknn_heap_storeBestDistances(M_SQRT2, id, heapNNs, &rangeSearch);
+	}
+	//objects without any common dimension are never scored
+	MknnResultQuery *res = mknn_result_getResultQuery(state->result, query_id);
+	res->num_discarded_candidates = idx->num_objects - num_touched;
+	mknn_result_storeMatchesInResultQuery(state->result, query_id, heapNNs,
+			num_touched);
+	for (int64_t i = 0; i < num_touched; ++i) {
+		int32_t id = th->touched_list[i];
+		th->scores[id] = 0;
+		th->touched[id] = false;
+	}
+}
+static void sparseInverted_resolver_query(int64_t current_process,
+		void *state_object, int64_t current_thread) {
+	struct SparseInverted_Search *state = state_object;
+	sparseInverted_resolveOneQuery(state, current_process,
+			state->threads + current_thread);
+}
+static MknnResult *sparseInverted_resolver_search(void *state_resolver,
+		MknnDataset *query_dataset) {
+	int64_t num_query_objects = mknn_dataset_getNumObjects(query_dataset);
+	struct SparseInverted_Search *state = state_resolver;
+	state->query_dataset = query_dataset;
+	state->result = mknn_result_newEmpty(num_query_objects, state->knn);
+	if (state->with_statistics)
+		mknn_result_enableStatistics(state->result);
+	my_parallel_incremental(num_query_objects, state,
+			sparseInverted_resolver_query, "inverted index", state->max_threads);
+	return state->result;
+}
+static void sparseInverted_resolver_release(void *state_resolver) {
+	struct SparseInverted_Search *state = state_resolver;
+	for (int64_t i = 0; i < state->max_threads; ++i) {
+		struct SparseInverted_Thread *th = state->threads + i;
+		mknn_heap_release(th->heapNNs);
+		mknn_heap_release(th->heapScores);
+		MY_FREE_MULTI(th->scores, th->touched, th->touched_list, th->terms);
+	}
+	MY_FREE_MULTI(state->threads, state);
+}
+static struct MknnResolverInstance sparseInverted_resolver_new(
+		void *state_index, const char *id_index,
+		MknnResolverParams *params_resolver) {
+	struct SparseInverted_Search *state = MY_MALLOC(1,
+			struct SparseInverted_Search);
+	state->state_index = state_index;
+	state->knn = mknn_resolverParams_getKnn(params_resolver);
+	if (state->knn < 1)
+		state->knn = 1;
+	state->range = mknn_resolverParams_getRange(params_resolver);
+	if (state->range == 0)
+		state->range = DBL_MAX;
+	state->max_threads = mknn_resolverParams_getMaxThreads(params_resolver);
+	if (state->max_threads < 1)
+		state->max_threads = my_parallel_getNumberOfCores();
+	state->pruning = mknn_resolverParams_getBool(params_resolver, "pruning");
+	state->with_statistics = mknn_resolverParams_getStatistics(params_resolver);
+	int64_t num_objects = MAX(1, state->state_index->num_objects);
+	state->threads = MY_MALLOC(state->max_threads,
+			struct SparseInverted_Thread);
+	for (int64_t i = 0; i < state->max_threads; ++i) {
+		struct SparseInverted_Thread *th = state->threads + i;
+		th->scores = MY_MALLOC(num_objects, double);
+		th->touched = MY_MALLOC(num_objects, bool);
+		th->touched_list = MY_MALLOC_NOINIT(num_objects, int32_t);
+		th->heapNNs = mknn_heap_newMaxHeap(state->knn);
+		th->heapScores = mknn_heap_newMinHeap(state->knn);
+	}
+	struct MknnResolverInstance newResolver = { 0 };
+	newResolver.state_resolver = state;
+	newResolver.func_resolver_search = sparseInverted_resolver_search;
+	newResolver.func_resolver_release = sparseInverted_resolver_release;
+	return newResolver;
+}
+static void sparseInverted_printHelp(const char *id_index) {
+	my_log_info(
+			"Objects must be sparse arrays. Distance is sqrt(2*|1-cos|) as SparseCosine.\n");
+	my_log_info(
+			"    idf=true computes idf weights from the indexed objects, idf_file reads the output of the IDF process.\n");
+	my_log_info(
+			"    pruning=true stops adding new objects once they can't reach the k-th score (useful for long queries with skewed weights).\n");
+	my_log_info(
+			"       It is applied only to non-negative arrays with L2 norm not greater than 1 (e.g. normalized or idf=true).\n");
+}
+/*********************************************************/
+void pvcd_register_default_indexes() {
+	metricknn_register_index("SPARSE-INVERTED",
+			"idf=[true|false],idf_file=[filename]", "pruning=[true|false]",
+			sparseInverted_printHelp, sparseInverted_index_new,
+			sparseInverted_resolver_new);
+}
@@ -13,30 +13,28 @@ static void loadQueryVectorsTxt(MyLineReader *reader, int64_t numVectors,
 		int64_t *out_maxNNLoaded, double *out_maxDistLoaded) {
 	if (numVectors == 0)
 		return;
-	query->name_query = MY_MALLOC(numVectors, char*);
-	query->nns = MY_MALLOC(numVectors, MyVectorObj*);
+	MyArena *arena = query->arena;
+	query->name_query = MY_ARENA_MALLOC(arena, numVectors, char*);
+	query->nns = MY_ARENA_MALLOC(arena, numVectors, MyVectorObj*);
 	for (int64_t i = 0; i < numVectors; i++) {
 		const char *line = my_lreader_readLine(reader);
 		my_assert_notNull("line", line);
-		MyTokenizer *tk = my_tokenizer_new(line, '\t');
-		char *nameQ = my_newString_string(my_tokenizer_nextToken(tk));
-		MyVectorObj *nnList = my_vectorObj_new();
+		MyTokenizer *tk = my_tokenizer_newArena(line, '\t', arena);
+		char *nameQ = my_arena_newString(arena, my_tokenizer_nextToken(tk));
+		MyVectorObj *nnList = my_vectorObj_newArena(arena);
 		double distPrev = 0;
 		while (my_tokenizer_hasNext(tk)) {
-			struct NNTxt *nn = MY_MALLOC(1, struct NNTxt);
-			nn->name_nn = my_newString_string(my_tokenizer_nextToken(tk));
+			struct NNTxt *nn = MY_ARENA_MALLOC(arena, 1, struct NNTxt);
+			nn->name_nn = my_arena_newString(arena, my_tokenizer_nextToken(tk));
 			nn->distance = my_tokenizer_nextDouble(tk);
 			if (distPrev > nn->distance) {
 				my_log_info("not sorted distances (%lf > %lf) in %s at %s\n",
 						distPrev, nn->distance, nameQ, query->name_file);
-				MY_FREE_MULTI(nn->name_nn, nn);
 				break;
 			}
 			distPrev = nn->distance;
-			if (nn->distance > maxDistLoad) {
-				MY_FREE_MULTI(nn->name_nn, nn);
+			if (nn->distance > maxDistLoad)
 				break;
-			}
 			my_vectorObj_add(nnList, nn);
 			if (nn->distance > *out_maxDistLoaded)
 				*out_maxDistLoaded = nn->distance;
@@ -56,9 +54,14 @@ static struct QueryTxt *parseQueryTxt(MyLineReader *reader, int64_t maxNNLoad,
 	if (line == NULL)
 		return NULL;
 	my_assert_prefixString("format file", line, "query=");
-	MyTokenizer *tk = my_tokenizer_new(line, '\t');
-	struct QueryTxt *query = MY_MALLOC(1, struct QueryTxt);
-	query->name_file = my_subStringC_firstEnd(my_tokenizer_nextToken(tk), '=');
+	//every object of the query is allocated in its arena
+	MyArena *arena = my_arena_new(0);
+	MyTokenizer *tk = my_tokenizer_newArena(line, '\t', arena);
+	struct QueryTxt *query = MY_ARENA_MALLOC(arena, 1, struct QueryTxt);
+	query->arena = arena;
+	char *name_file = my_subStringC_firstEnd(my_tokenizer_nextToken(tk), '=');
+	query->name_file = my_arena_newString(arena, name_file);
+	MY_FREE(name_file);
 	query->num_queries = my_parse_int_csubFirstEnd(my_tokenizer_nextToken(tk), '=');
 	query->search_time = my_parse_double_csubFirstEnd(my_tokenizer_nextToken(tk), '=');
 	my_tokenizer_releaseValidateEnd(tk);
@@ -67,17 +70,7 @@ static struct QueryTxt *parseQueryTxt(MyLineReader *reader, int64_t maxNNLoad,
 	return query;
 }
 static void releaseQueryTxt(struct QueryTxt *query) {
-	int64_t j, k;
-	for (j = 0; j < query->num_queries; ++j) {
-		MY_FREE(query->name_query[j]);
-		MyVectorObj *nns = query->nns[j];
-		for (k = 0; k < my_vectorObj_size(nns); ++k) {
-			struct NNTxt *nn = my_vectorObj_get(nns, k);
-			MY_FREE_MULTI(nn->name_nn, nn);
-		}
-		my_vectorObj_release(nns, 0);
-	}
-	MY_FREE_MULTI(query->name_query, query->nns, query->name_file, query);
+	my_arena_release(query->arena);
 }
 //Array_obj of struct QueryTxt *
 MyVectorObj *loadSsFileTxt(const char *filename, int64_t maxNNLoad, double maxDistLoad) {
@@ -13,7 +13,7 @@ struct VoteCount {
 	double score;
 };
 static MyVectorObj* sumVotesFrame(struct QueryTxt *frameTxt) {
-	MyMapStringObj *mapVotes = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *mapVotes = my_mapStringObj_newHashCaseSensitive();
 	for (int64_t i = 0; i < frameTxt->num_queries; ++i) {
 		MyVectorObj *nnList = frameTxt->nns[i];
 		for (int64_t j = 0; j < my_vectorObj_size(nnList); ++j) {
@@ -84,7 +84,7 @@ static void mergeFrames(int64_t currentProcess, void* state, int64_t numThread)
 	}
 }
 static MyVectorObj *groupCommonVideos(MyVectorObj *ssVectorList) {
-	MyMapStringObj *namevid2list = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *namevid2list = my_mapStringObj_newHashCaseSensitive();
 	int64_t j;
 	for (j = 0; j < my_vectorObj_size(ssVectorList); ++j) {
 		struct QueryTxt *frameQ = my_vectorObj_get(ssVectorList, j);
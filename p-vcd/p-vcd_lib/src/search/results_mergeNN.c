@@ -77,13 +77,8 @@ static void mergeQueries(struct QueryTxt *queryBase, struct QueryTxt *queryAdd,
 #endif
 		my_vectorObj_addAll(baseNNs, newNNs);
 		my_vectorObj_qsort(baseNNs, compareNNs);
-		while (my_vectorObj_size(baseNNs) > maxNN) {
-			struct NNTxt *nn = my_vectorObj_remove(baseNNs,
-					my_vectorObj_size(baseNNs) - 1);
-			MY_FREE_MULTI(nn->name_nn, nn);
-		}
-		my_vectorObj_release(queryAdd->nns[i], 0);
-		MY_FREE(queryAdd->name_query[i]);
+		while (my_vectorObj_size(baseNNs) > maxNN)
+			my_vectorObj_remove(baseNNs, my_vectorObj_size(baseNNs) - 1);
 	}
 }
 
@@ -97,6 +92,14 @@ static void addSearchTime(MyMapStringObj *name2searchTimes,
 	}
 	my_vectorDouble_add(times, qAdd->search_time);
 }
+//the values vector wraps the map array, it is copied to survive the map
+static MyVectorObj *newValuesList(MyMapStringObj *name2query) {
+	MyVectorObj *values = my_mapStringObj_valuesVector(name2query);
+	MyVectorObj *list = my_vectorObj_new();
+	my_vectorObj_addAll(list, values);
+	my_vectorObj_release(values, false);
+	return list;
+}
 static void updateSearchTimes(MyMapStringObj *name2query,
 		MyMapStringObj *name2searchTimes, const char *typeSearchTime) {
 	MyVectorObj *list = my_mapStringObj_valuesVector(name2query);
@@ -163,8 +166,8 @@ static MyVectorObj * NN_mergeByConcatenation(MyVectorString *filenames,
 		MyVectorDouble *maxDistLoad, int64_t *maxNNWrite,
 		MyVectorDouble *distsNorm, MyVectorDouble *distsWeight,
 		const char *typeSearchTime) {
-	MyMapStringObj *name2query = my_mapStringObj_newCaseSensitive();
-	MyMapStringObj *name2searchTimes = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *name2query = my_mapStringObj_newHashCaseSensitive();
+	MyMapStringObj *name2searchTimes = my_mapStringObj_newHashCaseSensitive();
 	for (int64_t i = 0; i < my_vectorString_size(filenames); ++i) {
 		const char *filename = my_vectorString_get(filenames, i);
 		MyVectorObj *vq = loadSsFileTxt(filename,
@@ -187,15 +190,15 @@ static MyVectorObj * NN_mergeByConcatenation(MyVectorString *filenames,
 				my_log_info("could not locate query '%s'\n", qAdd->name_file);
 			} else {
 				mergeQueries(qBase, qAdd, *maxNNWrite);
-				MY_FREE_MULTI(qAdd->nns, qAdd->name_query, qAdd->name_file,
-						qAdd);
+				//the NNs of qAdd now belong to qBase
+				my_arena_merge(qBase->arena, qAdd->arena);
 			}
 		}
 	}
 	updateSearchTimes(name2query, name2searchTimes, typeSearchTime);
 	my_log_info_time("merge complete, %"PRIi64" queries, %"PRIi64" files\n",
 			my_mapStringObj_size(name2query), my_vectorString_size(filenames));
-	MyVectorObj *list = my_mapStringObj_valuesVector(name2query);
+	MyVectorObj *list = newValuesList(name2query);
 	my_mapStringObj_release(name2query, false, false);
 	return list;
 }
@@ -240,8 +243,8 @@ static MyVectorObj * NN_mergeByDistSum(MyVectorString *filenames,
 		MyVectorDouble *maxDistLoad, int64_t *maxNNWrite,
 		MyVectorDouble *distsNorm, MyVectorDouble *distsWeight,
 		double distNotFound, const char *typeSearchTime) {
-	MyMapStringObj *name2query = my_mapStringObj_newCaseSensitive();
-	MyMapStringObj *name2searchTimes = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *name2query = my_mapStringObj_newHashCaseSensitive();
+	MyMapStringObj *name2searchTimes = my_mapStringObj_newHashCaseSensitive();
 	for (int64_t i = 0; i < my_vectorString_size(filenames); ++i) {
 		const char *filename = my_vectorString_get(filenames, i);
 		MyVectorObj *vq = loadSsFileTxt(filename,
@@ -270,7 +273,7 @@ static MyVectorObj * NN_mergeByDistSum(MyVectorString *filenames,
 	updateSearchTimes(name2query, name2searchTimes, typeSearchTime);
 	my_log_info_time("merge complete, %"PRIi64" queries, %"PRIi64" files\n",
 			my_mapStringObj_size(name2query), my_vectorString_size(filenames));
-	MyVectorObj *list = my_mapStringObj_valuesVector(name2query);
+	MyVectorObj *list = newValuesList(name2query);
 	my_mapStringObj_release(name2query, false, false);
 	return list;
 }
@@ -325,8 +328,8 @@ static MyVectorObj *NN_mergeByRankAggregation(MyVectorString *filenames,
 		const char *outFilename, MyVectorInt *maxNNLoad,
 		MyVectorDouble *maxDistLoad, int64_t *maxNNWrite,
 		const char *typeSearchTime) {
-	MyMapStringObj *name2query = my_mapStringObj_newCaseSensitive();
-	MyMapStringObj *name2searchTimes = my_mapStringObj_newCaseSensitive();
+	MyMapStringObj *name2query = my_mapStringObj_newHashCaseSensitive();
+	MyMapStringObj *name2searchTimes = my_mapStringObj_newHashCaseSensitive();
 	for (int64_t i = 0; i < my_vectorString_size(filenames); ++i) {
 		const char *filename = my_vectorString_get(filenames, i);
 		MyVectorObj *vq = loadSsFileTxt(filename,
@@ -352,7 +355,7 @@ static MyVectorObj *NN_mergeByRankAggregation(MyVectorString *filenames,
 	updateSearchTimes(name2query, name2searchTimes, typeSearchTime);
 	my_log_info_time("merge complete, %"PRIi64" queries, %"PRIi64" files\n",
 			my_mapStringObj_size(name2query), my_vectorString_size(filenames));
-	MyVectorObj *list = my_mapStringObj_valuesVector(name2query);
+	MyVectorObj *list = newValuesList(name2query);
 	for (int64_t i = 0; i < my_vectorObj_size(list); ++i) {
 		struct QueryTxt *query = my_vectorObj_get(list, i);
 		convertVotesToDistance(query);
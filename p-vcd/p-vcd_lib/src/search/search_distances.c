@@ -97,6 +97,9 @@ static double sparseCosine_eval(void *state_distEval, void *object_left,
 		return sqrt(2 * fabs(1 - cosine));
 }
 
+bool profile_is_sparseCosine_mdistance(MknnDistance *distance) {
+	return mknn_distance_getCustomFunctionEval(distance) == sparseCosine_eval;
+}
 MknnDistance *profile_get_mdistance(struct SearchProfile *profile) {
 	if (my_string_equals_ignorecase(profile->id_dist_custom, "SparseGeneral")) {
 		void *state_factory = sparseGeneral_newStateFactory(profile);
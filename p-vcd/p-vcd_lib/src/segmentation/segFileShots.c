@@ -144,7 +144,7 @@ static void seg_new(const char *segCode, const char *segParameters,
 		es->removeEnd = my_tokenizer_nextDouble(tk);
 	es->filenameShots = my_newString_string(my_tokenizer_getCurrentTail(tk));
 	my_tokenizer_release(tk);
-	es->videoName2segmentation = my_mapStringObj_newCaseSensitive();
+	es->videoName2segmentation = my_mapStringObj_newHashCaseSensitive();
 	char *format = my_io_detectFileConfig(es->filenameShots, "PVCD");
 	if (format != NULL && my_string_equals(format, "Shots")) {
 		loadShots(es->videoName2segmentation, es->filenameShots);
@@ -119,6 +119,18 @@ Transform *findTransform(const char *codeAndParameters) {
 	my_tokenizer_release(tk);
 	return tr;
 }
+#define PREPROCESS_CHECK_INTERVAL 30
+
+void parsePreprocessSampling(MyTokenizer *tk,
+		struct TransformPreprocessSampling *out_sampling) {
+	out_sampling->frameStep =
+			my_tokenizer_hasNext(tk) ? my_tokenizer_nextInt(tk) : 1;
+	out_sampling->tolerance =
+			my_tokenizer_hasNext(tk) ? my_tokenizer_nextDouble(tk) : 0;
+	out_sampling->checkInterval = PREPROCESS_CHECK_INTERVAL;
+	if (out_sampling->frameStep < 1)
+		my_log_error("invalid frameStep %"PRIi64"\n", out_sampling->frameStep);
+}
 void releaseTransform(Transform *tr) {
 	if (tr->def->func_release != NULL)
 		tr->def->func_release(tr->state);
@@ -29,6 +29,12 @@ typedef uchar (*tranform_func_preprocess_compute)(VideoFrame *video_frame,
 
 typedef void (*tranform_func_preprocess_load)(void* state, const char *savedData);
 
+//optional. returns a new string with the path of a file read by the
+//transformation (e.g. a segmentation), or NULL. The preprocess cache of the
+//following transformations depends on it.
+typedef char* (*tranform_func_preprocess_dependency)(void* state,
+		FileDB *fileDB);
+
 //la transformacion puede modificar la imagen o puede retornar una nueva.
 //los frames no necesariamente son consecutivos, xq se puede reiniciar el
 //video si es que se le agrega otra transformacion que requiera un preproceso.
@@ -43,6 +49,7 @@ typedef struct {
 	tranform_func_new func_new;
 	tranform_func_preprocess_compute func_preprocess_compute;
 	tranform_func_preprocess_load func_preprocess_load;
+	tranform_func_preprocess_dependency func_preprocess_dependency;
 	tranform_func_transform_frame func_transform_frame;
 	tranform_func_release func_release;
 } Transform_Def;
@@ -54,6 +61,17 @@ typedef struct {
 	void *state;
 } Transform;
 
+//sampling of frames for transformations that scan the whole video
+//in func_preprocess_compute
+struct TransformPreprocessSampling {
+	int64_t frameStep, checkInterval;
+	//tolerance<=0 process all the frames
+	double tolerance;
+};
+//reads optional parameters frameStep_tolerance
+void parsePreprocessSampling(MyTokenizer *tk,
+		struct TransformPreprocessSampling *out_sampling);
+
 Transform_Def *newTransformDef(const char *code, const char *helpText);
 Transform_Def *findTransformDef(const char *code);
 Transform *findTransform2(const char *code, const char *parameters);
@@ -19,12 +19,18 @@ struct Estado_ACC {
 			centroPrevX, centroPrevY;
 	IplImage *imgGris, *imgBinaria, *conversionPre, *conversionPost,
 			*transformadoPrev, *transformadoPrevGris, *transformadoPost;
+	struct TransformPreprocessSampling sampling;
 };
 
 static void tra_config_acc(const char *trCode, const char *trParameters, void **out_state) {
 	struct Estado_ACC *es = MY_MALLOC(1, struct Estado_ACC);
-	if (trParameters != NULL && my_string_equals(trParameters, "FORCED"))
+	MyTokenizer *tk = my_tokenizer_new(trParameters, '_');
+	if (my_tokenizer_isNext(tk, "FORCED")) {
+		my_tokenizer_nextToken(tk);
 		es->forzarDeteccion = 1;
+	}
+	parsePreprocessSampling(tk, &es->sampling);
+	my_tokenizer_releaseValidateEnd(tk);
 	*out_state = es;
 }
 
@@ -398,6 +404,21 @@ static void tra_acc_promediar(struct Poligono poli, double centroX,
 				&proms->esq_aba_der);
 	}
 }
+//maximum change of the averaged corners since the previous test
+static double tra_acc_cambioEsquinas(struct PoligonoPromedio *proms,
+		double *esquinasPrev) {
+	double esquinas[8] = { proms->esq_arr_izq.prom_x.mean,
+			proms->esq_arr_izq.prom_y.mean, proms->esq_arr_der.prom_x.mean,
+			proms->esq_arr_der.prom_y.mean, proms->esq_aba_izq.prom_x.mean,
+			proms->esq_aba_izq.prom_y.mean, proms->esq_aba_der.prom_x.mean,
+			proms->esq_aba_der.prom_y.mean };
+	double cambio = 0;
+	for (int64_t i = 0; i < 8; ++i) {
+		cambio = MAX(cambio, fabs(esquinas[i] - esquinasPrev[i]));
+		esquinasPrev[i] = esquinas[i];
+	}
+	return cambio;
+}
 static void centroMasa(IplImage *imgBinaria, uchar minNegro,
 		double *out_centroX, double *out_centroY) {
 	double centrox = 0, centroy = 0;
@@ -435,8 +456,9 @@ static uchar tra_preprocesar_compute_acc(VideoFrame *video_frame,
 	struct PoligonoPromedio *poli_prom = MY_MALLOC(1,
 			struct PoligonoPromedio);
 	int64_t numframes = 0;
+	double esquinasPrev[8] = { 0 };
 	struct Transf_Hough* hough = nueva_transf_hough(150, 200); //45, 60
-	while (loadNextFrame(video_frame)) {
+	while (loadNextFrameStep(video_frame, es->sampling.frameStep)) {
 		IplImage *frameGris = getCurrentFrameGray(video_frame);
 		if (imgBinaria == NULL) {
 			imgBinaria = cvCreateImage(cvGetSize(frameGris), IPL_DEPTH_8U, 1);
@@ -456,6 +478,16 @@ static uchar tra_preprocesar_compute_acc(VideoFrame *video_frame,
 				hasta, centroX, centroY);
 		tra_acc_promediar(poli, centroX, centroY, poli_prom);
 		numframes++;
+		if (es->sampling.tolerance > 0
+				&& numframes % es->sampling.checkInterval == 0) {
+			double cambio = tra_acc_cambioEsquinas(poli_prom, esquinasPrev);
+			if (numframes > es->sampling.checkInterval
+					&& cambio <= es->sampling.tolerance) {
+				my_log_info("acc %s: corners converged after %"PRIi64" frames\n",
+						getVideoName(video_frame), numframes);
+				break;
+			}
+		}
 	}
 	release_transf_hough(hough);
 	my_image_release(imgBinaria);
@@ -621,7 +653,7 @@ static void tra_release_acc(void *estado) {
 }
 
 void tra_reg_acc() {
-	Transform_Def *def = newTransformDef("ACC", "(FORCED)");
+	Transform_Def *def = newTransformDef("ACC", "(FORCED)_(frameStep_tolerance)");
 	def->func_new = tra_config_acc;
 	def->func_preprocess_compute = tra_preprocesar_compute_acc;
 	def->func_preprocess_load = tra_preprocesar_load_acc;
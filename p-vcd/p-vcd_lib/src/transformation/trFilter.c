@@ -18,8 +18,7 @@
 struct Proceso_FILTRO {
 	int64_t filtro_width, filtro_height, filtro_tipo, filtro_size;
 	double *valores_kernel;
-	int64_t array_dim1, array_dim2, array_dim3;
-	double ***my_convolution_perform;
+	float *convol_buffer;
 	uchar convol_abs;
 	double convol_max;
 	IplImage *imgOut;
@@ -120,17 +119,9 @@ static uchar tra_calcular_filtro(IplImage *imagen, int64_t x, int64_t y, int64_t
 static IplImage *tra_transformar_filtro(IplImage *imagen, int64_t numFrame,
 		void* estado) {
 	struct Proceso_FILTRO *es = estado;
-	if (es->my_convolution_perform == NULL) {
-		es->array_dim1 = imagen->nChannels;
-		es->array_dim2 = imagen->width;
-		es->array_dim3 = imagen->height;
-		es->my_convolution_perform = MY_MALLOC_NOINIT(es->array_dim1, double**);
-		int64_t i, j;
-		for (i = 0; i < es->array_dim1; ++i) {
-			es->my_convolution_perform[i] = MY_MALLOC_NOINIT(es->array_dim2, double*);
-			for (j = 0; j < es->array_dim2; ++j)
-				es->my_convolution_perform[i][j] = MY_MALLOC_NOINIT(es->array_dim3, double);
-		}
+	if (es->imgOut == NULL) {
+		es->convol_buffer = MY_MALLOC_NOINIT(
+				imagen->nChannels * imagen->width * imagen->height, float);
 		es->imgOut = cvCreateImage(cvGetSize(imagen), IPL_DEPTH_8U,
 				imagen->nChannels);
 	}
@@ -157,9 +148,9 @@ static IplImage *tra_transformar_filtro(IplImage *imagen, int64_t numFrame,
 			else if (es->filtro_tipo == F_TYPE_CONVOLUTION)
 				my_convolution_initKernel(es->kc, es->valores_kernel);
 		}
-		my_convolution_perform(imagen, es->kc, es->my_convolution_perform);
-		my_image_copyArrayToPixels(es->my_convolution_perform, es->convol_max, es->convol_abs,
-				es->imgOut);
+		my_convolution_performBuffer(imagen, es->kc, es->convol_buffer);
+		my_image_copyBufferToPixels(es->convol_buffer, es->convol_max,
+				es->convol_abs, es->imgOut);
 	} else {
 		int64_t x, y, nc;
 		for (y = 0; y < imagen->height; ++y) {
@@ -193,15 +184,7 @@ static void tra_release_filtro(void *estado) {
 	struct Proceso_FILTRO *es = estado;
 	my_image_release(es->imgOut);
 	my_convolution_releaseKernel(es->kc);
-	MY_FREE(es->ventana);
-	int64_t i, j;
-	for (i = 0; i < es->array_dim1; ++i) {
-		for (j = 0; j < es->array_dim2; ++j)
-			MY_FREE(es->my_convolution_perform[i][j]);
-		MY_FREE(es->my_convolution_perform[i]);
-	}
-	MY_FREE(es->my_convolution_perform);
-	MY_FREE(es);
+	MY_FREE_MULTI(es->ventana, es->convol_buffer, es);
 }
 
 void tra_reg_filtro() {
@@ -451,11 +451,15 @@ static struct Pip_Rectangulo detectarRectanguloPIP(double **arrayBordes,
 
 struct Proceso_PIP {
 	CvRect zona;
+	struct TransformPreprocessSampling sampling;
 };
 
 static void tra_config_pip(const char *trCode, const char *trParameters, void **out_state) {
 	struct Proceso_PIP *es = MY_MALLOC(1, struct Proceso_PIP);
 	es->zona = cvRect(0, 0, 0, 0);
+	MyTokenizer *tk = my_tokenizer_new(trParameters, '_');
+	parsePreprocessSampling(tk, &es->sampling);
+	my_tokenizer_releaseValidateEnd(tk);
 	*out_state = es;
 }
 
@@ -463,31 +467,21 @@ static void tra_config_pip(const char *trCode, const char *trParameters, void **
 int64_t pip_espera = 0;
 #endif
 
-static double **pip_calcularBordesPromedios(VideoFrame *video_frame) {
-	int64_t x, y, cont = 0;
+static double **pip_calcularBordesPromedios(VideoFrame *video_frame,
+		struct TransformPreprocessSampling *sampling) {
+	int64_t x, y;
 	CvSize frame_size = getFrameSize(video_frame);
-	double **framesMu = MY_MALLOC_MATRIX(frame_size.width, frame_size.height,
-			double);
-	double **framesVar = MY_MALLOC_MATRIX(frame_size.width, frame_size.height,
-			double);
-	while (loadNextFrame(video_frame)) {
+	MyImageStats *stats = my_imageStats_new(frame_size.width,
+			frame_size.height);
+	my_imageStats_setConvergence(stats, sampling->checkInterval,
+			sampling->tolerance);
+	while (loadNextFrameStep(video_frame, sampling->frameStep)) {
 		IplImage *frameGris = getCurrentFrameGray(video_frame);
-		cont++;
-		for (y = 0; y < frame_size.height; ++y) {
-			uchar *ptr = (uchar*) (frameGris->imageData
-					+ frameGris->widthStep * y);
-			for (x = 0; x < frame_size.width; ++x) {
-				double delta = ptr[x] - framesMu[x][y];
-				framesMu[x][y] += delta / cont;
-				framesVar[x][y] += delta * (ptr[x] - framesMu[x][y]);
-			}
-		}
+		my_imageStats_addImage(stats, frameGris);
 #if PIP_VER_PASO1
 		cvShowImage("frameGris", frameGris);
-		IplImage *im_mediasFrame = my_image_newFromArray(framesMu,
-				frame_size.width, frame_size.height, 0);
-		IplImage *im_varsFrame = my_image_newFromArray(framesVar,
-				frame_size.width, frame_size.height, 0);
+		IplImage *im_mediasFrame = my_imageStats_newImageMeans(stats, 0);
+		IplImage *im_varsFrame = my_imageStats_newImageVariances(stats, 0);
 		cvShowImage("mediasFrame", im_mediasFrame);
 		cvShowImage("varsFrame", im_varsFrame);
 		char c = cvWaitKey(pip_espera);
@@ -498,21 +492,21 @@ static double **pip_calcularBordesPromedios(VideoFrame *video_frame) {
 		my_image_release(im_mediasFrame);
 		my_image_release(im_varsFrame);
 #endif
+		if (my_imageStats_hasConverged(stats)) {
+			my_log_info("pip %s: averages converged after %"PRIi64" frames\n",
+					getVideoName(video_frame),
+					my_imageStats_getNumImages(stats));
+			break;
+		}
 	}
 #if PIP_VER_PASO1
 	cvDestroyWindow("frameGris");
 	cvDestroyWindow("mediasFrame");
 	cvDestroyWindow("varsFrame");
 #endif
-	for (y = 0; y < frame_size.height; ++y)
-		for (x = 0; x < frame_size.width; ++x)
-			framesVar[x][y] /= cont;
-	IplImage *img_framesMu = my_image_newFromArray(framesMu, frame_size.width,
-			frame_size.height, 0);
-	IplImage *img_framesVar = my_image_newFromArray(framesVar, frame_size.width,
-			frame_size.height, 0);
-	MY_FREE_MATRIX(framesMu, frame_size.width);
-	MY_FREE_MATRIX(framesVar, frame_size.width);
+	IplImage *img_framesMu = my_imageStats_newImageMeans(stats, 0);
+	IplImage *img_framesVar = my_imageStats_newImageVariances(stats, 0);
+	my_imageStats_release(stats);
 	IplImage *diffMu16b = cvCreateImage(frame_size, IPL_DEPTH_16S, 1);
 	IplImage *diffVar16b = cvCreateImage(frame_size, IPL_DEPTH_16S, 1);
 	cvLaplace(img_framesMu, diffMu16b, 3);
@@ -571,7 +565,9 @@ static uchar tra_preprocesar_compute_pip(VideoFrame *video_frame,
 		FileDB *fileDB, void* estado, char **out_stateToSave) {
 	CvSize frame_size = getFrameSize(video_frame);
 	my_log_info("pip %s: promediando frames...\n", getVideoName(video_frame));
-	double **arrayBordes = pip_calcularBordesPromedios(video_frame);
+	struct Proceso_PIP *es = estado;
+	double **arrayBordes = pip_calcularBordesPromedios(video_frame,
+			&es->sampling);
 	my_log_info("pip %s: detectando rectangulo...\n", getVideoName(video_frame));
 	struct Pip_Rectangulo rect = detectarRectanguloPIP(arrayBordes,
 			frame_size.width, frame_size.height);
@@ -606,7 +602,7 @@ static void tra_release_pip(void *estado) {
 	MY_FREE(es);
 }
 void tra_reg_pip() {
-	Transform_Def *def = newTransformDef("PIP", NULL);
+	Transform_Def *def = newTransformDef("PIP", "(frameStep_tolerance)");
 	def->func_new = tra_config_pip;
 	def->func_preprocess_compute = tra_preprocesar_compute_pip;
 	def->func_preprocess_load = tra_preprocesar_load_pip;
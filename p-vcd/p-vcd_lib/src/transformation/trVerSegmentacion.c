@@ -61,6 +61,13 @@ static uchar tra_preprocesar_compute_vseg(VideoFrame *video_frame,
 	return 1;
 }
 
+static char *tra_preprocesar_dependency_vseg(void* estado, FileDB *fileDB) {
+	struct Proceso_VerFs *es = estado;
+	if (es->loader == NULL)
+		es->loader = newLoadSegmentation(fileDB->db, es->segmentacion_dir);
+	return loadSegmentation_newFilenameFileDB(es->loader, fileDB);
+}
+
 #define NUM_PREVIOS 9
 
 static void tra_init_vseg(IplImage *imagen, struct Proceso_VerFs *es) {
@@ -149,6 +156,7 @@ void tra_reg_vseg() {
 	Transform_Def *def = newTransformDef("VERSEGM", "samplingDir");
 	def->func_new = tra_config_vseg;
 	def->func_preprocess_compute = tra_preprocesar_compute_vseg;
+	def->func_preprocess_dependency = tra_preprocesar_dependency_vseg;
 	def->func_transform_frame = tra_transformar_vseg;
 	def->func_release = tra_release_vseg;
 }
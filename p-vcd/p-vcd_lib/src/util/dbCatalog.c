@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of P-VCD. http://p-vcd.org/
+ * P-VCD is made available under the terms of the BSD 2-Clause License.
+ */
+
+#include "dbCatalog.h"
+
+#define CATALOG_MAGIC "PVCDCAT"
+#define CATALOG_VERSION 1
+
+#define CATALOG_TYPE_VIDEO 0
+#define CATALOG_TYPE_IMAGE 1
+#define CATALOG_TYPE_AUDIO 2
+
+//file layout: header, files, transfs, hashId, hashFilenameReal, strings
+struct CatalogHeader {
+	char magic[8];
+	int64_t version, textFilesize, textModificationTime;
+	int64_t numFiles, numTransfs, hashSize, stringsSize;
+};
+//strings are offsets in the string pool
+struct CatalogFile {
+	int64_t type, id, pathReal, filenameReal;
+	int64_t filesize, width, height;
+	double secStartTime, secEndTime, numObjsPerSecond;
+	int64_t numTransfs, firstTransf;
+};
+//-1 means NULL
+struct CatalogTransf {
+	int64_t name, preprocessData;
+};
+struct DBCatalog {
+	const void *bytes;
+	int64_t numBytes;
+	const struct CatalogHeader *header;
+	//position of the file in each slot, -1 means empty
+	const int64_t *hashId, *hashFilenameReal;
+	const char *strings;
+	FileDB *files;
+	char **transfStrings;
+};
+
+static bool priv_isEnabled() {
+	return my_env_getInt("PVCD_DB_CATALOG", 1) != 0;
+}
+static char *priv_newFilename(DB *db) {
+	return my_newString_format("%s/files.catalog", db->pathBase);
+}
+//FNV-1a
+static uint64_t priv_hashString(const char *string) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+	for (const char *c = string; *c != '\0'; ++c) {
+		hash ^= (uint8_t) *c;
+		hash *= UINT64_C(1099511628211);
+	}
+	return hash;
+}
+static int64_t priv_hashSize(int64_t numValues) {
+	int64_t size = 16;
+	while (size < 2 * numValues)
+		size *= 2;
+	return size;
+}
+
+/************ writing **************/
+
+struct StringPool {
+	char *buffer;
+	int64_t size, capacity;
+	//offset of each interned string, -1 means empty
+	int64_t *slots;
+	int64_t numSlots, numStrings;
+};
+static void priv_pool_rehash(struct StringPool *pool, int64_t newNumSlots) {
+	int64_t *slots = MY_MALLOC_NOINIT(newNumSlots, int64_t);
+	for (int64_t i = 0; i < newNumSlots; ++i)
+		slots[i] = -1;
+	for (int64_t i = 0; i < pool->numSlots; ++i) {
+		if (pool->slots[i] < 0)
+			continue;
+		uint64_t pos = priv_hashString(pool->buffer + pool->slots[i])
+				& (newNumSlots - 1);
+		while (slots[pos] >= 0)
+			pos = (pos + 1) & (newNumSlots - 1);
+		slots[pos] = pool->slots[i];
+	}
+	MY_FREE(pool->slots);
+	pool->slots = slots;
+	pool->numSlots = newNumSlots;
+}
+static int64_t priv_pool_intern(struct StringPool *pool, const char *string) {
+	if (string == NULL)
+		return -1;
+	if (2 * (pool->numStrings + 1) > pool->numSlots)
+		priv_pool_rehash(pool, priv_hashSize(pool->numStrings + 1));
+	uint64_t pos = priv_hashString(string) & (pool->numSlots - 1);
+	while (pool->slots[pos] >= 0) {
+		if (strcmp(pool->buffer + pool->slots[pos], string) == 0)
+			return pool->slots[pos];
+		pos = (pos + 1) & (pool->numSlots - 1);
+	}
+	int64_t length = strlen(string) + 1;
+	if (pool->size + length > pool->capacity) {
+		pool->capacity = MAX(2 * pool->capacity, pool->size + length + 1024);
+		MY_REALLOC(pool->buffer, pool->capacity, char);
+	}
+	int64_t offset = pool->size;
+	memcpy(pool->buffer + offset, string, length);
+	pool->size += length;
+	pool->slots[pos] = offset;
+	pool->numStrings++;
+	return offset;
+}
+static void priv_hash_add(int64_t *hash, int64_t hashSize, const char *key,
+		int64_t value) {
+	uint64_t pos = priv_hashString(key) & (hashSize - 1);
+	while (hash[pos] >= 0)
+		pos = (pos + 1) & (hashSize - 1);
+	hash[pos] = value;
+}
+void dbCatalog_save(DB *db, int64_t textFilesize, int64_t textModificationTime) {
+	if (!priv_isEnabled() || db->numFilesDb == 0)
+		return;
+	struct CatalogHeader header = { { 0 } };
+	memcpy(header.magic, CATALOG_MAGIC, strlen(CATALOG_MAGIC));
+	header.version = CATALOG_VERSION;
+	header.textFilesize = textFilesize;
+	header.textModificationTime = textModificationTime;
+	header.numFiles = db->numFilesDb;
+	header.hashSize = priv_hashSize(db->numFilesDb);
+	for (int64_t i = 0; i < db->numFilesDb; ++i)
+		header.numTransfs += db->filesDb[i]->numTransfs;
+	struct CatalogFile *files = MY_MALLOC(header.numFiles, struct CatalogFile);
+	struct CatalogTransf *transfs = MY_MALLOC(MAX(1, header.numTransfs),
+			struct CatalogTransf);
+	int64_t *hashId = MY_MALLOC_NOINIT(header.hashSize, int64_t);
+	int64_t *hashFilenameReal = MY_MALLOC_NOINIT(header.hashSize, int64_t);
+	for (int64_t i = 0; i < header.hashSize; ++i)
+		hashId[i] = hashFilenameReal[i] = -1;
+	struct StringPool pool = { 0 };
+	int64_t numTransfs = 0;
+	for (int64_t i = 0; i < db->numFilesDb; ++i) {
+		FileDB *fdb = db->filesDb[i];
+		struct CatalogFile *f = &files[i];
+		f->type = fdb->isVideo ? CATALOG_TYPE_VIDEO :
+					fdb->isImage ? CATALOG_TYPE_IMAGE : CATALOG_TYPE_AUDIO;
+		f->id = priv_pool_intern(&pool, fdb->id);
+		f->pathReal = priv_pool_intern(&pool, fdb->pathReal);
+		f->filenameReal = priv_pool_intern(&pool, fdb->filenameReal);
+		f->filesize = fdb->filesize;
+		f->width = fdb->width;
+		f->height = fdb->height;
+		f->secStartTime = fdb->secStartTime;
+		f->secEndTime = fdb->secEndTime;
+		f->numObjsPerSecond = fdb->numObjsPerSecond;
+		f->numTransfs = fdb->numTransfs;
+		f->firstTransf = numTransfs;
+		for (int64_t j = 0; j < fdb->numTransfs; ++j) {
+			transfs[numTransfs].name = priv_pool_intern(&pool,
+					fdb->nameTransf[j]);
+			transfs[numTransfs].preprocessData = priv_pool_intern(&pool,
+					fdb->preprocessDataTransf[j]);
+			numTransfs++;
+		}
+		priv_hash_add(hashId, header.hashSize, fdb->id, i);
+		priv_hash_add(hashFilenameReal, header.hashSize, fdb->filenameReal, i);
+	}
+	header.stringsSize = pool.size;
+	char *filename = priv_newFilename(db);
+	//other processes or threads may be loading the same db, the temporal
+	//name is unique (pid and a counter) and the rename is atomic
+	static int64_t counter = 0;
+	char *tempname = my_newString_format("%s.%"PRIi64".%"PRIi64".tmp",
+			filename, (int64_t) getpid(),
+			__atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+	FILE *out = fopen(tempname, "wb");
+	if (out == NULL) {
+		my_log_info("can't write catalog %s\n", tempname);
+	} else {
+		bool ok = fwrite(&header, sizeof(header), 1, out) == 1
+				&& fwrite(files, sizeof(struct CatalogFile), header.numFiles,
+						out) == (size_t) header.numFiles
+				&& fwrite(transfs, sizeof(struct CatalogTransf),
+						header.numTransfs, out) == (size_t) header.numTransfs
+				&& fwrite(hashId, sizeof(int64_t), header.hashSize, out)
+						== (size_t) header.hashSize
+				&& fwrite(hashFilenameReal, sizeof(int64_t), header.hashSize,
+						out) == (size_t) header.hashSize
+				&& fwrite(pool.buffer, sizeof(char), pool.size, out)
+						== (size_t) pool.size;
+		if (fclose(out) != 0)
+			ok = false;
+		//replaces the outdated catalog (rename does not overwrite in windows)
+		if (ok && rename(tempname, filename) != 0) {
+			my_io_deleteFile(filename, false);
+			ok = (rename(tempname, filename) == 0);
+		}
+		if (!ok)
+			my_io_deleteFile(tempname, false);
+	}
+	MY_FREE_MULTI(filename, tempname, files, transfs, hashId, hashFilenameReal,
+			pool.buffer, pool.slots);
+}
+
+/************ reading **************/
+
+static bool priv_validateHeader(const struct CatalogHeader *header,
+		int64_t numBytes, int64_t textFilesize, int64_t textModificationTime) {
+	if (numBytes < (int64_t) sizeof(struct CatalogHeader)
+			|| memcmp(header->magic, CATALOG_MAGIC, strlen(CATALOG_MAGIC)) != 0
+			|| header->version != CATALOG_VERSION)
+		return false;
+	if (header->textFilesize != textFilesize
+			|| header->textModificationTime != textModificationTime)
+		return false;
+	int64_t expected = sizeof(struct CatalogHeader)
+			+ header->numFiles * sizeof(struct CatalogFile)
+			+ header->numTransfs * sizeof(struct CatalogTransf)
+			+ 2 * header->hashSize * sizeof(int64_t) + header->stringsSize;
+	return header->numFiles > 0 && expected == numBytes;
+}
+static char *priv_getString(DBCatalog *cat, int64_t offset) {
+	//the mapping is read-only, the FileDB must not modify its strings
+	return (offset < 0) ? NULL : (char*) (cat->strings + offset);
+}
+bool dbCatalog_load(DB *db) {
+	if (!priv_isEnabled())
+		return false;
+	char *filename = priv_newFilename(db);
+	if (!my_io_existsFile(filename)) {
+		MY_FREE(filename);
+		return false;
+	}
+	int64_t numBytes = 0;
+	const void *bytes = my_io_mapFileRead(filename, &numBytes, false);
+	MY_FREE(filename);
+	if (bytes == NULL)
+		return false;
+	const struct CatalogHeader *header = bytes;
+	if (!priv_validateHeader(header, numBytes,
+			my_io_getFilesize(db->pathFiles),
+			my_io_getModificationTime(db->pathFiles))) {
+		my_io_unmapFile(bytes, numBytes);
+		return false;
+	}
+	DBCatalog *cat = MY_MALLOC(1, DBCatalog);
+	cat->bytes = bytes;
+	cat->numBytes = numBytes;
+	cat->header = header;
+	const struct CatalogFile *files = (const struct CatalogFile*) (header + 1);
+	const struct CatalogTransf *transfs =
+			(const struct CatalogTransf*) (files + header->numFiles);
+	cat->hashId = (const int64_t*) (transfs + header->numTransfs);
+	cat->hashFilenameReal = cat->hashId + header->hashSize;
+	cat->strings = (const char*) (cat->hashFilenameReal + header->hashSize);
+	cat->files = MY_MALLOC(header->numFiles, FileDB);
+	cat->transfStrings = MY_MALLOC(2 * MAX(1, header->numTransfs), char*);
+	db->numFilesDb = header->numFiles;
+	db->filesDb = MY_MALLOC(db->numFilesDb, FileDB *);
+	for (int64_t i = 0; i < header->numFiles; ++i) {
+		const struct CatalogFile *f = &files[i];
+		FileDB *fdb = &cat->files[i];
+		fdb->isVideo = (f->type == CATALOG_TYPE_VIDEO);
+		fdb->isImage = (f->type == CATALOG_TYPE_IMAGE);
+		fdb->isAudio = (f->type == CATALOG_TYPE_AUDIO);
+		fdb->id = priv_getString(cat, f->id);
+		fdb->pathReal = priv_getString(cat, f->pathReal);
+		fdb->filenameReal = priv_getString(cat, f->filenameReal);
+		fdb->filesize = f->filesize;
+		fdb->width = f->width;
+		fdb->height = f->height;
+		fdb->secStartTime = f->secStartTime;
+		fdb->secEndTime = f->secEndTime;
+		fdb->lengthSec = fdb->secEndTime - fdb->secStartTime;
+		fdb->numObjsPerSecond = f->numObjsPerSecond;
+		fdb->numTransfs = f->numTransfs;
+		if (fdb->numTransfs > 0) {
+			fdb->nameTransf = cat->transfStrings + 2 * f->firstTransf;
+			fdb->preprocessDataTransf = fdb->nameTransf + fdb->numTransfs;
+			for (int64_t j = 0; j < fdb->numTransfs; ++j) {
+				const struct CatalogTransf *t = &transfs[f->firstTransf + j];
+				fdb->nameTransf[j] = priv_getString(cat, t->name);
+				fdb->preprocessDataTransf[j] = priv_getString(cat,
+						t->preprocessData);
+			}
+		}
+		fdb->db = db;
+		fdb->internal_id = i;
+		db->filesDb[i] = fdb;
+	}
+	FileDB *first = db->filesDb[0];
+	db->isVideoDb = first->isVideo;
+	db->isImageDb = first->isImage;
+	db->isAudioDb = first->isAudio;
+	db->catalog = cat;
+	return true;
+}
+FileDB *dbCatalog_findById(DBCatalog *cat, const char *id) {
+	int64_t hashSize = cat->header->hashSize;
+	uint64_t pos = priv_hashString(id) & (hashSize - 1);
+	while (cat->hashId[pos] >= 0) {
+		FileDB *fdb = &cat->files[cat->hashId[pos]];
+		if (strcmp(fdb->id, id) == 0)
+			return fdb;
+		pos = (pos + 1) & (hashSize - 1);
+	}
+	return NULL;
+}
+void dbCatalog_findByFilenameReal(DBCatalog *cat, const char *filenameReal,
+		MyVectorObj *found) {
+	int64_t hashSize = cat->header->hashSize;
+	uint64_t pos = priv_hashString(filenameReal) & (hashSize - 1);
+	while (cat->hashFilenameReal[pos] >= 0) {
+		FileDB *fdb = &cat->files[cat->hashFilenameReal[pos]];
+		if (strcmp(fdb->filenameReal, filenameReal) == 0)
+			my_vectorObj_add(found, fdb);
+		pos = (pos + 1) & (hashSize - 1);
+	}
+}
+void dbCatalog_release(DBCatalog *cat) {
+	if (cat == NULL)
+		return;
+	my_io_unmapFile(cat->bytes, cat->numBytes);
+	MY_FREE_MULTI(cat->files, cat->transfStrings, cat);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of P-VCD. http://p-vcd.org/
+ * P-VCD is made available under the terms of the BSD 2-Clause License.
+ */
+
+#ifndef DBCATALOG_H
+#define DBCATALOG_H
+
+#include "../pvcd.h"
+
+//Binary copy of files.txt ("files.catalog" in the DB dir) with interned
+//strings and hash indexes by id and by filename. It is mapped in memory
+//instead of parsing the text file and it is discarded when files.txt changes.
+//Set PVCD_DB_CATALOG=0 to disable it.
+typedef struct DBCatalog DBCatalog;
+
+//loads the files of db from its catalog. Returns false if it is missing or outdated.
+bool dbCatalog_load(DB *db);
+
+//writes the catalog for the files currently loaded in db. The size and
+//modification time of files.txt must be read before parsing it.
+void dbCatalog_save(DB *db, int64_t textFilesize, int64_t textModificationTime);
+
+FileDB *dbCatalog_findById(DBCatalog *cat, const char *id);
+
+void dbCatalog_findByFilenameReal(DBCatalog *cat, const char *filenameReal,
+		MyVectorObj *found);
+
+//releases the catalog and the FileDB created by dbCatalog_load
+void dbCatalog_release(DBCatalog *cat);
+
+#endif
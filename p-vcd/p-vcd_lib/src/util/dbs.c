@@ -19,6 +19,12 @@ static int qsort_compare_fdb_filenameReal(const void *a, const void *b) {
 	return strcmp(o1->filenameReal, o2->filenameReal);
 }
 FileDB *findFileDB_byId(DB *db, const char *file_id, bool fail) {
+	if (db->catalog != NULL) {
+		FileDB *fdb = dbCatalog_findById(db->catalog, file_id);
+		if (fdb == NULL && fail)
+			my_log_error("can't find video id '%s'\n", file_id);
+		return fdb;
+	}
 	int64_t desde = 0, hasta = db->numFilesDb;
 	while (desde < hasta) {
 		int64_t medio = (desde + hasta) / 2;
@@ -37,6 +43,11 @@ FileDB *findFileDB_byId(DB *db, const char *file_id, bool fail) {
 }
 //hacer free de lo retornado
 MyVectorObj *findFilesDB_byFilenameReal(DB *db, const char *pathReal) {
+	if (db->catalog != NULL) {
+		MyVectorObj *found = my_vectorObj_new();
+		dbCatalog_findByFilenameReal(db->catalog, pathReal, found);
+		return found;
+	}
 	int64_t from = 0, to = db->numFilesDb;
 	int64_t posFound = -1;
 	while (from < to) {
@@ -277,6 +288,12 @@ DB *loadDB(const char *pathDB, bool fail, bool loadFiles) {
 	db->pathClustering = my_newString_format("%s/clustering", db->pathBase);
 	if (!loadFiles || !my_io_existsFile(db->pathFiles))
 		return db;
+	//the catalog contains the whole db
+	bool loadAll = (loadOptions == NULL);
+	if (loadAll && dbCatalog_load(db))
+		return db;
+	int64_t textFilesize = my_io_getFilesize(db->pathFiles);
+	int64_t textModificationTime = my_io_getModificationTime(db->pathFiles);
 	struct ParametersLoadDb param = loadParametersDB(loadOptions);
 	MY_FREE(loadOptions);
 	MyVectorObj *files = parseFiles(db->pathFiles, &param);
@@ -289,6 +306,8 @@ DB *loadDB(const char *pathDB, bool fail, bool loadFiles) {
 	}
 	addFilesToDb(db, files);
 	my_vectorObj_release(files, 0);
+	if (loadAll)
+		dbCatalog_save(db, textFilesize, textModificationTime);
 	return db;
 }
 FileDB *loadFileDB(const char *nameDB, const char *idFile, bool fail) {
@@ -323,7 +342,10 @@ FileDB *loadFileDB(const char *nameDB, const char *idFile, bool fail) {
 void releaseDB(DB *db) {
 	if (db == NULL)
 		return;
-	if (db->filesDb != NULL) {
+	if (db->catalog != NULL) {
+		dbCatalog_release(db->catalog);
+		MY_FREE(db->filesDb);
+	} else if (db->filesDb != NULL) {
 		int64_t i;
 		for (i = 0; i < db->numFilesDb; ++i) {
 			FileDB *fdb = db->filesDb[i];
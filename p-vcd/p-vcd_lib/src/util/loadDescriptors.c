@@ -9,14 +9,23 @@
 #include "loadDescriptors.h"
 
 struct GlobalEntry {
-	char *file_id;
+	const char *file_id;
 	int64_t offset;
 	int64_t size;
+	//-1 when unknown (index from the pos file)
+	int64_t numDescriptors;
 };
 struct LoadedDB {
-	MyVectorObj *entryList;
+	//index of the single file, entry_byFile is indexed by FileDB internal_id
+	int64_t numEntries, data_size;
+	struct GlobalEntry *entries;
+	struct GlobalEntry **entry_byFile;
+	char *ids_buffer;
+	MyBlockReader *reader;
 	struct DescriptorsDB* ddb;
-	char *file_bytes;
+	//mapping of the single file, descriptors point into it
+	const char *file_bytes;
+	int64_t file_bytes_size;
 };
 struct LoadedFile {
 	struct DescriptorsFile *df;
@@ -27,19 +36,34 @@ struct LoadDescriptors {
 	char *descAlias, *descriptor, *segmentation;
 	bool isSingleFile;
 	DescriptorType td;
+	//MY_LOCALDESCRIPTORS_COMPACT_* (DescriptorData 1.3)
+	int64_t compression;
 	DB *db;
 	LoadSegmentation *seg_loader;
 	struct LoadedDB loaded_db;
 	struct LoadedFile *loaded_files;
 };
 
+static void releaseIndex(struct LoadedDB *ldb);
+
+//1.2 uncompressed data, 1.3 adds the compression of local vectors and sparse arrays
+static int64_t getDesMinorVersion(const char *fname) {
+	MyLineReader *reader = my_lreader_open(my_io_openFileRead1(fname, true));
+	const char *line = my_lreader_readLineOrComment(reader);
+	char *header13 = my_io_getConfigFileHeader("PVCD", "DescriptorData", 1, 3);
+	int64_t minor = (line != NULL && my_string_equals(line, header13)) ? 3 : 2;
+	free(header13);
+	my_lreader_close(reader, true);
+	return minor;
+}
+
 LoadDescriptors *newLoadDescriptors(DB *db, const char *descAlias) {
 	LoadDescriptors *desloader = MY_MALLOC(1, LoadDescriptors);
 	desloader->descriptors_dir = my_newString_format("%s/%s",
 			db->pathDescriptors, descAlias);
 	char *fname = getFilenameDes(desloader->descriptors_dir);
 	MyMapStringObj *prop = my_io_loadProperties(fname, true, "PVCD",
-			"DescriptorData", 1, 2);
+			"DescriptorData", 1, getDesMinorVersion(fname));
 	free(fname);
 	desloader->db = db;
 	desloader->descAlias = my_newString_string(descAlias);
@@ -57,6 +81,8 @@ LoadDescriptors *newLoadDescriptors(DB *db, const char *descAlias) {
 			my_mapStringObj_get(prop, "subarray_length"));
 	desloader->isSingleFile = my_parse_bool(
 			my_mapStringObj_get(prop, "single_file"));
+	desloader->compression = string2compression(
+			my_mapStringObj_get(prop, "compression"));
 	my_mapStringObj_release(prop, true, true);
 	desloader->loaded_files = MY_MALLOC(db->numFilesDb, struct LoadedFile);
 	return desloader;
@@ -79,6 +105,7 @@ void releaseLoadDescriptors(LoadDescriptors *desloader) {
 	releaseLoadDescriptors_allFileBytes(desloader);
 	if (desloader->seg_loader != NULL)
 		releaseLoadSegmentation(desloader->seg_loader);
+	releaseIndex(&desloader->loaded_db);
 	MY_FREE_MULTI(desloader->descriptors_dir, desloader->descAlias,
 			desloader->descriptor, desloader->segmentation, desloader);
 }
@@ -112,66 +139,139 @@ DB *loadDescriptors_getDb(LoadDescriptors *desloader) {
 	return desloader->db;
 }
 
-static int qsort_compare_GlobalEntry(const void *a, const void *b) {
-	struct GlobalEntry *da = *(struct GlobalEntry**) a;
-	struct GlobalEntry *db = *(struct GlobalEntry**) b;
-	return strcmp(da->file_id, db->file_id);
-}
-static int binarySearch_compare_GlobalEntry(const void *search_object,
-		const void *array_object) {
-	const char *id_file = search_object;
-	const struct GlobalEntry *db = array_object;
-	return strcmp(id_file, db->file_id);
+static bool loadIndexFromFooter(struct LoadedDB *ldb) {
+	int64_t filesize = my_io_blockReader_getFilesize(ldb->reader);
+	struct SingleFileIndexTrailer trailer;
+	if (filesize < (int64_t) sizeof(trailer))
+		return false;
+	my_io_blockReader_read(ldb->reader, filesize - sizeof(trailer), &trailer,
+			sizeof(trailer));
+	if (memcmp(trailer.magic, SINGLE_FILE_INDEX_MAGIC, sizeof(trailer.magic))
+			!= 0)
+		return false;
+	int64_t size_entries = trailer.numEntries
+			* sizeof(struct SingleFileIndexEntry);
+	if (trailer.numEntries < 0 || trailer.ids_size < 0
+			|| trailer.index_start + size_entries + trailer.ids_size
+					+ (int64_t) sizeof(trailer) != filesize) {
+		my_log_info("invalid index in descriptors file, using pos file\n");
+		return false;
+	}
+	//entries and ids are contiguous, one read
+	int64_t size_index = size_entries + trailer.ids_size;
+	char *index = MY_MALLOC_NOINIT(MAX(1, size_index), char);
+	my_io_blockReader_read(ldb->reader, trailer.index_start, index,
+			size_index);
+	ldb->numEntries = trailer.numEntries;
+	ldb->data_size = trailer.index_start;
+	ldb->entries = MY_MALLOC(MAX(1, ldb->numEntries), struct GlobalEntry);
+	for (int64_t i = 0; i < ldb->numEntries; ++i) {
+		struct SingleFileIndexEntry e;
+		memcpy(&e, index + i * sizeof(e), sizeof(e));
+		if (e.id_offset < 0 || e.id_offset >= trailer.ids_size)
+			my_log_error("invalid index in descriptors file\n");
+		struct GlobalEntry *entry = ldb->entries + i;
+		entry->file_id = index + size_entries + e.id_offset;
+		entry->offset = e.offset;
+		entry->size = e.size;
+		entry->numDescriptors = e.numDescriptors;
+	}
+	if (trailer.ids_size > 0 && index[size_index - 1] != '\0')
+		my_log_error("invalid index in descriptors file\n");
+	ldb->ids_buffer = index;
+	return true;
 }
-static MyVectorObj *parsePosFile(LoadDescriptors *desloader) {
+//stores written before the footer index only have the pos file
+static void loadIndexFromPosFile(LoadDescriptors *desloader) {
+	struct LoadedDB *ldb = &desloader->loaded_db;
 	char *filePos = getFilenameSinglePos(desloader->descriptors_dir);
 	MyLineReader *reader = my_lreader_config_open(
 			my_io_openFileRead1(filePos, 1), "PVCD", "GlobalPos", 1, 3);
 	free(filePos);
-	int64_t num_files = my_parse_int(my_lreader_readLine(reader));
-	struct GlobalEntry **entries = MY_MALLOC(num_files, struct GlobalEntry*);
-	for (int64_t i = 0; i < num_files; ++i) {
+	ldb->numEntries = my_parse_int(my_lreader_readLine(reader));
+	ldb->entries = MY_MALLOC(MAX(1, ldb->numEntries), struct GlobalEntry);
+	for (int64_t i = 0; i < ldb->numEntries; ++i) {
 		MyTokenizer *tk = my_tokenizer_new(my_lreader_readLine(reader), '\t');
-		struct GlobalEntry *entry = MY_MALLOC(1, struct GlobalEntry);
+		struct GlobalEntry *entry = ldb->entries + i;
 		entry->file_id = my_tokenizer_nextToken_newString(tk);
 		entry->offset = my_tokenizer_nextInt(tk);
 		entry->size = my_tokenizer_nextInt(tk);
-		entries[i] = entry;
+		entry->numDescriptors = -1;
 		my_tokenizer_release(tk);
 	}
 	my_lreader_close(reader, true);
-	MyVectorObj * entryList = my_vectorObj_new_wrapper(num_files,
-			(void**) entries,
-			true);
-	my_vectorObj_qsort(entryList, qsort_compare_GlobalEntry);
-	return entryList;
+	ldb->data_size = my_io_blockReader_getFilesize(ldb->reader);
+}
+static void loadIndex(LoadDescriptors *desloader) {
+	struct LoadedDB *ldb = &desloader->loaded_db;
+	if (ldb->entry_byFile != NULL)
+		return;
+	char *fileBin = getFilenameSingleBin(desloader->descriptors_dir);
+	ldb->reader = my_io_blockReader_open(fileBin, true);
+	free(fileBin);
+	if (!loadIndexFromFooter(ldb))
+		loadIndexFromPosFile(desloader);
+	ldb->entry_byFile = MY_MALLOC(MAX(1, desloader->db->numFilesDb),
+			struct GlobalEntry*);
+	for (int64_t i = 0; i < ldb->numEntries; ++i) {
+		struct GlobalEntry *entry = ldb->entries + i;
+		FileDB *fdb = findFileDB_byId(desloader->db, entry->file_id, false);
+		if (fdb != NULL)
+			ldb->entry_byFile[fdb->internal_id] = entry;
+	}
+}
+static void releaseIndex(struct LoadedDB *ldb) {
+	if (ldb->ids_buffer == NULL) {
+		for (int64_t i = 0; i < ldb->numEntries; ++i)
+			MY_FREE((char* ) ldb->entries[i].file_id);
+	}
+	my_io_blockReader_close(ldb->reader);
+	MY_FREE_MULTI(ldb->entries, ldb->entry_byFile, ldb->ids_buffer);
+	ldb->entries = NULL;
+	ldb->entry_byFile = NULL;
+	ldb->ids_buffer = NULL;
+	ldb->reader = NULL;
+	ldb->numEntries = 0;
 }
 static struct GlobalEntry *getGlobalEntry(LoadDescriptors *desloader,
 		FileDB *fdb) {
-	if (desloader->loaded_db.entryList == NULL)
-		desloader->loaded_db.entryList = parsePosFile(desloader);
-	int64_t pos = my_vectorObj_indexOf_binsearch(desloader->loaded_db.entryList,
-			fdb->id, binarySearch_compare_GlobalEntry);
-	if (pos < 0)
+	loadIndex(desloader);
+	struct GlobalEntry *entry =
+			desloader->loaded_db.entry_byFile[fdb->internal_id];
+	if (entry == NULL)
 		my_log_error("can't find file %s at %s\n", fdb->id,
 				desloader->descriptors_dir);
-	struct GlobalEntry *entry = my_vectorObj_get(desloader->loaded_db.entryList,
-			pos);
 	return entry;
 }
 static struct DescriptorsFile *createDescriptorsFile(LoadDescriptors *desloader,
 		FileDB *fdb, char *base_bytes, int64_t size_bytes,
-		bool release_base_bytes) {
-	int numDescriptors = 0;
+		int64_t knownNumDescriptors, bool release_base_bytes) {
+	//bytes that outlive the file can be read in place, compressed data is
+	//always decoded
+	bool compressed = (desloader->compression
+			!= MY_LOCALDESCRIPTORS_COMPACT_NONE);
+	bool as_view = !release_base_bytes && !compressed;
+	int64_t numDescriptors = 0;
 	void **descriptors = NULL;
 	if (desloader->td.dtype == DTYPE_LOCAL_VECTORS
 			|| desloader->td.dtype == DTYPE_SPARSE_ARRAY) {
 		int64_t pos = 0;
+		if (knownNumDescriptors >= 0) {
+			numDescriptors = knownNumDescriptors;
+			pos = size_bytes;
+		}
 		while (pos < size_bytes) {
 			int64_t numBytesDesc = 0;
-			if (desloader->td.dtype == DTYPE_LOCAL_VECTORS)
+			if (desloader->td.dtype == DTYPE_LOCAL_VECTORS && compressed)
+				numBytesDesc =
+						my_localDescriptors_deserializeCompactPredictReadBytes(
+								base_bytes + pos);
+			else if (desloader->td.dtype == DTYPE_LOCAL_VECTORS)
 				numBytesDesc = my_localDescriptors_deserializePredictReadBytes(
 						base_bytes + pos);
+			else if (desloader->td.dtype == DTYPE_SPARSE_ARRAY && compressed)
+				numBytesDesc = my_sparseArray_deserializeCompactPredictReadBytes(
+						base_bytes + pos);
 			else if (desloader->td.dtype == DTYPE_SPARSE_ARRAY)
 				numBytesDesc = my_sparseArray_deserializePredictReadBytes(
 						base_bytes + pos);
@@ -187,12 +287,26 @@ static struct DescriptorsFile *createDescriptorsFile(LoadDescriptors *desloader,
 			int64_t numBytesDesc = 0;
 			if (desloader->td.dtype == DTYPE_LOCAL_VECTORS) {
 				descriptors[i] = my_localDescriptors_newEmpty();
-				numBytesDesc = my_localDescriptors_deserialize(base_bytes + pos,
-						descriptors[i]);
+				if (compressed)
+					numBytesDesc = my_localDescriptors_deserializeCompact(
+							base_bytes + pos, descriptors[i]);
+				else if (as_view)
+					numBytesDesc = my_localDescriptors_deserializeView(
+							base_bytes + pos, descriptors[i]);
+				else
+					numBytesDesc = my_localDescriptors_deserialize(
+							base_bytes + pos, descriptors[i]);
 			} else if (desloader->td.dtype == DTYPE_SPARSE_ARRAY) {
 				descriptors[i] = my_sparseArray_new();
-				numBytesDesc = my_sparseArray_deserialize(base_bytes + pos,
-						descriptors[i]);
+				if (compressed)
+					numBytesDesc = my_sparseArray_deserializeCompact(
+							base_bytes + pos, descriptors[i]);
+				else if (as_view)
+					numBytesDesc = my_sparseArray_deserializeView(
+							base_bytes + pos, descriptors[i]);
+				else
+					numBytesDesc = my_sparseArray_deserialize(base_bytes + pos,
+							descriptors[i]);
 			}
 			pos += numBytesDesc;
 			my_assert_lessEqualInt("invalid file size", pos, size_bytes);
@@ -206,6 +320,9 @@ static struct DescriptorsFile *createDescriptorsFile(LoadDescriptors *desloader,
 		int64_t numBytesDesc = getLengthBytesDescriptor(desloader->td);
 		my_assert_equalInt("invalid file size", size_bytes % numBytesDesc, 0);
 		numDescriptors = size_bytes / numBytesDesc;
+		if (knownNumDescriptors >= 0)
+			my_assert_equalInt("numDescriptors", numDescriptors,
+					knownNumDescriptors);
 		descriptors = MY_MALLOC(numDescriptors, void*);
 		for (int64_t i = 0; i < numDescriptors; ++i)
 			descriptors[i] = base_bytes + i * numBytesDesc;
@@ -234,24 +351,20 @@ struct DescriptorsFile* loadDescriptorsFileDB(LoadDescriptors *desloader,
 	if (fb->df != NULL)
 		return fb->df;
 	char *filebytes = NULL;
-	int64_t filesize = 0;
+	int64_t filesize = 0, numDescriptors = -1;
 	bool release_filebytes = false;
 	if (desloader->isSingleFile) {
 		struct GlobalEntry *entry = getGlobalEntry(desloader, fdb);
+		filesize = entry->size;
+		numDescriptors = entry->numDescriptors;
 		if (desloader->loaded_db.file_bytes != NULL) {
-			filebytes = desloader->loaded_db.file_bytes + entry->offset;
-			filesize = entry->size;
+			filebytes = (char*) desloader->loaded_db.file_bytes + entry->offset;
 			release_filebytes = false;
 		} else {
-			char *fileBin = getFilenameSingleBin(desloader->descriptors_dir);
-			FILE *in = my_io_openFileRead1(fileBin, true);
-			if (fseeko(in, entry->offset, SEEK_SET) != 0)
-				my_log_error("can't seek %s to %"PRIi64"\n", fileBin,
-						entry->offset);
-			filesize = entry->size;
+			//the descriptor stays open between files
 			filebytes = MY_MALLOC_NOINIT(filesize, char);
-			my_io_readBytesFile(in, filebytes, filesize, false);
-			fclose(in);
+			my_io_blockReader_read(desloader->loaded_db.reader, entry->offset,
+					filebytes, filesize);
 			release_filebytes = true;
 		}
 	} else {
@@ -262,9 +375,39 @@ struct DescriptorsFile* loadDescriptorsFileDB(LoadDescriptors *desloader,
 		release_filebytes = true;
 	}
 	struct DescriptorsFile* df = createDescriptorsFile(desloader, fdb,
-			filebytes, filesize, release_filebytes);
+			filebytes, filesize, numDescriptors, release_filebytes);
 	return df;
 }
+static int qsort_compare_GlobalEntry_offset(const void *a, const void *b) {
+	const struct GlobalEntry *ea = *(struct GlobalEntry**) a;
+	const struct GlobalEntry *eb = *(struct GlobalEntry**) b;
+	return (ea->offset < eb->offset) ? -1 : ((ea->offset > eb->offset) ? 1 : 0);
+}
+void loadDescriptors_prefetchFiles(LoadDescriptors *desloader,
+		int64_t numFiles, FileDB **fdbs) {
+	if (!desloader->isSingleFile || desloader->loaded_db.file_bytes != NULL)
+		return;
+	struct GlobalEntry **entries = MY_MALLOC(MAX(1, numFiles),
+			struct GlobalEntry*);
+	int64_t num = 0;
+	for (int64_t i = 0; i < numFiles; ++i) {
+		if (desloader->loaded_files[fdbs[i]->internal_id].df == NULL)
+			entries[num++] = getGlobalEntry(desloader, fdbs[i]);
+	}
+	//contiguous entries are requested as a single range
+	qsort(entries, num, sizeof(struct GlobalEntry*),
+			qsort_compare_GlobalEntry_offset);
+	int64_t i = 0;
+	while (i < num) {
+		int64_t start = entries[i]->offset;
+		int64_t end = start + entries[i]->size;
+		for (i = i + 1; i < num && entries[i]->offset <= end; ++i)
+			end = MAX(end, entries[i]->offset + entries[i]->size);
+		my_io_blockReader_willNeed(desloader->loaded_db.reader, start,
+				end - start);
+	}
+	MY_FREE(entries);
+}
 MknnDataset *loadDescriptorsFile_getMknnDataset(struct DescriptorsFile* df,
 		double sampleFractionDescriptors, double sampleFractionPerFrame) {
 	return descriptors2MknnDataset_samples(df->descriptors, df->numDescriptors,
@@ -282,7 +425,7 @@ void releaseDescriptorsFile(struct DescriptorsFile *df) {
 			MyLocalDescriptors *ldes = df->descriptors[i];
 			my_localDescriptors_release(ldes);
 		}
-	} else if (df->desloader->td.dtype == DTYPE_LOCAL_VECTORS) {
+	} else if (df->desloader->td.dtype == DTYPE_SPARSE_ARRAY) {
 		for (int64_t i = 0; i < df->numDescriptors; ++i) {
 			MySparseArray *sp = df->descriptors[i];
 			my_sparseArray_release(sp);
@@ -302,20 +445,21 @@ struct DescriptorsDB* loadDescriptorsDB(LoadDescriptors *desloader) {
 	int64_t size_bytes_total = 0;
 	MyProgress *lt = my_progress_new("loading descriptors", numFiles, 1);
 	if (desloader->isSingleFile) {
+		//the pages are read on demand and shared with the page cache, every
+		//descriptor (local and sparse too) points into the mapping
+		loadIndex(desloader);
+		size_bytes_total = desloader->loaded_db.data_size;
 		char *fileBin = getFilenameSingleBin(desloader->descriptors_dir);
-		char *base_bytes = my_io_loadFileBytes(fileBin, &size_bytes_total);
+		if (size_bytes_total > 0) {
+			desloader->loaded_db.file_bytes = my_io_mapFileRead(fileBin,
+					&desloader->loaded_db.file_bytes_size, true);
+		}
 		free(fileBin);
-		desloader->loaded_db.file_bytes = base_bytes;
 		for (int64_t j = 0; j < numFiles; ++j) {
 			allFiles[j] = loadDescriptorsFileDB(desloader,
 					desloader->db->filesDb[j]);
 			my_progress_add1(lt);
 		}
-		if (desloader->td.dtype == DTYPE_LOCAL_VECTORS
-				|| desloader->td.dtype == DTYPE_SPARSE_ARRAY) {
-			MY_FREE(desloader->loaded_db.file_bytes);
-			desloader->loaded_db.file_bytes = NULL;
-		}
 	} else {
 		for (int64_t j = 0; j < numFiles; ++j) {
 			allFiles[j] = loadDescriptorsFileDB(desloader,
@@ -342,20 +486,10 @@ void releaseDescriptorsDB(struct DescriptorsDB *ddb) {
 		releaseDescriptorsFile(ddb->allFiles[i]);
 	free(ddb->allFiles);
 	if (ddb->desloader->loaded_db.file_bytes != NULL) {
-		free(ddb->desloader->loaded_db.file_bytes);
+		my_io_unmapFile(ddb->desloader->loaded_db.file_bytes,
+				ddb->desloader->loaded_db.file_bytes_size);
 		ddb->desloader->loaded_db.file_bytes = NULL;
-	}
-	if (ddb->desloader->loaded_db.entryList != NULL) {
-		for (int64_t i = 0;
-				i < my_vectorObj_size(ddb->desloader->loaded_db.entryList);
-				++i) {
-			struct GlobalEntry *entry = my_vectorObj_get(
-					ddb->desloader->loaded_db.entryList, i);
-			free(entry->file_id);
-			free(entry);
-		}
-		my_vectorObj_release(ddb->desloader->loaded_db.entryList, false);
-		ddb->desloader->loaded_db.entryList = NULL;
+		ddb->desloader->loaded_db.file_bytes_size = 0;
 	}
 	ddb->desloader->loaded_db.ddb = NULL;
 	free(ddb);
@@ -38,6 +38,13 @@ struct DescriptorsFile* loadDescriptorsFileId(LoadDescriptors *desloader,
 		const char *file_id);
 struct DescriptorsFile* loadDescriptorsFileDB(LoadDescriptors *desloader,
 		FileDB *fdb);
+/**
+ * Announces that the descriptors of these files will be loaded soon, thus
+ * the system can read them in background. Only for single-file descriptors
+ * that are not mapped, otherwise it does nothing.
+ */
+void loadDescriptors_prefetchFiles(LoadDescriptors *desloader,
+		int64_t numFiles, FileDB **fdbs);
 MknnDataset *loadDescriptorsFile_getMknnDataset(struct DescriptorsFile* df,
 		double sampleFractionDescriptors, double sampleFractionPerFrame);
 void releaseDescriptorsFile(struct DescriptorsFile *df);
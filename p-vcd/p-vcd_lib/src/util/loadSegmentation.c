@@ -172,6 +172,13 @@ const struct Segmentation* loadSegmentationFileDB(LoadSegmentation *loader,
 	return ss;
 }
 
+char *loadSegmentation_newFilenameFileDB(LoadSegmentation *loader,
+		FileDB *fdb) {
+	if (fdb->isImage || loader->segmentations_dir == NULL)
+		return NULL;
+	return getFilenameSegmentationSeg(loader->segmentations_dir, fdb->id);
+}
+
 struct Segmentation *createNewSegmentationFileDB(int64_t total_segments,
 		FileDB *fdb) {
 	return createNewSegmentation(total_segments, fdb->numObjsPerSecond);
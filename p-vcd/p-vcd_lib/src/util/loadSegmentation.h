@@ -30,6 +30,9 @@ const struct Segmentation* loadSegmentationFileId(LoadSegmentation *loader,
 		const char *file_id);
 const struct Segmentation* loadSegmentationFileDB(LoadSegmentation *loader,
 		FileDB *fdb);
+//the file read by loadSegmentationFileDB, NULL for default segmentations
+char *loadSegmentation_newFilenameFileDB(LoadSegmentation *loader,
+		FileDB *fdb);
 
 void validateSegmentation(const struct Segmentation *seg);
 void contFramesAndSecondsInSegmentation(const struct Segmentation *seg,
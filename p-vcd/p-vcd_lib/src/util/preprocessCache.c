@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of P-VCD. http://p-vcd.org/
+ * P-VCD is made available under the terms of the BSD 2-Clause License.
+ */
+
+#include "preprocessCache.h"
+
+char *preprocessCache_newDirname(FileDB *fdb) {
+	const char *dir = my_env_getString("PVCD_PREPROCESS_CACHE_DIR");
+	if (strlen(dir) > 0)
+		return my_newString_string(dir);
+	if (my_env_getInt("PVCD_PREPROCESS_CACHE", 0) != 0 && fdb != NULL
+			&& fdb->db != NULL)
+		return my_newString_format("%s/preprocess_cache", fdb->db->pathBase);
+	return NULL;
+}
+//FNV-1a, the key is also stored in the file to discard collisions
+static char *priv_newFilename(const char *cacheDir, const char *key) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+	for (const char *c = key; *c != '\0'; ++c) {
+		hash ^= (uint8_t) *c;
+		hash *= UINT64_C(1099511628211);
+	}
+	return my_newString_format("%s/%016"PRIx64".txt", cacheDir, hash);
+}
+bool preprocessCache_get(const char *cacheDir, const char *key,
+		bool *out_enabled, char **out_savedData) {
+	char *filename = priv_newFilename(cacheDir, key);
+	bool found = false;
+	if (my_io_existsFile(filename)) {
+		MyVectorString *lines = my_io_loadLinesFile(filename);
+		if (my_vectorString_size(lines) >= 2
+				&& my_string_equals(my_vectorString_get(lines, 0), key)) {
+			*out_enabled = my_string_equals(my_vectorString_get(lines, 1), "1");
+			*out_savedData =
+					(my_vectorString_size(lines) >= 3) ?
+							my_newString_string(my_vectorString_get(lines, 2)) :
+							NULL;
+			found = true;
+		}
+		my_vectorString_release(lines, true);
+	}
+	MY_FREE(filename);
+	return found;
+}
+void preprocessCache_put(const char *cacheDir, const char *key, bool enabled,
+		const char *savedData) {
+	if (!my_io_existsDir(cacheDir))
+		my_io_createDir(cacheDir, false);
+	char *filename = priv_newFilename(cacheDir, key);
+	//other processes or threads may be writing the same entry, the temporal
+	//name is unique (pid and a counter) and the rename is atomic
+	static int64_t counter = 0;
+	char *tempname = my_newString_format("%s.%"PRIi64".%"PRIi64".tmp",
+			filename, (int64_t) getpid(),
+			__atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+	FILE *out = fopen(tempname, "w");
+	if (out == NULL) {
+		my_log_info("can't write cache %s\n", tempname);
+	} else {
+		fprintf(out, "%s\n%i\n", key, enabled ? 1 : 0);
+		if (savedData != NULL)
+			fprintf(out, "%s\n", savedData);
+		fclose(out);
+		if (!my_io_moveFile(tempname, filename, false))
+			my_io_deleteFile(tempname, false);
+	}
+	MY_FREE_MULTI(filename, tempname);
+}
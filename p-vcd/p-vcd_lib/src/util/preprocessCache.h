@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2012-2015, Juan Manuel Barrios <http://juan.cl/>
+ * All rights reserved.
+ *
+ * This file is part of P-VCD. http://p-vcd.org/
+ * P-VCD is made available under the terms of the BSD 2-Clause License.
+ */
+
+#ifndef PREPROCESSCACHE_H
+#define PREPROCESSCACHE_H
+
+#include "../pvcd.h"
+
+//On-disk cache of the data computed by func_preprocess_compute, only for
+//transformations with func_preprocess_load. It is disabled by default.
+//The directory is PVCD_PREPROCESS_CACHE_DIR, or the "preprocess_cache" dir in
+//the DB of the file when PVCD_PREPROCESS_CACHE=1. Returns NULL when cache is
+//not enabled.
+char *preprocessCache_newDirname(FileDB *fdb);
+
+//the key must identify the file content, the time range, the previous
+//transformations and the code and parameters of the transformation.
+bool preprocessCache_get(const char *cacheDir, const char *key,
+		bool *out_enabled, char **out_savedData);
+
+void preprocessCache_put(const char *cacheDir, const char *key, bool enabled,
+		const char *savedData);
+
+#endif
@@ -27,15 +27,36 @@ char *getFilenameDes(const char *descriptors_dir) {
 	return my_newString_format("%s/descriptor.des", descriptors_dir);
 }
 
+int64_t string2compression(const char *name) {
+	if (name == NULL || name[0] == '\0'
+			|| my_string_equals_ignorecase(name, "NONE"))
+		return MY_LOCALDESCRIPTORS_COMPACT_NONE;
+	else if (my_string_equals_ignorecase(name, "FP16"))
+		return MY_LOCALDESCRIPTORS_COMPACT_FLOAT16;
+	else if (my_string_equals_ignorecase(name, "INT8"))
+		return MY_LOCALDESCRIPTORS_COMPACT_INT8;
+	my_log_error("unknown compression %s (valid: NONE, FP16, INT8)\n", name);
+	return MY_LOCALDESCRIPTORS_COMPACT_NONE;
+}
+const char *compression2string(int64_t compression) {
+	if (compression == MY_LOCALDESCRIPTORS_COMPACT_FLOAT16)
+		return "FP16";
+	else if (compression == MY_LOCALDESCRIPTORS_COMPACT_INT8)
+		return "INT8";
+	return "NONE";
+}
+
 struct SaveDescriptors {
 	bool saveBinaryFormat, saveTxtFormat, useSingleFile;
 	char *output_dir, *segmentation, *descriptor;
 	DescriptorType td;
+	//MY_LOCALDESCRIPTORS_COMPACT_* (PVCD_DESCRIPTORS_COMPRESSION)
+	int64_t compression;
 	int64_t total_bytes, total_descriptors;
 	pthread_mutex_t mutex;
 	FILE *singleFile_out, *singleFile_outTxt;
 	MyVectorString *singleFile_ids;
-	MyVectorInt *singleFile_starts, *singleFile_sizes;
+	MyVectorInt *singleFile_starts, *singleFile_sizes, *singleFile_counts;
 };
 static void print_DescriptorFileTxt(FILE *outTxt, DescriptorType td,
 		int64_t numDescriptors, void **descriptors,
@@ -57,7 +78,7 @@ static void print_DescriptorFileTxt(FILE *outTxt, DescriptorType td,
 	}
 }
 static int64_t print_DescriptorFileBin(FILE *out, DescriptorType td,
-		int64_t numDescriptors, void **descriptors) {
+		int64_t compression, int64_t numDescriptors, void **descriptors) {
 	int64_t write_size = 0;
 	if (td.dtype == DTYPE_LOCAL_VECTORS || td.dtype == DTYPE_SPARSE_ARRAY) {
 		char *buffer = NULL;
@@ -66,16 +87,36 @@ static int64_t print_DescriptorFileBin(FILE *out, DescriptorType td,
 			int64_t numBytes = 0;
 			if (td.dtype == DTYPE_LOCAL_VECTORS) {
 				MyLocalDescriptors *ldes = (MyLocalDescriptors *) descriptors[i];
-				numBytes = my_localDescriptors_serializePredictSizeBytes(ldes);
-				MY_REALLOC(buffer, numBytes, char);
-				int64_t numBytes2 = my_localDescriptors_serialize(ldes, buffer);
-				my_assert_equalInt("numBytes", numBytes2, numBytes);
+				if (compression != MY_LOCALDESCRIPTORS_COMPACT_NONE) {
+					//int8 scale is computed for each frame
+					double max = my_localDescriptors_getMaxAbsValue(ldes);
+					float scale = (max > 0) ? 127 / max : 1;
+					MY_REALLOC(buffer,
+							my_localDescriptors_serializeCompactMaxBytes(ldes),
+							char);
+					numBytes = my_localDescriptors_serializeCompact(ldes,
+							compression, scale, buffer);
+				} else {
+					numBytes = my_localDescriptors_serializePredictSizeBytes(
+							ldes);
+					MY_REALLOC(buffer, numBytes, char);
+					int64_t numBytes2 = my_localDescriptors_serialize(ldes,
+							buffer);
+					my_assert_equalInt("numBytes", numBytes2, numBytes);
+				}
 			} else if (td.dtype == DTYPE_SPARSE_ARRAY) {
 				MySparseArray *sparse = (MySparseArray*) descriptors[i];
-				numBytes = my_sparseArray_serializePredictSizeBytes(sparse);
-				MY_REALLOC(buffer, numBytes, char);
-				int64_t numBytes2 = my_sparseArray_serialize(sparse, buffer);
-				my_assert_equalInt("numBytes", numBytes2, numBytes);
+				if (compression != MY_LOCALDESCRIPTORS_COMPACT_NONE) {
+					MY_REALLOC(buffer,
+							my_sparseArray_serializeCompactMaxBytes(sparse),
+							char);
+					numBytes = my_sparseArray_serializeCompact(sparse, buffer);
+				} else {
+					numBytes = my_sparseArray_serializePredictSizeBytes(sparse);
+					MY_REALLOC(buffer, numBytes, char);
+					int64_t numBytes2 = my_sparseArray_serialize(sparse, buffer);
+					my_assert_equalInt("numBytes", numBytes2, numBytes);
+				}
 			}
 			int64_t wrote = fwrite(buffer, sizeof(char), numBytes, out);
 			my_assert_equalInt("fwrite", wrote, numBytes);
@@ -105,8 +146,8 @@ static void writeDescriptorsToNewFile(SaveDescriptors *dessaver,
 	if (dessaver->saveBinaryFormat) {
 		char *fnameTemp = my_newString_format("%s.temp", fname);
 		FILE *out = my_io_openFileWrite1(fnameTemp);
-		write_size = print_DescriptorFileBin(out, dessaver->td, numDescriptors,
-				descriptors);
+		write_size = print_DescriptorFileBin(out, dessaver->td,
+				dessaver->compression, numDescriptors, descriptors);
 		fclose(out);
 		my_io_moveFile(fnameTemp, fname, true);
 		free(fnameTemp);
@@ -136,6 +177,7 @@ static void openSingleFile(SaveDescriptors *dessaver) {
 		dessaver->singleFile_ids = my_vectorString_new();
 		dessaver->singleFile_starts = my_vectorInt_new();
 		dessaver->singleFile_sizes = my_vectorInt_new();
+		dessaver->singleFile_counts = my_vectorInt_new();
 	}
 	if (dessaver->saveTxtFormat) {
 		char *fnameTxt = getFilenameSingleTxt(dessaver->output_dir);
@@ -152,11 +194,13 @@ static void writeDescriptorsToSingleFile(SaveDescriptors *dessaver,
 	int64_t write_size = 0;
 	if (dessaver->saveBinaryFormat) {
 		write_size = print_DescriptorFileBin(dessaver->singleFile_out,
-				dessaver->td, numDescriptors, descriptors);
+				dessaver->td, dessaver->compression, numDescriptors,
+				descriptors);
 		my_vectorString_add(dessaver->singleFile_ids,
 				my_newString_string(file_id));
 		my_vectorInt_add(dessaver->singleFile_starts, dessaver->total_bytes);
 		my_vectorInt_add(dessaver->singleFile_sizes, write_size);
+		my_vectorInt_add(dessaver->singleFile_counts, numDescriptors);
 	}
 	if (dessaver->saveTxtFormat) {
 		fprintf(dessaver->singleFile_outTxt, "##%s\n", file_id);
@@ -167,9 +211,44 @@ static void writeDescriptorsToSingleFile(SaveDescriptors *dessaver,
 	dessaver->total_descriptors += numDescriptors;
 	MY_MUTEX_UNLOCK(dessaver->mutex);
 }
+static void writeSingleFileIndex(SaveDescriptors *dessaver) {
+	int64_t numEntries = my_vectorString_size(dessaver->singleFile_ids);
+	struct SingleFileIndexEntry *entries = MY_MALLOC(MAX(1, numEntries),
+			struct SingleFileIndexEntry);
+	int64_t ids_size = 0;
+	for (int64_t i = 0; i < numEntries; ++i) {
+		struct SingleFileIndexEntry *e = entries + i;
+		e->offset = my_vectorInt_get(dessaver->singleFile_starts, i);
+		e->size = my_vectorInt_get(dessaver->singleFile_sizes, i);
+		e->numDescriptors = my_vectorInt_get(dessaver->singleFile_counts, i);
+		e->id_offset = ids_size;
+		ids_size += strlen(my_vectorString_get(dessaver->singleFile_ids, i))
+				+ 1;
+	}
+	FILE *out = dessaver->singleFile_out;
+	int64_t wrote = fwrite(entries, sizeof(struct SingleFileIndexEntry),
+			numEntries, out);
+	my_assert_equalInt("fwrite", wrote, numEntries);
+	for (int64_t i = 0; i < numEntries; ++i) {
+		char *id = my_vectorString_get(dessaver->singleFile_ids, i);
+		int64_t len = strlen(id) + 1;
+		wrote = fwrite(id, sizeof(char), len, out);
+		my_assert_equalInt("fwrite", wrote, len);
+	}
+	struct SingleFileIndexTrailer trailer = { { 0 } };
+	memcpy(trailer.magic, SINGLE_FILE_INDEX_MAGIC, sizeof(trailer.magic));
+	trailer.numEntries = numEntries;
+	trailer.index_start = dessaver->total_bytes;
+	trailer.ids_size = ids_size;
+	wrote = fwrite(&trailer, sizeof(struct SingleFileIndexTrailer), 1, out);
+	my_assert_equalInt("fwrite", wrote, 1);
+	MY_FREE(entries);
+}
 static void closeSingleFile(SaveDescriptors *dessaver) {
-	if (dessaver->singleFile_out != NULL)
+	if (dessaver->singleFile_out != NULL) {
+		writeSingleFileIndex(dessaver);
 		fclose(dessaver->singleFile_out);
+	}
 	if (dessaver->singleFile_outTxt != NULL)
 		fclose(dessaver->singleFile_outTxt);
 	char *fname = getFilenameSinglePos(dessaver->output_dir);
@@ -189,12 +268,16 @@ static void closeSingleFile(SaveDescriptors *dessaver) {
 	my_vectorString_release(dessaver->singleFile_ids, true);
 	my_vectorInt_release(dessaver->singleFile_starts);
 	my_vectorInt_release(dessaver->singleFile_sizes);
+	my_vectorInt_release(dessaver->singleFile_counts);
 }
 
 static void writeDescriptorDes(SaveDescriptors *dessaver) {
 	char *fname = getFilenameDes(dessaver->output_dir);
+	//compressed data requires version 1.3
+	bool compressed = (dessaver->compression
+			!= MY_LOCALDESCRIPTORS_COMPACT_NONE);
 	FILE *out = my_io_openFileWrite1Config(fname, "PVCD", "DescriptorData", 1,
-			2);
+			compressed ? 3 : 2);
 	free(fname);
 	fprintf(out, "descriptor=%s\n", dessaver->descriptor);
 	if (dessaver->segmentation != NULL)
@@ -206,6 +289,9 @@ static void writeDescriptorDes(SaveDescriptors *dessaver) {
 	char *s = my_newString_bool(dessaver->useSingleFile);
 	fprintf(out, "single_file=%s\n", s);
 	free(s);
+	if (compressed)
+		fprintf(out, "compression=%s\n",
+				compression2string(dessaver->compression));
 	fclose(out);
 }
 
@@ -220,6 +306,18 @@ bool saveBinaryFormat, bool saveTxtFormat, bool useSingleFile,
 	dessaver->useSingleFile = useSingleFile;
 	dessaver->descriptor = my_newString_string(descriptor);
 	dessaver->segmentation = my_newString_string(segmentation);
+	//only local vectors and sparse arrays are compressed
+	if (td.dtype == DTYPE_LOCAL_VECTORS || td.dtype == DTYPE_SPARSE_ARRAY)
+		dessaver->compression = string2compression(
+				my_env_getString("PVCD_DESCRIPTORS_COMPRESSION"));
+	//sparse arrays only support FP16
+	if (td.dtype == DTYPE_SPARSE_ARRAY
+			&& dessaver->compression == MY_LOCALDESCRIPTORS_COMPACT_INT8) {
+		my_log_info(
+				"INT8 compression is not supported for sparse arrays, using FP16 for %s\n",
+				descriptor);
+		dessaver->compression = MY_LOCALDESCRIPTORS_COMPACT_FLOAT16;
+	}
 	MY_MUTEX_INIT(dessaver->mutex);
 	return dessaver;
 }
@@ -18,6 +18,22 @@ char *getFilenameSinglePos(const char *descriptors_dir);
 char *getFilenameSingleTxt(const char *descriptors_dir);
 char *getFilenameDes(const char *descriptors_dir);
 
+//compression of local vectors and sparse arrays (DescriptorData 1.3):
+//"NONE", "FP16" or "INT8" <-> MY_LOCALDESCRIPTORS_COMPACT_*
+int64_t string2compression(const char *name);
+const char *compression2string(int64_t compression);
+
+//index appended to the single file after the descriptors:
+//entries, '\0'-terminated file ids, and the trailer at the end of the file
+#define SINGLE_FILE_INDEX_MAGIC "PVCDIDX1"
+struct SingleFileIndexEntry {
+	int64_t offset, size, numDescriptors, id_offset;
+};
+struct SingleFileIndexTrailer {
+	char magic[8];
+	int64_t numEntries, index_start, ids_size;
+};
+
 SaveDescriptors *newSaveDescriptors(const char *output_dir, DescriptorType td,
 bool saveBinaryFormat, bool saveTxtFormat,
 bool useSingleFile, const char *descriptor, const char *segmentation);
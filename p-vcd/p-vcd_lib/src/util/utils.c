@@ -89,6 +89,8 @@ static void pvcd_system_exit_logerror() {
 }
 void pvcd_register_default_values() {
 	my_log_setErrorFunction(pvcd_system_exit_logerror);
+	if (my_env_getInt("PVCD_LOG_ASYNC", 0) != 0)
+		my_log_setAsync(true);
 	NUM_CORES = my_env_getInt("PVCD_NUM_CORES", 0);
 	if (NUM_CORES == 0)
 		NUM_CORES = my_parallel_getNumberOfCores();
@@ -99,6 +101,7 @@ void pvcd_register_default_values() {
 	pvcd_register_default_processors();
 	pvcd_register_default_segmentators();
 	pvcd_register_default_transformations();
+	pvcd_register_default_indexes();
 }
 static void priv_load_cmd_parameters(CmdParams *cmd_params) {
 	while (hasNextParam(cmd_params)) {
@@ -518,27 +518,95 @@ static VideoFrame *reopenVideo(VideoFrame *video_frame) {
 	vtemp->name = my_newString_string(video_frame->name);
 	return vtemp;
 }
+//the preprocess depends on the content (path, size and modification time),
+//the file id, the time range and the frames produced by the previous
+//transformations, including the files they read (e.g. a segmentation)
+static char *newPreprocessCacheKey(VideoFrame *video_frame, Transform *tr) {
+	struct V_Layer0_opencv *c0 = video_frame->layer3->layer1->layer0;
+	MyStringBuffer *sb = my_stringbuf_new();
+	char *path = my_io_getAbsolutPath(c0->file_full_path);
+	my_stringbuf_appendString(sb, path);
+	my_stringbuf_appendString(sb, "|");
+	my_stringbuf_appendInt(sb, my_io_getFilesize(path));
+	my_stringbuf_appendString(sb, "|");
+	my_stringbuf_appendInt(sb, my_io_getModificationTime(path));
+	my_stringbuf_appendString(sb, "|");
+	if (video_frame->fdb != NULL && video_frame->fdb->id != NULL)
+		my_stringbuf_appendString(sb, video_frame->fdb->id);
+	my_stringbuf_appendString(sb, "|");
+	my_stringbuf_appendDouble(sb, getVideoTimeStart(video_frame));
+	my_stringbuf_appendString(sb, "-");
+	my_stringbuf_appendDouble(sb, getVideoTimeEnd(video_frame));
+	MyVectorObj *list = video_frame->layer3->layer1->transform;
+	for (int64_t i = 0; i < my_vectorObj_size(list); ++i) {
+		Transform *prev = my_vectorObj_get(list, i);
+		my_stringbuf_appendString(sb, "|");
+		my_stringbuf_appendString(sb, prev->codeAndParameters);
+		if (prev->preprocessSavedData != NULL) {
+			my_stringbuf_appendString(sb, "=");
+			my_stringbuf_appendString(sb, prev->preprocessSavedData);
+		}
+		char *dependency =
+				(prev->def->func_preprocess_dependency == NULL
+						|| video_frame->fdb == NULL) ?
+						NULL :
+						prev->def->func_preprocess_dependency(prev->state,
+								video_frame->fdb);
+		if (dependency != NULL) {
+			my_stringbuf_appendString(sb, "@");
+			my_stringbuf_appendString(sb, dependency);
+			my_stringbuf_appendString(sb, ":");
+			my_stringbuf_appendInt(sb, my_io_getModificationTime(dependency));
+			MY_FREE(dependency);
+		}
+	}
+	my_stringbuf_appendString(sb, "|");
+	my_stringbuf_appendString(sb, tr->codeAndParameters);
+	MY_FREE(path);
+	return my_stringbuf_releaseReturnBuffer(sb);
+}
+static uchar computePreprocess(VideoFrame *video_frame, Transform *tr) {
+	my_log_info("starting preprocess %s on %s\n", tr->codeAndParameters,
+			video_frame->name);
+	VideoFrame *vtemp = reopenVideo(video_frame);
+	MyVectorObj *listPrev = vtemp->layer3->layer1->transform;
+	vtemp->layer3->layer1->transform = video_frame->layer3->layer1->transform;
+	uchar enabled = tr->def->func_preprocess_compute(vtemp, video_frame->fdb,
+			tr->state, &tr->preprocessSavedData);
+	vtemp->layer3->layer1->transform = listPrev;
+	closeVideo(vtemp);
+	return enabled;
+}
+//only the saved data is cached, transformations without func_preprocess_load
+//set their state in func_preprocess_compute (e.g. VERSEGM)
+static uchar computePreprocessCached(VideoFrame *video_frame, Transform *tr) {
+	char *cacheDir =
+			(getIsWebcam(video_frame) || tr->def->func_preprocess_load == NULL) ?
+					NULL : preprocessCache_newDirname(video_frame->fdb);
+	if (cacheDir == NULL)
+		return computePreprocess(video_frame, tr);
+	char *key = newPreprocessCacheKey(video_frame, tr);
+	bool enabled = false;
+	if (preprocessCache_get(cacheDir, key, &enabled,
+			&tr->preprocessSavedData)) {
+		my_log_info("preprocess %s on %s loaded from cache\n",
+				tr->codeAndParameters, video_frame->name);
+	} else {
+		enabled = computePreprocess(video_frame, tr);
+		preprocessCache_put(cacheDir, key, enabled, tr->preprocessSavedData);
+	}
+	MY_FREE_MULTI(cacheDir, key);
+	return enabled;
+}
 static uchar myAddTransformation(VideoFrame *video_frame, const char *trName,
 bool wasPreprocessed, const char *preprocessSavedData) {
 	Transform *tr = findTransform(trName);
 	if (tr->mustPreprocessCompute) {
 		if (wasPreprocessed) {
 			tr->preprocessSavedData = my_newString_string(preprocessSavedData);
-		} else {
-			my_log_info("starting preprocess %s on %s\n", tr->codeAndParameters,
-					video_frame->name);
-			VideoFrame *vtemp = reopenVideo(video_frame);
-			MyVectorObj *listPrev = vtemp->layer3->layer1->transform;
-			vtemp->layer3->layer1->transform =
-					video_frame->layer3->layer1->transform;
-			uchar enabled = tr->def->func_preprocess_compute(vtemp,
-					video_frame->fdb, tr->state, &tr->preprocessSavedData);
-			vtemp->layer3->layer1->transform = listPrev;
-			closeVideo(vtemp);
-			if (!enabled) {
-				releaseTransform(tr);
-				return 0;
-			}
+		} else if (!computePreprocessCached(video_frame, tr)) {
+			releaseTransform(tr);
+			return 0;
 		}
 		tr->mustPreprocessCompute = 0;
 	}
@@ -617,6 +685,13 @@ bool loadNextFrame(VideoFrame *video_frame) {
 				getCurrentNumFrame(video_frame) + 1);
 	}
 }
+bool loadNextFrameStep(VideoFrame *video_frame, int64_t frameStep) {
+	if (frameStep <= 1
+			|| getCurrentNumFrame(video_frame) == NUMFRAME_NOT_OPENED)
+		return loadNextFrame(video_frame);
+	return seekVideoToFrame_layer3(video_frame->layer3,
+			getCurrentNumFrame(video_frame) + frameStep);
+}
 IplImage *getCurrentFrameOrig(VideoFrame *video_frame) {
 	if (video_frame == NULL)
 		return NULL;
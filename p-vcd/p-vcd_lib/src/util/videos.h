@@ -24,6 +24,8 @@ uchar addTransformationPreprocessed(VideoFrame *video_frame, const char *trName,
 void removeLastTransformation(VideoFrame *video_frame);
 FileDB *getNewFileDB(VideoFrame *video_frame);
 bool loadNextFrame(VideoFrame *video_frame);
+//advances frameStep frames (the first call loads the first frame)
+bool loadNextFrameStep(VideoFrame *video_frame, int64_t frameStep);
 IplImage *getCurrentFrameOrig(VideoFrame *video_frame);
 IplImage *getCurrentFrameGray(VideoFrame *video_frame);
 int64_t getCurrentNumFrame(VideoFrame *video_frame);